@@ -0,0 +1,89 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "hal.h"
+#include "ch.h"
+#include "nil_test_root.h"
+#include "oslib_test_root.h"
+#include "console.h"
+
+/*
+ * Sleeper thread, it keeps a timeout armed while the test suite runs.
+ */
+THD_WORKING_AREA(waThread1, 1024);
+THD_FUNCTION(Thread1, arg) {
+
+  (void)arg;
+
+  while (true) {
+    chThdSleepMilliseconds(500);
+  }
+}
+
+/*
+ * Tester thread, it runs the test suites then terminates the simulator
+ * with an exit code reporting the global result.
+ */
+THD_WORKING_AREA(waThread2, 8192);
+THD_FUNCTION(Thread2, arg) {
+
+  (void)arg;
+
+  test_execute((BaseSequentialStream *)&CD1, &nil_test_suite);
+  test_execute((BaseSequentialStream *)&CD1, &oslib_test_suite);
+  if (chtest.global_fail)
+    exit(1);
+  else
+    exit(0);
+}
+
+/*
+ * Threads static table, one entry per thread. The test suites create
+ * threads at the two priority levels above the tester and at the level
+ * below it, those levels must be left free.
+ */
+THD_TABLE_BEGIN
+  THD_TABLE_THREAD(2, "tester",   waThread2,  Thread2,  NULL)
+  THD_TABLE_THREAD(4, "sleeper",  waThread1,  Thread1,  NULL)
+THD_TABLE_END
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /* This is now the idle thread loop, interrupts are simulated by polling
+     the host, the system time is also advanced from here.*/
+  while (true) {
+    _sim_check_for_interrupts();
+  }
+}
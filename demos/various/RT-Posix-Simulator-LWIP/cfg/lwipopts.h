@@ -0,0 +1,63 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef LWIP_HDR_LWIPOPTS_H__
+#define LWIP_HDR_LWIPOPTS_H__
+
+/* Fixed settings mandated by the ChibiOS integration.*/
+#include "static_lwipopts.h"
+
+/* Optional, application-specific settings.*/
+#if !defined(TCPIP_MBOX_SIZE)
+#define TCPIP_MBOX_SIZE                 32
+#endif
+#if !defined(TCPIP_THREAD_STACKSIZE)
+#define TCPIP_THREAD_STACKSIZE          4096
+#endif
+
+#define DEFAULT_RAW_RECVMBOX_SIZE       8
+#define DEFAULT_UDP_RECVMBOX_SIZE       8
+#define DEFAULT_TCP_RECVMBOX_SIZE       8
+#define DEFAULT_ACCEPTMBOX_SIZE         4
+
+#define MEMP_NUM_TCPIP_MSG_API          64
+#define MEM_SIZE                        (32 * 1024)
+#define PBUF_POOL_SIZE                  32
+
+/* The simulated MAC supports the zero-copy API.*/
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+#if !defined(LWIP_USE_ZERO_COPY)
+#define LWIP_USE_ZERO_COPY              TRUE
+#endif
+
+/* Batched mailboxes, build with -DCH_LWIP_USE_BATCHED_MBOXES=FALSE in
+   order to compare with the ChibiOS mailboxes.*/
+#if !defined(CH_LWIP_USE_BATCHED_MBOXES)
+#define CH_LWIP_USE_BATCHED_MBOXES      TRUE
+#endif
+
+/* Use ChibiOS specific priorities. */
+#if !defined(TCPIP_THREAD_PRIO)
+#define TCPIP_THREAD_PRIO               (LOWPRIO + 1)
+#endif
+#if !defined(LWIP_THREAD_PRIORITY)
+#define LWIP_THREAD_PRIORITY            (LOWPRIO)
+#endif
+#if !defined(LWIP_THREAD_STACK_SIZE)
+#define LWIP_THREAD_STACK_SIZE          4096
+#endif
+
+#endif /* LWIP_HDR_LWIPOPTS_H__ */
@@ -0,0 +1,129 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "lwipthread.h"
+
+#include <lwip/tcpip.h>
+
+/*
+ * Number of messages posted by each producer thread.
+ */
+#define BMK_MESSAGES        200000U
+
+/*
+ * Maximum number of producer threads.
+ */
+#define BMK_MAX_PRODUCERS   4U
+
+#define BMK_WA_SIZE         THD_WORKING_AREA_SIZE(4096)
+
+static uint32_t bmk_expected;
+static uint32_t bmk_received;
+static semaphore_t bmk_done;
+
+/*
+ * Executed by the tcpip thread.
+ */
+static void bmk_callback(void *p) {
+
+  (void)p;
+
+  if (++bmk_received == bmk_expected) {
+    chSemSignal(&bmk_done);
+  }
+}
+
+static THD_FUNCTION(bmk_producer, p) {
+  uint32_t i;
+
+  (void)p;
+
+  for (i = 0U; i < BMK_MESSAGES; i++) {
+    (void) tcpip_callback(bmk_callback, NULL);
+  }
+}
+
+/*
+ * Measures the tcpip thread messages/second with a number of producer
+ * threads posting callbacks.
+ */
+static void bmk_tcpip_messages(unsigned producers) {
+  thread_t *tps[BMK_MAX_PRODUCERS];
+  rtcnt_t start, elapsed;
+  unsigned i;
+
+  bmk_expected = producers * BMK_MESSAGES;
+  bmk_received = 0U;
+  chSemObjectInit(&bmk_done, (cnt_t)0);
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < producers; i++) {
+    tps[i] = chThdCreateFromHeap(NULL, BMK_WA_SIZE, "producer",
+                                 NORMALPRIO - 1, bmk_producer, NULL);
+  }
+  chSemWait(&bmk_done);
+
+  /* Note, the simulator realtime counter counts microseconds.*/
+  elapsed = chSysGetRealtimeCounterX() - start;
+  for (i = 0U; i < producers; i++) {
+    chThdWait(tps[i]);
+  }
+
+  printf("--- tcpip messages, %u producer(s): %u msgs/S\n",
+         producers,
+         (unsigned)(((uint64_t)bmk_expected * 1000000U) /
+                    (elapsed > 0U ? elapsed : 1U)));
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  unsigned producers;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * lwIP stack started on the simulated MAC ETHD1.
+   */
+  lwipInit(NULL);
+
+  printf("*** lwIP benchmarks, batched mailboxes: %s\n",
+         CH_LWIP_USE_BATCHED_MBOXES ? "yes" : "no");
+  for (producers = 1U; producers <= BMK_MAX_PRODUCERS; producers *= 2U) {
+    bmk_tcpip_messages(producers);
+  }
+  fflush(stdout);
+
+  /*
+   * Clean simulator exit.
+   */
+  exit(0);
+}
@@ -0,0 +1,223 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "sb.h"
+
+#include "sandbox.h"
+
+/*
+ * Number of system calls performed by each benchmark.
+ */
+#define BMK_CALLS           100000U
+
+/*
+ * Number of fuzzer iterations.
+ */
+#define FUZZ_HOST_CYCLES    10000000U
+#define FUZZ_SB_CYCLES      100000U
+
+/*
+ * Sandbox data region, moved in shared memory when the sandbox starts.
+ */
+uint8_t sb_ram[SB_RAM_SIZE] __attribute__((aligned(4096)));
+
+/*
+ * Console stream, sandbox STDOUT.
+ */
+static size_t console_write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+
+  n = fwrite(bp, 1, n, stdout);
+  fflush(stdout);
+
+  return n;
+}
+
+/*
+ * Null stream, sandbox STDERR.
+ */
+static size_t null_write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+
+  return n;
+}
+
+static size_t null_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0;
+}
+
+static msg_t null_put(void *ip, uint8_t b) {
+
+  (void)ip;
+  (void)b;
+
+  return MSG_OK;
+}
+
+static msg_t null_get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+static const struct SandboxStreamVMT console_vmt = {
+  0, console_write, null_read, null_put, null_get
+};
+
+static const struct SandboxStreamVMT null_vmt = {
+  0, null_write, null_read, null_put, null_get
+};
+
+static SandboxStream console_stream = {&console_vmt};
+static SandboxStream null_stream = {&null_vmt};
+
+/* Sandbox configuration.*/
+static const sb_config_t sb_config = {
+  .code_region    = 0U,
+  .data_region    = 1U,
+  .regions        = {
+    [0] = {
+      (uint32_t)&sb_image,          (uint32_t)(&sb_image + 1),    false
+    },
+    [1] = {
+      (uint32_t)&sb_ram[0],         (uint32_t)&sb_ram[SB_RAM_SIZE], true
+    }
+  },
+  .stdin_stream   = NULL,
+  .stdout_stream  = &console_stream,
+  .stderr_stream  = &null_stream
+};
+
+/* Sandbox object.*/
+static sb_class_t sbx;
+
+static THD_WORKING_AREA(waSandbox, 4096);
+
+/*
+ * Measures the round trip of a sandbox system call.
+ */
+static void bmk_round_trip(const char *name, msg_t cmd) {
+  rtcnt_t start, elapsed;
+  msg_t msg;
+
+  start = chSysGetRealtimeCounterX();
+  msg = sbSendMessage(&sbx, cmd | (msg_t)BMK_CALLS);
+
+  /* Note, the simulator realtime counter counts microseconds.*/
+  elapsed = chSysGetRealtimeCounterX() - start;
+  if (elapsed == 0U) {
+    elapsed = 1U;
+  }
+
+  printf("--- %s: %u calls/S, %u nS per call, %u errors\n", name,
+         (unsigned)(((uint64_t)BMK_CALLS * 1000000U) / elapsed),
+         (unsigned)(((uint64_t)elapsed * 1000U) / BMK_CALLS),
+         (unsigned)msg);
+}
+
+/*
+ * Checks the host validation functions against the reference model.
+ */
+static void fuzz_host(void) {
+  uint32_t seed = 0x9E3779B9U;
+  uint32_t i, errors = 0U;
+
+  for (i = 0U; i < FUZZ_HOST_CYCLES; i++) {
+    uint32_t p = fuzz_address(&seed);
+    uint32_t size = fuzz_size(&seed);
+
+    if (sb_is_valid_read_range(&sbx, (const void *)p, (size_t)size) !=
+        fuzz_readable(p, size)) {
+      errors++;
+    }
+    if (sb_is_valid_write_range(&sbx, (void *)p, (size_t)size) !=
+        fuzz_writable(p, size)) {
+      errors++;
+    }
+  }
+
+  printf("--- validation fuzzer, %u cycles: %u errors\n",
+         (unsigned)FUZZ_HOST_CYCLES, (unsigned)errors);
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+int main(void) {
+  thread_t *utp;
+  msg_t msg;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - SandBox manager initialization.
+   */
+  halInit();
+  chSysInit();
+  sbHostInit();
+
+  /*
+   * Starting the sandbox process.
+   */
+  sbObjectInit(&sbx);
+  utp = sbStartThread(&sbx, &sb_config, "sbx",
+                      waSandbox, sizeof (waSandbox),
+                      NORMALPRIO + 1);
+  if (utp == NULL) {
+    chSysHalt("sbx failed");
+  }
+
+  printf("*** Sandbox benchmarks\n");
+  bmk_round_trip("sbGetSystemTime()", (msg_t)CMD_SYSTIME);
+  bmk_round_trip("sbFileWrite() 16 bytes", (msg_t)CMD_WRITE);
+  bmk_round_trip("sbRingQueueFileWrite() 16 bytes, batched",
+                 (msg_t)CMD_WRITE_BATCHED);
+
+  printf("*** Sandbox fuzzers\n");
+  fuzz_host();
+  msg = sbSendMessage(&sbx, (msg_t)(CMD_FUZZ | FUZZ_SB_CYCLES));
+  printf("--- syscalls fuzzer, %u cycles: %u errors\n",
+         (unsigned)FUZZ_SB_CYCLES, (unsigned)msg);
+
+  /*
+   * Sandbox termination, the argument is the exit code.
+   */
+  (void) sbSendMessage(&sbx, (msg_t)(CMD_EXIT | 42U));
+  printf("*** Sandbox exit code: %d\n", (int)sbWait(&sbx));
+  fflush(stdout);
+
+  /*
+   * Clean simulator exit.
+   */
+  exit(0);
+}
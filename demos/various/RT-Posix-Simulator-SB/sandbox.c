@@ -0,0 +1,149 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Sandboxed code, it runs in a child process of the simulator and only
+ * uses the sandbox API.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sbuser.h"
+#include "sandbox.h"
+
+/*
+ * Passes random pointers to the host, the results are checked against the
+ * reference model.
+ */
+static uint32_t fuzz_syscalls(uint32_t n) {
+  uint32_t seed = 0x2545F491U;
+  uint32_t errors = 0U;
+
+  while (n-- > 0U) {
+    uint32_t p = fuzz_address(&seed);
+    uint32_t size = fuzz_size(&seed);
+    uint32_t r;
+
+    /* Write checks the buffer as readable, STDERR is a null stream.*/
+    r = (uint32_t)sbFileWrite(2U, (const uint8_t *)p, (size_t)size);
+    if (r != (fuzz_readable(p, size) ? size : SB_ERR_EFAULT)) {
+      errors++;
+    }
+
+    /* Read checks the buffer as writable, STDIN is not connected.*/
+    r = (uint32_t)sbFileRead(0U, (uint8_t *)p, (size_t)size);
+    if (r != (fuzz_writable(p, size) ? 0U : SB_ERR_EFAULT)) {
+      errors++;
+    }
+  }
+
+  return errors;
+}
+
+/*
+ * Consumes the pending completions, returns the number of failed calls.
+ */
+static uint32_t fetch_completions(sb_ring_t *rp, uint32_t size) {
+  sb_ring_cqe_t cqe;
+  uint32_t errors = 0U;
+
+  while (sbRingGetCompletion(rp, &cqe)) {
+    if (cqe.result != size) {
+      errors++;
+    }
+  }
+
+  return errors;
+}
+
+/*
+ * Performs writes through the batched syscalls ring, returns the number of
+ * failed calls.
+ */
+static uint32_t write_batched(sb_ring_t *rp, uint32_t n) {
+  uint8_t buf[16] = {0};
+  uint32_t i, errors = 0U;
+
+  for (i = 0U; i < n; i++) {
+    if (!sbRingQueueFileWrite(rp, 2U, buf, sizeof (buf), i)) {
+      /* Submission queue full, flushing it with a single trap.*/
+      (void) sbRingSubmit(rp);
+      errors += fetch_completions(rp, sizeof (buf));
+      (void) sbRingQueueFileWrite(rp, 2U, buf, sizeof (buf), i);
+    }
+  }
+  (void) sbRingSubmit(rp);
+  errors += fetch_completions(rp, sizeof (buf));
+
+  return errors;
+}
+
+static uint32_t sandbox_main(void) {
+  char hello[] = "sandbox process started\n";
+  sb_ring_t ring;
+
+  /* Buffers must be in the data region, the stack is.*/
+  (void) sbFileWrite(1U, (const uint8_t *)hello, sizeof (hello) - 1U);
+
+  /* The ring must be in the data region too.*/
+  if (sbRingInit(&ring) != SB_ERR_NOERROR) {
+    return (uint32_t)MSG_RESET;
+  }
+
+  while (true) {
+    msg_t cmd = sbMsgWait();
+    uint32_t arg = cmd & CMD_ARG_MASK;
+    uint32_t i, r = 0U;
+
+    switch (cmd & ~CMD_ARG_MASK) {
+    case CMD_SYSTIME:
+      for (i = 0U; i < arg; i++) {
+        (void) sbGetSystemTime();
+      }
+      break;
+    case CMD_WRITE:
+      {
+        uint8_t buf[16] = {0};
+
+        for (i = 0U; i < arg; i++) {
+          (void) sbFileWrite(2U, buf, sizeof (buf));
+        }
+      }
+      break;
+    case CMD_WRITE_BATCHED:
+      r = write_batched(&ring, arg);
+      break;
+    case CMD_FUZZ:
+      r = fuzz_syscalls(arg);
+      break;
+    case CMD_EXIT:
+      (void) sbMsgReply(MSG_OK);
+      return arg;
+    default:
+      r = (uint32_t)MSG_RESET;
+      break;
+    }
+
+    (void) sbMsgReply((msg_t)r);
+  }
+}
+
+/*
+ * Sandbox image, code region of the sandbox.
+ */
+SB_SIM_IMAGE(sb_image, sandbox_main);
@@ -0,0 +1,115 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SANDBOX_H
+#define SANDBOX_H
+
+#include "sbsim.h"
+
+/*
+ * Size of the sandbox data region, it must be a multiple of the page size.
+ */
+#define SB_RAM_SIZE         65536U
+
+/*
+ * Commands sent as messages to the sandbox, the low bits are the argument.
+ */
+#define CMD_SYSTIME         (1U << 24)
+#define CMD_WRITE           (2U << 24)
+#define CMD_FUZZ            (3U << 24)
+#define CMD_EXIT            (4U << 24)
+#define CMD_WRITE_BATCHED   (5U << 24)
+#define CMD_ARG_MASK        0x00FFFFFFU
+
+/*
+ * Sandbox memory, shared between host and sandbox code.
+ */
+extern uint8_t sb_ram[SB_RAM_SIZE];
+extern const sb_sim_image_t sb_image;
+
+/*
+ * Fuzzer helpers, used on both sides of the sandbox.
+ */
+static inline uint32_t fuzz_rand(uint32_t *seedp) {
+  uint32_t x = *seedp;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *seedp = x;
+
+  return x;
+}
+
+/* Addresses are biased toward the regions boundaries.*/
+static inline uint32_t fuzz_address(uint32_t *seedp) {
+  uint32_t rbase = (uint32_t)sb_ram;
+  uint32_t rend  = rbase + SB_RAM_SIZE;
+  uint32_t ibase = (uint32_t)&sb_image;
+  uint32_t r = fuzz_rand(seedp);
+
+  switch (r & 7U) {
+  case 0:
+    return rbase + (fuzz_rand(seedp) % SB_RAM_SIZE);
+  case 1:
+    return rbase - (fuzz_rand(seedp) & 63U);
+  case 2:
+    return rend - (fuzz_rand(seedp) & 63U);
+  case 3:
+    return rend + (fuzz_rand(seedp) & 63U);
+  case 4:
+    return ibase - 4U + (fuzz_rand(seedp) % (sizeof (sb_sim_image_t) + 8U));
+  default:
+    return fuzz_rand(seedp);
+  }
+}
+
+/* Sizes include zero and values wrapping around the address space.*/
+static inline uint32_t fuzz_size(uint32_t *seedp) {
+  uint32_t r = fuzz_rand(seedp);
+
+  switch (r & 3U) {
+  case 0:
+    return (r >> 8) & 63U;
+  case 1:
+    return fuzz_rand(seedp) % (SB_RAM_SIZE + 64U);
+  case 2:
+    return 0xFFFFFFFFU - ((r >> 8) & 63U);
+  default:
+    return fuzz_rand(seedp);
+  }
+}
+
+/* Reference model, 64 bits arithmetic cannot wrap.*/
+static inline bool fuzz_in(uint32_t p, uint32_t n,
+                           uint32_t base, uint32_t end) {
+
+  return (p >= base) && (p < end) && (((uint64_t)p + (uint64_t)n) <= end);
+}
+
+static inline bool fuzz_readable(uint32_t p, uint32_t n) {
+  uint32_t ibase = (uint32_t)&sb_image;
+
+  return fuzz_in(p, n, (uint32_t)sb_ram, (uint32_t)sb_ram + SB_RAM_SIZE) ||
+         fuzz_in(p, n, ibase, ibase + (uint32_t)sizeof (sb_sim_image_t));
+}
+
+static inline bool fuzz_writable(uint32_t p, uint32_t n) {
+
+  return fuzz_in(p, n, (uint32_t)sb_ram, (uint32_t)sb_ram + SB_RAM_SIZE);
+}
+
+#endif /* SANDBOX_H */
@@ -0,0 +1,502 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#if PORT_CORES_NUMBER < 2
+#error "this demo requires PORT_CORES_NUMBER > 1"
+#endif
+
+#if (CH_CFG_USE_THREADS_MIGRATION == FALSE) ||                              \
+    (CH_CFG_SMP_BALANCE_INTERVAL == 0)
+#error "this demo requires threads migration and load balancing"
+#endif
+
+/*
+ * Number of cross-core ping-pong round trips for each core.
+ */
+#define PINGPONG_ROUNDS         2000U
+
+/*
+ * Operations performed by each worker in the scaling test.
+ */
+#define WORKER_ITERATIONS       20000U
+
+#define WORKER_STACK_SIZE       2048U
+
+/*===========================================================================*/
+/* OS instances for cores 2 and above.                                       */
+/*===========================================================================*/
+
+/*
+ * Core 1 instance is provided by the kernel, the other cores instances are
+ * application-defined.
+ */
+#if PORT_CORES_NUMBER > 2
+static os_instance_t ch_cores[PORT_CORES_NUMBER - 2];
+static THD_WORKING_AREA(ch_cores_idle_wa[PORT_CORES_NUMBER - 2],
+                        PORT_IDLE_THREAD_STACK_SIZE);
+static os_instance_config_t ch_cores_cfg[PORT_CORES_NUMBER - 2];
+static char ch_cores_names[PORT_CORES_NUMBER - 2][8];
+#endif
+
+/*
+ * Signaled by each core when its instance is running.
+ */
+static semaphore_t cores_ready;
+
+/*
+ * Cores entry, each core waits for the system initialization and then
+ * initializes its own instance, the calling context becomes the instance
+ * main thread.
+ */
+static void core_entry(void) {
+  core_id_t core_id = port_get_core_id();
+
+  chSysWaitSystemState(ch_sys_running);
+  if (core_id == 1U) {
+    chInstanceObjectInit(&ch1, &ch_core1_cfg);
+  }
+#if PORT_CORES_NUMBER > 2
+  else {
+    unsigned n = (unsigned)core_id - 2U;
+    os_instance_config_t *cfgp = &ch_cores_cfg[n];
+
+    snprintf(ch_cores_names[n], sizeof ch_cores_names[n],
+             "c%u", (unsigned)core_id);
+    cfgp->name            = ch_cores_names[n];
+#if CH_CFG_USE_DYNAMIC == TRUE
+    cfgp->mainthread_base = NULL;
+    cfgp->mainthread_end  = NULL;
+#endif
+    cfgp->idlethread_base = THD_WORKING_AREA_BASE(ch_cores_idle_wa[n]);
+    cfgp->idlethread_end  = THD_WORKING_AREA_END(ch_cores_idle_wa[n]);
+    chInstanceObjectInit(&ch_cores[n], cfgp);
+  }
+#endif
+  chSysUnlock();
+
+  chSemSignal(&cores_ready);
+  while (true) {
+    chThdSleepMilliseconds(1000);
+  }
+}
+
+/*===========================================================================*/
+/* Cross-core ping-pong.                                                     */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(waworkers[PORT_CORES_NUMBER], WORKER_STACK_SIZE);
+static semaphore_t ping, pong;
+
+static THD_FUNCTION(ponger, arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0U; i < PINGPONG_ROUNDS; i++) {
+    chSemWait(&ping);
+    chSemSignal(&pong);
+  }
+}
+
+static uint32_t total_ipis(void) {
+  uint32_t n = 0U;
+  unsigned i;
+
+  for (i = 0U; i < PORT_CORES_NUMBER; i++) {
+    n += port_core_stats[i].ipis;
+  }
+  return n;
+}
+
+static uint32_t total_spins(void) {
+  uint32_t n = 0U;
+  unsigned i;
+
+  for (i = 0U; i < PORT_CORES_NUMBER; i++) {
+    n += port_core_stats[i].spins;
+  }
+  return n;
+}
+
+/*
+ * Round trips between the main thread on core 0 and a thread on the
+ * specified core.
+ */
+static void test_pingpong(core_id_t core_id) {
+  thread_descriptor_t td = THD_DESCRIPTOR_MASK("ponger",
+                                   THD_WORKING_AREA_BASE(waworkers[core_id]),
+                                   THD_WORKING_AREA_END(waworkers[core_id]),
+                                   NORMALPRIO + 1, ponger, NULL,
+                                   ch_system.instances[core_id],
+                                   CH_AFFINITY_CORE(core_id));
+  rtcnt_t start, elapsed;
+  uint32_t ipis;
+  thread_t *tp;
+  unsigned i;
+
+  chSemObjectInit(&ping, 0);
+  chSemObjectInit(&pong, 0);
+  tp = chThdCreate(&td);
+
+  ipis  = total_ipis();
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < PINGPONG_ROUNDS; i++) {
+    chSemSignal(&ping);
+    chSemWait(&pong);
+  }
+  elapsed = chSysGetRealtimeCounterX() - start;
+  ipis    = total_ipis() - ipis;
+  (void) chThdWait(tp);
+
+  printf("ping-pong c0<->c%u: %u round trips in %lu us, %lu trips/s, "
+         "%lu IPIs\n",
+         (unsigned)core_id, PINGPONG_ROUNDS, (unsigned long)elapsed,
+         (unsigned long)(((uint64_t)PINGPONG_ROUNDS * 1000000U) /
+                         (elapsed > 0U ? elapsed : 1U)),
+         (unsigned long)ipis);
+}
+
+/*===========================================================================*/
+/* Scaling test.                                                             */
+/*===========================================================================*/
+
+typedef struct {
+  uint32_t  buf[8];
+} item_t;
+
+static MEMORYPOOL_DECL(items_pool, sizeof (item_t), PORT_NATURAL_ALIGN, NULL);
+static item_t items[PORT_CORES_NUMBER];
+static MUTEX_DECL(counter_mtx);
+static volatile uint32_t counter;
+
+/*
+ * Each worker exercises kernel services shared with the other cores, a
+ * memory pool and a mutex-protected counter.
+ */
+static THD_FUNCTION(worker, arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0U; i < WORKER_ITERATIONS; i++) {
+    item_t *ip = chPoolAlloc(&items_pool);
+
+    chDbgAssert(ip != NULL, "pool empty");
+    ip->buf[0] = i;
+    chMtxLock(&counter_mtx);
+    counter = counter + 1U;
+    chMtxUnlock(&counter_mtx);
+    chPoolFree(&items_pool, ip);
+  }
+}
+
+/*
+ * Runs one worker on each of the first n cores.
+ */
+static bool test_scaling(unsigned n) {
+  thread_t *tps[PORT_CORES_NUMBER];
+  rtcnt_t start, elapsed;
+  uint32_t spins;
+  unsigned i;
+
+  counter = 0U;
+  spins   = total_spins();
+  start   = chSysGetRealtimeCounterX();
+  for (i = 0U; i < n; i++) {
+    thread_descriptor_t td = THD_DESCRIPTOR_MASK("worker",
+                                   THD_WORKING_AREA_BASE(waworkers[i]),
+                                   THD_WORKING_AREA_END(waworkers[i]),
+                                   NORMALPRIO - 1, worker, NULL,
+                                   ch_system.instances[i],
+                                   CH_AFFINITY_CORE(i));
+    tps[i] = chThdCreate(&td);
+  }
+  for (i = 0U; i < n; i++) {
+    (void) chThdWait(tps[i]);
+  }
+  elapsed = chSysGetRealtimeCounterX() - start;
+  spins   = total_spins() - spins;
+
+  printf("scaling %u core(s): %lu ops in %lu us, %lu ops/s, "
+         "%lu spinlock waits, counter %s\n",
+         n, (unsigned long)(n * WORKER_ITERATIONS), (unsigned long)elapsed,
+         (unsigned long)(((uint64_t)n * WORKER_ITERATIONS * 1000000U) /
+                         (elapsed > 0U ? elapsed : 1U)),
+         (unsigned long)spins,
+         counter == n * WORKER_ITERATIONS ? "OK" : "CORRUPTED");
+
+  return counter == n * WORKER_ITERATIONS;
+}
+
+/*===========================================================================*/
+/* Threads migration.                                                        */
+/*===========================================================================*/
+
+#define MIGRATION_TIMEOUT       50U
+
+static semaphore_t migsem;
+static volatile core_id_t migcore;
+static volatile msg_t migmsg;
+
+/*
+ * Moves itself through all the cores, then waits on a semaphore without
+ * timeout to be moved.
+ */
+static THD_FUNCTION(migrator, arg) {
+  bool *okp = (bool *)arg;
+  unsigned i;
+
+  for (i = 1U; i <= PORT_CORES_NUMBER; i++) {
+    core_id_t core_id = (core_id_t)(i % PORT_CORES_NUMBER);
+
+    if ((chThdMigrate(chThdGetSelfX(), ch_system.instances[core_id]) !=
+         MSG_OK) || (port_get_core_id() != core_id)) {
+      *okp = false;
+    }
+  }
+
+  chSemWait(&migsem);
+  migcore = port_get_core_id();
+}
+
+/*
+ * Waits on a semaphore with a timeout or sleeps, it must not be moved
+ * while waiting.
+ */
+static THD_FUNCTION(timed_waiter, arg) {
+
+  if (arg != NULL) {
+    migmsg = chSemWaitTimeout((semaphore_t *)arg,
+                              TIME_MS2I(MIGRATION_TIMEOUT));
+  }
+  else {
+    chThdSleepMilliseconds(MIGRATION_TIMEOUT);
+    migmsg = MSG_OK;
+  }
+  migcore = port_get_core_id();
+}
+
+/*
+ * Tries to move a thread waiting with a timeout, the thread must stay on
+ * the current core, it is woken early if requested else it times out.
+ */
+static bool test_timed_migration(thread_descriptor_t *tdp, tstate_t state,
+                                 bool wakeup, msg_t expected) {
+  thread_t *tp;
+  bool ok = true;
+
+  tp = chThdCreate(tdp);
+  while (tp->state != state) {
+    chThdSleepMilliseconds(1);
+  }
+
+  ok = (chThdMigrate(tp, ch_system.instances[1]) == MSG_RESET) && ok;
+  ok = (tp->owner == currcore) && ok;
+  if (wakeup) {
+    chSemSignal(&migsem);
+  }
+  (void) chThdWait(tp);
+
+  return (migmsg == expected) && (migcore == port_get_core_id()) && ok;
+}
+
+static bool test_migration(void) {
+  thread_descriptor_t td = THD_DESCRIPTOR_MASK("migrator",
+                                   THD_WORKING_AREA_BASE(waworkers[0]),
+                                   THD_WORKING_AREA_END(waworkers[0]),
+                                   NORMALPRIO + 1, migrator, NULL,
+                                   NULL, CH_AFFINITY_ALL);
+  bool ok = true;
+  thread_t *tp;
+  unsigned i;
+
+  chSemObjectInit(&migsem, 0);
+  td.arg = &ok;
+  tp = chThdCreate(&td);
+
+  /* Waiting for the thread to be back and sleeping on the semaphore.*/
+  while (tp->state != CH_STATE_WTSEM) {
+    chThdSleepMilliseconds(1);
+  }
+
+  /* Moving the sleeping thread, it must wake up on the new core.*/
+  ok = (chThdMigrate(tp, ch_system.instances[1]) == MSG_OK) && ok;
+  chSemSignal(&migsem);
+  (void) chThdWait(tp);
+  ok = (migcore == 1U) && ok;
+
+  /* Threads waiting with a timeout are not moved, the waits are completed
+     by a wakeup and by the timeout.*/
+  td.funcp = timed_waiter;
+  td.arg = &migsem;
+  ok = test_timed_migration(&td, CH_STATE_WTSEM, true, MSG_OK) && ok;
+  ok = test_timed_migration(&td, CH_STATE_WTSEM, false, MSG_TIMEOUT) && ok;
+  td.arg = NULL;
+  ok = test_timed_migration(&td, CH_STATE_SLEEPING, false, MSG_OK) && ok;
+
+  /* Affinity restrictions.*/
+  td.funcp = ponger;
+  td.affinity = CH_AFFINITY_CORE(0);
+  chSemObjectInit(&ping, 0);
+  chSemObjectInit(&pong, 0);
+  tp = chThdCreate(&td);
+  ok = (chThdMigrate(tp, ch_system.instances[1]) == MSG_RESET) && ok;
+  ok = (chThdSetAffinity(tp, CH_AFFINITY_CORE(1)) == MSG_OK) && ok;
+  ok = (tp->owner == ch_system.instances[1]) && ok;
+  for (i = 0U; i < PINGPONG_ROUNDS; i++) {
+    chSemSignal(&ping);
+    chSemWait(&pong);
+  }
+  (void) chThdWait(tp);
+
+  printf("migration: %s\n", ok ? "OK" : "FAILED");
+
+  return ok;
+}
+
+/*===========================================================================*/
+/* Load balancing.                                                           */
+/*===========================================================================*/
+
+#define BALANCE_WORKERS         (2U * PORT_CORES_NUMBER)
+#define BALANCE_CHUNKS          200U
+#define BALANCE_CHUNK_SIZE      20000U
+
+static THD_WORKING_AREA(wabalance[BALANCE_WORKERS], WORKER_STACK_SIZE);
+static volatile uint32_t chunks[BALANCE_WORKERS][PORT_CORES_NUMBER];
+
+/*
+ * CPU-bound worker, the work performed on each core is accounted.
+ */
+static THD_FUNCTION(cruncher, arg) {
+  volatile uint32_t *cp = (volatile uint32_t *)arg;
+  volatile uint32_t x = 1U;
+  unsigned i, j;
+
+  for (i = 0U; i < BALANCE_CHUNKS; i++) {
+    for (j = 0U; j < BALANCE_CHUNK_SIZE; j++) {
+      x = (x * 1103515245U) + 12345U;
+    }
+    cp[port_get_core_id()]++;
+  }
+}
+
+/*
+ * All the workers are created on core 0, if pinned they cannot be pulled
+ * by the other cores.
+ */
+static bool test_balance(bool pinned) {
+  thread_t *tps[BALANCE_WORKERS];
+  uint32_t percore[PORT_CORES_NUMBER] = {0};
+  uint32_t total = 0U;
+  rtcnt_t start, elapsed;
+  unsigned i, j;
+
+  memset((void *)chunks, 0, sizeof chunks);
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BALANCE_WORKERS; i++) {
+    thread_descriptor_t td = THD_DESCRIPTOR_MASK("cruncher",
+                                   THD_WORKING_AREA_BASE(wabalance[i]),
+                                   THD_WORKING_AREA_END(wabalance[i]),
+                                   NORMALPRIO - 1, cruncher,
+                                   (void *)chunks[i], ch_system.instances[0],
+                                   pinned ? CH_AFFINITY_CORE(0) :
+                                            CH_AFFINITY_ALL);
+    tps[i] = chThdCreate(&td);
+  }
+  for (i = 0U; i < BALANCE_WORKERS; i++) {
+    (void) chThdWait(tps[i]);
+  }
+  elapsed = chSysGetRealtimeCounterX() - start;
+
+  for (i = 0U; i < BALANCE_WORKERS; i++) {
+    for (j = 0U; j < PORT_CORES_NUMBER; j++) {
+      percore[j] += chunks[i][j];
+      total      += chunks[i][j];
+    }
+  }
+
+  printf("balance %s: %u workers in %lu us, chunks per core:",
+         pinned ? "pinned  " : "balanced", BALANCE_WORKERS,
+         (unsigned long)elapsed);
+  for (j = 0U; j < PORT_CORES_NUMBER; j++) {
+    printf(" %lu", (unsigned long)percore[j]);
+  }
+  printf("\n");
+
+  /* Pinned workers must not leave core 0, balanced workers must have
+     been spread.*/
+  return (total == BALANCE_WORKERS * BALANCE_CHUNKS) &&
+         (pinned ? (percore[0] == total) : (percore[0] < total));
+}
+
+/*===========================================================================*/
+/* Main.                                                                     */
+/*===========================================================================*/
+
+/*
+ * Simulator main.
+ */
+int main(void) {
+  bool ok = true;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * Starting the other cores and waiting for their instances.
+   */
+  chSemObjectInit(&cores_ready, 0);
+  for (i = 1U; i < PORT_CORES_NUMBER; i++) {
+    port_start_core((core_id_t)i, core_entry);
+  }
+  for (i = 1U; i < PORT_CORES_NUMBER; i++) {
+    chSemWait(&cores_ready);
+  }
+  printf("%u cores running\n", (unsigned)PORT_CORES_NUMBER);
+
+  for (i = 1U; i < PORT_CORES_NUMBER; i++) {
+    test_pingpong((core_id_t)i);
+  }
+
+  chPoolLoadArray(&items_pool, items, PORT_CORES_NUMBER);
+  for (i = 1U; i <= PORT_CORES_NUMBER; i++) {
+    ok = test_scaling(i) && ok;
+  }
+
+  ok = test_migration() && ok;
+  ok = test_balance(true) && ok;
+  ok = test_balance(false) && ok;
+
+  printf("%s\n", ok ? "PASSED" : "FAILED");
+  fflush(stdout);
+  exit(ok ? 0 : 1);
+}
@@ -49,6 +49,27 @@
 #define CH_CFG_SMP_MODE                     FALSE
 #endif
 
+/**
+ * @brief   Threads migration between OS instances.
+ * @details If enabled then threads have a cores affinity mask and can be
+ *          moved to another OS instance using @p chThdMigrate().
+ * @note    Requires @p CH_CFG_SMP_MODE.
+ */
+#if !defined(CH_CFG_USE_THREADS_MIGRATION)
+#define CH_CFG_USE_THREADS_MIGRATION        FALSE
+#endif
+
+/**
+ * @brief   Load balancing interval.
+ * @details Idle OS instances pull ready threads waiting on other instances,
+ *          the check is performed at most once every specified number of
+ *          system ticks. Zero disables the load balancing.
+ * @note    Requires @p CH_CFG_USE_THREADS_MIGRATION.
+ */
+#if !defined(CH_CFG_SMP_BALANCE_INTERVAL)
+#define CH_CFG_SMP_BALANCE_INTERVAL         0
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -256,6 +277,20 @@
 #define CH_CFG_USE_MUTEXES_RECURSIVE        FALSE
 #endif
 
+/**
+ * @brief   Enables priority ceiling mutexes.
+ * @details If enabled then mutexes can be initialized with a static
+ *          priority ceiling using the immediate priority ceiling protocol
+ *          instead of priority inheritance.
+ * @note    All the mutexes have an increased memory footprint.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MUTEXES.
+ */
+#if !defined(CH_CFG_USE_MUTEXES_CEILING)
+#define CH_CFG_USE_MUTEXES_CEILING          TRUE
+#endif
+
 /**
  * @brief   Conditional Variables APIs.
  * @details If enabled then the conditional variables APIs are included
@@ -280,6 +315,31 @@
 #define CH_CFG_USE_CONDVARS_TIMEOUT         TRUE
 #endif
 
+/**
+ * @brief   Reader-Writer Locks APIs.
+ * @details If enabled then the reader-writer locks APIs are included in
+ *          the kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_CFG_USE_MUTEXES.
+ */
+#if !defined(CH_CFG_USE_RWLOCKS)
+#define CH_CFG_USE_RWLOCKS                  TRUE
+#endif
+
+/**
+ * @brief   Maximum number of reader-writer locks held by a thread.
+ * @details Each thread has this number of hold records, a record is used
+ *          for each reader-writer lock held by the thread at the same
+ *          time.
+ *
+ * @note    The default is 4.
+ * @note    Requires @p CH_CFG_USE_RWLOCKS.
+ */
+#if !defined(CH_CFG_RWLOCKS_MAX_HELD)
+#define CH_CFG_RWLOCKS_MAX_HELD             4
+#endif
+
 /**
  * @brief   Events Flags APIs.
  * @details If enabled then the event flags APIs are included in the kernel.
@@ -302,6 +362,27 @@
 #define CH_CFG_USE_EVENTS_TIMEOUT           TRUE
 #endif
 
+/**
+ * @brief   Indexed Events Sources APIs.
+ * @details If enabled then the indexed event sources APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_EVENTS.
+ */
+#if !defined(CH_CFG_USE_EVENTS_INDEX)
+#define CH_CFG_USE_EVENTS_INDEX             TRUE
+#endif
+
+/**
+ * @brief   Number of listener buckets of each indexed event source.
+ * @note    It must be a power of two not greater than the size, in bits,
+ *          of the @p eventflags_t type.
+ */
+#if !defined(CH_CFG_EVENTS_INDEX_BUCKETS)
+#define CH_CFG_EVENTS_INDEX_BUCKETS         8
+#endif
+
 /**
  * @brief   Synchronous Messages APIs.
  * @details If enabled then the synchronous messages APIs are included
@@ -339,6 +420,17 @@
 #define CH_CFG_USE_DYNAMIC                  TRUE
 #endif
 
+/**
+ * @brief   Threads pools APIs.
+ * @details If enabled then the threads pools APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_THREADS_POOLS)
+#define CH_CFG_USE_THREADS_POOLS            TRUE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -466,6 +558,26 @@
 #define CH_CFG_USE_JOBS                     TRUE
 #endif
 
+/**
+ * @brief   Names index APIs.
+ * @details If enabled then the names index APIs are included in the
+ *          kernel, lookups by name in the registry and in the objects
+ *          factory become constant time.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_NAMES_INDEX)
+#define CH_CFG_USE_NAMES_INDEX              TRUE
+#endif
+
+/**
+ * @brief   Number of buckets of each names index.
+ * @note    It must be a power of two.
+ */
+#if !defined(CH_CFG_NAMES_INDEX_BUCKETS)
+#define CH_CFG_NAMES_INDEX_BUCKETS          16
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -14,10 +14,24 @@
     limitations under the License.
 */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "ch.h"
 #include "hal.h"
 #include "shell.h"
 #include "chprintf.h"
+#include "simblk.h"
+#include "blkqueue.h"
+#include "blkcache.h"
+#include "lis3dsh.h"
+#include "lsm6dsl.h"
+#include "hal_serial_nor.h"
+#include "hal_bus_queue.h"
+#include "hal_sample_stream.h"
+#include "simlis3dsh.h"
+#include "simlsm6dsl.h"
+#include "simsnor.h"
 
 #define SHELL_WA_SIZE       THD_WORKING_AREA_SIZE(4096)
 #define CONSOLE_WA_SIZE     THD_WORKING_AREA_SIZE(4096)
@@ -29,7 +43,717 @@ static thread_t *cdtp;
 static thread_t *shelltp1;
 static thread_t *shelltp2;
 
+/*
+ * Simulated disk, I/O operations have a fixed latency of 300uS plus a
+ * per-block transfer time.
+ */
+static SimBlockDevice sbd1;
+static const SimBlockConfig sbdcfg = {
+  NULL, 512, 4096, false, 300, 10, 20, NULL
+};
+
+/*
+ * Requests queue on the simulated disk.
+ */
+static QueuedBlockDevice qbd1;
+static const QueuedBlockConfig qbdcfg = {
+  (BaseBlockDevice *)&sbd1, NORMALPRIO + 20
+};
+
+#define LOGGERS_NUM         4
+#define LOGGERS_BLOCKS      200
+
+static MUTEX_DECL(sbd1mtx);
+static BaseBlockDevice *loggers_bdp;
+
+/*
+ * Logger thread, it writes its own interleaved blocks one at time, the
+ * disk is accessed directly under a mutex or through the queue.
+ */
+static THD_FUNCTION(logger_thread, arg) {
+  unsigned id = (unsigned)(size_t)arg;
+  uint8_t buf[512];
+  uint32_t i;
+
+  memset(buf, (int)id, sizeof buf);
+  for (i = 0; i < LOGGERS_BLOCKS; i++) {
+    uint32_t blk = (i * LOGGERS_NUM) + id;
+
+    if (loggers_bdp == NULL) {
+      chMtxLock(&sbd1mtx);
+      (void) blkWrite(&sbd1, blk, buf, 1);
+      chMtxUnlock(&sbd1mtx);
+    }
+    else {
+      (void) blkWrite(loggers_bdp, blk, buf, 1);
+    }
+  }
+}
+
+static unsigned run_loggers(BaseBlockDevice *bdp) {
+  thread_t *tp[LOGGERS_NUM];
+  systime_t start;
+  unsigned i;
+
+  loggers_bdp = bdp;
+  start = chVTGetSystemTime();
+  for (i = 0; i < LOGGERS_NUM; i++) {
+    tp[i] = chThdCreateFromHeap(NULL, THD_WORKING_AREA_SIZE(2048),
+                                "logger", NORMALPRIO + 1,
+                                logger_thread, (void *)(size_t)i);
+  }
+  for (i = 0; i < LOGGERS_NUM; i++) {
+    chThdWait(tp[i]);
+  }
+  return (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start));
+}
+
+static void cmd_blkq(BaseSequentialStream *chp, int argc, char *argv[]) {
+  unsigned ms;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: blkq\r\n");
+    return;
+  }
+
+  if (simblkStart(&sbd1, &sbdcfg) != HAL_RET_SUCCESS) {
+    chprintf(chp, "Disk start failed\r\n");
+    return;
+  }
+
+  /* Loggers writing directly on the disk.*/
+  (void) blkConnect(&sbd1);
+  ms = run_loggers(NULL);
+  chprintf(chp, "direct: %u ms, %u disk writes\r\n",
+           ms, (unsigned)simblkGetStatsX(&sbd1)->writes);
+  (void) blkDisconnect(&sbd1);
+
+  /* Loggers writing through the queue, adjacent blocks are merged.*/
+  simblkResetStats(&sbd1);
+  blkqStart(&qbd1, &qbdcfg);
+  (void) blkConnect(&qbd1);
+  ms = run_loggers((BaseBlockDevice *)&qbd1);
+  chprintf(chp, "queued: %u ms, %u disk writes, %u requests merged\r\n",
+           ms, (unsigned)simblkGetStatsX(&sbd1)->writes,
+           (unsigned)blkqGetStatsX(&qbd1)->merged);
+  (void) blkDisconnect(&qbd1);
+  blkqStop(&qbd1);
+
+  simblkStop(&sbd1);
+}
+
+/*
+ * Write-back cache on the simulated disk.
+ */
+static CachedBlockDevice cbd1;
+static const CachedBlockConfig cbdcfg = {
+  (BaseBlockDevice *)&sbd1
+};
+
+#define META_FILES          200
+#define META_FAT_BASE       1U
+#define META_DIR_BASE       32U
+#define META_DATA_BASE      256U
+
+/*
+ * File system like workload, each file creation updates a FAT block and
+ * a directory block then writes one data block, FAT and directory blocks
+ * are shared by many files.
+ */
+static unsigned run_metadata(BaseBlockDevice *bdp) {
+  uint8_t buf[512];
+  systime_t start;
+  uint32_t i;
+
+  (void) blkConnect(bdp);
+  start = chVTGetSystemTime();
+  for (i = 0; i < META_FILES; i++) {
+    (void) blkRead(bdp, META_FAT_BASE + (i / 128U), buf, 1);
+    buf[(i % 128U) * 4U] = (uint8_t)i;
+    (void) blkWrite(bdp, META_FAT_BASE + (i / 128U), buf, 1);
+    (void) blkRead(bdp, META_DIR_BASE + (i / 16U), buf, 1);
+    buf[(i % 16U) * 32U] = (uint8_t)i;
+    (void) blkWrite(bdp, META_DIR_BASE + (i / 16U), buf, 1);
+    memset(buf, (int)i, sizeof buf);
+    (void) blkWrite(bdp, META_DATA_BASE + i, buf, 1);
+  }
+  (void) blkSync(bdp);
+  (void) blkDisconnect(bdp);
+
+  return (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start));
+}
+
+static void cmd_blkc(BaseSequentialStream *chp, int argc, char *argv[]) {
+  blkcache_stats_t *sp;
+  unsigned ms;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: blkc\r\n");
+    return;
+  }
+
+  if (simblkStart(&sbd1, &sbdcfg) != HAL_RET_SUCCESS) {
+    chprintf(chp, "Disk start failed\r\n");
+    return;
+  }
+
+  /* Workload executed directly on the disk.*/
+  ms = run_metadata((BaseBlockDevice *)&sbd1);
+  chprintf(chp, "direct: %u ms, %u disk writes\r\n",
+           ms, (unsigned)simblkGetStatsX(&sbd1)->writes);
+
+  /* Workload executed through the cache.*/
+  simblkResetStats(&sbd1);
+  blkcacheStart(&cbd1, &cbdcfg);
+  ms = run_metadata((BaseBlockDevice *)&cbd1);
+  sp = blkcacheGetStatsX(&cbd1);
+  chprintf(chp, "cached: %u ms, %u disk writes, %u hits, %u misses\r\n",
+           ms, (unsigned)simblkGetStatsX(&sbd1)->writes,
+           (unsigned)sp->hits, (unsigned)sp->misses);
+  blkcacheStop(&cbd1);
+
+  simblkStop(&sbd1);
+}
+
+/*
+ * Simulated devices, a LIS3DSH and a serial NOR sharing SPI1, a LSM6DSL
+ * on I2C1.
+ */
+static SimLIS3DSH simlis3dsh;
+static SimLSM6DSL simlsm6dsl;
+static SimLSM6DSL simlsm6dsl2;
+static SimSerialNOR simsnor;
+static uint8_t snor_array[1024 * 1024];
+static const uint8_t snor_id[] = {0x20, 0xBA, 0x14};
+static const SimSerialNORConfig simsnorcfg = {
+  snor_array, sizeof snor_array, snor_id, sizeof snor_id,
+  300, 50000, 150000, 2000000
+};
+
+static const SPIConfig lis3dsh_spicfg = {
+  .end_cb     = NULL,
+  .cs         = 0,
+  .clock      = 10000000,
+  .latency_ns = 2000
+};
+static const SPIConfig snor_spicfg = {
+  .end_cb     = NULL,
+  .cs         = 1,
+  .clock      = 50000000,
+  .latency_ns = 2000
+};
+static const I2CConfig i2ccfg = {400000, 5000};
+
+static LIS3DSHDriver lis3dsh;
+static const LIS3DSHConfig lis3dshcfg = {
+  .spip               = &SPID1,
+  .spicfg             = &lis3dsh_spicfg,
+  .accsensitivity     = NULL,
+  .accbias            = NULL,
+  .accfullscale       = LIS3DSH_ACC_FS_2G,
+  .accoutputdatarate  = LIS3DSH_ACC_ODR_100HZ,
+#if LIS3DSH_USE_ADVANCED
+  .accantialiasing    = LIS3DSH_ACC_BW_800HZ,
+  .accblockdataupdate = LIS3DSH_ACC_BDU_CONTINUOUS
+#endif
+};
+
+static LSM6DSLDriver lsm6dsl;
+static const LSM6DSLConfig lsm6dslcfg = {
+  .i2cp               = &I2CD1,
+  .i2ccfg             = &i2ccfg,
+  .slaveaddress       = LSM6DSL_SAD_VCC,
+  .accsensitivity     = NULL,
+  .accbias            = NULL,
+  .accfullscale       = LSM6DSL_ACC_FS_2G,
+  .accoutdatarate     = LSM6DSL_ACC_ODR_104Hz,
+  .gyrosensitivity    = NULL,
+  .gyrobias           = NULL,
+  .gyrofullscale      = LSM6DSL_GYRO_FS_250DPS,
+  .gyrooutdatarate    = LSM6DSL_GYRO_ODR_104Hz
+};
+
+static SNORDriver snor;
+static const SNORConfig snorcfg = {
+  .busp               = &SPID1,
+  .buscfg             = &snor_spicfg
+};
+
+#define BUS_SAMPLES         1000
+#define BUS_READ_SIZE       4096
+
+static uint8_t snor_buf[BUS_READ_SIZE];
+
+static void cmd_bus(BaseSequentialStream *chp, int argc, char *argv[]) {
+  systime_t start;
+  int32_t raw[3];
+  unsigned i;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: bus\r\n");
+    return;
+  }
+
+  lis3dshStart(&lis3dsh, &lis3dshcfg);
+  lsm6dslStart(&lsm6dsl, &lsm6dslcfg);
+  snorStart(&snor, &snorcfg);
+
+  simSpiResetStats(&SPID1);
+  start = chVTGetSystemTime();
+  for (i = 0; i < BUS_SAMPLES; i++) {
+    (void) lis3dshAccelerometerReadRaw(&lis3dsh, raw);
+  }
+  chprintf(chp, "LIS3DSH:  %u samples in %u ms, %u transfers, "
+           "bus busy %u us\r\n",
+           BUS_SAMPLES, (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           (unsigned)simSpiGetStatsX(&SPID1)->transfers,
+           (unsigned)(simSpiGetStatsX(&SPID1)->busy_ns / 1000U));
+
+  simI2cResetStats(&I2CD1);
+  start = chVTGetSystemTime();
+  for (i = 0; i < BUS_SAMPLES; i++) {
+    (void) lsm6dslAccelerometerReadRaw(&lsm6dsl, raw);
+  }
+  chprintf(chp, "LSM6DSL:  %u samples in %u ms, %u transactions, "
+           "bus busy %u us\r\n",
+           BUS_SAMPLES, (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           (unsigned)simI2cGetStatsX(&I2CD1)->transactions,
+           (unsigned)(simI2cGetStatsX(&I2CD1)->busy_ns / 1000U));
+
+  simSpiResetStats(&SPID1);
+  start = chVTGetSystemTime();
+  for (i = 0; i < sizeof snor_array; i += BUS_READ_SIZE) {
+    (void) flashRead(&snor, i, BUS_READ_SIZE, snor_buf);
+  }
+  chprintf(chp, "SNOR:     %u bytes in %u ms, %u transfers, "
+           "bus busy %u us\r\n",
+           (unsigned)sizeof snor_array,
+           (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           (unsigned)simSpiGetStatsX(&SPID1)->transfers,
+           (unsigned)(simSpiGetStatsX(&SPID1)->busy_ns / 1000U));
+
+  snorStop(&snor);
+  lsm6dslStop(&lsm6dsl);
+  lis3dshStop(&lis3dsh);
+}
+
+/*
+ * Two accelerometers on I2C1 polled by a bus queue, both reads are
+ * executed as a single chain.
+ */
+static BusQueue busq1;
+static const BusQueueConfig busqcfg = {
+  .i2cp               = &I2CD1,
+  .i2ccfg             = &i2ccfg,
+  .spip               = NULL,
+  .spicfgs            = NULL,
+  .spitargets         = 0
+};
+static const uint8_t busq_reg = LSM6DSL_AD_OUTX_L_XL;
+static uint8_t busq_data[2][6];
+static const busq_transaction_t busq_transactions[2] = {
+  {LSM6DSL_SAD_VCC, &busq_reg, 1, busq_data[0], 6},
+  {LSM6DSL_SAD_GND, &busq_reg, 1, busq_data[1], 6}
+};
+
+/*
+ * Context switches counter, only available if the kernel statistics are
+ * enabled.
+ */
+#if CH_DBG_STATISTICS == TRUE
+#define busq_ctxswc() ((unsigned)currcore->kernel_stats.n_ctxswc)
+#endif
+
+static void cmd_busq(BaseSequentialStream *chp, int argc, char *argv[]) {
+  busq_chain_t chain;
+  systime_t start;
+  unsigned i, errors;
+#if CH_DBG_STATISTICS == TRUE
+  unsigned ctxswc;
+#endif
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: busq\r\n");
+    return;
+  }
+
+  /* Reading the two sensors one transaction at time.*/
+  i2cStart(&I2CD1, &i2ccfg);
+  errors = 0U;
+#if CH_DBG_STATISTICS == TRUE
+  ctxswc = busq_ctxswc();
+#endif
+  start = chVTGetSystemTime();
+  for (i = 0; i < BUS_SAMPLES; i++) {
+    i2cAcquireBus(&I2CD1);
+    if (i2cMasterTransmitTimeout(&I2CD1, LSM6DSL_SAD_VCC, &busq_reg, 1,
+                                 busq_data[0], 6, TIME_INFINITE) != MSG_OK) {
+      errors++;
+    }
+    if (i2cMasterTransmitTimeout(&I2CD1, LSM6DSL_SAD_GND, &busq_reg, 1,
+                                 busq_data[1], 6, TIME_INFINITE) != MSG_OK) {
+      errors++;
+    }
+    i2cReleaseBus(&I2CD1);
+  }
+  chprintf(chp, "Direct:   %u x 2 samples in %u ms, %u errors\r\n",
+           BUS_SAMPLES, (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           errors);
+#if CH_DBG_STATISTICS == TRUE
+  chprintf(chp, "          %u context switches\r\n", busq_ctxswc() - ctxswc);
+#endif
+  i2cStop(&I2CD1);
+
+  /* Reading the two sensors as a chain.*/
+  busqStart(&busq1, &busqcfg);
+  busqChainObjectInit(&chain, busq_transactions, 2, NULL);
+  errors = 0U;
+#if CH_DBG_STATISTICS == TRUE
+  ctxswc = busq_ctxswc();
+#endif
+  start = chVTGetSystemTime();
+  for (i = 0; i < BUS_SAMPLES; i++) {
+    if (busqExecute(&busq1, &chain) != MSG_OK) {
+      errors++;
+    }
+  }
+  chprintf(chp, "Queued:   %u x 2 samples in %u ms, %u errors, "
+           "%u chains, %u transactions\r\n",
+           BUS_SAMPLES, (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           errors, (unsigned)busqGetStatsX(&busq1)->chains,
+           (unsigned)busqGetStatsX(&busq1)->transactions);
+#if CH_DBG_STATISTICS == TRUE
+  chprintf(chp, "          %u context switches\r\n", busq_ctxswc() - ctxswc);
+#endif
+  busqStop(&busq1);
+  busqResetStats(&busq1);
+}
+
+/*
+ * Serial NOR access patterns, small sequential reads as performed while
+ * scanning a file system and a firmware update receiving and programming
+ * one page at time.
+ */
+#define SNOR_SCAN_SIZE      65536U
+#define SNOR_SCAN_READ      16U
+#define SNOR_UPDATE_BASE    65536U
+#define SNOR_UPDATE_SIZE    65536U
+#define SNOR_UPDATE_PAGE    256U
+
+static void cmd_snor(BaseSequentialStream *chp, int argc, char *argv[]) {
+  systime_t start;
+  flash_offset_t offset;
+  unsigned i, errors;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: snor\r\n");
+    return;
+  }
+
+  snorStart(&snor, &snorcfg);
+
+  /* File system scan.*/
+  simSpiResetStats(&SPID1);
+  errors = 0U;
+  start = chVTGetSystemTime();
+  for (offset = 0U; offset < SNOR_SCAN_SIZE; offset += SNOR_SCAN_READ) {
+    if (flashRead(&snor, offset, SNOR_SCAN_READ, snor_buf) != FLASH_NO_ERROR) {
+      errors++;
+    }
+  }
+  chprintf(chp, "Scan:     %u reads in %u ms, %u transfers, "
+           "bus busy %u us, %u errors\r\n",
+           SNOR_SCAN_SIZE / SNOR_SCAN_READ,
+           (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           (unsigned)simSpiGetStatsX(&SPID1)->transfers,
+           (unsigned)(simSpiGetStatsX(&SPID1)->busy_ns / 1000U), errors);
+#if SNOR_USE_READ_CACHE == TRUE
+  chprintf(chp, "Cache:    %u hits, %u misses, %u bypasses\r\n",
+           (unsigned)snorGetCacheStatsX(&snor)->hits,
+           (unsigned)snorGetCacheStatsX(&snor)->misses,
+           (unsigned)snorGetCacheStatsX(&snor)->bypasses);
+  snorResetCacheStats(&snor);
+#endif
+
+  /* Firmware update, receiving a page takes one millisecond.*/
+  (void) flashStartEraseSector(&snor, SNOR_UPDATE_BASE /
+                                     snor_descriptor.sectors_size);
+  (void) flashWaitErase((BaseFlash *)&snor);
+  for (i = 0U; i < SNOR_UPDATE_PAGE; i++) {
+    snor_buf[i] = (uint8_t)(i * 7U);
+  }
+  simSpiResetStats(&SPID1);
+  errors = 0U;
+  start = chVTGetSystemTime();
+  for (offset = 0U; offset < SNOR_UPDATE_SIZE; offset += SNOR_UPDATE_PAGE) {
+    chThdSleepMilliseconds(1);
+    if (flashProgram(&snor, SNOR_UPDATE_BASE + offset,
+                     SNOR_UPDATE_PAGE, snor_buf) != FLASH_NO_ERROR) {
+      errors++;
+    }
+  }
+
+  /* Completing the last program, a failure would be reported here.*/
+  if (snorSync(&snor) != FLASH_NO_ERROR) {
+    errors++;
+  }
+  chprintf(chp, "Update:   %u bytes in %u ms, %u transfers, "
+           "bus busy %u us, %u errors\r\n",
+           SNOR_UPDATE_SIZE,
+           (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           (unsigned)simSpiGetStatsX(&SPID1)->transfers,
+           (unsigned)(simSpiGetStatsX(&SPID1)->busy_ns / 1000U), errors);
+
+  /* Verifying the last page.*/
+  (void) flashRead(&snor, SNOR_UPDATE_BASE + SNOR_UPDATE_SIZE -
+                   SNOR_UPDATE_PAGE, SNOR_UPDATE_PAGE,
+                   &snor_buf[SNOR_UPDATE_PAGE]);
+  chprintf(chp, "Verify:   %s\r\n",
+           memcmp(snor_buf, &snor_buf[SNOR_UPDATE_PAGE],
+                  SNOR_UPDATE_PAGE) == 0 ? "OK" : "FAILED");
+
+  snorStop(&snor);
+}
+
+/*
+ * ADC samples streamed to the shell thread, two channels converted at
+ * 50kHz into a circular buffer, each half buffer is a 2.56ms block. An
+ * optional processing time per block can be specified for stressing the
+ * pipeline, blocks still held by the application when the converter
+ * starts refilling them are invalidated.
+ */
+#define ADCS_DURATION       TIME_MS2I(1000)
+#define ADCS_CHANNELS       2U
+#define ADCS_DEPTH          256U
+#define ADCS_BLOCK_DEPTH    (ADCS_DEPTH / 2U)
+
+static adcsample_t adcs_buffer[ADCS_DEPTH * ADCS_CHANNELS];
+static SampleStream sstr1;
+static const SampleStreamConfig sstrcfg = {
+  .buffer             = adcs_buffer,
+  .block_size         = sizeof adcs_buffer / 2U,
+  .blocks             = 2U
+};
+
+static void adcs_callback(ADCDriver *adcp) {
+
+  (void)adcp;
+
+  osalSysLockFromISR();
+  sstrPostI(&sstr1);
+  osalSysUnlockFromISR();
+}
+
+static const ADCConversionGroup adcsgrp = {
+  .circular           = true,
+  .num_channels       = ADCS_CHANNELS,
+  .end_cb             = adcs_callback,
+  .error_cb           = NULL,
+  .frequency          = 50000U,
+  .source             = NULL
+};
+
+/*
+ * Checks a block against the ramps generated by the simulated converter.
+ */
+static bool adcs_check(const sstr_block_t *bp) {
+  const adcsample_t *sp = (const adcsample_t *)bp->buffer;
+  uint64_t n = (uint64_t)bp->seq * ADCS_BLOCK_DEPTH;
+  unsigned i;
+
+  for (i = 0U; i < ADCS_BLOCK_DEPTH; i++, n++) {
+    if ((sp[i * ADCS_CHANNELS] != (adcsample_t)(n & SIM_ADC_MAX_VALUE)) ||
+        (sp[(i * ADCS_CHANNELS) + 1U] !=
+         (adcsample_t)((n * 2U) & SIM_ADC_MAX_VALUE))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void cmd_adcs(BaseSequentialStream *chp, int argc, char *argv[]) {
+  sstr_block_t blocks[2];
+  systime_t start;
+  sysinterval_t work;
+  size_t i, n, batches;
+  unsigned gaps, invalid, errors;
+  uint32_t next;
+
+  if (argc > 1) {
+    chprintf(chp, "Usage: adcs [work_ms]\r\n");
+    return;
+  }
+  work = argc > 0 ? TIME_MS2I(atoi(argv[0])) : (sysinterval_t)0;
+
+  sstrStart(&sstr1, &sstrcfg);
+  adcStart(&ADCD1, NULL);
+  adcStartConversion(&ADCD1, &adcsgrp, adcs_buffer, ADCS_DEPTH);
+
+  batches = 0U;
+  gaps = 0U;
+  invalid = 0U;
+  errors = 0U;
+  next = 0U;
+  start = chVTGetSystemTime();
+  while (chVTTimeElapsedSinceX(start) < ADCS_DURATION) {
+    n = sstrAcquireTimeout(&sstr1, blocks, 2U, TIME_MS2I(100));
+    if (n == 0U) {
+      break;
+    }
+    batches++;
+    if (work > (sysinterval_t)0) {
+      chThdSleep(work);
+    }
+    for (i = 0U; i < n; i++) {
+      if (blocks[i].seq != next) {
+        gaps++;
+      }
+      next = blocks[i].seq + 1U;
+      if (!adcs_check(&blocks[i])) {
+        errors++;
+      }
+      if (!sstrIsValidX(&sstr1, &blocks[i])) {
+        invalid++;
+      }
+    }
+    sstrRelease(&sstr1, n);
+  }
+
+  adcStopConversion(&ADCD1);
+  adcStop(&ADCD1);
+  sstrStop(&sstr1);
+
+  chprintf(chp, "Stream:   %u blocks in %u ms, %u batches, %u wakeups\r\n",
+           (unsigned)sstrGetStatsX(&sstr1)->blocks,
+           (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           (unsigned)batches, (unsigned)sstrGetStatsX(&sstr1)->wakeups);
+  chprintf(chp, "Overruns: %u, %u gaps, %u invalidated, "
+                "%u corrupted blocks\r\n",
+           (unsigned)sstrGetStatsX(&sstr1)->overruns, gaps, invalid, errors);
+  sstrResetStats(&sstr1);
+}
+
+#if (LSM6DSL_USE_FIFO == TRUE) && (LIS3DSH_USE_FIFO == TRUE)
+/*
+ * Sensors streamed through their FIFOs, the LSM6DSL runs at 833Hz and
+ * the LIS3DSH at 400Hz.
+ */
+#define IMU_DURATION        TIME_MS2I(1000)
+#define IMU_PERIOD          TIME_MS2I(20)
+
+static const LSM6DSLConfig lsm6dsl_fifocfg = {
+  .i2cp               = &I2CD1,
+  .i2ccfg             = &i2ccfg,
+  .slaveaddress       = LSM6DSL_SAD_VCC,
+  .accsensitivity     = NULL,
+  .accbias            = NULL,
+  .accfullscale       = LSM6DSL_ACC_FS_2G,
+  .accoutdatarate     = LSM6DSL_ACC_ODR_833Hz,
+  .gyrosensitivity    = NULL,
+  .gyrobias           = NULL,
+  .gyrofullscale      = LSM6DSL_GYRO_FS_250DPS,
+  .gyrooutdatarate    = LSM6DSL_GYRO_ODR_833Hz
+};
+
+static const LIS3DSHConfig lis3dsh_fifocfg = {
+  .spip               = &SPID1,
+  .spicfg             = &lis3dsh_spicfg,
+  .accsensitivity     = NULL,
+  .accbias            = NULL,
+  .accfullscale       = LIS3DSH_ACC_FS_2G,
+  .accoutputdatarate  = LIS3DSH_ACC_ODR_400HZ,
+#if LIS3DSH_USE_ADVANCED
+  .accantialiasing    = LIS3DSH_ACC_BW_800HZ,
+  .accblockdataupdate = LIS3DSH_ACC_BDU_CONTINUOUS
+#endif
+};
+
+static lsm6dsl_fifo_sample_t imu_samples[64];
+static lis3dsh_fifo_sample_t imu_acc_samples[LIS3DSH_FIFO_SIZE];
+
+static void cmd_imu(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static const int16_t acc[3] = {1000, -2000, 16384};
+  static const int16_t gyro[3] = {100, 200, -300};
+  systime_t start;
+  size_t n, n1, n2;
+  unsigned errors;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: imu\r\n");
+    return;
+  }
+
+  simlsm6dslSetAcceleration(&simlsm6dsl, acc);
+  simlsm6dslSetAngularRate(&simlsm6dsl, gyro);
+  simlis3dshSetAcceleration(&simlis3dsh, acc);
+  lsm6dslStart(&lsm6dsl, &lsm6dsl_fifocfg);
+  lis3dshStart(&lis3dsh, &lis3dsh_fifocfg);
+  (void) lsm6dslFIFOStart(&lsm6dsl, 16U);
+  (void) lis3dshFIFOStart(&lis3dsh, 8U);
+  simI2cResetStats(&I2CD1);
+  simSpiResetStats(&SPID1);
+
+  n1 = 0U;
+  n2 = 0U;
+  errors = 0U;
+  start = chVTGetSystemTime();
+  while (chVTTimeElapsedSinceX(start) < IMU_DURATION) {
+    chThdSleep(IMU_PERIOD);
+    do {
+      if (lsm6dslFIFOReadCooked(&lsm6dsl, imu_samples, 64U, &n) != MSG_OK) {
+        errors++;
+        break;
+      }
+      n1 += n;
+    } while (n == 64U);
+    if (lis3dshFIFOReadCooked(&lis3dsh, imu_acc_samples,
+                              LIS3DSH_FIFO_SIZE, &n) != MSG_OK) {
+      errors++;
+    }
+    n2 += n;
+  }
+
+  chprintf(chp, "LSM6DSL:  %u samples in %u ms, %u transactions, "
+           "bus busy %u us\r\n",
+           (unsigned)n1, (unsigned)TIME_I2MS(chVTTimeElapsedSinceX(start)),
+           (unsigned)simI2cGetStatsX(&I2CD1)->transactions,
+           (unsigned)(simI2cGetStatsX(&I2CD1)->busy_ns / 1000U));
+  chprintf(chp, "LIS3DSH:  %u samples, %u transfers, bus busy %u us\r\n",
+           (unsigned)n2, (unsigned)simSpiGetStatsX(&SPID1)->transfers,
+           (unsigned)(simSpiGetStatsX(&SPID1)->busy_ns / 1000U));
+  chprintf(chp, "Sample:   t=%u us acc=%d,%d,%d mg gyro=%d,%d,%d mdps\r\n",
+           (unsigned)imu_samples[0].timestamp,
+           (int)imu_samples[0].acc[0], (int)imu_samples[0].acc[1],
+           (int)imu_samples[0].acc[2],
+           (int)(imu_samples[0].gyro[0] * 1000.0f),
+           (int)(imu_samples[0].gyro[1] * 1000.0f),
+           (int)(imu_samples[0].gyro[2] * 1000.0f));
+  chprintf(chp, "Errors:   %u\r\n", errors);
+
+  (void) lis3dshFIFOStop(&lis3dsh);
+  (void) lsm6dslFIFOStop(&lsm6dsl);
+  lis3dshStop(&lis3dsh);
+  lsm6dslStop(&lsm6dsl);
+}
+#endif
+
 static const ShellCommand commands[] = {
+  {"blkc", cmd_blkc},
+  {"blkq", cmd_blkq},
+  {"bus", cmd_bus},
+  {"busq", cmd_busq},
+  {"snor", cmd_snor},
+  {"adcs", cmd_adcs},
+#if (LSM6DSL_USE_FIFO == TRUE) && (LIS3DSH_USE_FIFO == TRUE)
+  {"imu", cmd_imu},
+#endif
   {NULL, NULL}
 };
 
@@ -169,6 +893,32 @@ int main(void) {
   sdStart(&SD1, NULL);
   sdStart(&SD2, NULL);
 
+  /*
+   * Simulated disk and requests queue objects.
+   */
+  simblkObjectInit(&sbd1);
+  blkqObjectInit(&qbd1);
+  blkcacheObjectInit(&cbd1);
+
+  /*
+   * Simulated bus devices and their drivers.
+   */
+  simlis3dshObjectInit(&simlis3dsh);
+  simlsm6dslObjectInit(&simlsm6dsl);
+  simlsm6dslObjectInit(&simlsm6dsl2);
+  simsnorObjectInit(&simsnor, &simsnorcfg);
+  simSpiAttachDevice(&SPID1, 0, simregGetSpiDeviceX(&simlis3dsh.rm));
+  simSpiAttachDevice(&SPID1, 1, simsnorGetSpiDeviceX(&simsnor));
+  simI2cAttachDevice(&I2CD1, LSM6DSL_SAD_VCC,
+                     simregGetI2cDeviceX(&simlsm6dsl.rm));
+  simI2cAttachDevice(&I2CD1, LSM6DSL_SAD_GND,
+                     simregGetI2cDeviceX(&simlsm6dsl2.rm));
+  lis3dshObjectInit(&lis3dsh);
+  lsm6dslObjectInit(&lsm6dsl);
+  snorObjectInit(&snor);
+  busqObjectInit(&busq1);
+  sstrObjectInit(&sstr1);
+
   /*
    * Shell manager initialization.
    */
@@ -98,6 +98,9 @@ typedef void (*funcptr_t)(void);
 typedef struct {
   uint32                is_free;
   char                  name[OS_MAX_API_NAME];
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  names_node_t          node;
+#endif
   OS_TimerCallback_t    callback_ptr;
   uint32                start_time;
   uint32                interval_time;
@@ -110,6 +113,9 @@ typedef struct {
 typedef struct {
   uint32                is_free;
   char                  name[OS_MAX_API_NAME];
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  names_node_t          node;
+#endif
   semaphore_t           free_msgs;
   memory_pool_t         messages;
   mailbox_t             mb;
@@ -140,6 +146,10 @@ typedef struct {
   memory_pool_t         binary_semaphores_pool;
   memory_pool_t         count_semaphores_pool;
   memory_pool_t         mutexes_pool;
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  names_index_t         timers_names;
+  names_index_t         queues_names;
+#endif
   osal_timer_t          timers[OS_MAX_TIMERS];
   osal_queue_t          queues[OS_MAX_QUEUES];
   binary_semaphore_t    binary_semaphores[OS_MAX_BIN_SEMAPHORES];
@@ -198,6 +208,23 @@ static void timer_handler(virtual_timer_t *vtp, void *p) {
  * @brief   Finds a queue by name.
  */
 uint32 queue_find(const char *queue_name) {
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  names_node_t *np;
+  uint32 id = 0;
+
+  /* Entering a reentrant critical zone, once for the whole lookup.*/
+  syssts_t sts = chSysGetStatusAndLockX();
+
+  np = chNamesFindX(&osal.queues_names, queue_name);
+  if (np != NULL) {
+    id = (uint32)chNamesGetObject(np, osal_queue_t, node);
+  }
+
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
+
+  return id;
+#else
   osal_queue_t *oqp;
 
   /* Searching the queue in the table.*/
@@ -217,12 +244,30 @@ uint32 queue_find(const char *queue_name) {
   }
 
   return 0;
+#endif
 }
 
 /**
  * @brief   Finds a timer by name.
  */
 uint32 timer_find(const char *timer_name) {
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  names_node_t *np;
+  uint32 id = 0;
+
+  /* Entering a reentrant critical zone, once for the whole lookup.*/
+  syssts_t sts = chSysGetStatusAndLockX();
+
+  np = chNamesFindX(&osal.timers_names, timer_name);
+  if (np != NULL) {
+    id = (uint32)chNamesGetObject(np, osal_timer_t, node);
+  }
+
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
+
+  return id;
+#else
   osal_timer_t *otp;
 
   /* Searching the queue in the table.*/
@@ -242,6 +287,7 @@ uint32 timer_find(const char *timer_name) {
   }
 
   return 0;
+#endif
 }
 
 /*===========================================================================*/
@@ -290,6 +336,12 @@ int32 OS_API_Init(void) {
                   &osal.queues[0],
                   OS_MAX_QUEUES);
 
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  /* Names indexes of timers and queues.*/
+  chNamesObjectInit(&osal.timers_names, (size_t)(OS_MAX_API_NAME - 1));
+  chNamesObjectInit(&osal.queues_names, (size_t)(OS_MAX_API_NAME - 1));
+#endif
+
   /* Binary Semaphores pool initialization.*/
   chPoolObjectInit(&osal.binary_semaphores_pool,
                    sizeof (binary_semaphore_t),
@@ -489,7 +541,14 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
   otp->start_time    = 0;
   otp->interval_time = 0;
   otp->callback_ptr  = callback_ptr;
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  chSysLock();
+  chNamesInsertX(&osal.timers_names, &otp->node, otp->name);
+  otp->is_free       = 0;   /* Note, last.*/
+  chSysUnlock();
+#else
   otp->is_free       = 0;   /* Note, last.*/
+#endif
 
   *timer_id = (uint32)otp;
   *clock_accuracy = (uint32)(1000000 / CH_CFG_ST_FREQUENCY);
@@ -519,6 +578,9 @@ int32 OS_TimerDelete(uint32 timer_id) {
 
   /* Marking as no more free, will be overwritten by the pool pointer.*/
   otp->is_free = 1;
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  chNamesRemoveX(&osal.timers_names, &otp->node);
+#endif
 
   /* Resetting the timer.*/
   chVTResetI(&otp->vt);
@@ -731,7 +793,14 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
   chPoolLoadArray(&oqp->messages, oqp->mb_buffer, (size_t)queue_depth);
   oqp->depth   = queue_depth;
   oqp->size    = data_size;
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  chSysLock();
+  chNamesInsertX(&osal.queues_names, &oqp->node, oqp->name);
   oqp->is_free = 0;   /* Note, last.*/
+  chSysUnlock();
+#else
+  oqp->is_free = 0;   /* Note, last.*/
+#endif
   *queue_id = (uint32)oqp;
 
   return OS_SUCCESS;
@@ -761,6 +830,9 @@ int32 OS_QueueDelete(uint32 queue_id) {
 
   /* Marking as no more free, will be overwritten by the pool pointer.*/
   oqp->is_free = 1;
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  chNamesRemoveX(&osal.queues_names, &oqp->node);
+#endif
 
   /* Pointers to areas to be freed.*/
   q_buffer  = oqp->q_buffer;
@@ -33,6 +33,12 @@
 
 #include "ch.h"
 
+#if PORT_CORES_NUMBER > 1
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
 /*===========================================================================*/
 /* Module local definitions.                                                 */
 /*===========================================================================*/
@@ -54,21 +60,96 @@
 /* Module exported variables.                                                */
 /*===========================================================================*/
 
-bool port_isr_context_flag;
-syssts_t port_irq_sts;
+PORT_CORE_LOCAL bool port_isr_context_flag;
+PORT_CORE_LOCAL syssts_t port_irq_sts;
+
+#if (PORT_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Identifier of the core running on the current host thread.
+ */
+PORT_CORE_LOCAL core_id_t port_core_id;
+
+/**
+ * @brief   Kernel spinlock.
+ */
+volatile bool port_spinlock;
+
+/**
+ * @brief   Simulated cores statistics.
+ */
+port_core_stats_t port_core_stats[PORT_CORES_NUMBER];
+#endif
 
 /*===========================================================================*/
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (PORT_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Simulated core state.
+ */
+typedef struct {
+  /**
+   * @brief   Mutex protecting the notifications.
+   */
+  pthread_mutex_t       mtx;
+  /**
+   * @brief   Condition signaled on notifications.
+   */
+  pthread_cond_t        cond;
+  /**
+   * @brief   Pending inter-core interrupt.
+   */
+  volatile bool         ipi;
+  /**
+   * @brief   Next system tick time, cores other than zero.
+   */
+  struct timeval        nextcnt;
+  /**
+   * @brief   Core entry function.
+   */
+  void                  (*entry)(void);
+} sim_core_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (PORT_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Simulated cores.
+ */
+static sim_core_t sim_cores[PORT_CORES_NUMBER];
+
+/**
+ * @brief   System tick period.
+ */
+static const struct timeval sim_tick = {0, 1000000 / CH_CFG_ST_FREQUENCY};
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (PORT_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Host thread of a simulated core.
+ *
+ * @param[in] arg       pointer to the @p sim_core_t structure
+ * @return              Never returns.
+ */
+static void *sim_core_thread(void *arg) {
+  sim_core_t *cp = (sim_core_t *)arg;
+
+  port_core_id = (core_id_t)(cp - sim_cores);
+  port_irq_sts = (syssts_t)1;
+  cp->entry();
+
+  return NULL;
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -141,4 +222,144 @@ rtcnt_t port_rt_get_counter_value(void) {
 #endif
 }
 
+#if (PORT_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a simulated core.
+ * @details A host thread is created for the core, the entry function runs
+ *          on it with interrupts disabled and is expected to wait for the
+ *          system initialization, initialize its own OS instance using
+ *          @p chInstanceObjectInit() and then invoke @p chSysUnlock().
+ *
+ * @param[in] core_id   identifier of the core to be started
+ * @param[in] entry     core entry function
+ */
+void port_start_core(core_id_t core_id, void (*entry)(void)) {
+  pthread_attr_t attr;
+  pthread_t thread;
+
+  chDbgCheck((core_id > 0U) && (core_id < (core_id_t)PORT_CORES_NUMBER) &&
+             (entry != NULL));
+
+  sim_cores[core_id].entry = entry;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  if (pthread_create(&thread, &attr, sim_core_thread,
+                     (void *)&sim_cores[core_id]) != 0) {
+    chSysHalt("core start failure");
+  }
+  pthread_attr_destroy(&attr);
+}
+
+/**
+ * @brief   Core-specific part of the port initialization.
+ * @details The instance initialization is performed within the kernel
+ *          lock, it is released by the @p chSysUnlock() following the
+ *          initialization.
+ *
+ * @param[in] oip       pointer to the OS instance
+ */
+void __port_core_init(os_instance_t *oip) {
+  sim_core_t *cp = &sim_cores[oip->core_id];
+
+  pthread_mutex_init(&cp->mtx, NULL);
+  pthread_cond_init(&cp->cond, NULL);
+  cp->ipi = false;
+  gettimeofday(&cp->nextcnt, NULL);
+  timeradd(&cp->nextcnt, &sim_tick, &cp->nextcnt);
+
+  port_isr_context_flag = false;
+  port_lock();
+}
+
+/**
+ * @brief   Sends a simulated inter-core interrupt to an OS instance.
+ *
+ * @param[in] oip       pointer to the instance to be notified
+ */
+void __port_notify_instance(os_instance_t *oip) {
+  sim_core_t *cp = &sim_cores[oip->core_id];
+
+  pthread_mutex_lock(&cp->mtx);
+  cp->ipi = true;
+  pthread_cond_signal(&cp->cond);
+  pthread_mutex_unlock(&cp->mtx);
+}
+
+/**
+ * @brief   Waits for the kernel spinlock to be released by another core.
+ * @details The host CPU is yielded, the core owning the spinlock could be
+ *          waiting for it.
+ */
+void __port_spinlock_wait(void) {
+
+  port_core_stats[port_core_id].spins++;
+  (void) sched_yield();
+}
+
+/**
+ * @brief   Interrupts simulation for multiple cores.
+ * @details Core zero serves the HAL simulated peripherals and its system
+ *          tick by polling, the other cores only have a system tick and
+ *          sleep until the next tick or an inter-core interrupt.
+ */
+void __port_wait_for_interrupt(void) {
+  core_id_t core_id = port_core_id;
+  sim_core_t *cp = &sim_cores[core_id];
+  bool int_occurred = false;
+
+  if (core_id == 0U) {
+    _sim_check_for_interrupts();
+    (void) sched_yield();
+  }
+  else {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    if (timercmp(&tv, &cp->nextcnt, <)) {
+      struct timespec ts;
+
+      ts.tv_sec  = cp->nextcnt.tv_sec;
+      ts.tv_nsec = cp->nextcnt.tv_usec * 1000;
+      pthread_mutex_lock(&cp->mtx);
+      while (!cp->ipi) {
+        if (pthread_cond_timedwait(&cp->cond, &cp->mtx, &ts) != 0) {
+          break;
+        }
+      }
+      pthread_mutex_unlock(&cp->mtx);
+      gettimeofday(&tv, NULL);
+    }
+
+    if (timercmp(&tv, &cp->nextcnt, >=)) {
+      int_occurred = true;
+      timeradd(&cp->nextcnt, &sim_tick, &cp->nextcnt);
+
+      CH_IRQ_PROLOGUE();
+
+      chSysLockFromISR();
+      chSysTimerHandlerI();
+      chSysUnlockFromISR();
+
+      CH_IRQ_EPILOGUE();
+    }
+  }
+
+  if (cp->ipi) {
+    pthread_mutex_lock(&cp->mtx);
+    cp->ipi = false;
+    pthread_mutex_unlock(&cp->mtx);
+    port_core_stats[core_id].ipis++;
+    int_occurred = true;
+  }
+
+  if (int_occurred) {
+    chSysLock();
+    if (chSchIsPreemptionRequired()) {
+      chSchDoPreemption();
+    }
+    chSysUnlock();
+  }
+}
+#endif /* PORT_CORES_NUMBER > 1 */
+
 /** @} */
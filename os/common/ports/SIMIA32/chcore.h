@@ -113,6 +113,35 @@
 #define PORT_INT_REQUIRED_STACK         16384
 #endif
 
+/**
+ * @brief   Number of simulated cores.
+ * @details Each core runs its own OS instance on a dedicated host thread,
+ *          core zero is the host main thread and the other cores are
+ *          started using @p port_start_core().
+ * @note    Multiple cores require @p CH_CFG_SMP_MODE and a Posix host.
+ */
+#if !defined(PORT_CORES_NUMBER) || defined(__DOXYGEN__)
+#define PORT_CORES_NUMBER               1
+#endif
+
+/**
+ * @brief   Enables support for system calls.
+ * @details On the simulator system calls are not trapped, the privileged
+ *          side receives the call parameters into a @p port_extctx
+ *          structure marshalled by the caller.
+ */
+#if !defined(PORT_USE_SYSCALL) || defined(__DOXYGEN__)
+#define PORT_USE_SYSCALL                FALSE
+#endif
+
+/**
+ * @brief   Number of MPU regions to be saved/restored during context switch.
+ * @note    The simulator has no MPU, zero is the only allowed value.
+ */
+#if !defined(PORT_SWITCHED_REGIONS_NUMBER) || defined(__DOXYGEN__)
+#define PORT_SWITCHED_REGIONS_NUMBER    0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -121,6 +150,30 @@
 #error "option CH_DBG_ENABLE_STACK_CHECK not supported by this port"
 #endif
 
+#if PORT_CORES_NUMBER > 1
+#if defined(WIN32)
+#error "multiple cores not supported on Windows hosts"
+#endif
+#if !defined(CH_CFG_SMP_MODE) || (CH_CFG_SMP_MODE == FALSE)
+#error "multiple cores require CH_CFG_SMP_MODE"
+#endif
+#endif
+
+/**
+ * @brief   Core-local variables qualifier.
+ * @details Each simulated core runs on its own host thread, the variables
+ *          representing the core state are host thread-local.
+ */
+#if (PORT_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+#define PORT_CORE_LOCAL                 __thread
+#else
+#define PORT_CORE_LOCAL
+#endif
+
+#if PORT_SWITCHED_REGIONS_NUMBER != 0
+#error "PORT_SWITCHED_REGIONS_NUMBER not supported by this port"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -129,6 +182,22 @@
    asm module.*/
 #if !defined(_FROM_ASM_)
 
+#if (PORT_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Simulated core statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Served inter-core notifications.
+   */
+  uint32_t      ipis;
+  /**
+   * @brief   Waits on the kernel spinlock taken by another core.
+   */
+  uint32_t      spins;
+} port_core_stats_t;
+#endif
+
 /**
  * @brief   16 bytes stack and memory alignment enforcement.
  */
@@ -147,6 +216,12 @@ typedef void *regx86;
  *          preemption-capable interrupt handler.
  */
 struct port_extctx {
+#if (PORT_USE_SYSCALL == TRUE) || defined(__DOXYGEN__)
+  uint32_t      r0;
+  uint32_t      r1;
+  uint32_t      r2;
+  uint32_t      r3;
+#endif
 };
 
 /**
@@ -169,6 +244,11 @@ struct port_intctx {
  */
 struct port_context {
   struct port_intctx *sp;
+#if (PORT_USE_SYSCALL == TRUE) || defined(__DOXYGEN__)
+  struct {
+    const void          *p;
+  } syscall;
+#endif
 };
 
 #endif /* !defined(_FROM_ASM_) */
@@ -182,6 +262,14 @@ struct port_context {
   *(void **)(void *)(p) = (void*)(a);                                       \
 } while (false)
 
+/* By default threads have no syscall context information.*/
+#if (PORT_USE_SYSCALL == TRUE) || defined(__DOXYGEN__)
+  #define __PORT_SETUP_CONTEXT_SYSCALL(tp)                                  \
+    (tp)->ctx.syscall.p = NULL;
+#else
+  #define __PORT_SETUP_CONTEXT_SYSCALL(tp)
+#endif
+
 /* Darwin requires the stack to be aligned to a 16-byte boundary at
  * the time of a call instruction (in case the called function needs
  * to save MMX registers). This aligns to 'mod' module 16, so that we'll end
@@ -210,6 +298,7 @@ struct port_context {
   ((struct port_intctx *)(void *)esp)->esi = NULL;                          \
   ((struct port_intctx *)(void *)esp)->ebp = (void *)savebp;                \
   (tp)->ctx.sp = (struct port_intctx *)(void *)esp;                         \
+  __PORT_SETUP_CONTEXT_SYSCALL(tp);                                         \
   /*lint -restore*/                                                         \
 }
 
@@ -291,8 +380,13 @@ struct port_context {
    asm module.*/
 #if !defined(_FROM_ASM_)
 
-extern bool port_isr_context_flag;
-extern syssts_t port_irq_sts;
+extern PORT_CORE_LOCAL bool port_isr_context_flag;
+extern PORT_CORE_LOCAL syssts_t port_irq_sts;
+#if PORT_CORES_NUMBER > 1
+extern PORT_CORE_LOCAL core_id_t port_core_id;
+extern volatile bool port_spinlock;
+extern port_core_stats_t port_core_stats[PORT_CORES_NUMBER];
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -304,6 +398,13 @@ extern "C" {
   /*lint -restore*/
   rtcnt_t port_rt_get_counter_value(void);
   void _sim_check_for_interrupts(void);
+#if PORT_CORES_NUMBER > 1
+  void port_start_core(core_id_t core_id, void (*entry)(void));
+  void __port_core_init(os_instance_t *oip);
+  void __port_notify_instance(os_instance_t *oip);
+  void __port_spinlock_wait(void);
+  void __port_wait_for_interrupt(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -323,12 +424,58 @@ extern "C" {
  */
 static inline void port_init(os_instance_t *oip) {
 
+#if PORT_CORES_NUMBER > 1
+  __port_core_init(oip);
+#else
   (void)oip;
 
   port_irq_sts = (syssts_t)0;
   port_isr_context_flag = false;
+#endif
+}
+
+#if (PORT_CORES_NUMBER > 1) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the current core identifier.
+ *
+ * @return              The core identifier from 0 to @p PORT_CORES_NUMBER - 1.
+ */
+static inline core_id_t port_get_core_id(void) {
+
+  return port_core_id;
 }
 
+/**
+ * @brief   Notifies an OS instance to check for reschedule.
+ * @details The notification is a simulated inter-core interrupt, it is
+ *          served by the target core when idle.
+ *
+ * @param[in] oip       pointer to the instance to be notified
+ */
+static inline void port_notify_instance(os_instance_t *oip) {
+
+  __port_notify_instance(oip);
+}
+
+/**
+ * @brief   Takes the kernel spinlock.
+ */
+static inline void port_spinlock_take(void) {
+
+  while (__atomic_test_and_set(&port_spinlock, __ATOMIC_ACQUIRE)) {
+    __port_spinlock_wait();
+  }
+}
+
+/**
+ * @brief   Releases the kernel spinlock.
+ */
+static inline void port_spinlock_release(void) {
+
+  __atomic_clear(&port_spinlock, __ATOMIC_RELEASE);
+}
+#endif /* PORT_CORES_NUMBER > 1 */
+
 /**
  * @brief   Returns a word encoding the current interrupts status.
  *
@@ -367,19 +514,27 @@ static inline bool port_is_isr_context(void) {
 
 /**
  * @brief   Kernel-lock action.
- * @details In this port this function disables interrupts globally.
+ * @details In this port this function disables interrupts globally, with
+ *          multiple cores the kernel spinlock is also taken.
  */
 static inline void port_lock(void) {
 
   port_irq_sts = (syssts_t)1;
+#if PORT_CORES_NUMBER > 1
+  port_spinlock_take();
+#endif
 }
 
 /**
  * @brief   Kernel-unlock action.
- * @details In this port this function enables interrupts globally.
+ * @details In this port this function enables interrupts globally, with
+ *          multiple cores the kernel spinlock is also released.
  */
 static inline void port_unlock(void) {
 
+#if PORT_CORES_NUMBER > 1
+  port_spinlock_release();
+#endif
   port_irq_sts = (syssts_t)0;
 }
 
@@ -390,7 +545,7 @@ static inline void port_unlock(void) {
  */
 static inline void port_lock_from_isr(void) {
 
-  port_irq_sts = (syssts_t)1;
+  port_lock();
 }
 
 /**
@@ -400,7 +555,7 @@ static inline void port_lock_from_isr(void) {
  */
 static inline void port_unlock_from_isr(void) {
 
-  port_irq_sts = (syssts_t)0;
+  port_unlock();
 }
 
 /**
@@ -437,7 +592,11 @@ static inline void port_enable(void) {
  */
 static inline void port_wait_for_interrupt(void) {
 
+#if PORT_CORES_NUMBER > 1
+  __port_wait_for_interrupt();
+#else
   _sim_check_for_interrupts();
+#endif
 }
 
 #endif /* !defined(_FROM_ASM_) */
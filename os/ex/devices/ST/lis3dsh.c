@@ -42,6 +42,16 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (LIS3DSH_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Samples periods in nanoseconds indexed by the ODR field.
+ */
+static const uint32_t lis3dsh_fifo_periods[] = {
+  0U, 320000000U, 160000000U, 80000000U, 40000000U, 20000000U, 10000000U,
+  2500000U, 1250000U, 625000U
+};
+#endif /* LIS3DSH_USE_FIFO */
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -88,6 +98,94 @@ static void lis3dshSPIWriteRegister(SPIDriver *spip, uint8_t reg, size_t n,
 }
 #endif /* LIS3DSH_USE_SPI */
 
+#if (LIS3DSH_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Gains the bus ownership if the bus is shared.
+ *
+ * @param[in] devp      pointer to the @p LIS3DSHDriver object
+ */
+static void lis3dsh_bus_acquire(LIS3DSHDriver *devp) {
+
+#if LIS3DSH_SHARED_SPI
+  spiAcquireBus(devp->config->spip);
+  spiStart(devp->config->spip, devp->config->spicfg);
+#else
+  (void)devp;
+#endif /* LIS3DSH_SHARED_SPI */
+}
+
+/**
+ * @brief   Releases the bus ownership if the bus is shared.
+ *
+ * @param[in] devp      pointer to the @p LIS3DSHDriver object
+ */
+static void lis3dsh_bus_release(LIS3DSHDriver *devp) {
+
+#if LIS3DSH_SHARED_SPI
+  spiReleaseBus(devp->config->spip);
+#else
+  (void)devp;
+#endif /* LIS3DSH_SHARED_SPI */
+}
+
+/**
+ * @brief   Reads the number of samples in the FIFO.
+ * @pre     The bus must be owned.
+ *
+ * @param[in] devp      pointer to the @p LIS3DSHDriver object
+ * @param[out] np       number of samples in the FIFO
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if the FIFO overrun.
+ */
+static msg_t lis3dsh_fifo_level(LIS3DSHDriver *devp, size_t *np) {
+  uint8_t src;
+
+  lis3dshSPIReadRegister(devp->config->spip, LIS3DSH_AD_FIFO_SRC, 1, &src);
+  if ((src & LIS3DSH_FIFO_SRC_OVRN) != 0U) {
+    return MSG_RESET;
+  }
+  *np = (size_t)(src & LIS3DSH_FIFO_SRC_FSS_MASK);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Converts raw FIFO samples in cooked samples.
+ * @note    Sensitivities and biases are copied locally, the compiler
+ *          could not otherwise assume that the output does not alias
+ *          them and vectorize the loop.
+ *
+ * @param[in] devp      pointer to the @p LIS3DSHDriver object
+ * @param[out] sp       pointer to the output samples
+ * @param[in] n         number of samples in the burst buffer
+ */
+static void lis3dsh_fifo_cook(LIS3DSHDriver *devp, lis3dsh_fifo_sample_t *sp,
+                              size_t n) {
+  float sens[LIS3DSH_ACC_NUMBER_OF_AXES];
+  float bias[LIS3DSH_ACC_NUMBER_OF_AXES];
+  const uint8_t *p = devp->fifobuf;
+  uint64_t t = (uint64_t)devp->fifocnt * devp->fifoperiod;
+  size_t i, j;
+
+  for (j = 0U; j < LIS3DSH_ACC_NUMBER_OF_AXES; j++) {
+    sens[j] = devp->accsensitivity[j];
+    bias[j] = devp->accbias[j];
+  }
+
+  for (i = 0U; i < n; i++) {
+    sp[i].timestamp = (uint32_t)(t / 1000U);
+    for (j = 0U; j < LIS3DSH_ACC_NUMBER_OF_AXES; j++) {
+      int16_t raw = (int16_t)(p[2U * j] | (p[(2U * j) + 1U] << 8));
+      sp[i].acc[j] = ((float)raw * sens[j]) - bias[j];
+    }
+    p += LIS3DSH_ACC_NUMBER_OF_AXES * 2U;
+    t += devp->fifoperiod;
+  }
+  devp->fifocnt += (uint32_t)n;
+}
+#endif /* LIS3DSH_USE_FIFO */
+
 /**
  * @brief   Return the number of axes of the BaseAccelerometer.
  *
@@ -453,6 +551,10 @@ void lis3dshObjectInit(LIS3DSHDriver *devp) {
 
   devp->accaxes = LIS3DSH_ACC_NUMBER_OF_AXES;
 
+#if LIS3DSH_USE_FIFO
+  devp->fifoactive = false;
+#endif
+
   devp->state = LIS3DSH_STOP;
 }
 
@@ -636,6 +738,174 @@ void lis3dshStop(LIS3DSHDriver *devp) {
 #endif /* LIS3DSH_SHARED_SPI */    		
 #endif /* LIS3DSH_USE_SPI */
   }	
+#if LIS3DSH_USE_FIFO
+  devp->fifoactive = false;
+#endif
   devp->state = LIS3DSH_STOP;
 }
+
+#if (LIS3DSH_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the FIFO streaming.
+ * @details The FIFO is emptied and set in stream mode.
+ * @note    The FIFO watermark flag is set when the FIFO contains at least
+ *          @p watermark samples, the application can route it to an
+ *          interrupt pin or poll the FIFO at the matching rate.
+ *
+ * @param[in] devp      pointer to the @p LIS3DSHDriver object
+ * @param[in] watermark FIFO watermark in samples
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ *
+ * @api
+ */
+msg_t lis3dshFIFOStart(LIS3DSHDriver *devp, size_t watermark) {
+  uint32_t odr;
+  uint8_t cr;
+
+  osalDbgCheck((devp != NULL) && (watermark > 0U) &&
+               (watermark <= LIS3DSH_FIFO_CTRL_WTP_MASK));
+
+  osalDbgAssert((devp->state == LIS3DSH_READY),
+                "lis3dshFIFOStart(), invalid state");
+
+  odr = (uint32_t)devp->config->accoutputdatarate >> 4;
+  osalDbgAssert((odr > 0U) &&
+                (odr < sizeof lis3dsh_fifo_periods /
+                       sizeof lis3dsh_fifo_periods[0]),
+                "lis3dshFIFOStart(), unsupported data rate");
+
+  lis3dsh_bus_acquire(devp);
+
+  /* Enabling the FIFO and the watermark.*/
+  lis3dshSPIReadRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG6, 1, &cr);
+  cr |= LIS3DSH_CTRL_REG6_FIFO_EN | LIS3DSH_CTRL_REG6_WTM_EN;
+  lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG6, 1, &cr);
+
+  /* Bypass mode first, the FIFO content is discarded.*/
+  cr = LIS3DSH_FIFO_CTRL_FMODE_BYPASS;
+  lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_FIFO_CTRL, 1, &cr);
+  cr = LIS3DSH_FIFO_CTRL_FMODE_STREAM | (uint8_t)watermark;
+  lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_FIFO_CTRL, 1, &cr);
+
+  lis3dsh_bus_release(devp);
+
+  devp->fifoactive = true;
+  devp->fifoperiod = lis3dsh_fifo_periods[odr];
+  devp->fifocnt    = 0U;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Stops the FIFO streaming.
+ * @details The FIFO is set in bypass mode and disabled.
+ *
+ * @param[in] devp      pointer to the @p LIS3DSHDriver object
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ *
+ * @api
+ */
+msg_t lis3dshFIFOStop(LIS3DSHDriver *devp) {
+  uint8_t cr;
+
+  osalDbgCheck(devp != NULL);
+
+  osalDbgAssert((devp->state == LIS3DSH_READY) && devp->fifoactive,
+                "lis3dshFIFOStop(), invalid state");
+
+  lis3dsh_bus_acquire(devp);
+
+  cr = LIS3DSH_FIFO_CTRL_FMODE_BYPASS;
+  lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_FIFO_CTRL, 1, &cr);
+  lis3dshSPIReadRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG6, 1, &cr);
+  cr &= ~(LIS3DSH_CTRL_REG6_FIFO_EN | LIS3DSH_CTRL_REG6_WTM_EN);
+  lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG6, 1, &cr);
+
+  lis3dsh_bus_release(devp);
+
+  devp->fifoactive = false;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Returns the number of samples in the FIFO.
+ *
+ * @param[in] devp      pointer to the @p LIS3DSHDriver object
+ * @param[out] np       number of samples ready to be read
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if the FIFO overrun, samples may have been lost and
+ *                      the streaming must be restarted.
+ *
+ * @api
+ */
+msg_t lis3dshFIFOGetLevel(LIS3DSHDriver *devp, size_t *np) {
+  msg_t msg;
+
+  osalDbgCheck((devp != NULL) && (np != NULL));
+
+  osalDbgAssert((devp->state == LIS3DSH_READY) && devp->fifoactive,
+                "lis3dshFIFOGetLevel(), invalid state");
+
+  *np = 0U;
+  lis3dsh_bus_acquire(devp);
+  msg = lis3dsh_fifo_level(devp, np);
+  lis3dsh_bus_release(devp);
+
+  return msg;
+}
+
+/**
+ * @brief   Reads cooked samples from the FIFO.
+ * @details Up to @p n samples are read, the content of the FIFO is
+ *          transferred in a single burst.
+ * @note    The cooked data is computed as in the single sample functions.
+ *
+ * @param[in] devp      pointer to the @p LIS3DSHDriver object
+ * @param[out] sp       pointer to an array of @p n samples
+ * @param[in] n         maximum number of samples to be read
+ * @param[out] np       number of samples actually read
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if the FIFO overrun, samples may have been lost and
+ *                      the streaming must be restarted.
+ *
+ * @api
+ */
+msg_t lis3dshFIFOReadCooked(LIS3DSHDriver *devp, lis3dsh_fifo_sample_t *sp,
+                            size_t n, size_t *np) {
+  size_t level;
+  msg_t msg;
+
+  osalDbgCheck((devp != NULL) && (sp != NULL) && (np != NULL));
+
+  osalDbgAssert((devp->state == LIS3DSH_READY) && devp->fifoactive,
+                "lis3dshFIFOReadCooked(), invalid state");
+
+  *np   = 0U;
+  level = 0U;
+  lis3dsh_bus_acquire(devp);
+  msg = lis3dsh_fifo_level(devp, &level);
+  if (n > level) {
+    n = level;
+  }
+  if ((msg == MSG_OK) && (n > 0U)) {
+    /* The output registers address rolls back to OUT_X_L while the FIFO
+       is enabled, the samples are read in a single burst.*/
+    lis3dshSPIReadRegister(devp->config->spip, LIS3DSH_AD_OUT_X_L,
+                           n * LIS3DSH_ACC_NUMBER_OF_AXES * 2U, devp->fifobuf);
+  }
+  lis3dsh_bus_release(devp);
+
+  if ((msg == MSG_OK) && (n > 0U)) {
+    lis3dsh_fifo_cook(devp, sp, n);
+    *np = n;
+  }
+
+  return msg;
+}
+#endif /* LIS3DSH_USE_FIFO */
 /** @} */
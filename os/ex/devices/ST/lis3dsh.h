@@ -43,7 +43,7 @@
 /**
  * @brief   LIS3DSH driver version string.
  */
-#define EX_LIS3DSH_VERSION                  "1.1.2"
+#define EX_LIS3DSH_VERSION                  "1.2.0"
 
 /**
  * @brief   LIS3DSH driver version major number.
@@ -53,12 +53,12 @@
 /**
  * @brief   LIS3DSH driver version minor number.
  */
-#define EX_LIS3DSH_MINOR                    1
+#define EX_LIS3DSH_MINOR                    2
 
 /**
  * @brief   LIS3DSH driver version patch number.
  */
-#define EX_LIS3DSH_PATCH                    2
+#define EX_LIS3DSH_PATCH                    0
 /** @} */
 
 /**
@@ -286,6 +286,34 @@
 #define LIS3DSH_CTRL_REG6_BOOT              (1 << 7)
 /** @} */
 
+/**
+ * @name    LIS3DSH_FIFO_CTRL register bits definitions
+ * @{
+ */
+#define LIS3DSH_FIFO_CTRL_MASK              0xFF
+#define LIS3DSH_FIFO_CTRL_WTP_MASK          0x1F
+#define LIS3DSH_FIFO_CTRL_FMODE_MASK        0xE0
+#define LIS3DSH_FIFO_CTRL_FMODE_BYPASS      (0 << 5)
+#define LIS3DSH_FIFO_CTRL_FMODE_FIFO        (1 << 5)
+#define LIS3DSH_FIFO_CTRL_FMODE_STREAM      (2 << 5)
+/** @} */
+
+/**
+ * @name    LIS3DSH_FIFO_SRC register bits definitions
+ * @{
+ */
+#define LIS3DSH_FIFO_SRC_MASK               0xFF
+#define LIS3DSH_FIFO_SRC_FSS_MASK           0x1F
+#define LIS3DSH_FIFO_SRC_EMPTY              (1 << 5)
+#define LIS3DSH_FIFO_SRC_OVRN               (1 << 6)
+#define LIS3DSH_FIFO_SRC_WTM                (1 << 7)
+/** @} */
+
+/**
+ * @brief   LIS3DSH FIFO size in samples.
+ */
+#define LIS3DSH_FIFO_SIZE                   32U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -340,6 +368,15 @@
 #if !defined(LIS3DSH_USE_ADVANCED) || defined(__DOXYGEN__)
 #define LIS3DSH_USE_ADVANCED                FALSE
 #endif
+
+/**
+ * @brief   LIS3DSH FIFO streaming switch.
+ * @details If set to @p TRUE the FIFO streaming API is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LIS3DSH_USE_FIFO) || defined(__DOXYGEN__)
+#define LIS3DSH_USE_FIFO                    FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -431,6 +468,22 @@ typedef enum {
   LIS3DSH_ACC_BDU_BLOCKED = 0x80    /**< Block data updated after reading.  */
 } lis3dsh_acc_bdu_t;
 
+/**
+ * @brief   LIS3DSH FIFO sample.
+ */
+typedef struct {
+  /**
+   * @brief   Sample time in microseconds.
+   * @details Sensor time computed from the output data rate, it starts
+   *          from zero at @p lis3dshFIFOStart() and wraps around.
+   */
+  uint32_t                  timestamp;
+  /**
+   * @brief   Cooked accelerometer data in milli-G.
+   */
+  float                     acc[LIS3DSH_ACC_NUMBER_OF_AXES];
+} lis3dsh_fifo_sample_t;
+
 /**
  * @brief   Driver state machine possible states.
  */
@@ -533,7 +586,26 @@ struct LIS3DSHVMT {
   /* Accelerometer subsystem current bias .*/                               \
   float                     accbias[LIS3DSH_ACC_NUMBER_OF_AXES];            \
   /* Accelerometer subsystem current full scale value.*/                    \
-  float                     accfullscale;
+  float                     accfullscale;                                   \
+  _lis3dsh_fifo_data
+
+#if (LIS3DSH_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   @p LIS3DSHDriver FIFO streaming data.
+ */
+#define _lis3dsh_fifo_data                                                  \
+  /* FIFO streaming active.*/                                               \
+  bool                      fifoactive;                                     \
+  /* Samples period in nanoseconds.*/                                       \
+  uint32_t                  fifoperiod;                                     \
+  /* Samples read since the stream start.*/                                 \
+  uint32_t                  fifocnt;                                        \
+  /* Burst read buffer.*/                                                   \
+  uint8_t                   fifobuf[LIS3DSH_FIFO_SIZE *                     \
+                                    LIS3DSH_ACC_NUMBER_OF_AXES * 2U];
+#else
+#define _lis3dsh_fifo_data
+#endif /* LIS3DSH_USE_FIFO */
 
 /**
  * @brief   LIS3DSH 3-axis accelerometer class.
@@ -698,6 +770,13 @@ extern "C" {
   void lis3dshObjectInit(LIS3DSHDriver *devp);
   void lis3dshStart(LIS3DSHDriver *devp, const LIS3DSHConfig *config);
   void lis3dshStop(LIS3DSHDriver *devp);
+#if LIS3DSH_USE_FIFO
+  msg_t lis3dshFIFOStart(LIS3DSHDriver *devp, size_t watermark);
+  msg_t lis3dshFIFOStop(LIS3DSHDriver *devp);
+  msg_t lis3dshFIFOGetLevel(LIS3DSHDriver *devp, size_t *np);
+  msg_t lis3dshFIFOReadCooked(LIS3DSHDriver *devp, lis3dsh_fifo_sample_t *sp,
+                              size_t n, size_t *np);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,16 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Samples periods in nanoseconds indexed by the ODR field.
+ */
+static const uint32_t lsm6dsl_fifo_periods[] = {
+  0U, 80000000U, 38461538U, 19230769U, 9615385U, 4807692U, 2403846U,
+  1200480U, 602410U, 300300U, 150150U
+};
+#endif /* LSM6DSL_USE_FIFO */
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -85,6 +95,136 @@ msg_t lsm6dslI2CReadRegister(I2CDriver *i2cp, lsm6dsl_sad_t sad, uint8_t reg,
                                   TIME_INFINITE)
 #endif /* LSM6DSL_USE_I2C */
 
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Gains the bus ownership if the bus is shared.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ */
+static void lsm6dsl_bus_acquire(LSM6DSLDriver *devp) {
+
+#if LSM6DSL_SHARED_I2C
+  i2cAcquireBus(devp->config->i2cp);
+  i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+#else
+  (void)devp;
+#endif /* LSM6DSL_SHARED_I2C */
+}
+
+/**
+ * @brief   Releases the bus ownership if the bus is shared.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ */
+static void lsm6dsl_bus_release(LSM6DSLDriver *devp) {
+
+#if LSM6DSL_SHARED_I2C
+  i2cReleaseBus(devp->config->i2cp);
+#else
+  (void)devp;
+#endif /* LSM6DSL_SHARED_I2C */
+}
+
+/**
+ * @brief   Reads the number of complete samples in the FIFO.
+ * @details If the FIFO read pointer is not at the start of a sample the
+ *          remaining words of the partial sample are discarded, the
+ *          discarded sample is accounted in the samples counter so the
+ *          time stamps of the following samples are not shifted.
+ * @pre     The bus must be owned.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[out] np       number of samples in the FIFO
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if an I2C error occurred or the FIFO overrun.
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ */
+static msg_t lsm6dsl_fifo_level(LSM6DSLDriver *devp, size_t *np) {
+  uint8_t sts[4];
+  size_t words, partial;
+  msg_t msg;
+
+  msg = lsm6dslI2CReadRegister(devp->config->i2cp, devp->config->slaveaddress,
+                               LSM6DSL_AD_FIFO_STATUS1, sts, 4);
+  if (msg != MSG_OK) {
+    return msg;
+  }
+  if ((sts[1] & LSMDSL_FIFO_STATUS2_OVER_RUN) != 0U) {
+    return MSG_RESET;
+  }
+
+  words   = (size_t)sts[0] |
+            ((size_t)(sts[1] & LSMDSL_FIFO_STATUS2_DIFF_MASK) << 8);
+  partial = ((size_t)sts[2] | ((size_t)(sts[3] & 0x03U) << 8)) %
+            LSM6DSL_FIFO_SAMPLE_WORDS;
+  if ((partial > 0U) && (words > 0U)) {
+    bool complete = true;
+
+    partial = LSM6DSL_FIFO_SAMPLE_WORDS - partial;
+    if (partial > words) {
+      /* The rest of the sample is discarded on the next call.*/
+      partial  = words;
+      complete = false;
+    }
+    msg = lsm6dslI2CReadRegister(devp->config->i2cp,
+                                 devp->config->slaveaddress,
+                                 LSM6DSL_AD_FIFO_DATA_OUT_L, devp->fifobuf,
+                                 partial * 2U);
+    if ((msg == MSG_OK) && complete) {
+      devp->fifocnt++;
+    }
+    words -= partial;
+  }
+  *np = words / LSM6DSL_FIFO_SAMPLE_WORDS;
+
+  return msg;
+}
+
+/**
+ * @brief   Converts raw FIFO samples in cooked samples.
+ * @note    Sensitivities and biases are copied locally, the compiler
+ *          could not otherwise assume that the output does not alias
+ *          them and vectorize the loop.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[out] sp       pointer to the output samples
+ * @param[in] n         number of samples in the burst buffer
+ */
+static void lsm6dsl_fifo_cook(LSM6DSLDriver *devp, lsm6dsl_fifo_sample_t *sp,
+                              size_t n) {
+  float accsens[LSM6DSL_ACC_NUMBER_OF_AXES];
+  float accbias[LSM6DSL_ACC_NUMBER_OF_AXES];
+  float gyrosens[LSM6DSL_GYRO_NUMBER_OF_AXES];
+  float gyrobias[LSM6DSL_GYRO_NUMBER_OF_AXES];
+  const uint8_t *p = devp->fifobuf;
+  uint64_t t = (uint64_t)devp->fifocnt * devp->fifoperiod;
+  size_t i, j;
+
+  for (j = 0U; j < LSM6DSL_ACC_NUMBER_OF_AXES; j++) {
+    accsens[j]  = devp->accsensitivity[j];
+    accbias[j]  = devp->accbias[j];
+    gyrosens[j] = devp->gyrosensitivity[j];
+    gyrobias[j] = devp->gyrobias[j];
+  }
+
+  for (i = 0U; i < n; i++) {
+    sp[i].timestamp = (uint32_t)(t / 1000U);
+    for (j = 0U; j < LSM6DSL_GYRO_NUMBER_OF_AXES; j++) {
+      int16_t raw = (int16_t)(p[2U * j] | (p[(2U * j) + 1U] << 8));
+      sp[i].gyro[j] = ((float)raw * gyrosens[j]) - gyrobias[j];
+    }
+    for (j = 0U; j < LSM6DSL_ACC_NUMBER_OF_AXES; j++) {
+      int16_t raw = (int16_t)(p[6U + (2U * j)] | (p[7U + (2U * j)] << 8));
+      sp[i].acc[j] = ((float)raw * accsens[j]) - accbias[j];
+    }
+    p += LSM6DSL_FIFO_SAMPLE_WORDS * 2U;
+    t += devp->fifoperiod;
+  }
+  devp->fifocnt += (uint32_t)n;
+}
+#endif /* LSM6DSL_USE_FIFO */
+
 /**
  * @brief   Return the number of axes of the BaseAccelerometer.
  *
@@ -839,6 +979,10 @@ void lsm6dslObjectInit(LSM6DSLDriver *devp) {
   devp->accaxes = LSM6DSL_ACC_NUMBER_OF_AXES;
   devp->gyroaxes = LSM6DSL_GYRO_NUMBER_OF_AXES;
 
+#if LSM6DSL_USE_FIFO
+  devp->fifoactive = false;
+#endif
+
   devp->state = LSM6DSL_STOP;
 }
 
@@ -1085,7 +1229,7 @@ void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config) {
  * @api
  */
 void lsm6dslStop(LSM6DSLDriver *devp) {
-  uint8_t cr[2];
+  uint8_t cr[3];
 
   osalDbgCheck(devp != NULL);
 
@@ -1114,6 +1258,201 @@ void lsm6dslStop(LSM6DSLDriver *devp) {
 #endif /* LSM6DSL_SHARED_I2C */
 #endif /* LSM6DSL_USE_I2C */
   }
+#if LSM6DSL_USE_FIFO
+  devp->fifoactive = false;
+#endif
   devp->state = LSM6DSL_STOP;
 }
+
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the FIFO streaming.
+ * @details The FIFO is emptied and set in continuous mode, each sample
+ *          contains both the gyroscope and the accelerometer axes.
+ * @pre     Accelerometer and gyroscope must be configured with the same
+ *          output data rate.
+ * @note    The FIFO watermark flag is set when the FIFO contains at least
+ *          @p watermark samples, the application can route it to an
+ *          interrupt pin or poll the FIFO at the matching rate.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[in] watermark FIFO watermark in samples
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+msg_t lsm6dslFIFOStart(LSM6DSLDriver *devp, size_t watermark) {
+  uint32_t odr, fth;
+  uint8_t cr[6];
+  msg_t msg;
+
+  osalDbgCheck((devp != NULL) && (watermark > 0U) &&
+               (watermark <= LSM6DSL_FIFO_MAX_SAMPLES));
+
+  osalDbgAssert((devp->state == LSM6DSL_READY),
+                "lsm6dslFIFOStart(), invalid state");
+  osalDbgAssert(((uint32_t)devp->config->accoutdatarate ==
+                 (uint32_t)devp->config->gyrooutdatarate),
+                "lsm6dslFIFOStart(), different data rates");
+
+  odr = (uint32_t)devp->config->accoutdatarate >> 4;
+  osalDbgAssert((odr > 0U) &&
+                (odr < sizeof lsm6dsl_fifo_periods /
+                       sizeof lsm6dsl_fifo_periods[0]),
+                "lsm6dslFIFOStart(), unsupported data rate");
+  fth = (uint32_t)watermark * LSM6DSL_FIFO_SAMPLE_WORDS;
+
+  lsm6dsl_bus_acquire(devp);
+
+  /* Bypass mode first, the FIFO content is discarded.*/
+  cr[0] = LSM6DSL_AD_FIFO_CTRL5;
+  cr[1] = LSMDSL_FIFO_CTRL5_MODE_BYPASS;
+  msg = lsm6dslI2CWriteRegister(devp->config->i2cp,
+                                devp->config->slaveaddress, cr, 1);
+  if (msg == MSG_OK) {
+    cr[0] = LSM6DSL_AD_FIFO_CTRL1;
+    cr[1] = (uint8_t)fth;
+    cr[2] = (uint8_t)(fth >> 8) & LSMDSL_FIFO_CTRL2_FTH_MASK;
+    cr[3] = LSMDSL_FIFO_CTRL3_DEC_XL_NONE | LSMDSL_FIFO_CTRL3_DEC_G_NONE;
+    cr[4] = 0;
+    cr[5] = (uint8_t)(odr << 3) | LSMDSL_FIFO_CTRL5_MODE_CONTINUOUS;
+    msg = lsm6dslI2CWriteRegister(devp->config->i2cp,
+                                  devp->config->slaveaddress, cr, 5);
+  }
+
+  lsm6dsl_bus_release(devp);
+
+  if (msg == MSG_OK) {
+    devp->fifoactive = true;
+    devp->fifoperiod = lsm6dsl_fifo_periods[odr];
+    devp->fifocnt    = 0U;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Stops the FIFO streaming.
+ * @details The FIFO is set in bypass mode.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+msg_t lsm6dslFIFOStop(LSM6DSLDriver *devp) {
+  uint8_t cr[2];
+  msg_t msg;
+
+  osalDbgCheck(devp != NULL);
+
+  osalDbgAssert((devp->state == LSM6DSL_READY) && devp->fifoactive,
+                "lsm6dslFIFOStop(), invalid state");
+
+  cr[0] = LSM6DSL_AD_FIFO_CTRL5;
+  cr[1] = LSMDSL_FIFO_CTRL5_MODE_BYPASS;
+
+  lsm6dsl_bus_acquire(devp);
+  msg = lsm6dslI2CWriteRegister(devp->config->i2cp,
+                                devp->config->slaveaddress, cr, 1);
+  lsm6dsl_bus_release(devp);
+
+  devp->fifoactive = false;
+
+  return msg;
+}
+
+/**
+ * @brief   Returns the number of samples in the FIFO.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[out] np       number of samples ready to be read
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred or the FIFO
+ *                      overrun, in the latter case samples have been lost
+ *                      and the streaming must be restarted.
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+msg_t lsm6dslFIFOGetLevel(LSM6DSLDriver *devp, size_t *np) {
+  msg_t msg;
+
+  osalDbgCheck((devp != NULL) && (np != NULL));
+
+  osalDbgAssert((devp->state == LSM6DSL_READY) && devp->fifoactive,
+                "lsm6dslFIFOGetLevel(), invalid state");
+
+  *np = 0U;
+  lsm6dsl_bus_acquire(devp);
+  msg = lsm6dsl_fifo_level(devp, np);
+  lsm6dsl_bus_release(devp);
+
+  return msg;
+}
+
+/**
+ * @brief   Reads cooked samples from the FIFO.
+ * @details Up to @p n samples are read, the samples are transferred in
+ *          bursts of up to @p LSM6DSL_FIFO_BURST_SIZE samples.
+ * @note    The cooked data is computed as in the single sample functions,
+ *          the FIFO data is assumed to be little endian.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[out] sp       pointer to an array of @p n samples
+ * @param[in] n         maximum number of samples to be read
+ * @param[out] np       number of samples actually read
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred or the FIFO
+ *                      overrun, in the latter case samples have been lost
+ *                      and the streaming must be restarted.
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+msg_t lsm6dslFIFOReadCooked(LSM6DSLDriver *devp, lsm6dsl_fifo_sample_t *sp,
+                            size_t n, size_t *np) {
+  size_t level, cnt;
+  msg_t msg;
+
+  osalDbgCheck((devp != NULL) && (sp != NULL) && (np != NULL));
+
+  osalDbgAssert((devp->state == LSM6DSL_READY) && devp->fifoactive,
+                "lsm6dslFIFOReadCooked(), invalid state");
+
+  *np   = 0U;
+  level = 0U;
+  lsm6dsl_bus_acquire(devp);
+  msg = lsm6dsl_fifo_level(devp, &level);
+  if (n > level) {
+    n = level;
+  }
+  while ((msg == MSG_OK) && (n > 0U)) {
+    cnt = n > LSM6DSL_FIFO_BURST_SIZE ? LSM6DSL_FIFO_BURST_SIZE : n;
+    msg = lsm6dslI2CReadRegister(devp->config->i2cp,
+                                 devp->config->slaveaddress,
+                                 LSM6DSL_AD_FIFO_DATA_OUT_L, devp->fifobuf,
+                                 cnt * LSM6DSL_FIFO_SAMPLE_WORDS * 2U);
+    if (msg == MSG_OK) {
+      lsm6dsl_fifo_cook(devp, sp, cnt);
+      sp  += cnt;
+      n   -= cnt;
+      *np += cnt;
+    }
+  }
+  lsm6dsl_bus_release(devp);
+
+  return msg;
+}
+#endif /* LSM6DSL_USE_FIFO */
 /** @} */
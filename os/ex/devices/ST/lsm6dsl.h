@@ -43,7 +43,7 @@
 /**
  * @brief   LSM6DSL driver version string.
  */
-#define EX_LSM6DSL_VERSION                  "1.0.1"
+#define EX_LSM6DSL_VERSION                  "1.1.0"
 
 /**
  * @brief   LSM6DSL driver version major number.
@@ -53,12 +53,12 @@
 /**
  * @brief   LSM6DSL driver version minor number.
  */
-#define EX_LSM6DSL_MINOR                    0
+#define EX_LSM6DSL_MINOR                    1
 
 /**
  * @brief   LSM6DSL driver version patch number.
  */
-#define EX_LSM6DSL_PATCH                    1
+#define EX_LSM6DSL_PATCH                    0
 /** @} */
 
 /**
@@ -352,6 +352,66 @@
 #define LSMDSL_CTRL10_C_WRIST_TILT          (1 << 7)
 /** @} */
 
+/**
+ * @name    LSM6DSL_AD_FIFO_CTRL2 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_CTRL2_FTH_MASK          0x07
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_CTRL3 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_CTRL3_DEC_XL_MASK       0x07
+#define LSMDSL_FIFO_CTRL3_DEC_XL_NONE       (1 << 0)
+#define LSMDSL_FIFO_CTRL3_DEC_G_MASK        0x38
+#define LSMDSL_FIFO_CTRL3_DEC_G_NONE        (1 << 3)
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_CTRL5 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_CTRL5_MODE_MASK         0x07
+#define LSMDSL_FIFO_CTRL5_MODE_BYPASS       0x00
+#define LSMDSL_FIFO_CTRL5_MODE_FIFO         0x01
+#define LSMDSL_FIFO_CTRL5_MODE_CONTINUOUS   0x06
+#define LSMDSL_FIFO_CTRL5_ODR_MASK          0x78
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_STATUS2 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_STATUS2_DIFF_MASK       0x07
+#define LSMDSL_FIFO_STATUS2_EMPTY           (1 << 4)
+#define LSMDSL_FIFO_STATUS2_FULL_SMART      (1 << 5)
+#define LSMDSL_FIFO_STATUS2_OVER_RUN        (1 << 6)
+#define LSMDSL_FIFO_STATUS2_WATERM          (1 << 7)
+/** @} */
+
+/**
+ * @name    LSM6DSL FIFO characteristics
+ * @{
+ */
+/**
+ * @brief   FIFO size in 16 bits words.
+ */
+#define LSM6DSL_FIFO_WORDS                  2048U
+
+/**
+ * @brief   Words of a FIFO sample, gyroscope then accelerometer axes.
+ */
+#define LSM6DSL_FIFO_SAMPLE_WORDS           6U
+
+/**
+ * @brief   Maximum number of samples stored in the FIFO.
+ */
+#define LSM6DSL_FIFO_MAX_SAMPLES            (LSM6DSL_FIFO_WORDS /           \
+                                             LSM6DSL_FIFO_SAMPLE_WORDS)
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -423,6 +483,24 @@
 #if !defined(LSM6DSL_GYRO_BIAS_SETTLING_US) || defined(__DOXYGEN__)
 #define LSM6DSL_GYRO_BIAS_SETTLING_US       5000
 #endif
+
+/**
+ * @brief   LSM6DSL FIFO streaming switch.
+ * @details If set to @p TRUE the FIFO streaming API is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+#define LSM6DSL_USE_FIFO                    FALSE
+#endif
+
+/**
+ * @brief   Maximum number of FIFO samples read in a single transaction.
+ * @details The driver structure contains a buffer of 12 bytes for each
+ *          sample.
+ */
+#if !defined(LSM6DSL_FIFO_BURST_SIZE) || defined(__DOXYGEN__)
+#define LSM6DSL_FIFO_BURST_SIZE             32
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -449,6 +527,11 @@
 #error "LSM6DSL_SHARED_I2C requires I2C_USE_MUTUAL_EXCLUSION"
 #endif
 
+#if (LSM6DSL_FIFO_BURST_SIZE < 1) ||                                        \
+    (LSM6DSL_FIFO_BURST_SIZE > LSM6DSL_FIFO_MAX_SAMPLES)
+#error "invalid LSM6DSL_FIFO_BURST_SIZE value"
+#endif
+
 /*
  * CHTODO: Add support for LSM6DSL over SPI.
  */
@@ -576,6 +659,26 @@ typedef enum {
   LSM6DSL_END_BIG = 0x20            /**< Big endian.                        */
 } lsm6dsl_end_t;
 
+/**
+ * @brief   LSM6DSL FIFO sample.
+ */
+typedef struct {
+  /**
+   * @brief   Sample time in microseconds.
+   * @details Sensor time computed from the output data rate, it starts
+   *          from zero at @p lsm6dslFIFOStart() and wraps around.
+   */
+  uint32_t                  timestamp;
+  /**
+   * @brief   Cooked accelerometer data in milli-G.
+   */
+  float                     acc[LSM6DSL_ACC_NUMBER_OF_AXES];
+  /**
+   * @brief   Cooked gyroscope data in DPS.
+   */
+  float                     gyro[LSM6DSL_GYRO_NUMBER_OF_AXES];
+} lsm6dsl_fifo_sample_t;
+
 /**
  * @brief   Driver state machine possible states.
  */
@@ -722,7 +825,26 @@ struct LSM6DSLVMT {
   /* Gyroscope subsystem current Bias.*/                                    \
   float                     gyrobias[LSM6DSL_GYRO_NUMBER_OF_AXES];          \
   /* Gyroscope subsystem current full scale value.*/                        \
-  float                     gyrofullscale;
+  float                     gyrofullscale;                                  \
+  _lsm6dsl_fifo_data
+
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   @p LSM6DSLDriver FIFO streaming data.
+ */
+#define _lsm6dsl_fifo_data                                                  \
+  /* FIFO streaming active.*/                                               \
+  bool                      fifoactive;                                     \
+  /* Samples period in nanoseconds.*/                                       \
+  uint32_t                  fifoperiod;                                     \
+  /* Samples read since the stream start.*/                                 \
+  uint32_t                  fifocnt;                                        \
+  /* Burst read buffer.*/                                                   \
+  uint8_t                   fifobuf[LSM6DSL_FIFO_BURST_SIZE *               \
+                                    LSM6DSL_FIFO_SAMPLE_WORDS * 2U];
+#else
+#define _lsm6dsl_fifo_data
+#endif /* LSM6DSL_USE_FIFO */
 
 /**
  * @brief LSM6DSL 6-axis accelerometer/gyroscope class.
@@ -1046,6 +1168,13 @@ extern "C" {
   void lsm6dslObjectInit(LSM6DSLDriver *devp);
   void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config);
   void lsm6dslStop(LSM6DSLDriver *devp);
+#if LSM6DSL_USE_FIFO
+  msg_t lsm6dslFIFOStart(LSM6DSLDriver *devp, size_t watermark);
+  msg_t lsm6dslFIFOStop(LSM6DSLDriver *devp);
+  msg_t lsm6dslFIFOGetLevel(LSM6DSLDriver *devp, size_t *np);
+  msg_t lsm6dslFIFOReadCooked(LSM6DSLDriver *devp, lsm6dsl_fifo_sample_t *sp,
+                              size_t n, size_t *np);
+#endif
 #ifdef __cplusplus
 }
 #endif
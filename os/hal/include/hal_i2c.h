@@ -82,8 +82,29 @@ typedef enum {
   I2C_LOCKED = 5                            /**< @brief Bus locked.         */
 } i2cstate_t;
 
+/**
+ * @brief   I2C notification callback type.
+ * @note    Only used by low level drivers supporting asynchronous
+ *          transactions.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object triggering the
+ *                      callback
+ */
+struct hal_i2c_driver;
+typedef void (*i2ccallback_t)(struct hal_i2c_driver *i2cp);
+
 #include "hal_i2c_lld.h"
 
+/**
+ * @brief   Asynchronous transactions support.
+ * @details Low level drivers able to start a transaction without waiting
+ *          for its completion define this capability as @p TRUE and
+ *          provide an @p end_cb field in the driver structure.
+ */
+#if !defined(I2C_SUPPORTS_ASYNC) || defined(__DOXYGEN__)
+#define I2C_SUPPORTS_ASYNC                  FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -114,6 +135,25 @@ typedef enum {
   osalSysUnlockFromISR();                                                   \
 } while (0)
 
+/**
+ * @brief   Common ISR code for asynchronous transactions.
+ * @details This code handles the portable part of the ISR code:
+ *          - Driver state transitions.
+ *          - Callback invocation.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only.
+ * @note    The callback is allowed to start another transaction.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define _i2c_isr_code(i2cp) do {                                            \
+  (i2cp)->state = I2C_READY;                                                \
+  (i2cp)->end_cb(i2cp);                                                     \
+} while (0)
+
 /**
  * @brief   Wrap i2cMasterTransmitTimeout function with TIME_INFINITE timeout.
  * @api
@@ -150,6 +190,13 @@ extern "C" {
                                 i2caddr_t addr,
                                 uint8_t *rxbuf, size_t rxbytes,
                                 sysinterval_t timeout);
+#if I2C_SUPPORTS_ASYNC == TRUE
+  void i2cStartMasterTransmitI(I2CDriver *i2cp,
+                               i2caddr_t addr,
+                               const uint8_t *txbuf, size_t txbytes,
+                               uint8_t *rxbuf, size_t rxbytes,
+                               i2ccallback_t end_cb);
+#endif
 #if I2C_USE_MUTUAL_EXCLUSION == TRUE
   void i2cAcquireBus(I2CDriver *i2cp);
   void i2cReleaseBus(I2CDriver *i2cp);
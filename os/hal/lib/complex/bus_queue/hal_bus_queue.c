@@ -0,0 +1,419 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_bus_queue.c
+ * @brief   Bus transactions queue code.
+ *
+ * @addtogroup HAL_BUS_QUEUE
+ * @{
+ */
+
+#include "hal.h"
+#include "hal_bus_queue.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   List of the started queues.
+ * @details Used for finding the queue associated to a bus from within the
+ *          bus drivers callbacks.
+ */
+static BusQueue *busq_started;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Finds the started queue associated to a bus driver.
+ *
+ * @param[in] busp      pointer to the bus driver
+ * @return              The queue.
+ */
+static BusQueue *busq_find(const void *busp) {
+  BusQueue *bqp = busq_started;
+
+  while (bqp != NULL) {
+#if BUSQ_USE_I2C == TRUE
+    if ((const void *)bqp->config->i2cp == busp) {
+      break;
+    }
+#endif
+#if BUSQ_USE_SPI == TRUE
+    if ((const void *)bqp->config->spip == busp) {
+      break;
+    }
+#endif
+    bqp = bqp->next;
+  }
+
+  osalDbgAssert(bqp != NULL, "bus not associated to a queue");
+
+  return bqp;
+}
+
+#if (BUSQ_USE_I2C == TRUE) || defined(__DOXYGEN__)
+static void busq_i2c_callback(I2CDriver *i2cp);
+#endif
+
+/**
+ * @brief   Starts the current transaction of the head chain.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ */
+static void busq_start_transaction(BusQueue *bqp) {
+  const busq_transaction_t *btp = &bqp->head->transactions[bqp->current];
+
+#if BUSQ_USE_I2C == TRUE
+  if (bqp->config->i2cp != NULL) {
+    i2cStartMasterTransmitI(bqp->config->i2cp, (i2caddr_t)btp->target,
+                            btp->txbuf, btp->txbytes,
+                            btp->rxbuf, btp->rxbytes,
+                            busq_i2c_callback);
+    return;
+  }
+#endif
+
+#if BUSQ_USE_SPI == TRUE
+  {
+    SPIDriver *spip = bqp->config->spip;
+
+    osalDbgAssert(btp->target < bqp->config->spitargets, "invalid target");
+
+    /* Switching the slave select setting, the configurations only differ
+       in this.*/
+    spip->config = bqp->config->spicfgs[btp->target];
+    spiSelectI(spip);
+    if (btp->txbytes > 0U) {
+      bqp->rxphase = false;
+      spiStartSendI(spip, btp->txbytes, btp->txbuf);
+    }
+    else {
+      bqp->rxphase = true;
+      spiStartReceiveI(spip, btp->rxbytes, btp->rxbuf);
+    }
+  }
+#endif
+}
+
+/**
+ * @brief   Handles the end of the current transaction.
+ * @details The next transaction of the chain is started, on chain
+ *          completion the waiting thread is resumed and the next chain
+ *          is started.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ * @param[in] msg       transaction result
+ * @return              The completed chain or @p NULL.
+ */
+static busq_chain_t *busq_transaction_done(BusQueue *bqp, msg_t msg) {
+  busq_chain_t *bcp = bqp->head;
+
+  bqp->stats.transactions++;
+  if (msg != MSG_OK) {
+    bqp->stats.errors++;
+  }
+
+  /* Next transaction in the chain, unless the chain failed.*/
+  bqp->current++;
+  if ((msg == MSG_OK) && (bqp->current < bcp->n)) {
+    busq_start_transaction(bqp);
+    return NULL;
+  }
+
+  /* Chain completed, removing it from the queue.*/
+  bqp->head    = bcp->next;
+  bqp->current = 0U;
+  if (bqp->head == NULL) {
+    bqp->tail = NULL;
+  }
+  bqp->stats.chains++;
+  bcp->result = msg;
+  osalThreadResumeI(&bcp->thread, msg);
+
+  /* The bus is kept busy with the next chain, if any.*/
+  if (bqp->head != NULL) {
+    busq_start_transaction(bqp);
+  }
+
+  return bcp;
+}
+
+#if (BUSQ_USE_I2C == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   I2C transaction end callback.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ */
+static void busq_i2c_callback(I2CDriver *i2cp) {
+  BusQueue *bqp;
+  busq_chain_t *bcp;
+
+  osalSysLockFromISR();
+  bqp = busq_find(i2cp);
+  bcp = busq_transaction_done(bqp, i2cGetErrors(i2cp) == I2C_NO_ERROR ?
+                                   MSG_OK : MSG_RESET);
+  osalSysUnlockFromISR();
+
+  if ((bcp != NULL) && (bcp->cb != NULL)) {
+    bcp->cb(bqp, bcp);
+  }
+}
+#endif
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] bqp      pointer to the @p BusQueue object
+ *
+ * @init
+ */
+void busqObjectInit(BusQueue *bqp) {
+
+  osalDbgCheck(bqp != NULL);
+
+  bqp->state   = BUSQ_STOP;
+  bqp->config  = NULL;
+  bqp->next    = NULL;
+  bqp->head    = NULL;
+  bqp->tail    = NULL;
+  bqp->current = 0U;
+  busqResetStats(bqp);
+}
+
+/**
+ * @brief   Configures and activates a queue.
+ * @details The associated bus driver is started.
+ * @note    The bus is reserved to the queue until the queue is stopped,
+ *          other users of the bus must not access it meanwhile.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ * @param[in] config    pointer to the configuration
+ * @return              The operation status.
+ *
+ * @api
+ */
+msg_t busqStart(BusQueue *bqp, const BusQueueConfig *config) {
+  msg_t msg = HAL_RET_SUCCESS;
+
+  osalDbgCheck((bqp != NULL) && (config != NULL));
+  osalDbgAssert(bqp->state == BUSQ_STOP, "invalid state");
+
+#if BUSQ_USE_I2C == TRUE
+  if (config->i2cp != NULL) {
+    msg = i2cStart(config->i2cp, config->i2ccfg);
+  }
+#endif
+#if BUSQ_USE_SPI == TRUE
+  if (config->spip != NULL) {
+    osalDbgCheck((config->spicfgs != NULL) && (config->spitargets > 0U));
+
+    msg = spiStart(config->spip, config->spicfgs[0]);
+  }
+#endif
+
+  if (msg == HAL_RET_SUCCESS) {
+    osalSysLock();
+    bqp->config  = config;
+    bqp->next    = busq_started;
+    busq_started = bqp;
+    bqp->state   = BUSQ_READY;
+    osalSysUnlock();
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Deactivates a queue.
+ * @details The associated bus driver is stopped.
+ * @pre     The queue must be empty.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ *
+ * @api
+ */
+void busqStop(BusQueue *bqp) {
+  BusQueue **pp;
+
+  osalDbgCheck(bqp != NULL);
+  osalDbgAssert(bqp->state == BUSQ_READY, "invalid state");
+
+  osalSysLock();
+  osalDbgAssert(bqp->head == NULL, "queue not empty");
+  pp = &busq_started;
+  while (*pp != bqp) {
+    pp = &(*pp)->next;
+  }
+  *pp = bqp->next;
+  bqp->state = BUSQ_STOP;
+  osalSysUnlock();
+
+#if BUSQ_USE_I2C == TRUE
+  if (bqp->config->i2cp != NULL) {
+    i2cStop(bqp->config->i2cp);
+  }
+#endif
+#if BUSQ_USE_SPI == TRUE
+  if (bqp->config->spip != NULL) {
+    spiStop(bqp->config->spip);
+  }
+#endif
+
+  bqp->config = NULL;
+}
+
+/**
+ * @brief   Submits a transactions chain.
+ * @details The chain is appended to the queue, if the queue is idle the
+ *          first transaction is started immediately.
+ * @note    The chain callback, if any, is invoked from ISR context after
+ *          the chain completion, it can submit chains using this
+ *          function from within a system lock zone.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ * @param[in] bcp       pointer to the @p busq_chain_t object
+ *
+ * @iclass
+ */
+void busqSubmitI(BusQueue *bqp, busq_chain_t *bcp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((bqp != NULL) && (bcp != NULL) && (bcp->n > 0U));
+  osalDbgAssert(bqp->state == BUSQ_READY, "not ready");
+
+  bcp->next = NULL;
+  if (bqp->tail == NULL) {
+    bqp->head    = bcp;
+    bqp->tail    = bcp;
+    bqp->current = 0U;
+    busq_start_transaction(bqp);
+  }
+  else {
+    bqp->tail->next = bcp;
+    bqp->tail       = bcp;
+  }
+}
+
+/**
+ * @brief   Submits a transactions chain.
+ * @details The function returns immediately, the chain completion is
+ *          notified by the chain callback.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ * @param[in] bcp       pointer to the @p busq_chain_t object
+ *
+ * @api
+ */
+void busqSubmit(BusQueue *bqp, busq_chain_t *bcp) {
+
+  osalSysLock();
+  busqSubmitI(bqp, bcp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Executes a transactions chain.
+ * @details The chain is submitted and the calling thread waits for its
+ *          completion, the thread is woken once for the whole chain.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ * @param[in] bcp       pointer to the @p busq_chain_t object
+ * @return              The chain result.
+ * @retval MSG_OK       if all transactions succeeded.
+ * @retval MSG_RESET    if a transaction failed, the following transactions
+ *                      have not been executed.
+ *
+ * @api
+ */
+msg_t busqExecute(BusQueue *bqp, busq_chain_t *bcp) {
+  msg_t msg;
+
+  osalSysLock();
+  busqSubmitI(bqp, bcp);
+  msg = osalThreadSuspendS(&bcp->thread);
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Resets the queue statistics.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ *
+ * @api
+ */
+void busqResetStats(BusQueue *bqp) {
+
+  bqp->stats.chains       = 0U;
+  bqp->stats.transactions = 0U;
+  bqp->stats.errors       = 0U;
+}
+
+#if (BUSQ_USE_SPI == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   SPI end callback.
+ * @details This function must be specified as end callback in the SPI
+ *          configurations used by queues.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @special
+ */
+void busqSpiCallback(SPIDriver *spip) {
+  const busq_transaction_t *btp;
+  BusQueue *bqp;
+  busq_chain_t *bcp;
+
+  osalSysLockFromISR();
+  bqp = busq_find(spip);
+  btp = &bqp->head->transactions[bqp->current];
+
+  /* Receive phase after the transmit phase, if any.*/
+  if (!bqp->rxphase && (btp->rxbytes > 0U)) {
+    bqp->rxphase = true;
+    spiStartReceiveI(spip, btp->rxbytes, btp->rxbuf);
+    osalSysUnlockFromISR();
+    return;
+  }
+
+  spiUnselectI(spip);
+  bcp = busq_transaction_done(bqp, MSG_OK);
+  osalSysUnlockFromISR();
+
+  if ((bcp != NULL) && (bcp->cb != NULL)) {
+    bcp->cb(bqp, bcp);
+  }
+}
+#endif
+
+/** @} */
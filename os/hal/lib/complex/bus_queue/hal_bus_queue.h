@@ -0,0 +1,315 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_bus_queue.h
+ * @brief   Bus transactions queue header.
+ *
+ * @addtogroup HAL_BUS_QUEUE
+ * @{
+ */
+
+#ifndef HAL_BUS_QUEUE_H
+#define HAL_BUS_QUEUE_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   I2C buses support.
+ * @note    Requires a low level driver supporting asynchronous
+ *          transactions.
+ */
+#if ((HAL_USE_I2C == TRUE) && (I2C_SUPPORTS_ASYNC == TRUE)) ||              \
+    defined(__DOXYGEN__)
+#define BUSQ_USE_I2C                        TRUE
+#else
+#define BUSQ_USE_I2C                        FALSE
+#endif
+
+/**
+ * @brief   SPI buses support.
+ * @note    Requires the SPI driver version 1.
+ */
+#if ((HAL_USE_SPI == TRUE) && !defined(HAL_LLD_SELECT_SPI_V2)) ||           \
+    defined(__DOXYGEN__)
+#define BUSQ_USE_SPI                        TRUE
+#else
+#define BUSQ_USE_SPI                        FALSE
+#endif
+
+#if (BUSQ_USE_I2C == FALSE) && (BUSQ_USE_SPI == FALSE)
+#error "bus queue requires an asynchronous I2C or SPI driver"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  BUSQ_UNINIT = 0,                  /**< Not initialized.                   */
+  BUSQ_STOP = 1,                    /**< Stopped.                           */
+  BUSQ_READY = 2                    /**< Ready.                             */
+} busqstate_t;
+
+/**
+ * @brief   Type of a bus transactions queue.
+ */
+typedef struct hal_bus_queue BusQueue;
+
+/**
+ * @brief   Type of a transactions chain.
+ */
+typedef struct busq_chain busq_chain_t;
+
+/**
+ * @brief   Chain completion callback type.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ * @param[in] bcp       pointer to the completed chain
+ */
+typedef void (*busqcallback_t)(BusQueue *bqp, busq_chain_t *bcp);
+
+/**
+ * @brief   Type of a bus transaction descriptor.
+ * @details A transaction is a transmit phase followed by a receive phase,
+ *          one of the two phases can be empty. On I2C the phases are
+ *          separated by a repeated start, on SPI the target is kept
+ *          selected for the whole transaction.
+ */
+typedef struct {
+  /**
+   * @brief   Transaction target.
+   * @details The slave address on I2C buses, the index of the target
+   *          configuration on SPI buses.
+   */
+  uint32_t                  target;
+  /**
+   * @brief   Transmit buffer.
+   */
+  const uint8_t             *txbuf;
+  /**
+   * @brief   Number of bytes to transmit.
+   */
+  size_t                    txbytes;
+  /**
+   * @brief   Receive buffer.
+   */
+  uint8_t                   *rxbuf;
+  /**
+   * @brief   Number of bytes to receive.
+   */
+  size_t                    rxbytes;
+} busq_transaction_t;
+
+/**
+ * @brief   Structure representing a transactions chain.
+ * @details Transactions of a chain are executed back-to-back from the
+ *          completion interrupts, the chain is aborted on the first
+ *          failed transaction. The chain object is owned by the queue
+ *          from submission to completion.
+ */
+struct busq_chain {
+  /**
+   * @brief   Next chain in the queue.
+   */
+  busq_chain_t              *next;
+  /**
+   * @brief   Array of transaction descriptors.
+   */
+  const busq_transaction_t  *transactions;
+  /**
+   * @brief   Number of transactions in the chain.
+   */
+  size_t                    n;
+  /**
+   * @brief   Completion callback or @p NULL.
+   */
+  busqcallback_t            cb;
+  /**
+   * @brief   Thread waiting for the chain completion.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Chain result.
+   * @details @p MSG_OK if all transactions succeeded, @p MSG_RESET if a
+   *          transaction failed.
+   */
+  msg_t                     result;
+};
+
+/**
+ * @brief   Queue statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Completed chains.
+   */
+  uint32_t                  chains;
+  /**
+   * @brief   Executed transactions.
+   */
+  uint32_t                  transactions;
+  /**
+   * @brief   Failed transactions.
+   */
+  uint32_t                  errors;
+} busq_stats_t;
+
+/**
+ * @brief   Type of a bus transactions queue configuration structure.
+ * @note    Exactly one of the two buses must be specified.
+ */
+typedef struct {
+#if (BUSQ_USE_I2C == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   I2C driver or @p NULL.
+   */
+  I2CDriver                 *i2cp;
+  /**
+   * @brief   I2C configuration.
+   */
+  const I2CConfig           *i2ccfg;
+#endif
+#if (BUSQ_USE_SPI == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   SPI driver or @p NULL.
+   */
+  SPIDriver                 *spip;
+  /**
+   * @brief   SPI configurations, one for each target.
+   * @note    The configurations must use @p busqSpiCallback() as end
+   *          callback and must only differ in the slave select setting,
+   *          the driver is started using the first one and the others
+   *          are only used for selecting the targets.
+   */
+  const SPIConfig * const   *spicfgs;
+  /**
+   * @brief   Number of SPI targets.
+   */
+  uint32_t                  spitargets;
+#endif
+} BusQueueConfig;
+
+/**
+ * @brief   Structure representing a bus transactions queue.
+ */
+struct hal_bus_queue {
+  /**
+   * @brief   Driver state.
+   */
+  busqstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const BusQueueConfig      *config;
+  /**
+   * @brief   Next started queue.
+   */
+  BusQueue                  *next;
+  /**
+   * @brief   Chain in execution or @p NULL if the queue is idle.
+   */
+  busq_chain_t              *head;
+  /**
+   * @brief   Last queued chain.
+   */
+  busq_chain_t              *tail;
+  /**
+   * @brief   Index of the transaction in execution.
+   */
+  size_t                    current;
+#if (BUSQ_USE_SPI == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   SPI receive phase in progress.
+   */
+  bool                      rxphase;
+#endif
+  /**
+   * @brief   Queue statistics.
+   */
+  busq_stats_t              stats;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a transactions chain.
+ *
+ * @param[out] bcp      pointer to the @p busq_chain_t object
+ * @param[in] tp        pointer to the array of transaction descriptors
+ * @param[in] nt        number of transactions
+ * @param[in] cbp       completion callback or @p NULL
+ *
+ * @init
+ */
+#define busqChainObjectInit(bcp, tp, nt, cbp) do {                          \
+  (bcp)->next         = NULL;                                               \
+  (bcp)->transactions = (tp);                                               \
+  (bcp)->n            = (nt);                                               \
+  (bcp)->cb           = (cbp);                                              \
+  (bcp)->thread       = NULL;                                               \
+  (bcp)->result       = MSG_OK;                                             \
+} while (false)
+
+/**
+ * @brief   Returns the queue statistics.
+ *
+ * @param[in] bqp       pointer to the @p BusQueue object
+ * @return              A pointer to the @p busq_stats_t structure.
+ *
+ * @xclass
+ */
+#define busqGetStatsX(bqp) (&(bqp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void busqObjectInit(BusQueue *bqp);
+  msg_t busqStart(BusQueue *bqp, const BusQueueConfig *config);
+  void busqStop(BusQueue *bqp);
+  void busqSubmitI(BusQueue *bqp, busq_chain_t *bcp);
+  void busqSubmit(BusQueue *bqp, busq_chain_t *bcp);
+  msg_t busqExecute(BusQueue *bqp, busq_chain_t *bcp);
+  void busqResetStats(BusQueue *bqp);
+#if BUSQ_USE_SPI == TRUE
+  void busqSpiCallback(SPIDriver *spip);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_BUS_QUEUE_H */
+
+/** @} */
@@ -0,0 +1,9 @@
+# List of all the bus queue subsystem files.
+BUSQSRC := $(CHIBIOS)/os/hal/lib/complex/bus_queue/hal_bus_queue.c
+
+# Required include directories
+BUSQINC := $(CHIBIOS)/os/hal/lib/complex/bus_queue
+
+# Shared variables
+ALLCSRC += $(BUSQSRC)
+ALLINC  += $(BUSQINC)
@@ -0,0 +1,305 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_sample_stream.c
+ * @brief   Sample streams code.
+ *
+ * @addtogroup HAL_SAMPLE_STREAM
+ * @{
+ */
+
+#include "hal.h"
+#include "hal_sample_stream.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Compiler barrier.
+ * @details The queue is accessed by the application without locks, the
+ *          descriptors must be written before publishing them and read
+ *          after.
+ */
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define SSTR_BARRIER()      __asm__ volatile ("" : : : "memory")
+#else
+#define SSTR_BARRIER()
+#endif
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Takes the posted blocks, up to the specified number.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ * @param[out] bp       pointer to an array of block descriptors
+ * @param[in] n         maximum number of blocks
+ * @return              The number of taken blocks.
+ */
+static size_t sstr_take(SampleStream *ssp, sstr_block_t *bp, size_t n) {
+  uint32_t rdidx = ssp->rdidx;
+  size_t i, ready = (size_t)(ssp->wridx - rdidx);
+
+  if (n > ready) {
+    n = ready;
+  }
+
+  /* Descriptors are read after the publishing index.*/
+  SSTR_BARRIER();
+  for (i = 0U; i < n; i++) {
+    bp[i] = ssp->queue[(rdidx + (uint32_t)i) % ssp->config->blocks];
+  }
+  ssp->rdidx = rdidx + (uint32_t)n;
+  ssp->stats.blocks += (uint32_t)n;
+
+  return n;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] ssp      pointer to the @p SampleStream object
+ *
+ * @init
+ */
+void sstrObjectInit(SampleStream *ssp) {
+
+  osalDbgCheck(ssp != NULL);
+
+  ssp->state  = SSTR_STOP;
+  ssp->config = NULL;
+  ssp->thread = NULL;
+  sstrResetStats(ssp);
+}
+
+/**
+ * @brief   Configures and activates a stream.
+ * @note    The stream must be started before the associated driver
+ *          starts invoking @p sstrPostI().
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void sstrStart(SampleStream *ssp, const SampleStreamConfig *config) {
+  uint32_t i;
+
+  osalDbgCheck((ssp != NULL) && (config != NULL) &&
+               (config->buffer != NULL) && (config->block_size > 0U) &&
+               (config->blocks >= 2U) && (config->blocks <= SSTR_MAX_BLOCKS));
+  osalDbgAssert(ssp->state == SSTR_STOP, "invalid state");
+
+  osalSysLock();
+  ssp->config   = config;
+  ssp->produced = 0U;
+  ssp->wridx    = 0U;
+  ssp->rdidx    = 0U;
+  ssp->relidx   = 0U;
+  for (i = 0U; i < config->blocks; i++) {
+    ssp->owned[i]   = false;
+    ssp->invalid[i] = false;
+  }
+  ssp->state    = SSTR_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Deactivates a stream.
+ * @details A thread waiting for blocks is resumed with @p MSG_RESET.
+ * @pre     The associated driver must not invoke @p sstrPostI() anymore.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ *
+ * @api
+ */
+void sstrStop(SampleStream *ssp) {
+
+  osalDbgCheck(ssp != NULL);
+  osalDbgAssert(ssp->state == SSTR_READY, "invalid state");
+
+  osalSysLock();
+  ssp->state = SSTR_STOP;
+  osalThreadResumeS(&ssp->thread, MSG_RESET);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Posts the next completed block.
+ * @details Blocks are completed in buffer order and the driver starts
+ *          filling the next one. If the application still owns the next
+ *          block then an overrun is counted and the block is invalidated,
+ *          see @p sstrIsValidX(). The completed block is queued to the
+ *          application unless it is still owned from the previous buffer
+ *          round, in that case its new data is lost.
+ * @note    This function is meant to be invoked from the half and full
+ *          buffer callbacks of ADC, DAC or I2S drivers in circular mode,
+ *          for output streams a posted block has been consumed by the
+ *          driver and can be refilled.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ *
+ * @iclass
+ */
+void sstrPostI(SampleStream *ssp) {
+  const SampleStreamConfig *config;
+  sstr_block_t *bp;
+  uint32_t seq, block, next;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(ssp != NULL);
+
+  config = ssp->config;
+
+  if (ssp->state != SSTR_READY) {
+    return;
+  }
+
+  seq   = ssp->produced++;
+  block = seq % config->blocks;
+
+  /* The driver is already refilling the next block.*/
+  next = (seq + 1U) % config->blocks;
+  if (ssp->owned[next]) {
+    ssp->invalid[next] = true;
+    ssp->stats.overruns++;
+  }
+
+  /* Still owned, the overrun has been counted when the refill started.*/
+  if (ssp->owned[block]) {
+    return;
+  }
+
+  /* The block is published after the descriptor has been written.*/
+  bp = &ssp->queue[ssp->wridx % config->blocks];
+  bp->buffer = (uint8_t *)config->buffer + ((size_t)block * config->block_size);
+  bp->seq    = seq;
+  ssp->owned[block] = true;
+  SSTR_BARRIER();
+  ssp->wridx++;
+
+  if (ssp->thread != NULL) {
+    ssp->stats.wakeups++;
+    osalThreadResumeI(&ssp->thread, MSG_OK);
+  }
+}
+
+/**
+ * @brief   Acquires posted blocks.
+ * @details All the posted blocks are returned, up to the specified number,
+ *          the calling thread waits if there are no posted blocks. The
+ *          blocks are owned by the caller until released.
+ * @note    Only one thread can acquire blocks from a stream.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ * @param[out] bp       pointer to an array of block descriptors
+ * @param[in] n         maximum number of blocks
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of acquired blocks, zero in case of
+ *                      timeout or if the stream has been stopped while
+ *                      waiting.
+ *
+ * @api
+ */
+size_t sstrAcquireTimeout(SampleStream *ssp, sstr_block_t *bp,
+                          size_t n, sysinterval_t timeout) {
+
+  osalDbgCheck((ssp != NULL) && (bp != NULL) && (n > 0U));
+
+  /* Fast path, blocks already posted.*/
+  if (sstrGetReadyX(ssp) > 0U) {
+    return sstr_take(ssp, bp, n);
+  }
+
+  osalSysLock();
+  while ((ssp->state == SSTR_READY) && (sstrGetReadyX(ssp) == 0U)) {
+    if (osalThreadSuspendTimeoutS(&ssp->thread, timeout) != MSG_OK) {
+      break;
+    }
+  }
+  osalSysUnlock();
+
+  return sstr_take(ssp, bp, n);
+}
+
+/**
+ * @brief   Releases acquired blocks.
+ * @details Blocks are released in acquisition order, the released blocks
+ *          can be reused by the driver.
+ * @note    The validity of the blocks must be checked before releasing
+ *          them.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ * @param[in] n         number of blocks to be released
+ *
+ * @api
+ */
+void sstrRelease(SampleStream *ssp, size_t n) {
+  const SampleStreamConfig *config;
+  uint32_t relidx;
+
+  osalDbgCheck(ssp != NULL);
+
+  config = ssp->config;
+  relidx = ssp->relidx;
+  osalDbgAssert(n <= (size_t)(ssp->rdidx - relidx), "not acquired");
+
+  while (n > 0U) {
+    const sstr_block_t *bp = &ssp->queue[relidx % config->blocks];
+
+    ssp->owned[bp->seq % config->blocks]   = false;
+    ssp->invalid[bp->seq % config->blocks] = false;
+    relidx++;
+    n--;
+  }
+  ssp->relidx = relidx;
+}
+
+/**
+ * @brief   Resets the stream statistics.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ *
+ * @api
+ */
+void sstrResetStats(SampleStream *ssp) {
+
+  ssp->stats.blocks   = 0U;
+  ssp->stats.overruns = 0U;
+  ssp->stats.wakeups  = 0U;
+}
+
+/** @} */
@@ -0,0 +1,251 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_sample_stream.h
+ * @brief   Sample streams header.
+ *
+ * @addtogroup HAL_SAMPLE_STREAM
+ * @{
+ */
+
+#ifndef HAL_SAMPLE_STREAM_H
+#define HAL_SAMPLE_STREAM_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Sample streams configuration options
+ * @{
+ */
+/**
+ * @brief   Maximum number of blocks in a stream.
+ */
+#if !defined(SSTR_MAX_BLOCKS) || defined(__DOXYGEN__)
+#define SSTR_MAX_BLOCKS                     4U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SSTR_MAX_BLOCKS < 2U
+#error "SSTR_MAX_BLOCKS must be at least 2"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  SSTR_UNINIT = 0,                  /**< Not initialized.                   */
+  SSTR_STOP = 1,                    /**< Stopped.                           */
+  SSTR_READY = 2                    /**< Ready.                             */
+} sstrstate_t;
+
+/**
+ * @brief   Type of a block descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the block data within the stream buffer.
+   */
+  void                      *buffer;
+  /**
+   * @brief   Block sequence number.
+   * @details Blocks are numbered from zero in completion order, a gap in
+   *          the sequence means that blocks have been lost because of
+   *          overruns.
+   */
+  uint32_t                  seq;
+} sstr_block_t;
+
+/**
+ * @brief   Stream statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Blocks delivered to the application.
+   */
+  uint32_t                  blocks;
+  /**
+   * @brief   Blocks refilled by the driver while still owned by the
+   *          application.
+   * @details The owned block data is invalidated and the new data is lost
+   *          unless the block is released before its completion.
+   */
+  uint32_t                  overruns;
+  /**
+   * @brief   Wakeups of the application thread.
+   */
+  uint32_t                  wakeups;
+} sstr_stats_t;
+
+/**
+ * @brief   Type of a sample stream configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Stream buffer.
+   * @details This is the whole circular buffer used by the driver.
+   */
+  void                      *buffer;
+  /**
+   * @brief   Size of a block in bytes.
+   */
+  size_t                    block_size;
+  /**
+   * @brief   Number of blocks in the buffer.
+   * @note    Drivers in circular mode notify half and full buffer
+   *          completion, the number of blocks is 2 for them.
+   */
+  uint32_t                  blocks;
+} SampleStreamConfig;
+
+/**
+ * @brief   Structure representing a sample stream.
+ * @details The stream is a single-producer single-consumer queue of the
+ *          blocks of a circular buffer. Blocks are posted in completion
+ *          order from the driver callbacks, the application acquires them
+ *          in place and releases them after use, blocks are never copied.
+ *          The queue indexes are free-running counters, each one only
+ *          written by one side, the application accesses the queue
+ *          without entering a critical zone unless it has to wait.
+ */
+typedef struct {
+  /**
+   * @brief   Driver state.
+   */
+  sstrstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const SampleStreamConfig  *config;
+  /**
+   * @brief   Completed blocks counter, written by the driver side.
+   */
+  uint32_t                  produced;
+  /**
+   * @brief   Posted blocks counter, written by the driver side.
+   */
+  volatile uint32_t         wridx;
+  /**
+   * @brief   Acquired blocks counter, written by the application side.
+   */
+  volatile uint32_t         rdidx;
+  /**
+   * @brief   Released blocks counter, written by the application side.
+   */
+  volatile uint32_t         relidx;
+  /**
+   * @brief   Ownership flags of the buffer blocks.
+   * @details A block is owned by the application from its posting to its
+   *          release.
+   */
+  volatile bool             owned[SSTR_MAX_BLOCKS];
+  /**
+   * @brief   Invalidation flags of the buffer blocks.
+   * @details A block is invalidated when the driver starts refilling it
+   *          while it is still owned by the application.
+   */
+  volatile bool             invalid[SSTR_MAX_BLOCKS];
+  /**
+   * @brief   Posted blocks queue.
+   */
+  sstr_block_t              queue[SSTR_MAX_BLOCKS];
+  /**
+   * @brief   Thread waiting for blocks.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Stream statistics.
+   */
+  sstr_stats_t              stats;
+} SampleStream;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the number of blocks waiting to be acquired.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ * @return              The number of blocks.
+ *
+ * @xclass
+ */
+#define sstrGetReadyX(ssp) ((size_t)((ssp)->wridx - (ssp)->rdidx))
+
+/**
+ * @brief   Checks if the data of an acquired block is still valid.
+ * @details The driver could have started refilling the block while it was
+ *          owned by the application, the check has to be performed after
+ *          processing the block and before releasing it.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ * @param[in] bp        pointer to an acquired block descriptor
+ * @return              The block status.
+ * @retval false        if the block has been overwritten.
+ * @retval true         if the block is valid.
+ *
+ * @xclass
+ */
+#define sstrIsValidX(ssp, bp)                                               \
+  ((bool)!(ssp)->invalid[(bp)->seq % (ssp)->config->blocks])
+
+/**
+ * @brief   Returns the stream statistics.
+ *
+ * @param[in] ssp       pointer to the @p SampleStream object
+ * @return              A pointer to the @p sstr_stats_t structure.
+ *
+ * @xclass
+ */
+#define sstrGetStatsX(ssp) (&(ssp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void sstrObjectInit(SampleStream *ssp);
+  void sstrStart(SampleStream *ssp, const SampleStreamConfig *config);
+  void sstrStop(SampleStream *ssp);
+  void sstrPostI(SampleStream *ssp);
+  size_t sstrAcquireTimeout(SampleStream *ssp, sstr_block_t *bp,
+                            size_t n, sysinterval_t timeout);
+  void sstrRelease(SampleStream *ssp, size_t n);
+  void sstrResetStats(SampleStream *ssp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_SAMPLE_STREAM_H */
+
+/** @} */
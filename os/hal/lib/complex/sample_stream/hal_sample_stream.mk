@@ -0,0 +1,9 @@
+# List of all the sample stream subsystem files.
+SSTRSRC := $(CHIBIOS)/os/hal/lib/complex/sample_stream/hal_sample_stream.c
+
+# Required include directories
+SSTRINC := $(CHIBIOS)/os/hal/lib/complex/sample_stream
+
+# Shared variables
+ALLCSRC += $(SSTRSRC)
+ALLINC  += $(SSTRINC)
@@ -470,6 +470,14 @@ flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
                       chunk, pp);
 #endif
 
+#if SNOR_USE_PROGRAM_PIPELINE == TRUE
+    /* The last page is left in progress, the completion is checked
+       before the next operation.*/
+    if (chunk == n) {
+      break;
+    }
+#endif
+
     /* Wait for status and check errors.*/
     err = mx25_poll_status(devp);
     if (err != FLASH_NO_ERROR) {
@@ -486,6 +494,18 @@ flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
   return FLASH_NO_ERROR;
 }
 
+#if (SNOR_USE_PROGRAM_PIPELINE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the completion of a pipelined page program.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+flash_error_t snor_device_wait_program(SNORDriver *devp) {
+
+  return mx25_poll_status(devp);
+}
+#endif /* SNOR_USE_PROGRAM_PIPELINE == TRUE */
+
 /**
  * @brief   Device global erase start.
  *
@@ -407,6 +407,14 @@ flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
     bus_cmd_addr_send(devp->config->busp, N25Q_CMD_PAGE_PROGRAM, offset,
                       chunk, pp);
 
+#if SNOR_USE_PROGRAM_PIPELINE == TRUE
+    /* The last page is left in progress, the completion is checked
+       before the next operation.*/
+    if (chunk == n) {
+      break;
+    }
+#endif
+
     /* Wait for status and check errors.*/
     err = n25q_poll_status(devp);
     if (err != FLASH_NO_ERROR) {
@@ -423,6 +431,31 @@ flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
   return FLASH_NO_ERROR;
 }
 
+#if (SNOR_USE_PROGRAM_PIPELINE == TRUE) || defined(__DOXYGEN__)
+flash_error_t snor_device_wait_program(SNORDriver *devp) {
+  uint8_t sts;
+
+  /* The operation is usually already completed, polling only if still
+     busy.*/
+  bus_cmd_receive(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
+                  1, &sts);
+  if ((sts & N25Q_FLAGS_PROGRAM_ERASE) == 0U) {
+    return n25q_poll_status(devp);
+  }
+
+  /* Checking for errors.*/
+  if ((sts & N25Q_FLAGS_ALL_ERRORS) != 0U) {
+    /* Clearing status register.*/
+    bus_cmd(devp->config->busp, N25Q_CMD_CLEAR_FLAG_STATUS_REGISTER);
+
+    /* Program operation failed.*/
+    return FLASH_ERROR_PROGRAM;
+  }
+
+  return FLASH_NO_ERROR;
+}
+#endif /* SNOR_USE_PROGRAM_PIPELINE == TRUE */
+
 flash_error_t snor_device_start_erase_all(SNORDriver *devp) {
 
   /* Enabling write operation.*/
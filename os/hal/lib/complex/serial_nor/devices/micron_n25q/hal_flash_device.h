@@ -314,6 +314,9 @@ extern "C" {
                                  size_t n, uint8_t *rp);
   flash_error_t snor_device_program(SNORDriver *devp, flash_offset_t offset,
                                     size_t n, const uint8_t *pp);
+#if SNOR_USE_PROGRAM_PIPELINE == TRUE
+  flash_error_t snor_device_wait_program(SNORDriver *devp);
+#endif
   flash_error_t snor_device_start_erase_all(SNORDriver *devp);
   flash_error_t snor_device_start_erase_sector(SNORDriver *devp,
                                                flash_sector_t sector);
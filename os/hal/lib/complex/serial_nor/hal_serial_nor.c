@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "hal_serial_nor.h"
 
@@ -29,6 +31,11 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if SNOR_USE_PROGRAM_PIPELINE == FALSE
+#define snor_sync(devp) (void)(devp)
+#define snor_take_error(devp) FLASH_NO_ERROR
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -66,6 +73,139 @@ static const struct SNORDriverVMT snor_vmt = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SNOR_USE_PROGRAM_PIPELINE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the completion of a pipelined program operation.
+ * @details An error of the operation is latched, the first latched error
+ *          is kept until taken.
+ * @pre     The bus must be acquired.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ */
+static void snor_sync(SNORDriver *devp) {
+  flash_error_t err;
+
+  if (!devp->pgm_pending) {
+    return;
+  }
+
+  devp->pgm_pending = false;
+
+  err = snor_device_wait_program(devp);
+  if (devp->pgm_error == FLASH_NO_ERROR) {
+    devp->pgm_error = err;
+  }
+}
+
+/**
+ * @brief   Returns and clears the latched program error.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @return              The latched error.
+ */
+static flash_error_t snor_take_error(SNORDriver *devp) {
+  flash_error_t err = devp->pgm_error;
+
+  devp->pgm_error = FLASH_NO_ERROR;
+
+  return err;
+}
+#endif /* SNOR_USE_PROGRAM_PIPELINE == TRUE */
+
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Invalidates the cache lines overlapping a flash area.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         size of the area
+ */
+static void snor_cache_invalidate(SNORDriver *devp, flash_offset_t offset,
+                                  size_t n) {
+  unsigned i;
+
+  for (i = 0U; i < SNOR_READ_CACHE_LINES; i++) {
+    snor_cache_line_t *lp = &devp->cache[i];
+
+    if ((lp->offset != SNOR_CACHE_INVALID) &&
+        ((size_t)lp->offset < (size_t)offset + n) &&
+        ((size_t)lp->offset + SNOR_READ_CACHE_LINE_SIZE > (size_t)offset)) {
+      lp->offset = SNOR_CACHE_INVALID;
+      lp->stamp  = 0U;
+    }
+  }
+}
+
+/**
+ * @brief   Reads data through the cache.
+ * @details Missing lines are read from the device replacing the least
+ *          recently used lines.
+ * @pre     The bus must be acquired.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ */
+static flash_error_t snor_cache_read(SNORDriver *devp, flash_offset_t offset,
+                                     size_t n, uint8_t *rp) {
+
+  while (n > 0U) {
+    size_t pos = (size_t)offset & (SNOR_READ_CACHE_LINE_SIZE - 1U);
+    flash_offset_t base = offset - (flash_offset_t)pos;
+    size_t chunk = SNOR_READ_CACHE_LINE_SIZE - pos;
+    snor_cache_line_t *lp = NULL;
+    snor_cache_line_t *victim = &devp->cache[0];
+    unsigned i;
+
+    if (chunk > n) {
+      chunk = n;
+    }
+
+    /* Searching the line, the least recently used line is the victim in
+       case of miss.*/
+    for (i = 0U; i < SNOR_READ_CACHE_LINES; i++) {
+      if (devp->cache[i].offset == base) {
+        lp = &devp->cache[i];
+        break;
+      }
+      if (devp->cache[i].stamp < victim->stamp) {
+        victim = &devp->cache[i];
+      }
+    }
+
+    if (lp == NULL) {
+      flash_error_t err;
+
+      /* Line fill.*/
+      err = snor_device_read(devp, base, SNOR_READ_CACHE_LINE_SIZE,
+                             victim->data);
+      if (err != FLASH_NO_ERROR) {
+        victim->offset = SNOR_CACHE_INVALID;
+        victim->stamp  = 0U;
+
+        return err;
+      }
+      victim->offset = base;
+      lp = victim;
+      devp->cache_stats.misses++;
+    }
+    else {
+      devp->cache_stats.hits++;
+    }
+    lp->stamp = ++devp->cache_stamp;
+
+    memcpy(rp, &lp->data[pos], chunk);
+    offset += chunk;
+    rp     += chunk;
+    n      -= chunk;
+  }
+
+  return FLASH_NO_ERROR;
+}
+#endif /* SNOR_USE_READ_CACHE == TRUE */
+
 /**
  * @brief   Returns a pointer to the device descriptor.
  *
@@ -100,11 +240,37 @@ static flash_error_t snor_read(void *instance, flash_offset_t offset,
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  /* If the flash is memory mapped then the data is copied from the mapped
+     area, the device is in continuous read mode. The bus is held during
+     the copy so the area cannot be unmapped meanwhile.*/
+  if (devp->map != NULL) {
+    memcpy(rp, devp->map + offset, n);
+
+    /* Bus released.*/
+    bus_release(devp->config->busp);
+
+    return FLASH_NO_ERROR;
+  }
+#endif
+
   /* FLASH_READY state while the operation is performed.*/
   devp->state = FLASH_READ;
 
   /* Actual read implementation.*/
+  snor_sync(devp);
+#if SNOR_USE_READ_CACHE == TRUE
+  /* Small reads are performed through the cache.*/
+  if (n < SNOR_READ_CACHE_LINE_SIZE) {
+    err = snor_cache_read(devp, offset, n, rp);
+  }
+  else {
+    devp->cache_stats.bypasses++;
+    err = snor_device_read(devp, offset, n, rp);
+  }
+#else
   err = snor_device_read(devp, offset, n, rp);
+#endif
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
@@ -130,14 +296,30 @@ static flash_error_t snor_program(void *instance, flash_offset_t offset,
     return FLASH_BUSY_ERASING;
   }
 
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  osalDbgAssert(devp->map == NULL, "memory mapped");
+#endif
+
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
   /* FLASH_PGM state while the operation is performed.*/
   devp->state = FLASH_PGM;
 
-  /* Actual program implementation.*/
-  err = snor_device_program(devp, offset, n, pp);
+  /* Actual program implementation, a failed pipelined page program is
+     reported instead of performing the operation.*/
+  snor_sync(devp);
+  err = snor_take_error(devp);
+  if (err == FLASH_NO_ERROR) {
+#if SNOR_USE_READ_CACHE == TRUE
+    snor_cache_invalidate(devp, offset, n);
+#endif
+    err = snor_device_program(devp, offset, n, pp);
+#if SNOR_USE_PROGRAM_PIPELINE == TRUE
+    /* The last page is still in progress.*/
+    devp->pgm_pending = err == FLASH_NO_ERROR;
+#endif
+  }
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
@@ -160,6 +342,10 @@ static flash_error_t snor_start_erase_all(void *instance) {
     return FLASH_BUSY_ERASING;
   }
 
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  osalDbgAssert(devp->map == NULL, "memory mapped");
+#endif
+
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
@@ -167,6 +353,10 @@ static flash_error_t snor_start_erase_all(void *instance) {
   devp->state = FLASH_ERASE;
 
   /* Actual erase implementation.*/
+  snor_sync(devp);
+#if SNOR_USE_READ_CACHE == TRUE
+  snorInvalidateCache(devp);
+#endif
   err = snor_device_start_erase_all(devp);
 
   /* Ready state again.*/
@@ -192,6 +382,10 @@ static flash_error_t snor_start_erase_sector(void *instance,
     return FLASH_BUSY_ERASING;
   }
 
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  osalDbgAssert(devp->map == NULL, "memory mapped");
+#endif
+
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
@@ -199,6 +393,13 @@ static flash_error_t snor_start_erase_sector(void *instance,
   devp->state = FLASH_ERASE;
 
   /* Actual erase implementation.*/
+  snor_sync(devp);
+#if SNOR_USE_READ_CACHE == TRUE
+  snor_cache_invalidate(devp,
+                        (flash_offset_t)(sector *
+                                         snor_descriptor.sectors_size),
+                        (size_t)snor_descriptor.sectors_size);
+#endif
   err = snor_device_start_erase_sector(devp, sector);
 
   /* Bus released.*/
@@ -221,6 +422,10 @@ static flash_error_t snor_verify_erase(void *instance,
     return FLASH_BUSY_ERASING;
   }
 
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  osalDbgAssert(devp->map == NULL, "memory mapped");
+#endif
+
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
@@ -228,6 +433,7 @@ static flash_error_t snor_verify_erase(void *instance,
   devp->state = FLASH_READ;
 
   /* Actual verify erase implementation.*/
+  snor_sync(devp);
   err = snor_device_verify_erase(devp, sector);
 
   /* Ready state again.*/
@@ -284,10 +490,15 @@ static flash_error_t snor_read_sfdp(void *instance, flash_offset_t offset,
     return FLASH_BUSY_ERASING;
   }
 
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  osalDbgAssert(devp->map == NULL, "memory mapped");
+#endif
+
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
   /* Actual read SFDP implementation.*/
+  snor_sync(devp);
   err = snor_device_read_sfdp(devp, offset, n, rp);
 
   /* The device is ready to accept commands.*/
@@ -647,6 +858,17 @@ void snorObjectInit(SNORDriver *devp) {
   devp->vmt         = &snor_vmt;
   devp->state       = FLASH_STOP;
   devp->config      = NULL;
+#if SNOR_USE_PROGRAM_PIPELINE == TRUE
+  devp->pgm_pending = false;
+  devp->pgm_error   = FLASH_NO_ERROR;
+#endif
+#if SNOR_USE_READ_CACHE == TRUE
+  snorInvalidateCache(devp);
+  snorResetCacheStats(devp);
+#endif
+#if SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI
+  devp->map         = NULL;
+#endif
 }
 
 /**
@@ -672,6 +894,11 @@ void snorStart(SNORDriver *devp, const SNORConfig *config) {
     /* Device identification and initialization.*/
     snor_device_init(devp);
 
+#if SNOR_USE_READ_CACHE == TRUE
+    /* The flash content could have been changed while stopped.*/
+    snorInvalidateCache(devp);
+#endif
+
     /* Driver in ready state.*/
     devp->state = FLASH_READY;
 
@@ -697,6 +924,10 @@ void snorStop(SNORDriver *devp) {
     /* Bus acquisition.*/
     bus_acquire(devp->config->busp, devp->config->buscfg);
 
+    /* Waiting for a pipelined program operation, an error is kept latched
+       for snorSync().*/
+    snor_sync(devp);
+
     /* Stopping bus device.*/
     bus_stop(devp->config->busp);
 
@@ -711,6 +942,83 @@ void snorStop(SNORDriver *devp) {
   }
 }
 
+/**
+ * @brief   Waits for the completion of the program operations.
+ * @details A pipelined page program still in progress is awaited, then
+ *          the latched error of the pipelined page programs is returned
+ *          and cleared. The error is kept across @p snorStop() and
+ *          @p snorMemoryMap().
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR       if all the page programs succeeded.
+ * @retval FLASH_ERROR_PROGRAM  if a pipelined page program failed.
+ *
+ * @api
+ */
+flash_error_t snorSync(SNORDriver *devp) {
+  flash_error_t err;
+
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert(devp->state != FLASH_UNINIT, "invalid state");
+
+  /* A stopped driver has no operations in progress.*/
+  if (devp->state == FLASH_STOP) {
+    return snor_take_error(devp);
+  }
+
+  /* Bus acquired.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+
+  snor_sync(devp);
+  err = snor_take_error(devp);
+
+  /* Bus released.*/
+  bus_release(devp->config->busp);
+
+  return err;
+}
+
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Invalidates the read cache.
+ * @note    The cache is kept coherent with the operations performed through
+ *          the driver, this function is only required if the flash is
+ *          modified by other means.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @api
+ */
+void snorInvalidateCache(SNORDriver *devp) {
+  unsigned i;
+
+  osalDbgCheck(devp != NULL);
+
+  for (i = 0U; i < SNOR_READ_CACHE_LINES; i++) {
+    devp->cache[i].offset = SNOR_CACHE_INVALID;
+    devp->cache[i].stamp  = 0U;
+  }
+  devp->cache_stamp = 0U;
+}
+
+/**
+ * @brief   Resets the read cache statistics.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @api
+ */
+void snorResetCacheStats(SNORDriver *devp) {
+
+  osalDbgCheck(devp != NULL);
+
+  devp->cache_stats.hits     = 0U;
+  devp->cache_stats.misses   = 0U;
+  devp->cache_stats.bypasses = 0U;
+}
+#endif /* SNOR_USE_READ_CACHE == TRUE */
+
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
@@ -718,6 +1026,9 @@ void snorStop(SNORDriver *devp) {
  * @details The memory mapping mode is only available when the WSPI mode
  *          is selected and the underlying WSPI controller supports the
  *          feature.
+ * @note    Reads performed through the driver while the flash is mapped
+ *          are served from the mapped area, program and erase operations
+ *          are not allowed.
  *
  * @param[in] devp      pointer to the @p SNORDriver object
  * @param[out] addrp    pointer to the memory start address of the mapped
@@ -730,13 +1041,21 @@ void snorMemoryMap(SNORDriver *devp, uint8_t **addrp) {
   /* Bus acquisition.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
+  /* Waiting for a pipelined program operation, an error is kept latched
+     for the next program operation or snorSync().*/
+  snor_sync(devp);
+
 #if SNOR_DEVICE_SUPPORTS_XIP == TRUE
   /* Activating XIP mode in the device.*/
   snor_activate_xip(devp);
 #endif
 
-  /* Starting WSPI memory mapped mode.*/
-  wspiMapFlash(devp->config->busp, &snor_memmap_read, addrp);
+  /* Starting WSPI memory mapped mode, reads are served from the mapped
+     area from now on.*/
+  wspiMapFlash(devp->config->busp, &snor_memmap_read, &devp->map);
+  if (addrp != NULL) {
+    *addrp = devp->map;
+  }
 
   /* Bus release.*/
   bus_release(devp->config->busp);
@@ -756,6 +1075,7 @@ void snorMemoryUnmap(SNORDriver *devp) {
 
   /* Stopping WSPI memory mapped mode.*/
   wspiUnmapFlash(devp->config->busp);
+  devp->map = NULL;
 
 #if SNOR_DEVICE_SUPPORTS_XIP == TRUE
   snor_reset_xip(devp);
@@ -65,6 +65,44 @@
 #if !defined(SNOR_SHARED_BUS) || defined(__DOXYGEN__)
 #define SNOR_SHARED_BUS                     TRUE
 #endif
+
+/**
+ * @brief   Read cache switch.
+ * @details If set to @p TRUE reads smaller than a cache line are served
+ *          from a cache of recently read flash lines, larger reads are
+ *          performed directly.
+ */
+#if !defined(SNOR_USE_READ_CACHE) || defined(__DOXYGEN__)
+#define SNOR_USE_READ_CACHE                 FALSE
+#endif
+
+/**
+ * @brief   Number of read cache lines.
+ */
+#if !defined(SNOR_READ_CACHE_LINES) || defined(__DOXYGEN__)
+#define SNOR_READ_CACHE_LINES               8U
+#endif
+
+/**
+ * @brief   Size of a read cache line.
+ * @note    Must be a power of two.
+ */
+#if !defined(SNOR_READ_CACHE_LINE_SIZE) || defined(__DOXYGEN__)
+#define SNOR_READ_CACHE_LINE_SIZE           64U
+#endif
+
+/**
+ * @brief   Program pipelining switch.
+ * @details If set to @p TRUE program operations return as soon as the
+ *          last page program is started, the completion is awaited before
+ *          the next operation. The program time of the last page overlaps
+ *          with the caller activity.
+ * @note    An error of the last page program is latched and reported by
+ *          the next program operation or by @p snorSync().
+ */
+#if !defined(SNOR_USE_PROGRAM_PIPELINE) || defined(__DOXYGEN__)
+#define SNOR_USE_PROGRAM_PIPELINE           FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -81,6 +119,17 @@
 #error "invalid SNOR_BUS_DRIVER setting"
 #endif
 
+#if SNOR_USE_READ_CACHE == TRUE
+#if SNOR_READ_CACHE_LINES < 1
+#error "invalid SNOR_READ_CACHE_LINES value"
+#endif
+
+#if (SNOR_READ_CACHE_LINE_SIZE < 4) ||                                      \
+    ((SNOR_READ_CACHE_LINE_SIZE & (SNOR_READ_CACHE_LINE_SIZE - 1)) != 0)
+#error "SNOR_READ_CACHE_LINE_SIZE must be a power of two"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -93,6 +142,44 @@ typedef struct {
   const BUSConfig           *buscfg;
 } SNORConfig;
 
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a read cache line.
+ */
+typedef struct {
+  /**
+   * @brief   Flash offset of the line or @p SNOR_CACHE_INVALID.
+   */
+  flash_offset_t                offset;
+  /**
+   * @brief   Last access stamp.
+   */
+  uint32_t                      stamp;
+  /**
+   * @brief   Line data.
+   */
+  uint8_t                       data[SNOR_READ_CACHE_LINE_SIZE];
+} snor_cache_line_t;
+
+/**
+ * @brief   Read cache statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Line accesses served from the cache.
+   */
+  uint32_t                      hits;
+  /**
+   * @brief   Line fills.
+   */
+  uint32_t                      misses;
+  /**
+   * @brief   Reads bypassing the cache.
+   */
+  uint32_t                      bypasses;
+} snor_cache_stats_t;
+#endif /* SNOR_USE_READ_CACHE == TRUE */
+
 /**
  * @brief   @p SNORDriver specific methods.
  */
@@ -138,6 +225,36 @@ typedef struct {
    * @brief   Device ID and unique ID.
    */
   uint8_t                       device_id[20];
+#if (SNOR_USE_PROGRAM_PIPELINE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   A page program is still in progress.
+   */
+  bool                          pgm_pending;
+  /**
+   * @brief   Latched error of a pipelined page program.
+   */
+  flash_error_t                 pgm_error;
+#endif
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Read cache lines.
+   */
+  snor_cache_line_t             cache[SNOR_READ_CACHE_LINES];
+  /**
+   * @brief   Read cache access counter.
+   */
+  uint32_t                      cache_stamp;
+  /**
+   * @brief   Read cache statistics.
+   */
+  snor_cache_stats_t            cache_stats;
+#endif
+#if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
+  /**
+   * @brief   Address of the memory mapped flash or @p NULL.
+   */
+  uint8_t                       *map;
+#endif
 } SNORDriver;
 
 /*===========================================================================*/
@@ -149,6 +266,23 @@ typedef struct {
 #define bus_release(busp)
 #endif
 
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Invalid cache line offset.
+ */
+#define SNOR_CACHE_INVALID                  ((flash_offset_t)-1)
+
+/**
+ * @brief   Returns the read cache statistics.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @return              A pointer to the @p snor_cache_stats_t structure.
+ *
+ * @xclass
+ */
+#define snorGetCacheStatsX(devp) (&(devp)->cache_stats)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -193,6 +327,11 @@ extern "C" {
   void snorObjectInit(SNORDriver *devp);
   void snorStart(SNORDriver *devp, const SNORConfig *config);
   void snorStop(SNORDriver *devp);
+  flash_error_t snorSync(SNORDriver *devp);
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+  void snorInvalidateCache(SNORDriver *devp);
+  void snorResetCacheStats(SNORDriver *devp);
+#endif
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
   void snorMemoryMap(SNORDriver *devp, uint8_t ** addrp);
@@ -34,6 +34,23 @@
 /* Driver exported variables.                                                */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Host time at the counter start.
+ */
+uint64_t st_lld_start_ns;
+
+/**
+ * @brief   Alarm time.
+ */
+systime_t st_lld_alarm_time;
+
+/**
+ * @brief   Alarm enable flag.
+ */
+bool st_lld_alarm_enabled;
+#endif
+
 /*===========================================================================*/
 /* Driver local types.                                                       */
 /*===========================================================================*/
@@ -60,6 +77,14 @@
  * @notapi
  */
 void st_lld_init(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  /* The counter is derived from the host monotonic clock, it starts from
+     zero like a free running hardware timer.*/
+  st_lld_start_ns      = _sim_get_time_ns();
+  st_lld_alarm_time    = (systime_t)0;
+  st_lld_alarm_enabled = false;
+#endif
 }
 
 #endif /* OSAL_ST_MODE != OSAL_ST_MODE_NONE */
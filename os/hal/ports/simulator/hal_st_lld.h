@@ -39,6 +39,10 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) && defined(WIN32)
+#error "free running ST mode not supported by the Win32 simulator"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -53,6 +57,11 @@
 
 #ifdef __cplusplus
 extern "C" {
+#endif
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+  extern uint64_t st_lld_start_ns;
+  extern systime_t st_lld_alarm_time;
+  extern bool st_lld_alarm_enabled;
 #endif
   void st_lld_init(void);
 #ifdef __cplusplus
@@ -72,7 +81,12 @@ extern "C" {
  */
 static inline systime_t st_lld_get_counter(void) {
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  return (systime_t)((_sim_get_time_ns() - st_lld_start_ns) /
+                     (1000000000U / OSAL_ST_FREQUENCY));
+#else
   return (systime_t)0;
+#endif
 }
 
 /**
@@ -86,7 +100,12 @@ static inline systime_t st_lld_get_counter(void) {
  */
 static inline void st_lld_start_alarm(systime_t time) {
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  st_lld_alarm_time    = time;
+  st_lld_alarm_enabled = true;
+#else
   (void)time;
+#endif
 }
 
 /**
@@ -96,6 +115,9 @@ static inline void st_lld_start_alarm(systime_t time) {
  */
 static inline void st_lld_stop_alarm(void) {
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  st_lld_alarm_enabled = false;
+#endif
 }
 
 /**
@@ -107,7 +129,11 @@ static inline void st_lld_stop_alarm(void) {
  */
 static inline void st_lld_set_alarm(systime_t time) {
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  st_lld_alarm_time = time;
+#else
   (void)time;
+#endif
 }
 
 /**
@@ -119,7 +145,11 @@ static inline void st_lld_set_alarm(systime_t time) {
  */
 static inline systime_t st_lld_get_alarm(void) {
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  return st_lld_alarm_time;
+#else
   return (systime_t)0;
+#endif
 }
 
 /**
@@ -133,7 +163,11 @@ static inline systime_t st_lld_get_alarm(void) {
  */
 static inline bool st_lld_is_alarm_active(void) {
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  return st_lld_alarm_enabled;
+#else
   return false;
+#endif
 }
 
 #endif /* HAL_ST_LLD_H */
@@ -0,0 +1,226 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_adc_lld.c
+ * @brief   Posix simulator low level ADC driver code.
+ * @details The converter produces conversion sequences at the rate
+ *          specified in the conversion group, samples are taken from a
+ *          source function or generated as a ramp. Sequences are written
+ *          in the buffer by the interrupts simulation, all the sequences
+ *          due since the previous invocation are converted at once so the
+ *          half and full buffer callbacks can occur back-to-back when the
+ *          simulated CPU is busy, like with a DMA on a loaded system.
+ *
+ * @addtogroup POSIX_ADC
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_ADC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   ADC1 driver identifier.
+ */
+#if (USE_SIM_ADC1 == TRUE) || defined(__DOXYGEN__)
+ADCDriver ADCD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Default analog source.
+ * @details Each channel is a ramp with a slope proportional to the channel
+ *          index.
+ *
+ * @param[in] channel   channel index within the conversion group
+ * @param[in] n         conversion sequence number
+ * @return              The sample value.
+ */
+static adcsample_t adc_ramp(adc_channels_num_t channel, uint64_t n) {
+
+  return (adcsample_t)((n * ((uint64_t)channel + 1U)) & SIM_ADC_MAX_VALUE);
+}
+
+/**
+ * @brief   Converts the sequences due at the specified time.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] now       current time
+ * @return              @p true if a callback has been invoked.
+ */
+static bool adc_serve_interrupt(ADCDriver *adcp, uint64_t now) {
+  const ADCConversionGroup *grpp;
+  simadcsource_t source;
+  uint64_t start, due;
+  bool b = false;
+
+  if (adcp->state != ADC_ACTIVE) {
+    return false;
+  }
+
+  grpp   = adcp->grpp;
+  source = grpp->source != NULL ? grpp->source : adc_ramp;
+  start  = adcp->start_ns;
+  due    = ((now - start) * (uint64_t)grpp->frequency) / 1000000000U;
+
+  while (adcp->sequences < due) {
+    adcsample_t *sp = &adcp->samples[adcp->pos * grpp->num_channels];
+    adc_channels_num_t ch;
+
+    for (ch = 0U; ch < grpp->num_channels; ch++) {
+      sp[ch] = source(ch, adcp->sequences);
+    }
+    adcp->sequences++;
+    adcp->pos++;
+
+    if (adcp->pos >= adcp->depth) {
+      /* The position is rewound before the callback, it could restart
+         the conversion.*/
+      adcp->pos = 0U;
+      _adc_isr_full_code(adcp);
+      b = true;
+    }
+    else if ((adcp->depth > 1U) && (adcp->pos == (adcp->depth / 2U))) {
+      _adc_isr_half_code(adcp);
+      b = true;
+    }
+
+    /* Stopped or restarted from a callback or end of a linear
+       conversion.*/
+    if ((adcp->state != ADC_ACTIVE) || (adcp->start_ns != start)) {
+      break;
+    }
+  }
+
+  return b;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   ADC interrupts simulation.
+ *
+ * @return              @p true if an interrupt has been served.
+ *
+ * @notapi
+ */
+bool adc_lld_interrupt_pending(void) {
+  uint64_t now = _sim_get_time_ns();
+  bool b = false;
+
+  OSAL_IRQ_PROLOGUE();
+
+#if USE_SIM_ADC1
+  b |= adc_serve_interrupt(&ADCD1, now);
+#endif
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level ADC driver initialization.
+ *
+ * @notapi
+ */
+void adc_lld_init(void) {
+
+#if USE_SIM_ADC1
+  adcObjectInit(&ADCD1);
+  ADCD1.start_ns  = 0U;
+  ADCD1.sequences = 0U;
+  ADCD1.pos       = 0U;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the ADC peripheral.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+void adc_lld_start(ADCDriver *adcp) {
+
+  (void)adcp;
+}
+
+/**
+ * @brief   Deactivates the ADC peripheral.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+void adc_lld_stop(ADCDriver *adcp) {
+
+  (void)adcp;
+}
+
+/**
+ * @brief   Starts an ADC conversion.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+void adc_lld_start_conversion(ADCDriver *adcp) {
+
+  osalDbgAssert(adcp->grpp->frequency > 0U, "invalid frequency");
+
+  adcp->start_ns  = _sim_get_time_ns();
+  adcp->sequences = 0U;
+  adcp->pos       = 0U;
+}
+
+/**
+ * @brief   Stops an ongoing conversion.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+void adc_lld_stop_conversion(ADCDriver *adcp) {
+
+  (void)adcp;
+}
+
+#endif /* HAL_USE_ADC == TRUE */
+
+/** @} */
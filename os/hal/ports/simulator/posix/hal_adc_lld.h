@@ -0,0 +1,163 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_adc_lld.h
+ * @brief   Posix simulator low level ADC driver header.
+ *
+ * @addtogroup POSIX_ADC
+ * @{
+ */
+
+#ifndef HAL_ADC_LLD_H
+#define HAL_ADC_LLD_H
+
+#if (HAL_USE_ADC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Possible ADC errors mask bits.
+ * @{
+ */
+#define ADC_ERR_DMAFAILURE      1U  /**< DMA operations failure.            */
+#define ADC_ERR_OVERFLOW        2U  /**< ADC overflow condition.            */
+#define ADC_ERR_AWD             4U  /**< Watchdog triggered.                */
+/** @} */
+
+/**
+ * @brief   Maximum simulated sample value.
+ */
+#define SIM_ADC_MAX_VALUE       4095U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Posix simulator ADC configuration options
+ * @{
+ */
+/**
+ * @brief   ADCD1 driver enable switch.
+ * @details If set to @p TRUE the support for ADCD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_ADC1) || defined(__DOXYGEN__)
+#define USE_SIM_ADC1                        TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !USE_SIM_ADC1
+#error "ADC driver activated but no ADC peripheral assigned"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   ADC sample data type.
+ */
+typedef uint16_t adcsample_t;
+
+/**
+ * @brief   Channels number in a conversion group.
+ */
+typedef uint16_t adc_channels_num_t;
+
+/**
+ * @brief   Type of an ADC error mask.
+ */
+typedef uint32_t adcerror_t;
+
+/**
+ * @brief   Type of a simulated analog source.
+ * @details The function returns the value of a channel in the conversion
+ *          sequence number @p n, counted from the conversion start.
+ * @note    The function is invoked from within the driver, it must not
+ *          invoke any OS API.
+ *
+ * @param[in] channel   channel index within the conversion group
+ * @param[in] n         conversion sequence number
+ * @return              The sample value.
+ */
+typedef adcsample_t (*simadcsource_t)(adc_channels_num_t channel,
+                                      uint64_t n);
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the ADC driver structure.
+ */
+#define adc_lld_driver_fields                                               \
+  /* Conversion start time.*/                                               \
+  uint64_t                  start_ns;                                       \
+  /* Converted sequences since the conversion start.*/                      \
+  uint64_t                  sequences;                                      \
+  /* Next sequence position in the samples buffer.*/                        \
+  size_t                    pos
+
+/**
+ * @brief   Low level fields of the ADC configuration structure.
+ */
+#define adc_lld_config_fields                                               \
+  /* Dummy configuration, it is not needed.*/                               \
+  uint32_t                  dummy
+
+/**
+ * @brief   Low level fields of the ADC conversion group structure.
+ */
+#define adc_lld_configuration_group_fields                                  \
+  /* Conversion sequences per second.*/                                     \
+  uint32_t                  frequency;                                      \
+  /* Analog source or NULL for a ramp on each channel.*/                    \
+  simadcsource_t            source
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if USE_SIM_ADC1 && !defined(__DOXYGEN__)
+extern ADCDriver ADCD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void adc_lld_init(void);
+  void adc_lld_start(ADCDriver *adcp);
+  void adc_lld_stop(ADCDriver *adcp);
+  void adc_lld_start_conversion(ADCDriver *adcp);
+  void adc_lld_stop_conversion(ADCDriver *adcp);
+  bool adc_lld_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_ADC == TRUE */
+
+#endif /* HAL_ADC_LLD_H */
+
+/** @} */
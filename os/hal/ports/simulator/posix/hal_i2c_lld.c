@@ -0,0 +1,472 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_i2c_lld.c
+ * @brief   Posix simulator I2C subsystem low level driver source.
+ * @details Device models are attached to the simulated buses at their
+ *          slave addresses. A transaction is performed on the addressed
+ *          model as soon as it is started, the calling thread is then
+ *          suspended for the time the transaction would take on a real
+ *          bus with the configured clock and latency.
+ *
+ * @addtogroup POSIX_I2C
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Bus clock cycles for each transferred byte, acknowledge included.
+ */
+#define I2C_BYTE_CYCLES                     9U
+
+/**
+ * @brief   Bus clock cycles for start and stop conditions.
+ */
+#define I2C_CONDITION_CYCLES                1U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   I2C1 driver identifier.
+ */
+#if (USE_SIM_I2C1 == TRUE) || defined(__DOXYGEN__)
+I2CDriver I2CD1;
+#endif
+
+/**
+ * @brief   I2C2 driver identifier.
+ */
+#if (USE_SIM_I2C2 == TRUE) || defined(__DOXYGEN__)
+I2CDriver I2CD2;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a bus object.
+ *
+ * @param[out] i2cp     pointer to the @p I2CDriver object
+ */
+static void i2c_bus_init(I2CDriver *i2cp) {
+  unsigned i;
+
+  i2cObjectInit(i2cp);
+  i2cp->end_cb = NULL;
+  i2cp->thread = NULL;
+  for (i = 0U; i < SIM_I2C_MAX_DEVICES; i++) {
+    i2cp->devices[i] = NULL;
+  }
+  i2cp->busy = false;
+  simI2cResetStats(i2cp);
+}
+
+/**
+ * @brief   Finds the model attached at an address.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave address
+ * @return              The model or @p NULL if there is no device at the
+ *                      specified address.
+ */
+static sim_i2c_device_t *i2c_find_device(I2CDriver *i2cp, i2caddr_t addr) {
+  unsigned i;
+
+  for (i = 0U; i < SIM_I2C_MAX_DEVICES; i++) {
+    if ((i2cp->devices[i] != NULL) && (i2cp->addresses[i] == addr)) {
+      return i2cp->devices[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Performs a transaction on the addressed model.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave address
+ * @param[in] txbuf     transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @return              The number of bytes on the bus, addresses included.
+ */
+static size_t i2c_transfer(I2CDriver *i2cp, i2caddr_t addr,
+                           const uint8_t *txbuf, size_t txbytes,
+                           uint8_t *rxbuf, size_t rxbytes) {
+  sim_i2c_device_t *devp = i2c_find_device(i2cp, addr);
+  size_t bytes = 1U;
+  size_t i;
+
+  if (txbytes > 0U) {
+    if ((devp == NULL) || !devp->vmt->start(devp, false)) {
+      i2cp->errors |= I2C_ACK_FAILURE;
+      return bytes;
+    }
+    for (i = 0U; i < txbytes; i++) {
+      bytes++;
+      if (!devp->vmt->write(devp, txbuf[i])) {
+        devp->vmt->stop(devp);
+        i2cp->errors |= I2C_ACK_FAILURE;
+        return bytes;
+      }
+    }
+    if (rxbytes > 0U) {
+      /* Repeated start.*/
+      bytes++;
+    }
+  }
+
+  if (rxbytes > 0U) {
+    if (devp == NULL) {
+      i2cp->errors |= I2C_ACK_FAILURE;
+      return bytes;
+    }
+    if (!devp->vmt->start(devp, true)) {
+      devp->vmt->stop(devp);
+      i2cp->errors |= I2C_ACK_FAILURE;
+      return bytes;
+    }
+    for (i = 0U; i < rxbytes; i++) {
+      bytes++;
+      rxbuf[i] = devp->vmt->read(devp);
+    }
+  }
+
+  devp->vmt->stop(devp);
+
+  return bytes;
+}
+
+/**
+ * @brief   Performs a transaction and schedules its simulated completion.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave address
+ * @param[in] txbuf     transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ */
+static void i2c_start_transaction(I2CDriver *i2cp, i2caddr_t addr,
+                                  const uint8_t *txbuf, size_t txbytes,
+                                  uint8_t *rxbuf, size_t rxbytes) {
+  size_t bytes;
+  uint64_t t;
+
+  bytes = i2c_transfer(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes);
+
+  t = (uint64_t)i2cp->config->latency_ns;
+  if (i2cp->config->clock > 0U) {
+    uint64_t cycles = ((uint64_t)bytes * I2C_BYTE_CYCLES) +
+                      (2U * I2C_CONDITION_CYCLES);
+
+    t += (cycles * 1000000000U) / (uint64_t)i2cp->config->clock;
+  }
+
+  i2cp->stats.transactions++;
+  i2cp->stats.bytes   += (uint64_t)bytes;
+  i2cp->stats.busy_ns += t;
+  if (i2cp->errors != I2C_NO_ERROR) {
+    i2cp->stats.nacks++;
+  }
+
+  i2cp->result   = i2cp->errors != I2C_NO_ERROR ? MSG_RESET : MSG_OK;
+  i2cp->deadline = _sim_get_time_ns() + t;
+  i2cp->busy     = true;
+}
+
+/**
+ * @brief   Performs a transaction and waits for its simulated completion.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave address
+ * @param[in] txbuf     transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The operation status.
+ */
+static msg_t i2c_transaction(I2CDriver *i2cp, i2caddr_t addr,
+                             const uint8_t *txbuf, size_t txbytes,
+                             uint8_t *rxbuf, size_t rxbytes,
+                             sysinterval_t timeout) {
+  msg_t msg;
+
+  i2cp->end_cb = NULL;
+  i2c_start_transaction(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes);
+
+  msg = osalThreadSuspendTimeoutS(&i2cp->thread, timeout);
+  if (msg == MSG_TIMEOUT) {
+    i2cp->busy = false;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Serves the completion of a transaction.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] now       current time
+ * @return              @p true if a transaction has been completed.
+ */
+static bool i2c_serve_interrupt(I2CDriver *i2cp, uint64_t now) {
+
+  if (!i2cp->busy || (now < i2cp->deadline)) {
+    return false;
+  }
+
+  i2cp->busy = false;
+  if (i2cp->end_cb != NULL) {
+    _i2c_isr_code(i2cp);
+  }
+  else if (i2cp->result == MSG_OK) {
+    _i2c_wakeup_isr(i2cp);
+  }
+  else {
+    _i2c_wakeup_error_isr(i2cp);
+  }
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   I2C interrupts simulation.
+ *
+ * @return              @p true if an interrupt has been served.
+ *
+ * @notapi
+ */
+bool i2c_lld_interrupt_pending(void) {
+  uint64_t now = _sim_get_time_ns();
+  bool b = false;
+
+  OSAL_IRQ_PROLOGUE();
+
+#if USE_SIM_I2C1
+  b |= i2c_serve_interrupt(&I2CD1, now);
+#endif
+#if USE_SIM_I2C2
+  b |= i2c_serve_interrupt(&I2CD2, now);
+#endif
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level I2C driver initialization.
+ *
+ * @notapi
+ */
+void i2c_lld_init(void) {
+
+#if USE_SIM_I2C1
+  i2c_bus_init(&I2CD1);
+#endif
+#if USE_SIM_I2C2
+  i2c_bus_init(&I2CD2);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the I2C peripheral.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_start(I2CDriver *i2cp) {
+
+  i2cp->busy = false;
+}
+
+/**
+ * @brief   Deactivates the I2C peripheral.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_stop(I2CDriver *i2cp) {
+
+  i2cp->busy = false;
+}
+
+/**
+ * @brief   Receives data via the I2C bus as master.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end. <b>After a
+ *                      timeout the driver must be stopped and restarted
+ *                      because the bus is in an uncertain state</b>.
+ *
+ * @notapi
+ */
+msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                     uint8_t *rxbuf, size_t rxbytes,
+                                     sysinterval_t timeout) {
+
+  return i2c_transaction(i2cp, addr, NULL, 0U, rxbuf, rxbytes, timeout);
+}
+
+/**
+ * @brief   Transmits data via the I2C bus as master.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end. <b>After a
+ *                      timeout the driver must be stopped and restarted
+ *                      because the bus is in an uncertain state</b>.
+ *
+ * @notapi
+ */
+msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                      const uint8_t *txbuf, size_t txbytes,
+                                      uint8_t *rxbuf, size_t rxbytes,
+                                      sysinterval_t timeout) {
+
+  return i2c_transaction(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes,
+                         timeout);
+}
+
+/**
+ * @brief   Starts an asynchronous transaction via the I2C bus as master.
+ * @post    At the end of the operation the callback is invoked.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ *
+ * @notapi
+ */
+void i2c_lld_start_master_transmit(I2CDriver *i2cp, i2caddr_t addr,
+                                   const uint8_t *txbuf, size_t txbytes,
+                                   uint8_t *rxbuf, size_t rxbytes) {
+
+  i2c_start_transaction(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes);
+}
+
+/**
+ * @brief   Attaches a device model to the bus.
+ * @note    A model already attached at the same address is replaced.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave address of the model
+ * @param[in] devp      pointer to the model or @p NULL for detaching
+ *
+ * @api
+ */
+void simI2cAttachDevice(I2CDriver *i2cp, i2caddr_t addr,
+                        sim_i2c_device_t *devp) {
+  unsigned i, slot = SIM_I2C_MAX_DEVICES;
+
+  osalDbgCheck(i2cp != NULL);
+
+  osalSysLock();
+  for (i = 0U; i < SIM_I2C_MAX_DEVICES; i++) {
+    if (i2cp->devices[i] == NULL) {
+      if (slot == SIM_I2C_MAX_DEVICES) {
+        slot = i;
+      }
+    }
+    else if (i2cp->addresses[i] == addr) {
+      break;
+    }
+  }
+  if (i < SIM_I2C_MAX_DEVICES) {
+    i2cp->devices[i] = devp;
+  }
+  else if (devp != NULL) {
+    osalDbgAssert(slot < SIM_I2C_MAX_DEVICES, "too many devices");
+
+    i2cp->addresses[slot] = addr;
+    i2cp->devices[slot]   = devp;
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Resets the bus statistics.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @api
+ */
+void simI2cResetStats(I2CDriver *i2cp) {
+
+  i2cp->stats.transactions = 0U;
+  i2cp->stats.bytes        = 0U;
+  i2cp->stats.nacks        = 0U;
+  i2cp->stats.busy_ns      = 0U;
+}
+
+#endif /* HAL_USE_I2C == TRUE */
+
+/** @} */
@@ -0,0 +1,307 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_i2c_lld.h
+ * @brief   Posix simulator I2C subsystem low level driver header.
+ *
+ * @addtogroup POSIX_I2C
+ * @{
+ */
+
+#ifndef HAL_I2C_LLD_H
+#define HAL_I2C_LLD_H
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Asynchronous transactions support.
+ */
+#define I2C_SUPPORTS_ASYNC                  TRUE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Posix simulator I2C configuration options
+ * @{
+ */
+/**
+ * @brief   I2CD1 driver enable switch.
+ * @details If set to @p TRUE the support for I2CD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_I2C1) || defined(__DOXYGEN__)
+#define USE_SIM_I2C1                        TRUE
+#endif
+
+/**
+ * @brief   I2CD2 driver enable switch.
+ * @details If set to @p TRUE the support for I2CD2 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(USE_SIM_I2C2) || defined(__DOXYGEN__)
+#define USE_SIM_I2C2                        FALSE
+#endif
+
+/**
+ * @brief   Number of device models attachable to each simulated bus.
+ */
+#if !defined(SIM_I2C_MAX_DEVICES) || defined(__DOXYGEN__)
+#define SIM_I2C_MAX_DEVICES                 8
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !USE_SIM_I2C1 && !USE_SIM_I2C2
+#error "I2C driver activated but no I2C peripheral assigned"
+#endif
+
+#if SIM_I2C_MAX_DEVICES < 1
+#error "invalid SIM_I2C_MAX_DEVICES value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type representing an I2C address.
+ */
+typedef uint16_t i2caddr_t;
+
+/**
+ * @brief   Type of I2C driver condition flags.
+ */
+typedef uint32_t i2cflags_t;
+
+/**
+ * @brief   Type of a simulated I2C device.
+ */
+typedef struct sim_i2c_device sim_i2c_device_t;
+
+/**
+ * @brief   Simulated I2C device model methods.
+ * @note    Methods are invoked from within the driver, the model must not
+ *          invoke any OS API.
+ */
+typedef struct {
+  /**
+   * @brief   Start or repeated start condition addressing the device.
+   * @details Returning @p false does not acknowledge the address.
+   */
+  bool (*start)(sim_i2c_device_t *devp, bool read);
+  /**
+   * @brief   Byte written by the master.
+   * @details Returning @p false does not acknowledge the byte.
+   */
+  bool (*write)(sim_i2c_device_t *devp, uint8_t data);
+  /**
+   * @brief   Byte read by the master.
+   */
+  uint8_t (*read)(sim_i2c_device_t *devp);
+  /**
+   * @brief   Stop condition.
+   */
+  void (*stop)(sim_i2c_device_t *devp);
+} sim_i2c_device_vmt_t;
+
+/**
+ * @brief   Simulated I2C device model.
+ * @note    This structure is meant to be the first field of the models
+ *          implementations.
+ */
+struct sim_i2c_device {
+  /**
+   * @brief   Model methods.
+   */
+  const sim_i2c_device_vmt_t *vmt;
+};
+
+/**
+ * @brief   Simulated I2C bus statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Performed transactions.
+   */
+  uint32_t                  transactions;
+  /**
+   * @brief   Transferred bytes, addresses included.
+   */
+  uint64_t                  bytes;
+  /**
+   * @brief   Transactions terminated by a missing acknowledge.
+   */
+  uint32_t                  nacks;
+  /**
+   * @brief   Time spent by the bus in transactions, in nanoseconds.
+   */
+  uint64_t                  busy_ns;
+} sim_i2c_stats_t;
+
+/**
+ * @brief   Type of I2C driver configuration structure.
+ */
+typedef struct hal_i2c_config {
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Bus clock in Hz, zero for instantaneous transactions.
+   */
+  uint32_t                  clock;
+  /**
+   * @brief   Fixed latency of each transaction in nanoseconds.
+   */
+  uint32_t                  latency_ns;
+} I2CConfig;
+
+/**
+ * @brief   Type of a structure representing an I2C driver.
+ */
+typedef struct hal_i2c_driver I2CDriver;
+
+/**
+ * @brief   Structure representing an I2C driver.
+ */
+struct hal_i2c_driver {
+  /**
+   * @brief   Driver state.
+   */
+  i2cstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const I2CConfig           *config;
+  /**
+   * @brief   Error flags.
+   */
+  i2cflags_t                errors;
+#if (I2C_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the bus.
+   */
+  mutex_t                   mutex;
+#endif
+#if defined(I2C_DRIVER_EXT_FIELDS)
+  I2C_DRIVER_EXT_FIELDS
+#endif
+  /**
+   * @brief   Callback of the asynchronous transaction in progress.
+   * @note    It is @p NULL during synchronous transactions.
+   */
+  i2ccallback_t             end_cb;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Thread waiting for the transaction completion.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Addresses of the attached models.
+   */
+  i2caddr_t                 addresses[SIM_I2C_MAX_DEVICES];
+  /**
+   * @brief   Attached models.
+   */
+  sim_i2c_device_t          *devices[SIM_I2C_MAX_DEVICES];
+  /**
+   * @brief   Transaction in progress.
+   */
+  bool                      busy;
+  /**
+   * @brief   Completion time of the transaction in progress.
+   */
+  uint64_t                  deadline;
+  /**
+   * @brief   Result of the transaction in progress.
+   */
+  msg_t                     result;
+  /**
+   * @brief   Bus statistics.
+   */
+  sim_i2c_stats_t           stats;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Get errors from I2C driver.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define i2c_lld_get_errors(i2cp) ((i2cp)->errors)
+
+/**
+ * @brief   Returns the bus statistics.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @return              A pointer to the @p sim_i2c_stats_t structure.
+ *
+ * @xclass
+ */
+#define simI2cGetStatsX(i2cp) (&(i2cp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if USE_SIM_I2C1 && !defined(__DOXYGEN__)
+extern I2CDriver I2CD1;
+#endif
+#if USE_SIM_I2C2 && !defined(__DOXYGEN__)
+extern I2CDriver I2CD2;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void i2c_lld_init(void);
+  void i2c_lld_start(I2CDriver *i2cp);
+  void i2c_lld_stop(I2CDriver *i2cp);
+  msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                        const uint8_t *txbuf, size_t txbytes,
+                                        uint8_t *rxbuf, size_t rxbytes,
+                                        sysinterval_t timeout);
+  msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                       uint8_t *rxbuf, size_t rxbytes,
+                                       sysinterval_t timeout);
+  void i2c_lld_start_master_transmit(I2CDriver *i2cp, i2caddr_t addr,
+                                     const uint8_t *txbuf, size_t txbytes,
+                                     uint8_t *rxbuf, size_t rxbytes);
+  bool i2c_lld_interrupt_pending(void);
+  void simI2cAttachDevice(I2CDriver *i2cp, i2caddr_t addr,
+                          sim_i2c_device_t *devp);
+  void simI2cResetStats(I2CDriver *i2cp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_I2C == TRUE */
+
+#endif /* HAL_I2C_LLD_H */
+
+/** @} */
@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include "hal.h"
 
@@ -36,8 +37,10 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
 static struct timeval nextcnt;
 static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
+#endif
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
@@ -61,15 +64,36 @@ void hal_lld_init(void) {
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
   gettimeofday(&nextcnt, NULL);
   timeradd(&nextcnt, &tick, &nextcnt);
+#endif
+}
+
+/**
+ * @brief   Returns the host monotonic time.
+ * @details Simulated peripherals use this time base for timing their
+ *          operations.
+ *
+ * @return              The time in nanoseconds.
+ *
+ * @notapi
+ */
+uint64_t _sim_get_time_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
 }
 
 /**
  * @brief   Interrupt simulation.
  */
 void _sim_check_for_interrupts(void) {
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
   struct timeval tv;
+#endif
   bool int_occurred = false;
 
 #if HAL_USE_SERIAL
@@ -78,6 +102,37 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
+#if HAL_USE_MAC
+  if (mac_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_SPI
+  if (spi_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_I2C
+  if (i2c_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_ADC
+  if (adc_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if defined(SIM_EXTRA_INTERRUPTS_HANDLER)
+  if (SIM_EXTRA_INTERRUPTS_HANDLER()) {
+    int_occurred = true;
+  }
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
   gettimeofday(&tv, NULL);
   if (timercmp(&tv, &nextcnt, >=)) {
     int_occurred = true;
@@ -91,12 +146,31 @@ void _sim_check_for_interrupts(void) {
 
     CH_IRQ_EPILOGUE();
   }
+#elif OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  /* The alarm fires when the counter reaches or passes the programmed
+     time, the comparison is done modulo the counter width.*/
+  if (st_lld_alarm_enabled &&
+      ((systime_t)(st_lld_get_counter() - st_lld_alarm_time) <
+       (systime_t)(((systime_t)-1) / 2U))) {
+    int_occurred = true;
+
+    CH_IRQ_PROLOGUE();
+
+    chSysLockFromISR();
+    chSysTimerHandlerI();
+    chSysUnlockFromISR();
+
+    CH_IRQ_EPILOGUE();
+  }
+#endif
 
+  /* Preemption is performed under the kernel lock, in SMP configurations
+     other cores could be accessing the ready list.*/
   if (int_occurred) {
-    __dbg_check_lock();
+    chSysLock();
     if (chSchIsPreemptionRequired())
       chSchDoPreemption();
-    __dbg_check_unlock();
+    chSysUnlock();
   }
 }
 
@@ -33,6 +33,7 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/time.h>
 #endif
 #include <stdio.h>
 
@@ -53,6 +54,17 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Additional simulated interrupt sources.
+ * @details If defined, this is the name of a function invoked by the
+ *          interrupts simulation loop, the function is meant to poll
+ *          external sources not handled by HAL drivers and must return
+ *          @p true if an interrupt has been served.
+ */
+#if defined(__DOXYGEN__)
+#define SIM_EXTRA_INTERRUPTS_HANDLER        sb_sim_interrupt_pending
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -69,7 +81,11 @@
 extern "C" {
 #endif
   void hal_lld_init(void);
+  uint64_t _sim_get_time_ns(void);
   void _sim_check_for_interrupts(void);
+#if defined(SIM_EXTRA_INTERRUPTS_HANDLER)
+  bool SIM_EXTRA_INTERRUPTS_HANDLER(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
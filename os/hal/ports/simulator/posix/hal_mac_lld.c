@@ -0,0 +1,915 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_mac_lld.c
+ * @brief   Posix simulator MAC subsystem low level driver code.
+ * @details The driver simulates a MAC with a descriptors ring, frames are
+ *          exchanged with the following backends:
+ *          - An in-process virtual switch connecting all the simulated
+ *            nodes, unicast frames are forwarded using a learning address
+ *            table, broadcast, multicast and unknown destinations are
+ *            flooded to all the other nodes.
+ *          - A loopback returning all transmitted frames to the same node.
+ *          - A pcap file replayed as incoming traffic.
+ *          .
+ *          Any node can also capture its whole traffic into a pcap file.
+ *
+ * @addtogroup POSIX_MAC
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if HAL_USE_MAC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define PCAP_MAGIC_USEC             0xA1B2C3D4U
+#define PCAP_MAGIC_USEC_SWAPPED     0xD4C3B2A1U
+#define PCAP_MAGIC_NSEC             0xA1B23C4DU
+#define PCAP_MAGIC_NSEC_SWAPPED     0x4D3CB2A1U
+#define PCAP_LINKTYPE_ETHERNET      1U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief MAC driver 1 identifier.*/
+#if USE_SIM_MAC1 || defined(__DOXYGEN__)
+MACDriver ETHD1;
+#endif
+
+/** @brief MAC driver 2 identifier.*/
+#if USE_SIM_MAC2 || defined(__DOXYGEN__)
+MACDriver ETHD2;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   pcap file header.
+ */
+typedef struct {
+  uint32_t                  magic;
+  uint16_t                  version_major;
+  uint16_t                  version_minor;
+  int32_t                   thiszone;
+  uint32_t                  sigfigs;
+  uint32_t                  snaplen;
+  uint32_t                  network;
+} pcap_file_header_t;
+
+/**
+ * @brief   pcap record header.
+ */
+typedef struct {
+  uint32_t                  ts_sec;
+  uint32_t                  ts_frac;
+  uint32_t                  incl_len;
+  uint32_t                  orig_len;
+} pcap_record_header_t;
+
+/**
+ * @brief   Virtual switch address table entry.
+ */
+typedef struct {
+  uint8_t                   address[6];
+  MACDriver                 *port;
+} sim_switch_entry_t;
+
+/**
+ * @brief   All the simulated nodes.
+ */
+static MACDriver * const nodes[] = {
+#if USE_SIM_MAC1
+  &ETHD1,
+#endif
+#if USE_SIM_MAC2
+  &ETHD2,
+#endif
+};
+
+#define NUM_NODES (sizeof (nodes) / sizeof (nodes[0]))
+
+/**
+ * @brief   Frame buffers, initially assigned to the nodes descriptors.
+ */
+static uint8_t mac_buffers[NUM_NODES]
+                          [SIM_MAC_TRANSMIT_BUFFERS + SIM_MAC_RECEIVE_BUFFERS]
+                          [SIM_MAC_BUFFERS_SIZE];
+
+/**
+ * @brief   Virtual switch learned addresses.
+ */
+static sim_switch_entry_t switch_table[SIM_MAC_SWITCH_TABLE_SIZE];
+
+/**
+ * @brief   Next address table entry to be replaced.
+ */
+static unsigned switch_victim;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static uint32_t swap32(uint32_t x) {
+
+  return ((x & 0x000000FFU) << 24) | ((x & 0x0000FF00U) << 8) |
+         ((x & 0x00FF0000U) >> 8)  | ((x & 0xFF000000U) >> 24);
+}
+
+static bool is_multicast(const uint8_t *frame) {
+
+  return (frame[0] & 1U) != 0U;
+}
+
+static void pcap_write_header(FILE *f) {
+  pcap_file_header_t hdr;
+
+  hdr.magic         = PCAP_MAGIC_USEC;
+  hdr.version_major = 2U;
+  hdr.version_minor = 4U;
+  hdr.thiszone      = 0;
+  hdr.sigfigs       = 0U;
+  hdr.snaplen       = SIM_MAC_BUFFERS_SIZE;
+  hdr.network       = PCAP_LINKTYPE_ETHERNET;
+  (void) fwrite(&hdr, sizeof (hdr), 1, f);
+}
+
+static void pcap_write_frame(FILE *f, const uint8_t *frame, size_t n) {
+  pcap_record_header_t rec;
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  rec.ts_sec   = (uint32_t)tv.tv_sec;
+  rec.ts_frac  = (uint32_t)tv.tv_usec;
+  rec.incl_len = (uint32_t)n;
+  rec.orig_len = (uint32_t)n;
+  (void) fwrite(&rec, sizeof (rec), 1, f);
+  (void) fwrite(frame, 1, n, f);
+}
+
+/**
+ * @brief   Reads the next replayed frame into the holding buffer.
+ * @note    Frames not fitting the buffers are skipped. The replay file is
+ *          closed on EOF or on error.
+ */
+static void pcap_read_frame(MACDriver *macp) {
+  pcap_record_header_t rec;
+
+  macp->replay_valid = false;
+  while (fread(&rec, sizeof (rec), 1, macp->replay) == 1) {
+    if (macp->replay_swapped) {
+      rec.ts_sec   = swap32(rec.ts_sec);
+      rec.ts_frac  = swap32(rec.ts_frac);
+      rec.incl_len = swap32(rec.incl_len);
+    }
+    if (rec.incl_len > SIM_MAC_BUFFERS_SIZE) {
+      if (fseek(macp->replay, (long)rec.incl_len, SEEK_CUR) != 0) {
+        break;
+      }
+      continue;
+    }
+    if (fread(macp->replay_frame, 1, rec.incl_len, macp->replay) !=
+        rec.incl_len) {
+      break;
+    }
+    macp->replay_size       = (size_t)rec.incl_len;
+    macp->replay_ts.tv_sec  = (time_t)rec.ts_sec;
+    macp->replay_ts.tv_usec = (suseconds_t)(macp->replay_nsec ?
+                                            rec.ts_frac / 1000U :
+                                            rec.ts_frac);
+    macp->replay_valid      = true;
+    return;
+  }
+
+  fclose(macp->replay);
+  macp->replay = NULL;
+}
+
+static bool pcap_open_replay(MACDriver *macp, const char *path) {
+  pcap_file_header_t hdr;
+
+  macp->replay = fopen(path, "rb");
+  if (macp->replay == NULL) {
+    printf("%s: Error opening replay file %s\n", macp->name, path);
+    return false;
+  }
+
+  if (fread(&hdr, sizeof (hdr), 1, macp->replay) != 1) {
+    goto abort;
+  }
+
+  switch (hdr.magic) {
+  case PCAP_MAGIC_USEC:
+  case PCAP_MAGIC_NSEC:
+    macp->replay_swapped = false;
+    break;
+  case PCAP_MAGIC_USEC_SWAPPED:
+  case PCAP_MAGIC_NSEC_SWAPPED:
+    macp->replay_swapped = true;
+    hdr.network = swap32(hdr.network);
+    break;
+  default:
+    goto abort;
+  }
+  macp->replay_nsec = (hdr.magic == PCAP_MAGIC_NSEC) ||
+                      (hdr.magic == PCAP_MAGIC_NSEC_SWAPPED);
+
+  if (hdr.network != PCAP_LINKTYPE_ETHERNET) {
+    goto abort;
+  }
+
+  /* Pre-loading the first frame, its timestamp is the replay time base.*/
+  pcap_read_frame(macp);
+  if (macp->replay_valid) {
+    gettimeofday(&macp->replay_t0, NULL);
+    macp->replay_c0 = macp->replay_ts;
+  }
+  return true;
+
+abort:
+  printf("%s: Invalid replay file %s\n", macp->name, path);
+  fclose(macp->replay);
+  macp->replay = NULL;
+  return false;
+}
+
+/**
+ * @brief   Address filter of a node.
+ */
+static bool mac_accept(MACDriver *macp, const uint8_t *frame) {
+
+  return is_multicast(frame) || (memcmp(frame, macp->address, 6) == 0);
+}
+
+/**
+ * @brief   Returns the next free receive descriptor of a node.
+ *
+ * @return              The descriptor or @p NULL if the ring is full, in
+ *                      which case an overrun is accounted.
+ */
+static sim_mac_slot_t *mac_rx_slot(MACDriver *macp) {
+  sim_mac_slot_t *slot = &macp->rxd[macp->rxfill];
+
+  if (slot->state != SIM_MAC_SLOT_FREE) {
+    macp->stats.rx_overruns++;
+    return NULL;
+  }
+
+  return slot;
+}
+
+/**
+ * @brief   Commits a frame written into a receive descriptor.
+ */
+static void mac_rx_commit(MACDriver *macp, sim_mac_slot_t *slot, size_t n) {
+
+  if (macp->capture != NULL) {
+    pcap_write_frame(macp->capture, slot->buffer, n);
+  }
+
+  slot->size   = n;
+  slot->state  = SIM_MAC_SLOT_READY;
+  macp->rxfill = (macp->rxfill + 1U) % SIM_MAC_RECEIVE_BUFFERS;
+  macp->rxpending = true;
+  macp->stats.rx_frames++;
+  macp->stats.rx_bytes += n;
+}
+
+/**
+ * @brief   Copies a frame into the receive ring of a node.
+ */
+static void mac_rx_copy(MACDriver *macp, const uint8_t *frame, size_t n) {
+  sim_mac_slot_t *slot = mac_rx_slot(macp);
+
+  if (slot != NULL) {
+    memcpy(slot->buffer, frame, n);
+    mac_rx_commit(macp, slot, n);
+  }
+}
+
+/**
+ * @brief   Moves a transmitted frame into the receive ring of a node.
+ * @details The buffers of the transmit and receive descriptors are swapped
+ *          or the frame is copied, depending on configuration.
+ */
+static void mac_rx_handoff(MACDriver *macp, sim_mac_slot_t *txslot) {
+#if SIM_MAC_SWITCH_ZERO_COPY
+  sim_mac_slot_t *slot = mac_rx_slot(macp);
+
+  if (slot != NULL) {
+    uint8_t *buffer = slot->buffer;
+
+    slot->buffer   = txslot->buffer;
+    txslot->buffer = buffer;
+    macp->stats.zero_copy_handoffs++;
+    mac_rx_commit(macp, slot, txslot->size);
+  }
+#else
+  mac_rx_copy(macp, txslot->buffer, txslot->size);
+#endif
+}
+
+/**
+ * @brief   Virtual switch address lookup and learning.
+ */
+static MACDriver *switch_lookup(MACDriver *src, const uint8_t *frame) {
+  MACDriver *dst = NULL;
+  bool learned = false;
+  unsigned i;
+
+  for (i = 0U; i < SIM_MAC_SWITCH_TABLE_SIZE; i++) {
+    sim_switch_entry_t *ep = &switch_table[i];
+
+    if (ep->port == NULL) {
+      continue;
+    }
+    if (memcmp(ep->address, frame, 6) == 0) {
+      dst = ep->port;
+    }
+    if (memcmp(ep->address, frame + 6, 6) == 0) {
+      ep->port = src;
+      learned  = true;
+    }
+  }
+
+  /* Learning the source address, the oldest entry is replaced if the
+     table is full.*/
+  if (!learned && !is_multicast(frame + 6)) {
+    sim_switch_entry_t *ep = &switch_table[switch_victim];
+
+    memcpy(ep->address, frame + 6, 6);
+    ep->port      = src;
+    switch_victim = (switch_victim + 1U) % SIM_MAC_SWITCH_TABLE_SIZE;
+  }
+
+  return dst;
+}
+
+/**
+ * @brief   Forwards a frame through the virtual switch.
+ */
+static void switch_forward(MACDriver *src, sim_mac_slot_t *txslot) {
+  const uint8_t *frame = txslot->buffer;
+  MACDriver *dst;
+  unsigned i;
+
+  if (txslot->size < 14U) {
+    return;
+  }
+
+  dst = switch_lookup(src, frame);
+  if (!is_multicast(frame) && (dst != NULL)) {
+    if ((dst != src) && (dst->state == MAC_ACTIVE) && dst->link_up &&
+        (dst->config->backend == SIM_MAC_BACKEND_SWITCH) &&
+        mac_accept(dst, frame)) {
+      mac_rx_handoff(dst, txslot);
+    }
+    return;
+  }
+
+  /* Flooding.*/
+  for (i = 0U; i < NUM_NODES; i++) {
+    dst = nodes[i];
+    if ((dst != src) && (dst->state == MAC_ACTIVE) && dst->link_up &&
+        (dst->config->backend == SIM_MAC_BACKEND_SWITCH) &&
+        mac_accept(dst, frame)) {
+      mac_rx_copy(dst, frame, txslot->size);
+    }
+  }
+}
+
+/**
+ * @brief   Transfers replayed frames whose time has come.
+ */
+static void replay_serve(MACDriver *macp) {
+
+  while (macp->replay_valid) {
+    if (macp->config->pcap_realtime) {
+      struct timeval now, elapsed, offset;
+
+      gettimeofday(&now, NULL);
+      timersub(&now, &macp->replay_t0, &elapsed);
+      timersub(&macp->replay_ts, &macp->replay_c0, &offset);
+      if (timercmp(&elapsed, &offset, <)) {
+        return;
+      }
+    }
+
+    if (macp->rxd[macp->rxfill].state != SIM_MAC_SLOT_FREE) {
+      /* No overrun accounting here, the frame is held until there is
+         space in the ring.*/
+      return;
+    }
+
+    mac_rx_copy(macp, macp->replay_frame, macp->replay_size);
+    pcap_read_frame(macp);
+  }
+}
+
+static void mac_close_files(MACDriver *macp) {
+
+  if (macp->replay != NULL) {
+    fclose(macp->replay);
+    macp->replay = NULL;
+  }
+  macp->replay_valid = false;
+  if (macp->capture != NULL) {
+    fclose(macp->capture);
+    macp->capture = NULL;
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level MAC initialization.
+ *
+ * @notapi
+ */
+void mac_lld_init(void) {
+  unsigned i, j;
+
+  for (i = 0U; i < NUM_NODES; i++) {
+    MACDriver *macp = nodes[i];
+
+    macObjectInit(macp);
+    macp->link_up   = false;
+    macp->rxpending = false;
+    macp->txpending = false;
+    macp->replay    = NULL;
+    macp->capture   = NULL;
+    macp->replay_valid = false;
+    for (j = 0U; j < SIM_MAC_TRANSMIT_BUFFERS; j++) {
+      macp->txd[j].state  = SIM_MAC_SLOT_FREE;
+      macp->txd[j].size   = 0U;
+      macp->txd[j].buffer = mac_buffers[i][j];
+    }
+    for (j = 0U; j < SIM_MAC_RECEIVE_BUFFERS; j++) {
+      macp->rxd[j].state  = SIM_MAC_SLOT_FREE;
+      macp->rxd[j].size   = 0U;
+      macp->rxd[j].buffer = mac_buffers[i][SIM_MAC_TRANSMIT_BUFFERS + j];
+    }
+  }
+
+#if USE_SIM_MAC1
+  ETHD1.name = "ETHD1";
+#endif
+#if USE_SIM_MAC2
+  ETHD2.name = "ETHD2";
+#endif
+}
+
+/**
+ * @brief   Configures and activates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+msg_t mac_lld_start(MACDriver *macp) {
+  const MACConfig *config = macp->config;
+  unsigned i;
+
+  if (config->mac_address != NULL) {
+    memcpy(macp->address, config->mac_address, 6);
+  }
+
+  /* Descriptors reset.*/
+  for (i = 0U; i < SIM_MAC_TRANSMIT_BUFFERS; i++) {
+    macp->txd[i].state = SIM_MAC_SLOT_FREE;
+  }
+  for (i = 0U; i < SIM_MAC_RECEIVE_BUFFERS; i++) {
+    macp->rxd[i].state = SIM_MAC_SLOT_FREE;
+  }
+  macp->txnext    = 0U;
+  macp->rxfill    = 0U;
+  macp->rxnext    = 0U;
+  macp->rxpending = false;
+  macp->txpending = false;
+  memset(&macp->stats, 0, sizeof (macp->stats));
+
+  if (config->backend == SIM_MAC_BACKEND_PCAP) {
+    if ((config->pcap_replay == NULL) ||
+        !pcap_open_replay(macp, config->pcap_replay)) {
+      return HAL_RET_CONFIG_ERROR;
+    }
+  }
+  else if (config->backend > SIM_MAC_BACKEND_PCAP) {
+    return HAL_RET_CONFIG_ERROR;
+  }
+
+  if (config->pcap_capture != NULL) {
+    macp->capture = fopen(config->pcap_capture, "wb");
+    if (macp->capture == NULL) {
+      printf("%s: Error creating capture file %s\n",
+             macp->name, config->pcap_capture);
+      mac_close_files(macp);
+      return HAL_RET_CONFIG_ERROR;
+    }
+    pcap_write_header(macp->capture);
+  }
+
+  macp->link_up = true;
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Deactivates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_stop(MACDriver *macp) {
+  unsigned i;
+
+  if (macp->state == MAC_ACTIVE) {
+    mac_close_files(macp);
+    macp->link_up = false;
+
+    /* Forgetting the addresses learned on this port.*/
+    for (i = 0U; i < SIM_MAC_SWITCH_TABLE_SIZE; i++) {
+      if (switch_table[i].port == macp) {
+        switch_table[i].port = NULL;
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Returns a transmission descriptor.
+ * @details One of the available transmission descriptors is locked and
+ *          returned.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tdp      pointer to a @p MACTransmitDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                      MACTransmitDescriptor *tdp) {
+  sim_mac_slot_t *slot;
+
+  if (!macp->link_up) {
+    return MSG_TIMEOUT;
+  }
+
+  slot = &macp->txd[macp->txnext];
+  if (slot->state != SIM_MAC_SLOT_FREE) {
+    return MSG_TIMEOUT;
+  }
+
+  slot->state  = SIM_MAC_SLOT_LOCKED;
+  macp->txnext = (macp->txnext + 1U) % SIM_MAC_TRANSMIT_BUFFERS;
+
+  tdp->offset  = 0U;
+  tdp->size    = SIM_MAC_BUFFERS_SIZE;
+  tdp->macp    = macp;
+  tdp->slot    = slot;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a transmit descriptor and starts the transmission of the
+ *          enqueued data as a single frame.
+ * @note    The simulated transmission is completed synchronously, the
+ *          frame is delivered to the backend before returning.
+ *
+ * @param[in] tdp       the pointer to the @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
+  MACDriver *macp = tdp->macp;
+  sim_mac_slot_t *slot = tdp->slot;
+
+  osalDbgAssert(slot->state == SIM_MAC_SLOT_LOCKED,
+                "attempt to release a descriptor not locked");
+
+  osalSysLock();
+
+  slot->size = tdp->offset;
+  macp->stats.tx_frames++;
+  macp->stats.tx_bytes += slot->size;
+
+  if (macp->capture != NULL) {
+    pcap_write_frame(macp->capture, slot->buffer, slot->size);
+  }
+
+  switch (macp->config->backend) {
+  case SIM_MAC_BACKEND_SWITCH:
+    switch_forward(macp, slot);
+    break;
+  case SIM_MAC_BACKEND_LOOPBACK:
+    mac_rx_handoff(macp, slot);
+    break;
+  default:
+    /* Frames are only captured.*/
+    break;
+  }
+
+  slot->state = SIM_MAC_SLOT_FREE;
+  macp->txpending = true;
+
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns a receive descriptor.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] rdp      pointer to a @p MACReceiveDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+  sim_mac_slot_t *slot = &macp->rxd[macp->rxnext];
+
+  if (slot->state != SIM_MAC_SLOT_READY) {
+    return MSG_TIMEOUT;
+  }
+
+  slot->state  = SIM_MAC_SLOT_LOCKED;
+  macp->rxnext = (macp->rxnext + 1U) % SIM_MAC_RECEIVE_BUFFERS;
+
+  rdp->offset  = 0U;
+  rdp->size    = slot->size;
+  rdp->macp    = macp;
+  rdp->slot    = slot;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a receive descriptor.
+ * @details The descriptor and its buffer are made available for more incoming
+ *          frames.
+ *
+ * @param[in] rdp       the pointer to the @p MACReceiveDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp) {
+
+  osalDbgAssert(rdp->slot->state == SIM_MAC_SLOT_LOCKED,
+                "attempt to release a descriptor not locked");
+
+  osalSysLock();
+  rdp->slot->state = SIM_MAC_SLOT_FREE;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Updates and returns the link status.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ * @retval true         if the link is active.
+ * @retval false        if the link is down.
+ *
+ * @notapi
+ */
+bool mac_lld_poll_link_status(MACDriver *macp) {
+
+  return macp->link_up;
+}
+
+/**
+ * @brief   Writes to a transmit descriptor's stream.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer containing the data to be
+ *                      written
+ * @param[in] size      number of bytes to be written
+ * @return              The number of bytes written into the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if the maximum
+ *                      frame size is reached.
+ *
+ * @notapi
+ */
+size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                         uint8_t *buf,
+                                         size_t size) {
+
+  osalDbgAssert(tdp->slot->state == SIM_MAC_SLOT_LOCKED,
+                "attempt to write descriptor not locked");
+
+  if (size > tdp->size - tdp->offset) {
+    size = tdp->size - tdp->offset;
+  }
+
+  if (size > 0U) {
+    memcpy(tdp->slot->buffer + tdp->offset, buf, size);
+    tdp->offset += size;
+  }
+  return size;
+}
+
+/**
+ * @brief   Reads from a receive descriptor's stream.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[in] buf       pointer to the buffer that will receive the read data
+ * @param[in] size      number of bytes to be read
+ * @return              The number of bytes read from the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if there are
+ *                      no more bytes to read.
+ *
+ * @notapi
+ */
+size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                       uint8_t *buf,
+                                       size_t size) {
+
+  osalDbgAssert(rdp->slot->state == SIM_MAC_SLOT_LOCKED,
+                "attempt to read descriptor not locked");
+
+  if (size > rdp->size - rdp->offset) {
+    size = rdp->size - rdp->offset;
+  }
+
+  if (size > 0U) {
+    memcpy(buf, rdp->slot->buffer + rdp->offset, size);
+    rdp->offset += size;
+  }
+  return size;
+}
+
+#if MAC_USE_ZERO_COPY || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a pointer to the next transmit buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that enough buffers can be requested to fill
+ *          a whole frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] size      size of the requested buffer. Specify the frame size
+ *                      on the first call then scale the value down subtracting
+ *                      the amount of data already copied into the previous
+ *                      buffers.
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ *                      Note that a returned size lower than the amount
+ *                      requested means that more buffers must be requested
+ *                      in order to fill the frame data entirely.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                          size_t size,
+                                          size_t *sizep) {
+
+  if (tdp->offset == 0U) {
+    *sizep      = tdp->size;
+    tdp->offset = size;
+    return tdp->slot->buffer;
+  }
+  *sizep = 0U;
+  return NULL;
+}
+
+/**
+ * @brief   Returns a pointer to the next receive buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that the descriptor chain contains a whole
+ *          frame.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                               size_t *sizep) {
+
+  if (rdp->size > 0U) {
+    *sizep      = rdp->size;
+    rdp->offset = rdp->size;
+    rdp->size   = 0U;
+    return rdp->slot->buffer;
+  }
+  *sizep = 0U;
+  return NULL;
+}
+#endif /* MAC_USE_ZERO_COPY */
+
+/**
+ * @brief   Interrupt simulation.
+ * @details Serves the replay backends then signals received frames and
+ *          freed transmit descriptors to the waiting threads.
+ *
+ * @return              @p true if an interrupt has been served.
+ *
+ * @notapi
+ */
+bool mac_lld_interrupt_pending(void) {
+  bool b = false;
+  unsigned i;
+
+  OSAL_IRQ_PROLOGUE();
+
+  for (i = 0U; i < NUM_NODES; i++) {
+    MACDriver *macp = nodes[i];
+
+    if (macp->state != MAC_ACTIVE) {
+      continue;
+    }
+
+    osalSysLockFromISR();
+
+    if (macp->link_up && (macp->replay != NULL)) {
+      replay_serve(macp);
+    }
+
+    if (macp->rxpending) {
+      macp->rxpending = false;
+      osalThreadDequeueAllI(&macp->rdqueue, MSG_RESET);
+#if MAC_USE_EVENTS
+      osalEventBroadcastFlagsI(&macp->rdevent, 0);
+#endif
+      b = true;
+    }
+
+    if (macp->txpending) {
+      macp->txpending = false;
+      osalThreadDequeueAllI(&macp->tdqueue, MSG_RESET);
+      b = true;
+    }
+
+    osalSysUnlockFromISR();
+  }
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/**
+ * @brief   Changes the link status of a simulated node.
+ * @details Frames are neither transmitted nor received while the link is
+ *          down.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] up        the new link status
+ *
+ * @api
+ */
+void simMacSetLinkStatus(MACDriver *macp, bool up) {
+
+  osalDbgCheck(macp != NULL);
+
+  osalSysLock();
+  if (macp->state == MAC_ACTIVE) {
+    macp->link_up = up;
+  }
+  osalSysUnlock();
+}
+
+#endif /* HAL_USE_MAC */
+
+/** @} */
@@ -0,0 +1,458 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_mac_lld.h
+ * @brief   Posix simulator MAC subsystem low level driver header.
+ *
+ * @addtogroup POSIX_MAC
+ * @{
+ */
+
+#ifndef HAL_MAC_LLD_H
+#define HAL_MAC_LLD_H
+
+#if HAL_USE_MAC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This implementation supports the zero-copy mode API.
+ */
+#define MAC_SUPPORTS_ZERO_COPY              TRUE
+
+/**
+ * @brief   This implementation returns a status from @p mac_lld_start().
+ */
+#define MAC_LLD_ENHANCED_API
+
+/**
+ * @name    Simulated descriptor states
+ * @{
+ */
+#define SIM_MAC_SLOT_FREE                   0U
+#define SIM_MAC_SLOT_READY                  1U
+#define SIM_MAC_SLOT_LOCKED                 2U
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Posix simulator MAC configuration options
+ * @{
+ */
+/**
+ * @brief   ETHD1 driver enable switch.
+ * @details If set to @p TRUE the support for ETHD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_MAC1) || defined(__DOXYGEN__)
+#define USE_SIM_MAC1                        TRUE
+#endif
+
+/**
+ * @brief   ETHD2 driver enable switch.
+ * @details If set to @p TRUE the support for ETHD2 is included, ETHD2 is
+ *          a second simulated node sharing the virtual switch with ETHD1.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(USE_SIM_MAC2) || defined(__DOXYGEN__)
+#define USE_SIM_MAC2                        FALSE
+#endif
+
+/**
+ * @brief   Number of available transmit buffers.
+ */
+#if !defined(SIM_MAC_TRANSMIT_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_TRANSMIT_BUFFERS            2
+#endif
+
+/**
+ * @brief   Number of available receive buffers.
+ */
+#if !defined(SIM_MAC_RECEIVE_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_RECEIVE_BUFFERS             4
+#endif
+
+/**
+ * @brief   Maximum supported frame size.
+ */
+#if !defined(SIM_MAC_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define SIM_MAC_BUFFERS_SIZE                1524
+#endif
+
+/**
+ * @brief   Number of entries in the virtual switch address table.
+ */
+#if !defined(SIM_MAC_SWITCH_TABLE_SIZE) || defined(__DOXYGEN__)
+#define SIM_MAC_SWITCH_TABLE_SIZE           16
+#endif
+
+/**
+ * @brief   Zero-copy frame handoff in the virtual switch.
+ * @details If enabled, unicast frames are moved between nodes by swapping
+ *          the transmit buffer with a free receive buffer of the destination
+ *          node instead of copying the frame data.
+ */
+#if !defined(SIM_MAC_SWITCH_ZERO_COPY) || defined(__DOXYGEN__)
+#define SIM_MAC_SWITCH_ZERO_COPY            TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !USE_SIM_MAC1 && !USE_SIM_MAC2
+#error "MAC driver activated but no MAC peripheral assigned"
+#endif
+
+#if (SIM_MAC_TRANSMIT_BUFFERS < 1) || (SIM_MAC_RECEIVE_BUFFERS < 1)
+#error "invalid number of MAC buffers"
+#endif
+
+#if SIM_MAC_BUFFERS_SIZE < 64
+#error "SIM_MAC_BUFFERS_SIZE too small"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated network backends.
+ */
+typedef enum {
+  /**
+   * @brief   Node attached to the in-process virtual switch.
+   */
+  SIM_MAC_BACKEND_SWITCH = 0,
+  /**
+   * @brief   Transmitted frames are received back by the same node.
+   */
+  SIM_MAC_BACKEND_LOOPBACK = 1,
+  /**
+   * @brief   Received frames are replayed from a pcap file.
+   */
+  SIM_MAC_BACKEND_PCAP = 2
+} sim_mac_backend_t;
+
+/**
+ * @brief   Simulated buffer descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Descriptor state.
+   */
+  uint32_t                  state;
+  /**
+   * @brief   Frame size.
+   */
+  size_t                    size;
+  /**
+   * @brief   Pointer to the frame buffer.
+   * @note    Buffers can be exchanged between descriptors by the virtual
+   *          switch zero-copy handoff.
+   */
+  uint8_t                   *buffer;
+} sim_mac_slot_t;
+
+/**
+ * @brief   Simulated MAC statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Transmitted frames.
+   */
+  uint32_t                  tx_frames;
+  /**
+   * @brief   Transmitted bytes.
+   */
+  uint64_t                  tx_bytes;
+  /**
+   * @brief   Received frames.
+   */
+  uint32_t                  rx_frames;
+  /**
+   * @brief   Received bytes.
+   */
+  uint64_t                  rx_bytes;
+  /**
+   * @brief   Frames dropped because of no free receive buffers.
+   */
+  uint32_t                  rx_overruns;
+  /**
+   * @brief   Frames handed off without copy.
+   */
+  uint32_t                  zero_copy_handoffs;
+} sim_mac_stats_t;
+
+/**
+ * @brief   Driver configuration structure.
+ * @note    A zero-initialized configuration, except the MAC address,
+ *          describes a node attached to the virtual switch.
+ */
+typedef struct {
+  /**
+   * @brief MAC address.
+   */
+  uint8_t                   *mac_address;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Network backend.
+   */
+  sim_mac_backend_t         backend;
+  /**
+   * @brief   Path of the pcap file replayed by @p SIM_MAC_BACKEND_PCAP.
+   */
+  const char                *pcap_replay;
+  /**
+   * @brief   Honor the replayed frames timestamps.
+   * @note    If @p false frames are replayed as fast as receive buffers are
+   *          made available.
+   */
+  bool                      pcap_realtime;
+  /**
+   * @brief   Path of the pcap file capturing all the traffic of the node.
+   * @note    Can be @p NULL, capture is allowed with any backend.
+   */
+  const char                *pcap_capture;
+} MACConfig;
+
+/**
+ * @brief   Structure representing a MAC driver.
+ */
+struct MACDriver {
+  /**
+   * @brief Driver state.
+   */
+  macstate_t                state;
+  /**
+   * @brief Current configuration data.
+   */
+  const MACConfig           *config;
+  /**
+   * @brief Transmit semaphore.
+   */
+  threads_queue_t           tdqueue;
+  /**
+   * @brief Receive semaphore.
+   */
+  threads_queue_t           rdqueue;
+#if MAC_USE_EVENTS || defined(__DOXYGEN__)
+  /**
+   * @brief Receive event.
+   */
+  event_source_t            rdevent;
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Node name.
+   */
+  const char                *name;
+  /**
+   * @brief   Current MAC address.
+   */
+  uint8_t                   address[6];
+  /**
+   * @brief   Link status.
+   */
+  bool                      link_up;
+  /**
+   * @brief   Frames have been received since last simulated interrupt.
+   */
+  bool                      rxpending;
+  /**
+   * @brief   Transmit buffers have been freed since last simulated
+   *          interrupt.
+   */
+  bool                      txpending;
+  /**
+   * @brief   Transmit descriptors.
+   */
+  sim_mac_slot_t            txd[SIM_MAC_TRANSMIT_BUFFERS];
+  /**
+   * @brief   Receive descriptors.
+   */
+  sim_mac_slot_t            rxd[SIM_MAC_RECEIVE_BUFFERS];
+  /**
+   * @brief   Next transmit descriptor to be used.
+   */
+  unsigned                  txnext;
+  /**
+   * @brief   Next receive descriptor to be filled by the backend.
+   */
+  unsigned                  rxfill;
+  /**
+   * @brief   Next receive descriptor to be returned to the application.
+   */
+  unsigned                  rxnext;
+  /**
+   * @brief   Replay file or @p NULL.
+   */
+  FILE                      *replay;
+  /**
+   * @brief   Replay file uses the opposite byte order.
+   */
+  bool                      replay_swapped;
+  /**
+   * @brief   Replay file uses nanoseconds timestamps.
+   */
+  bool                      replay_nsec;
+  /**
+   * @brief   A frame has been read from the replay file and is pending.
+   */
+  bool                      replay_valid;
+  /**
+   * @brief   Size of the pending replayed frame.
+   */
+  size_t                    replay_size;
+  /**
+   * @brief   Capture time of the pending replayed frame.
+   */
+  struct timeval            replay_ts;
+  /**
+   * @brief   Host time of the first replayed frame.
+   */
+  struct timeval            replay_t0;
+  /**
+   * @brief   Capture time of the first replayed frame.
+   */
+  struct timeval            replay_c0;
+  /**
+   * @brief   Pending replayed frame.
+   */
+  uint8_t                   replay_frame[SIM_MAC_BUFFERS_SIZE];
+  /**
+   * @brief   Capture file or @p NULL.
+   */
+  FILE                      *capture;
+  /**
+   * @brief   Statistics.
+   */
+  sim_mac_stats_t           stats;
+};
+
+/**
+ * @brief   Structure representing a transmit descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current write offset.
+   */
+  size_t                    offset;
+  /**
+   * @brief Available space size.
+   */
+  size_t                    size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the owner driver.
+   */
+  MACDriver                 *macp;
+  /**
+   * @brief   Pointer to the simulated descriptor.
+   */
+  sim_mac_slot_t            *slot;
+} MACTransmitDescriptor;
+
+/**
+ * @brief   Structure representing a receive descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current read offset.
+   */
+  size_t                    offset;
+  /**
+   * @brief Available data size.
+   */
+  size_t                    size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the owner driver.
+   */
+  MACDriver                 *macp;
+  /**
+   * @brief   Pointer to the simulated descriptor.
+   */
+  sim_mac_slot_t            *slot;
+} MACReceiveDescriptor;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the statistics of a simulated node.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              Pointer to a @p sim_mac_stats_t structure.
+ */
+#define simMacGetStatistics(macp) (&(macp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if USE_SIM_MAC1 && !defined(__DOXYGEN__)
+extern MACDriver ETHD1;
+#endif
+#if USE_SIM_MAC2 && !defined(__DOXYGEN__)
+extern MACDriver ETHD2;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mac_lld_init(void);
+  msg_t mac_lld_start(MACDriver *macp);
+  void mac_lld_stop(MACDriver *macp);
+  msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                        MACTransmitDescriptor *tdp);
+  void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp);
+  msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp);
+  bool mac_lld_poll_link_status(MACDriver *macp);
+  size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                           uint8_t *buf,
+                                           size_t size);
+  size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                         uint8_t *buf,
+                                         size_t size);
+#if MAC_USE_ZERO_COPY
+  uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                            size_t size,
+                                            size_t *sizep);
+  const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                                 size_t *sizep);
+#endif
+  bool mac_lld_interrupt_pending(void);
+  void simMacSetLinkStatus(MACDriver *macp, bool up);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_MAC */
+
+#endif /* HAL_MAC_LLD_H */
+
+/** @} */
@@ -0,0 +1,417 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_spi_lld.c
+ * @brief   Posix simulator SPI subsystem low level driver source.
+ * @details Each simulated bus has a number of chip selects, a device model
+ *          can be attached to each chip select. Frames are exchanged with
+ *          the selected model when a transfer is started, the transfer
+ *          completion interrupt is then simulated after the time the
+ *          transfer would take on a real bus with the configured clock
+ *          and latency.
+ *
+ * @addtogroup POSIX_SPI
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   SPI1 driver identifier.
+ */
+#if (USE_SIM_SPI1 == TRUE) || defined(__DOXYGEN__)
+SPIDriver SPID1;
+#endif
+
+/**
+ * @brief   SPI2 driver identifier.
+ */
+#if (USE_SIM_SPI2 == TRUE) || defined(__DOXYGEN__)
+SPIDriver SPID2;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Time taken by a transfer on the bus.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames
+ * @return              The transfer time in nanoseconds.
+ */
+static uint64_t spi_transfer_time(SPIDriver *spip, size_t n) {
+  uint64_t t = (uint64_t)spip->config->latency_ns;
+
+  if (spip->config->clock > 0U) {
+    t += ((uint64_t)n * 8U * 1000000000U) / (uint64_t)spip->config->clock;
+  }
+
+  return t;
+}
+
+/**
+ * @brief   Exchanges frames with the selected model.
+ * @note    Frames sent while no model is selected are lost and the
+ *          received frames are all ones, like on an idle bus.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames
+ * @param[in] txbuf     transmit buffer or @p NULL for idle frames
+ * @param[out] rxbuf    receive buffer or @p NULL if discarded
+ */
+static void spi_transfer(SPIDriver *spip, size_t n,
+                         const uint8_t *txbuf, uint8_t *rxbuf) {
+  sim_spi_device_t *devp = spip->selected;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    uint8_t tx = txbuf != NULL ? txbuf[i] : 0xFFU;
+    uint8_t rx = 0xFFU;
+
+    if (devp != NULL) {
+      rx = devp->vmt->exchange(devp, tx);
+    }
+    if (rxbuf != NULL) {
+      rxbuf[i] = rx;
+    }
+  }
+}
+
+/**
+ * @brief   Starts a simulated transfer.
+ * @details Data is exchanged immediately, the completion is signaled by
+ *          the interrupts simulation when the transfer time has elapsed.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames
+ * @param[in] txbuf     transmit buffer or @p NULL for idle frames
+ * @param[out] rxbuf    receive buffer or @p NULL if discarded
+ */
+static void spi_start_transfer(SPIDriver *spip, size_t n,
+                               const uint8_t *txbuf, uint8_t *rxbuf) {
+  uint64_t t = spi_transfer_time(spip, n);
+
+  spi_transfer(spip, n, txbuf, rxbuf);
+
+  spip->stats.transfers++;
+  spip->stats.frames  += (uint64_t)n;
+  spip->stats.busy_ns += t;
+
+  spip->deadline = _sim_get_time_ns() + t;
+  spip->busy     = true;
+}
+
+/**
+ * @brief   Serves the completion of a transfer.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] now       current time
+ * @return              @p true if a transfer has been completed.
+ */
+static bool spi_serve_interrupt(SPIDriver *spip, uint64_t now) {
+
+  if (!spip->busy || (now < spip->deadline)) {
+    return false;
+  }
+
+  /* Cleared before the callback, it could start another transfer.*/
+  spip->busy = false;
+  _spi_isr_code(spip);
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   SPI interrupts simulation.
+ *
+ * @return              @p true if an interrupt has been served.
+ *
+ * @notapi
+ */
+bool spi_lld_interrupt_pending(void) {
+  uint64_t now = _sim_get_time_ns();
+  bool b = false;
+
+  OSAL_IRQ_PROLOGUE();
+
+#if USE_SIM_SPI1
+  b |= spi_serve_interrupt(&SPID1, now);
+#endif
+#if USE_SIM_SPI2
+  b |= spi_serve_interrupt(&SPID2, now);
+#endif
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level SPI driver initialization.
+ *
+ * @notapi
+ */
+void spi_lld_init(void) {
+  unsigned i;
+
+#if USE_SIM_SPI1
+  spiObjectInit(&SPID1);
+  for (i = 0U; i < SIM_SPI_MAX_DEVICES; i++) {
+    SPID1.devices[i] = NULL;
+  }
+  SPID1.selected = NULL;
+  SPID1.busy     = false;
+  simSpiResetStats(&SPID1);
+#endif
+#if USE_SIM_SPI2
+  spiObjectInit(&SPID2);
+  for (i = 0U; i < SIM_SPI_MAX_DEVICES; i++) {
+    SPID2.devices[i] = NULL;
+  }
+  SPID2.selected = NULL;
+  SPID2.busy     = false;
+  simSpiResetStats(&SPID2);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_start(SPIDriver *spip) {
+
+  osalDbgAssert(spip->config->cs < SIM_SPI_MAX_DEVICES,
+                "invalid chip select");
+
+  spip->busy = false;
+}
+
+/**
+ * @brief   Deactivates the SPI peripheral.
+ * @note    A transfer in progress is aborted without completion.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_stop(SPIDriver *spip) {
+
+  spip->busy = false;
+}
+
+/**
+ * @brief   Asserts the slave select signal and prepares for transfers.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_select(SPIDriver *spip) {
+  sim_spi_device_t *devp = spip->devices[spip->config->cs];
+
+  osalDbgAssert(spip->selected == NULL, "already selected");
+
+  spip->selected = devp;
+  if (devp != NULL) {
+    devp->vmt->select(devp);
+  }
+}
+
+/**
+ * @brief   Deasserts the slave select signal.
+ * @details The previously selected peripheral is unselected.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_unselect(SPIDriver *spip) {
+  sim_spi_device_t *devp = spip->selected;
+
+  spip->selected = NULL;
+  if (devp != NULL) {
+    devp->vmt->unselect(devp);
+  }
+}
+
+/**
+ * @brief   Ignores data on the SPI bus.
+ * @details This synchronous function performs the transmission of a series of
+ *          idle words on the SPI bus and ignores the received data.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be ignored
+ *
+ * @notapi
+ */
+void spi_lld_ignore(SPIDriver *spip, size_t n) {
+
+  spi_start_transfer(spip, n, NULL, NULL);
+}
+
+/**
+ * @brief   Exchanges data on the SPI bus.
+ * @details This asynchronous function starts a simultaneous transmit/receive
+ *          operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below or
+ *          equal to 8 bits else it is organized as uint16_t arrays.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be exchanged
+ * @param[in] txbuf     the pointer to the transmit buffer
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_exchange(SPIDriver *spip, size_t n,
+                      const void *txbuf, void *rxbuf) {
+
+  spi_start_transfer(spip, n, (const uint8_t *)txbuf, (uint8_t *)rxbuf);
+}
+
+/**
+ * @brief   Sends data over the SPI bus.
+ * @details This asynchronous function starts a transmit operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below or
+ *          equal to 8 bits else it is organized as uint16_t arrays.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
+
+  spi_start_transfer(spip, n, (const uint8_t *)txbuf, NULL);
+}
+
+/**
+ * @brief   Receives data from the SPI bus.
+ * @details This asynchronous function starts a receive operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below or
+ *          equal to 8 bits else it is organized as uint16_t arrays.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
+
+  spi_start_transfer(spip, n, NULL, (uint8_t *)rxbuf);
+}
+
+/**
+ * @brief   Exchanges one frame using a polled wait.
+ * @details This synchronous function exchanges one data frame using a polled
+ *          synchronization method. This function is useful when exchanging
+ *          small amount of data on high speed channels, usually in this
+ *          situation is much more efficient just wait for completion using
+ *          polling than suspending the thread waiting for an interrupt.
+ * @note    The calling thread busy waits for the frame time.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] frame     the data frame to send over the SPI bus
+ * @return              The received data frame from the SPI bus.
+ */
+uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame) {
+  uint64_t t = spi_transfer_time(spip, 1U);
+  uint64_t deadline = _sim_get_time_ns() + t;
+  uint8_t tx = (uint8_t)frame;
+  uint8_t rx;
+
+  spi_transfer(spip, 1U, &tx, &rx);
+
+  spip->stats.transfers++;
+  spip->stats.frames++;
+  spip->stats.busy_ns += t;
+
+  while (_sim_get_time_ns() < deadline) {
+  }
+
+  return (uint16_t)rx;
+}
+
+/**
+ * @brief   Attaches a device model to a chip select of the bus.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] cs        chip select
+ * @param[in] devp      pointer to the model or @p NULL for detaching
+ *
+ * @api
+ */
+void simSpiAttachDevice(SPIDriver *spip, uint32_t cs,
+                        sim_spi_device_t *devp) {
+
+  osalDbgCheck((spip != NULL) && (cs < SIM_SPI_MAX_DEVICES));
+
+  osalSysLock();
+  spip->devices[cs] = devp;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Resets the bus statistics.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @api
+ */
+void simSpiResetStats(SPIDriver *spip) {
+
+  spip->stats.transfers = 0U;
+  spip->stats.frames    = 0U;
+  spip->stats.busy_ns   = 0U;
+}
+
+#endif /* HAL_USE_SPI == TRUE */
+
+/** @} */
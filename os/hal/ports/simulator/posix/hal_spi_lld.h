@@ -0,0 +1,227 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_spi_lld.h
+ * @brief   Posix simulator SPI subsystem low level driver header.
+ *
+ * @addtogroup POSIX_SPI
+ * @{
+ */
+
+#ifndef HAL_SPI_LLD_H
+#define HAL_SPI_LLD_H
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Circular mode support flag.
+ */
+#define SPI_SUPPORTS_CIRCULAR               FALSE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Posix simulator SPI configuration options
+ * @{
+ */
+/**
+ * @brief   SPID1 driver enable switch.
+ * @details If set to @p TRUE the support for SPID1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_SPI1) || defined(__DOXYGEN__)
+#define USE_SIM_SPI1                        TRUE
+#endif
+
+/**
+ * @brief   SPID2 driver enable switch.
+ * @details If set to @p TRUE the support for SPID2 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(USE_SIM_SPI2) || defined(__DOXYGEN__)
+#define USE_SIM_SPI2                        FALSE
+#endif
+
+/**
+ * @brief   Number of chip selects of each simulated bus.
+ */
+#if !defined(SIM_SPI_MAX_DEVICES) || defined(__DOXYGEN__)
+#define SIM_SPI_MAX_DEVICES                 4
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !USE_SIM_SPI1 && !USE_SIM_SPI2
+#error "SPI driver activated but no SPI peripheral assigned"
+#endif
+
+#if SPI_SELECT_MODE != SPI_SELECT_MODE_LLD
+#error "the simulated SPI requires SPI_SELECT_MODE_LLD"
+#endif
+
+#if SIM_SPI_MAX_DEVICES < 1
+#error "invalid SIM_SPI_MAX_DEVICES value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a simulated SPI device.
+ */
+typedef struct sim_spi_device sim_spi_device_t;
+
+/**
+ * @brief   Simulated SPI device model methods.
+ * @note    Methods are invoked from within the driver, the model must not
+ *          invoke any OS API.
+ */
+typedef struct {
+  /**
+   * @brief   Chip select asserted.
+   */
+  void (*select)(sim_spi_device_t *devp);
+  /**
+   * @brief   Chip select deasserted.
+   */
+  void (*unselect)(sim_spi_device_t *devp);
+  /**
+   * @brief   Exchanges a frame.
+   * @details The model receives the frame sent by the master and returns
+   *          the frame shifted out in the same clock cycles.
+   */
+  uint8_t (*exchange)(sim_spi_device_t *devp, uint8_t frame);
+} sim_spi_device_vmt_t;
+
+/**
+ * @brief   Simulated SPI device model.
+ * @note    This structure is meant to be the first field of the models
+ *          implementations.
+ */
+struct sim_spi_device {
+  /**
+   * @brief   Model methods.
+   */
+  const sim_spi_device_vmt_t *vmt;
+};
+
+/**
+ * @brief   Simulated SPI bus statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Performed transfers.
+   */
+  uint32_t                  transfers;
+  /**
+   * @brief   Exchanged frames.
+   */
+  uint64_t                  frames;
+  /**
+   * @brief   Time spent by the bus in transfers, in nanoseconds.
+   */
+  uint64_t                  busy_ns;
+} sim_spi_stats_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the SPI driver structure.
+ */
+#define spi_lld_driver_fields                                               \
+  /* Models attached to the bus chip selects.*/                             \
+  sim_spi_device_t          *devices[SIM_SPI_MAX_DEVICES];                  \
+  /* Currently selected model or NULL.*/                                    \
+  sim_spi_device_t          *selected;                                      \
+  /* Transfer in progress.*/                                                \
+  bool                      busy;                                           \
+  /* Completion time of the transfer in progress.*/                         \
+  uint64_t                  deadline;                                       \
+  /* Bus statistics.*/                                                      \
+  sim_spi_stats_t           stats
+
+/**
+ * @brief   Low level fields of the SPI configuration structure.
+ */
+#define spi_lld_config_fields                                               \
+  /* Chip select of the device on the simulated bus.*/                      \
+  uint32_t                  cs;                                             \
+  /* Bus clock in Hz, zero for instantaneous transfers.*/                   \
+  uint32_t                  clock;                                          \
+  /* Fixed latency of each transfer in nanoseconds.*/                       \
+  uint32_t                  latency_ns
+
+/**
+ * @brief   Returns the bus statistics.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @return              A pointer to the @p sim_spi_stats_t structure.
+ *
+ * @xclass
+ */
+#define simSpiGetStatsX(spip) (&(spip)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if USE_SIM_SPI1 && !defined(__DOXYGEN__)
+extern SPIDriver SPID1;
+#endif
+#if USE_SIM_SPI2 && !defined(__DOXYGEN__)
+extern SPIDriver SPID2;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spi_lld_init(void);
+  void spi_lld_start(SPIDriver *spip);
+  void spi_lld_stop(SPIDriver *spip);
+  void spi_lld_select(SPIDriver *spip);
+  void spi_lld_unselect(SPIDriver *spip);
+  void spi_lld_ignore(SPIDriver *spip, size_t n);
+  void spi_lld_exchange(SPIDriver *spip, size_t n,
+                        const void *txbuf, void *rxbuf);
+  void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf);
+  void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf);
+  uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame);
+  bool spi_lld_interrupt_pending(void);
+  void simSpiAttachDevice(SPIDriver *spip, uint32_t cs,
+                          sim_spi_device_t *devp);
+  void simSpiResetStats(SPIDriver *spip);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI == TRUE */
+
+#endif /* HAL_SPI_LLD_H */
+
+/** @} */
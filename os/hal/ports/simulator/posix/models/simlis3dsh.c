@@ -0,0 +1,251 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/models/simlis3dsh.c
+ * @brief   Posix simulator LIS3DSH device model code.
+ * @details The model implements the identification, control, status and
+ *          output registers of the accelerometer. Output registers return
+ *          the values set using @p simlis3dshSetAcceleration().
+ *
+ * @addtogroup POSIX_SIMLIS3DSH
+ * @{
+ */
+
+#include "hal.h"
+#include "simlis3dsh.h"
+
+#if (HAL_USE_SPI == TRUE) || (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define AD_WHO_AM_I                         0x0FU
+#define AD_CTRL_REG4                        0x20U
+#define AD_CTRL_REG6                        0x25U
+#define AD_STATUS                           0x27U
+#define AD_OUT_X_L                          0x28U
+#define AD_OUT_Z_H                          0x2DU
+#define AD_FIFO_CTRL                        0x2EU
+#define AD_FIFO_SRC                         0x2FU
+
+#define WHO_AM_I_VALUE                      0x3FU
+#define CTRL_REG4_ODR_MASK                  0xF0U
+#define CTRL_REG6_ADD_INC                   0x10U
+#define CTRL_REG6_FIFO_EN                   0x40U
+#define FIFO_CTRL_WTP_MASK                  0x1FU
+#define FIFO_CTRL_FMODE_MASK                0xE0U
+#define FIFO_CTRL_FMODE_BYPASS              0x00U
+#define FIFO_SRC_EMPTY                      0x20U
+#define FIFO_SRC_OVRN                       0x40U
+#define FIFO_SRC_WTM                        0x80U
+#define STATUS_XYZ_DATA_AVAILABLE           0x0FU
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static uint8_t lis3dsh_read(SimRegisterMap *rmp, uint8_t reg);
+static void lis3dsh_write(SimRegisterMap *rmp, uint8_t reg, uint8_t value);
+
+static const SimRegisterMapConfig lis3dsh_config = {
+  0U, lis3dsh_read, lis3dsh_write
+};
+
+/**
+ * @brief   Samples periods in nanoseconds indexed by the ODR field.
+ */
+static const uint32_t lis3dsh_periods[16] = {
+  0U, 320000000U, 160000000U, 80000000U, 40000000U, 20000000U, 10000000U,
+  2500000U, 1250000U, 625000U, 0U, 0U, 0U, 0U, 0U, 0U
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static bool lis3dsh_fifo_enabled(SimRegisterMap *rmp) {
+
+  return ((rmp->regs[AD_CTRL_REG6] & CTRL_REG6_FIFO_EN) != 0U) &&
+         ((rmp->regs[AD_FIFO_CTRL] & FIFO_CTRL_FMODE_MASK) !=
+          FIFO_CTRL_FMODE_BYPASS);
+}
+
+static void lis3dsh_fifo_reset(SimLIS3DSH *devp) {
+
+  devp->fifo_level = 0U;
+  devp->fifo_time  = _sim_get_time_ns();
+}
+
+/*
+ * Stores the samples produced since the last update, the FIFO mode stops
+ * when full while the stream mode overwrites the oldest samples.
+ */
+static void lis3dsh_fifo_update(SimLIS3DSH *devp) {
+  SimRegisterMap *rmp = &devp->rm;
+  uint32_t period = lis3dsh_periods[rmp->regs[AD_CTRL_REG4] >> 4];
+  uint64_t n;
+
+  if (!lis3dsh_fifo_enabled(rmp) || (period == 0U)) {
+    return;
+  }
+
+  n = (_sim_get_time_ns() - devp->fifo_time) / period;
+  devp->fifo_time += n * period;
+  if (n > (uint64_t)(SIM_LIS3DSH_FIFO_SIZE - devp->fifo_level)) {
+    devp->fifo_level = SIM_LIS3DSH_FIFO_SIZE;
+  }
+  else {
+    devp->fifo_level += (uint32_t)n;
+  }
+}
+
+static uint8_t lis3dsh_fifo_src(SimLIS3DSH *devp) {
+  SimRegisterMap *rmp = &devp->rm;
+  uint32_t wtm = rmp->regs[AD_FIFO_CTRL] & FIFO_CTRL_WTP_MASK;
+  uint8_t src;
+
+  lis3dsh_fifo_update(devp);
+  src = (uint8_t)(devp->fifo_level & 0x1FU);
+  if ((wtm > 0U) && (devp->fifo_level >= wtm)) {
+    src |= FIFO_SRC_WTM;
+  }
+  /* The overrun flag is set when the FIFO is full.*/
+  if (devp->fifo_level == SIM_LIS3DSH_FIFO_SIZE) {
+    src |= FIFO_SRC_OVRN;
+  }
+  if (devp->fifo_level == 0U) {
+    src |= FIFO_SRC_EMPTY;
+  }
+
+  return src;
+}
+
+static uint8_t lis3dsh_read(SimRegisterMap *rmp, uint8_t reg) {
+  SimLIS3DSH *devp = (SimLIS3DSH *)rmp;
+
+  if (reg == AD_FIFO_SRC) {
+    return lis3dsh_fifo_src(devp);
+  }
+
+  if (reg == AD_STATUS) {
+    if ((rmp->regs[AD_CTRL_REG4] & CTRL_REG4_ODR_MASK) != 0U) {
+      return STATUS_XYZ_DATA_AVAILABLE;
+    }
+    return 0U;
+  }
+
+  if ((reg >= AD_OUT_X_L) && (reg <= AD_OUT_Z_H)) {
+    uint16_t v = (uint16_t)devp->acc[(reg - AD_OUT_X_L) / 2U];
+
+    if (reg == AD_OUT_X_L) {
+      devp->reads++;
+    }
+    if (lis3dsh_fifo_enabled(rmp)) {
+      /* Samples are popped from the FIFO and burst reads roll back to
+         the first output register.*/
+      if ((reg == AD_OUT_Z_H) && (devp->fifo_level > 0U)) {
+        devp->fifo_level--;
+      }
+      if ((reg == AD_OUT_Z_H) && rmp->inc) {
+        rmp->ptr = AD_OUT_X_L;
+      }
+    }
+    return (reg & 1U) == 0U ? (uint8_t)v : (uint8_t)(v >> 8);
+  }
+
+  return rmp->regs[reg];
+}
+
+static void lis3dsh_write(SimRegisterMap *rmp, uint8_t reg, uint8_t value) {
+
+  switch (reg) {
+  case AD_WHO_AM_I:
+  case AD_STATUS:
+  case AD_FIFO_SRC:
+    /* Read only registers.*/
+    break;
+  case AD_FIFO_CTRL:
+    /* FIFO mode changes restart the FIFO.*/
+    if ((value & FIFO_CTRL_FMODE_MASK) !=
+        (rmp->regs[reg] & FIFO_CTRL_FMODE_MASK)) {
+      lis3dsh_fifo_reset((SimLIS3DSH *)rmp);
+    }
+    rmp->regs[reg] = value;
+    break;
+  case AD_CTRL_REG6:
+    rmp->autoinc = (value & CTRL_REG6_ADD_INC) != 0U;
+    rmp->regs[reg] = value;
+    break;
+  default:
+    if ((reg < AD_OUT_X_L) || (reg > AD_OUT_Z_H)) {
+      rmp->regs[reg] = value;
+    }
+    break;
+  }
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ * @details The registers are set to their reset values.
+ *
+ * @param[out] devp     pointer to the @p SimLIS3DSH object
+ *
+ * @init
+ */
+void simlis3dshObjectInit(SimLIS3DSH *devp) {
+
+  simregObjectInit(&devp->rm, &lis3dsh_config);
+  devp->rm.regs[AD_WHO_AM_I]  = WHO_AM_I_VALUE;
+  devp->rm.regs[AD_CTRL_REG4] = 0x07U;
+  devp->rm.regs[AD_CTRL_REG6] = CTRL_REG6_ADD_INC;
+  devp->rm.autoinc            = true;
+  devp->acc[0] = 0;
+  devp->acc[1] = 0;
+  devp->acc[2] = 0;
+  devp->reads  = 0U;
+  lis3dsh_fifo_reset(devp);
+}
+
+/**
+ * @brief   Sets the acceleration sensed by the model.
+ *
+ * @param[in] devp      pointer to the @p SimLIS3DSH object
+ * @param[in] acc       raw values of the X, Y and Z axes
+ *
+ * @api
+ */
+void simlis3dshSetAcceleration(SimLIS3DSH *devp, const int16_t acc[3]) {
+
+  osalSysLock();
+  devp->acc[0] = acc[0];
+  devp->acc[1] = acc[1];
+  devp->acc[2] = acc[2];
+  osalSysUnlock();
+}
+
+#endif /* (HAL_USE_SPI == TRUE) || (HAL_USE_I2C == TRUE) */
+
+/** @} */
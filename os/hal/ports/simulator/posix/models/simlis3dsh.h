@@ -0,0 +1,96 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/models/simlis3dsh.h
+ * @brief   Posix simulator LIS3DSH device model header.
+ *
+ * @addtogroup POSIX_SIMLIS3DSH
+ * @{
+ */
+
+#ifndef SIMLIS3DSH_H
+#define SIMLIS3DSH_H
+
+#include "simregmap.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   FIFO size in samples.
+ */
+#define SIM_LIS3DSH_FIFO_SIZE               32U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Structure representing a LIS3DSH device model.
+ */
+typedef struct {
+  /**
+   * @brief   Register map.
+   */
+  SimRegisterMap            rm;
+  /**
+   * @brief   Current acceleration raw values.
+   */
+  int16_t                   acc[3];
+  /**
+   * @brief   Output registers reads counter.
+   */
+  uint32_t                  reads;
+  /**
+   * @brief   Samples in the FIFO.
+   */
+  uint32_t                  fifo_level;
+  /**
+   * @brief   Time of the last sample stored in the FIFO.
+   */
+  uint64_t                  fifo_time;
+} SimLIS3DSH;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void simlis3dshObjectInit(SimLIS3DSH *devp);
+  void simlis3dshSetAcceleration(SimLIS3DSH *devp, const int16_t acc[3]);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMLIS3DSH_H */
+
+/** @} */
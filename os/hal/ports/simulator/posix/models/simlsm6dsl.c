@@ -0,0 +1,378 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/models/simlsm6dsl.c
+ * @brief   Posix simulator LSM6DSL device model code.
+ * @details The model implements the identification, control, status and
+ *          output registers of the accelerometer, gyroscope and
+ *          temperature sensor. Output registers return the values set
+ *          using the model API.<br>
+ *          The FIFO is modeled in FIFO and continuous modes for the
+ *          accelerometer and gyroscope data sets without decimation,
+ *          samples are stored at the FIFO data rate and return the
+ *          values set at the time they are read.
+ *
+ * @addtogroup POSIX_SIMLSM6DSL
+ * @{
+ */
+
+#include "hal.h"
+#include "simlsm6dsl.h"
+
+#if (HAL_USE_SPI == TRUE) || (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define AD_FIFO_CTRL1                       0x06U
+#define AD_FIFO_CTRL2                       0x07U
+#define AD_FIFO_CTRL3                       0x08U
+#define AD_FIFO_CTRL5                       0x0AU
+#define AD_WHO_AM_I                         0x0FU
+#define AD_CTRL1_XL                         0x10U
+#define AD_CTRL2_G                          0x11U
+#define AD_CTRL3_C                          0x12U
+#define AD_STATUS_REG                       0x1EU
+#define AD_OUT_TEMP_L                       0x20U
+#define AD_OUTX_L_G                         0x22U
+#define AD_OUTX_L_XL                        0x28U
+#define AD_OUTZ_H_XL                        0x2DU
+#define AD_FIFO_STATUS1                     0x3AU
+#define AD_FIFO_STATUS2                     0x3BU
+#define AD_FIFO_STATUS3                     0x3CU
+#define AD_FIFO_STATUS4                     0x3DU
+#define AD_FIFO_DATA_OUT_L                  0x3EU
+#define AD_FIFO_DATA_OUT_H                  0x3FU
+
+#define WHO_AM_I_VALUE                      0x6AU
+#define CTRL_ODR_MASK                       0xF0U
+#define CTRL3_C_IF_INC                      0x04U
+#define CTRL3_C_SW_RESET                    0x01U
+#define STATUS_XLDA                         0x01U
+#define STATUS_GDA                          0x02U
+#define STATUS_TDA                          0x04U
+#define FIFO_CTRL3_DEC_XL_MASK              0x07U
+#define FIFO_CTRL3_DEC_G_MASK               0x38U
+#define FIFO_CTRL5_MODE_MASK                0x07U
+#define FIFO_CTRL5_MODE_BYPASS              0x00U
+#define FIFO_CTRL5_MODE_FIFO                0x01U
+#define FIFO_CTRL5_ODR_MASK                 0x78U
+#define FIFO_STATUS2_EMPTY                  0x10U
+#define FIFO_STATUS2_OVER_RUN               0x40U
+#define FIFO_STATUS2_WATERM                 0x80U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static uint8_t lsm6dsl_read(SimRegisterMap *rmp, uint8_t reg);
+static void lsm6dsl_write(SimRegisterMap *rmp, uint8_t reg, uint8_t value);
+
+static const SimRegisterMapConfig lsm6dsl_config = {
+  0U, lsm6dsl_read, lsm6dsl_write
+};
+
+/**
+ * @brief   FIFO samples periods in nanoseconds indexed by the ODR field.
+ */
+static const uint32_t lsm6dsl_fifo_periods[16] = {
+  0U, 80000000U, 38461538U, 19230769U, 9615385U, 4807692U, 2403846U,
+  1200480U, 602410U, 300300U, 150150U, 0U, 0U, 0U, 0U, 0U
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void lsm6dsl_fifo_reset(SimLSM6DSL *devp) {
+
+  devp->fifo_level   = 0U;
+  devp->fifo_pattern = 0U;
+  devp->fifo_time    = _sim_get_time_ns();
+  devp->fifo_overrun = false;
+  devp->fifo_high    = 0U;
+}
+
+static uint32_t lsm6dsl_fifo_pattern_size(SimRegisterMap *rmp) {
+  uint32_t n = 0U;
+
+  if ((rmp->regs[AD_FIFO_CTRL3] & FIFO_CTRL3_DEC_G_MASK) != 0U) {
+    n += 3U;
+  }
+  if ((rmp->regs[AD_FIFO_CTRL3] & FIFO_CTRL3_DEC_XL_MASK) != 0U) {
+    n += 3U;
+  }
+
+  return n;
+}
+
+/*
+ * Stores the samples produced since the last update.
+ */
+static void lsm6dsl_fifo_update(SimLSM6DSL *devp) {
+  SimRegisterMap *rmp = &devp->rm;
+  uint8_t ctrl5 = rmp->regs[AD_FIFO_CTRL5];
+  uint32_t period = lsm6dsl_fifo_periods[(ctrl5 & FIFO_CTRL5_ODR_MASK) >> 3];
+  uint32_t size = lsm6dsl_fifo_pattern_size(rmp);
+  uint32_t capacity;
+  uint64_t now, n;
+
+  if (((ctrl5 & FIFO_CTRL5_MODE_MASK) == FIFO_CTRL5_MODE_BYPASS) ||
+      (period == 0U) || (size == 0U)) {
+    return;
+  }
+
+  now = _sim_get_time_ns();
+  n   = (now - devp->fifo_time) / period;
+  devp->fifo_time += n * period;
+
+  /* Only complete samples are stored, in continuous mode the oldest
+     samples are overwritten.*/
+  capacity = SIM_LSM6DSL_FIFO_WORDS - (SIM_LSM6DSL_FIFO_WORDS % size);
+  if (n * size > (uint64_t)(capacity - devp->fifo_level)) {
+    devp->fifo_level = capacity;
+    if ((ctrl5 & FIFO_CTRL5_MODE_MASK) != FIFO_CTRL5_MODE_FIFO) {
+      devp->fifo_overrun = true;
+    }
+  }
+  else {
+    devp->fifo_level += (uint32_t)(n * size);
+  }
+}
+
+static uint8_t lsm6dsl_fifo_status2(SimLSM6DSL *devp) {
+  SimRegisterMap *rmp = &devp->rm;
+  uint32_t fth = rmp->regs[AD_FIFO_CTRL1] |
+                 ((rmp->regs[AD_FIFO_CTRL2] & 0x07U) << 8);
+  uint8_t sts = (uint8_t)((devp->fifo_level >> 8) & 0x07U);
+
+  if ((fth > 0U) && (devp->fifo_level >= fth)) {
+    sts |= FIFO_STATUS2_WATERM;
+  }
+  if (devp->fifo_overrun) {
+    sts |= FIFO_STATUS2_OVER_RUN;
+  }
+  if (devp->fifo_level == 0U) {
+    sts |= FIFO_STATUS2_EMPTY;
+  }
+
+  return sts;
+}
+
+static uint8_t lsm6dsl_fifo_read(SimLSM6DSL *devp, uint8_t reg) {
+  SimRegisterMap *rmp = &devp->rm;
+  uint32_t size = lsm6dsl_fifo_pattern_size(rmp);
+  uint16_t v = 0U;
+
+  if (reg == AD_FIFO_DATA_OUT_H) {
+    /* Burst reads roll back to the low byte register.*/
+    if (rmp->inc) {
+      rmp->ptr = AD_FIFO_DATA_OUT_L;
+    }
+    return devp->fifo_high;
+  }
+
+  if (devp->fifo_level > 0U) {
+    uint32_t i = devp->fifo_pattern;
+
+    /* The gyroscope data set comes first.*/
+    if ((rmp->regs[AD_FIFO_CTRL3] & FIFO_CTRL3_DEC_G_MASK) != 0U) {
+      v = (uint16_t)(i < 3U ? devp->gyro[i] : devp->acc[i - 3U]);
+    }
+    else {
+      v = (uint16_t)devp->acc[i];
+    }
+    devp->fifo_level--;
+    devp->fifo_pattern = (i + 1U) % size;
+  }
+  devp->fifo_high = (uint8_t)(v >> 8);
+
+  return (uint8_t)v;
+}
+
+static void lsm6dsl_reset(SimRegisterMap *rmp) {
+  unsigned i;
+
+  for (i = 0U; i < SIM_REG_MAP_SIZE; i++) {
+    rmp->regs[i] = 0U;
+  }
+  rmp->regs[AD_WHO_AM_I] = WHO_AM_I_VALUE;
+  rmp->regs[AD_CTRL3_C]  = CTRL3_C_IF_INC;
+  rmp->autoinc           = true;
+  lsm6dsl_fifo_reset((SimLSM6DSL *)rmp);
+}
+
+static uint8_t lsm6dsl_read(SimRegisterMap *rmp, uint8_t reg) {
+  SimLSM6DSL *devp = (SimLSM6DSL *)rmp;
+  uint16_t v;
+
+  if (reg == AD_STATUS_REG) {
+    uint8_t sts = 0U;
+
+    if ((rmp->regs[AD_CTRL1_XL] & CTRL_ODR_MASK) != 0U) {
+      sts |= STATUS_XLDA | STATUS_TDA;
+    }
+    if ((rmp->regs[AD_CTRL2_G] & CTRL_ODR_MASK) != 0U) {
+      sts |= STATUS_GDA | STATUS_TDA;
+    }
+    return sts;
+  }
+
+  switch (reg) {
+  case AD_FIFO_STATUS1:
+    /* The FIFO is updated when its status is read.*/
+    lsm6dsl_fifo_update(devp);
+    return (uint8_t)devp->fifo_level;
+  case AD_FIFO_STATUS2:
+    return lsm6dsl_fifo_status2(devp);
+  case AD_FIFO_STATUS3:
+    return (uint8_t)devp->fifo_pattern;
+  case AD_FIFO_STATUS4:
+    return (uint8_t)(devp->fifo_pattern >> 8);
+  case AD_FIFO_DATA_OUT_L:
+  case AD_FIFO_DATA_OUT_H:
+    return lsm6dsl_fifo_read(devp, reg);
+  default:
+    break;
+  }
+
+  if ((reg < AD_OUT_TEMP_L) || (reg > AD_OUTZ_H_XL)) {
+    return rmp->regs[reg];
+  }
+
+  if (reg >= AD_OUTX_L_XL) {
+    v = (uint16_t)devp->acc[(reg - AD_OUTX_L_XL) / 2U];
+  }
+  else if (reg >= AD_OUTX_L_G) {
+    v = (uint16_t)devp->gyro[(reg - AD_OUTX_L_G) / 2U];
+  }
+  else {
+    v = (uint16_t)devp->temp;
+  }
+
+  if ((reg == AD_OUTX_L_XL) || (reg == AD_OUTX_L_G)) {
+    devp->reads++;
+  }
+
+  return (reg & 1U) == 0U ? (uint8_t)v : (uint8_t)(v >> 8);
+}
+
+static void lsm6dsl_write(SimRegisterMap *rmp, uint8_t reg, uint8_t value) {
+
+  if (reg == AD_CTRL3_C) {
+    if ((value & CTRL3_C_SW_RESET) != 0U) {
+      lsm6dsl_reset(rmp);
+      return;
+    }
+    rmp->autoinc = (value & CTRL3_C_IF_INC) != 0U;
+  }
+
+  /* FIFO mode changes restart the FIFO.*/
+  if ((reg == AD_FIFO_CTRL5) && (value != rmp->regs[reg])) {
+    lsm6dsl_fifo_reset((SimLSM6DSL *)rmp);
+  }
+
+  /* Identification, status and output registers are read only.*/
+  if ((reg != AD_WHO_AM_I) && (reg != AD_STATUS_REG) &&
+      ((reg < AD_OUT_TEMP_L) || (reg > AD_OUTZ_H_XL)) &&
+      ((reg < AD_FIFO_STATUS1) || (reg > AD_FIFO_DATA_OUT_H))) {
+    rmp->regs[reg] = value;
+  }
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ * @details The registers are set to their reset values.
+ *
+ * @param[out] devp     pointer to the @p SimLSM6DSL object
+ *
+ * @init
+ */
+void simlsm6dslObjectInit(SimLSM6DSL *devp) {
+  unsigned i;
+
+  simregObjectInit(&devp->rm, &lsm6dsl_config);
+  lsm6dsl_reset(&devp->rm);
+  for (i = 0U; i < 3U; i++) {
+    devp->acc[i]  = 0;
+    devp->gyro[i] = 0;
+  }
+  devp->temp  = 0;
+  devp->reads = 0U;
+}
+
+/**
+ * @brief   Sets the acceleration sensed by the model.
+ *
+ * @param[in] devp      pointer to the @p SimLSM6DSL object
+ * @param[in] acc       raw values of the X, Y and Z axes
+ *
+ * @api
+ */
+void simlsm6dslSetAcceleration(SimLSM6DSL *devp, const int16_t acc[3]) {
+
+  osalSysLock();
+  devp->acc[0] = acc[0];
+  devp->acc[1] = acc[1];
+  devp->acc[2] = acc[2];
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Sets the angular rate sensed by the model.
+ *
+ * @param[in] devp      pointer to the @p SimLSM6DSL object
+ * @param[in] gyro      raw values of the X, Y and Z axes
+ *
+ * @api
+ */
+void simlsm6dslSetAngularRate(SimLSM6DSL *devp, const int16_t gyro[3]) {
+
+  osalSysLock();
+  devp->gyro[0] = gyro[0];
+  devp->gyro[1] = gyro[1];
+  devp->gyro[2] = gyro[2];
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Sets the temperature sensed by the model.
+ *
+ * @param[in] devp      pointer to the @p SimLSM6DSL object
+ * @param[in] temp      raw temperature value
+ *
+ * @api
+ */
+void simlsm6dslSetTemperature(SimLSM6DSL *devp, int16_t temp) {
+
+  osalSysLock();
+  devp->temp = temp;
+  osalSysUnlock();
+}
+
+#endif /* (HAL_USE_SPI == TRUE) || (HAL_USE_I2C == TRUE) */
+
+/** @} */
@@ -0,0 +1,118 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/models/simlsm6dsl.h
+ * @brief   Posix simulator LSM6DSL device model header.
+ *
+ * @addtogroup POSIX_SIMLSM6DSL
+ * @{
+ */
+
+#ifndef SIMLSM6DSL_H
+#define SIMLSM6DSL_H
+
+#include "simregmap.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   FIFO size in 16 bits words.
+ */
+#define SIM_LSM6DSL_FIFO_WORDS              2048U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Structure representing a LSM6DSL device model.
+ */
+typedef struct {
+  /**
+   * @brief   Register map.
+   */
+  SimRegisterMap            rm;
+  /**
+   * @brief   Current acceleration raw values.
+   */
+  int16_t                   acc[3];
+  /**
+   * @brief   Current angular rate raw values.
+   */
+  int16_t                   gyro[3];
+  /**
+   * @brief   Current temperature raw value.
+   */
+  int16_t                   temp;
+  /**
+   * @brief   Output registers reads counter.
+   */
+  uint32_t                  reads;
+  /**
+   * @brief   Words in the FIFO.
+   */
+  uint32_t                  fifo_level;
+  /**
+   * @brief   Position in the FIFO pattern of the next word.
+   */
+  uint32_t                  fifo_pattern;
+  /**
+   * @brief   Time of the last sample stored in the FIFO.
+   */
+  uint64_t                  fifo_time;
+  /**
+   * @brief   FIFO overrun flag.
+   */
+  bool                      fifo_overrun;
+  /**
+   * @brief   High byte of the last word read from the FIFO.
+   */
+  uint8_t                   fifo_high;
+} SimLSM6DSL;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void simlsm6dslObjectInit(SimLSM6DSL *devp);
+  void simlsm6dslSetAcceleration(SimLSM6DSL *devp, const int16_t acc[3]);
+  void simlsm6dslSetAngularRate(SimLSM6DSL *devp, const int16_t gyro[3]);
+  void simlsm6dslSetTemperature(SimLSM6DSL *devp, int16_t temp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMLSM6DSL_H */
+
+/** @} */
@@ -0,0 +1,208 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/models/simregmap.c
+ * @brief   Posix simulator register map device model code.
+ * @details Generic model of devices exposing an array of 8 bits registers,
+ *          specific devices are modeled by providing hooks for the
+ *          registers with special behavior.
+ *
+ * @addtogroup POSIX_SIMREGMAP
+ * @{
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "hal.h"
+#include "simregmap.h"
+
+#if (HAL_USE_SPI == TRUE) || (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static uint8_t reg_read(SimRegisterMap *rmp) {
+  uint8_t reg = rmp->ptr;
+
+  if (rmp->inc) {
+    rmp->ptr = (uint8_t)((reg + 1U) & (SIM_REG_MAP_SIZE - 1U));
+  }
+
+  if (rmp->config->read != NULL) {
+    return rmp->config->read(rmp, reg);
+  }
+
+  return rmp->regs[reg];
+}
+
+static void reg_write(SimRegisterMap *rmp, uint8_t value) {
+  uint8_t reg = rmp->ptr;
+
+  if (rmp->inc) {
+    rmp->ptr = (uint8_t)((reg + 1U) & (SIM_REG_MAP_SIZE - 1U));
+  }
+
+  if (rmp->config->write != NULL) {
+    rmp->config->write(rmp, reg, value);
+  }
+  else {
+    rmp->regs[reg] = value;
+  }
+}
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+static void spi_select(sim_spi_device_t *devp) {
+  SimRegisterMap *rmp = (SimRegisterMap *)devp;
+
+  rmp->addressed = false;
+}
+
+static void spi_unselect(sim_spi_device_t *devp) {
+
+  (void)devp;
+}
+
+static uint8_t spi_exchange(sim_spi_device_t *devp, uint8_t frame) {
+  SimRegisterMap *rmp = (SimRegisterMap *)devp;
+
+  if (!rmp->addressed) {
+    rmp->addressed = true;
+    rmp->rd        = (frame & 0x80U) != 0U;
+    rmp->inc       = rmp->autoinc;
+    if ((rmp->config->flags & SIM_REG_SPI_MS) != 0U) {
+      rmp->ptr  = frame & 0x3FU;
+      rmp->inc |= (frame & 0x40U) != 0U;
+    }
+    else {
+      rmp->ptr  = frame & 0x7FU;
+    }
+    return 0xFFU;
+  }
+
+  if (rmp->rd) {
+    return reg_read(rmp);
+  }
+
+  reg_write(rmp, frame);
+
+  return 0xFFU;
+}
+
+static const sim_spi_device_vmt_t spi_vmt = {
+  spi_select, spi_unselect, spi_exchange
+};
+#endif /* HAL_USE_SPI == TRUE */
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+static SimRegisterMap *i2c_get_map(sim_i2c_device_t *devp) {
+
+  return (SimRegisterMap *)((uint8_t *)devp - offsetof(SimRegisterMap, i2c));
+}
+
+static bool i2c_start(sim_i2c_device_t *devp, bool read) {
+  SimRegisterMap *rmp = i2c_get_map(devp);
+
+  rmp->rd = read;
+  if (!read) {
+    rmp->addressed = false;
+  }
+
+  return true;
+}
+
+static bool i2c_write(sim_i2c_device_t *devp, uint8_t data) {
+  SimRegisterMap *rmp = i2c_get_map(devp);
+
+  if (!rmp->addressed) {
+    rmp->addressed = true;
+    rmp->inc       = rmp->autoinc;
+    rmp->ptr       = data & 0x7FU;
+    if ((rmp->config->flags & SIM_REG_I2C_MSB) != 0U) {
+      rmp->inc |= (data & 0x80U) != 0U;
+    }
+    return true;
+  }
+
+  reg_write(rmp, data);
+
+  return true;
+}
+
+static uint8_t i2c_read(sim_i2c_device_t *devp) {
+
+  return reg_read(i2c_get_map(devp));
+}
+
+static void i2c_stop(sim_i2c_device_t *devp) {
+
+  (void)devp;
+}
+
+static const sim_i2c_device_vmt_t i2c_vmt = {
+  i2c_start, i2c_write, i2c_read, i2c_stop
+};
+#endif /* HAL_USE_I2C == TRUE */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ * @note    All registers are cleared and the address increment is
+ *          disabled, models set their reset values after this call.
+ *
+ * @param[out] rmp      pointer to the @p SimRegisterMap object
+ * @param[in] config    pointer to the @p SimRegisterMapConfig object
+ *
+ * @init
+ */
+void simregObjectInit(SimRegisterMap *rmp,
+                      const SimRegisterMapConfig *config) {
+
+#if HAL_USE_SPI == TRUE
+  rmp->spi.vmt   = &spi_vmt;
+#endif
+#if HAL_USE_I2C == TRUE
+  rmp->i2c.vmt   = &i2c_vmt;
+#endif
+  rmp->config    = config;
+  memset(rmp->regs, 0, sizeof rmp->regs);
+  rmp->autoinc   = false;
+  rmp->ptr       = 0U;
+  rmp->inc       = false;
+  rmp->rd        = false;
+  rmp->addressed = false;
+}
+
+#endif /* (HAL_USE_SPI == TRUE) || (HAL_USE_I2C == TRUE) */
+
+/** @} */
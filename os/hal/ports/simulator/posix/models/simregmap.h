@@ -0,0 +1,204 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/models/simregmap.h
+ * @brief   Posix simulator register map device model header.
+ *
+ * @addtogroup POSIX_SIMREGMAP
+ * @{
+ */
+
+#ifndef SIMREGMAP_H
+#define SIMREGMAP_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of registers of a register map.
+ */
+#define SIM_REG_MAP_SIZE                    128U
+
+/**
+ * @name    Register map addressing options
+ * @{
+ */
+/**
+ * @brief   Bit 6 of the SPI command byte enables the address increment.
+ */
+#define SIM_REG_SPI_MS                      (1U << 0)
+/**
+ * @brief   Bit 7 of the I2C sub-address enables the address increment.
+ */
+#define SIM_REG_I2C_MSB                     (1U << 1)
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a register map device model.
+ */
+typedef struct SimRegisterMap SimRegisterMap;
+
+/**
+ * @brief   Register read hook.
+ * @details The hook returns the value of a register, models implement
+ *          output and status registers using this hook.
+ *
+ * @param[in] rmp       pointer to the @p SimRegisterMap object
+ * @param[in] reg       register address
+ * @return              The register value.
+ */
+typedef uint8_t (*sim_reg_read_t)(SimRegisterMap *rmp, uint8_t reg);
+
+/**
+ * @brief   Register write hook.
+ * @details The hook stores a register value, models implement read only
+ *          registers and side effects using this hook.
+ *
+ * @param[in] rmp       pointer to the @p SimRegisterMap object
+ * @param[in] reg       register address
+ * @param[in] value     value written by the master
+ */
+typedef void (*sim_reg_write_t)(SimRegisterMap *rmp, uint8_t reg,
+                                uint8_t value);
+
+/**
+ * @brief   Register map device model configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Addressing options.
+   */
+  uint32_t                  flags;
+  /**
+   * @brief   Register read hook or @p NULL.
+   */
+  sim_reg_read_t            read;
+  /**
+   * @brief   Register write hook or @p NULL.
+   */
+  sim_reg_write_t           write;
+} SimRegisterMapConfig;
+
+/**
+ * @brief   Structure representing a register map device model.
+ * @details The model implements the usual sensors protocol on both SPI
+ *          and I2C buses:
+ *          - SPI, the first byte after the chip select is the register
+ *            address with bit 7 set for reads, the following bytes are
+ *            read or written starting from that register.
+ *          - I2C, the first byte written after the start condition is the
+ *            register address, the following bytes are written starting
+ *            from that register, reads start from the last addressed
+ *            register.
+ *          .
+ */
+struct SimRegisterMap {
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   SPI device interface.
+   */
+  sim_spi_device_t          spi;
+#endif
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   I2C device interface.
+   */
+  sim_i2c_device_t          i2c;
+#endif
+  /**
+   * @brief   Current configuration data.
+   */
+  const SimRegisterMapConfig *config;
+  /**
+   * @brief   Registers.
+   */
+  uint8_t                   regs[SIM_REG_MAP_SIZE];
+  /**
+   * @brief   Address increment enabled by the device configuration.
+   */
+  bool                      autoinc;
+  /**
+   * @brief   Current register address.
+   */
+  uint8_t                   ptr;
+  /**
+   * @brief   Address increment enabled for the current transaction.
+   */
+  bool                      inc;
+  /**
+   * @brief   Current transaction is a read.
+   */
+  bool                      rd;
+  /**
+   * @brief   Register address received in the current transaction.
+   */
+  bool                      addressed;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the SPI device interface of a model.
+ *
+ * @param[in] rmp       pointer to the @p SimRegisterMap object
+ * @return              The @p sim_spi_device_t interface.
+ *
+ * @xclass
+ */
+#define simregGetSpiDeviceX(rmp) (&(rmp)->spi)
+
+/**
+ * @brief   Returns the I2C device interface of a model.
+ *
+ * @param[in] rmp       pointer to the @p SimRegisterMap object
+ * @return              The @p sim_i2c_device_t interface.
+ *
+ * @xclass
+ */
+#define simregGetI2cDeviceX(rmp) (&(rmp)->i2c)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void simregObjectInit(SimRegisterMap *rmp,
+                        const SimRegisterMapConfig *config);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMREGMAP_H */
+
+/** @} */
@@ -0,0 +1,325 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/models/simsnor.c
+ * @brief   Posix simulator JEDEC serial NOR device model code.
+ *
+ * @addtogroup POSIX_SIMSNOR
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "simsnor.h"
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Supported commands
+ * @{
+ */
+#define CMD_PAGE_PROGRAM                    0x02U
+#define CMD_READ                            0x03U
+#define CMD_WRITE_DISABLE                   0x04U
+#define CMD_READ_STATUS                     0x05U
+#define CMD_WRITE_ENABLE                    0x06U
+#define CMD_FAST_READ                       0x0BU
+#define CMD_ERASE_4K                        0x20U
+#define CMD_ERASE_ALL_ALT                   0x60U
+#define CMD_READ_FLAG_STATUS                0x70U
+#define CMD_READ_ID                         0x9FU
+#define CMD_ERASE_ALL                       0xC7U
+#define CMD_ERASE_64K                       0xD8U
+/** @} */
+
+/**
+ * @name    Status and flag status bits
+ * @{
+ */
+#define STS_WIP                             0x01U
+#define STS_WEL                             0x02U
+#define FLAGS_READY                         0x80U
+/** @} */
+
+/**
+ * @name    Command states
+ * @{
+ */
+#define ST_COMMAND                          0U
+#define ST_ADDRESS                          1U
+#define ST_DUMMY                            2U
+#define ST_READ                             3U
+#define ST_PROGRAM                          4U
+#define ST_ID                               5U
+#define ST_STATUS                           6U
+#define ST_FLAG_STATUS                      7U
+#define ST_NO_DATA                          8U
+#define ST_IGNORE                           9U
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static bool snor_is_busy(SimSerialNOR *snp) {
+
+  return _sim_get_time_ns() < snp->busy_until;
+}
+
+static void snor_start_busy(SimSerialNOR *snp, uint32_t us) {
+
+  snp->busy_until = _sim_get_time_ns() + ((uint64_t)us * 1000U);
+  snp->wel        = false;
+}
+
+static void snor_erase(SimSerialNOR *snp, uint32_t size, uint32_t us) {
+  uint32_t base = snp->addr & ~(size - 1U) & (snp->config->size - 1U);
+
+  memset(&snp->config->array[base], 0xFF, size);
+  snp->stats.erases++;
+  snor_start_busy(snp, us);
+}
+
+static void snor_command(SimSerialNOR *snp, uint8_t cmd) {
+
+  snp->cmd   = cmd;
+  snp->count = 0U;
+  snp->addr  = 0U;
+
+  /* Only status commands are accepted while busy.*/
+  if (snor_is_busy(snp) &&
+      (cmd != CMD_READ_STATUS) && (cmd != CMD_READ_FLAG_STATUS)) {
+    snp->state = ST_IGNORE;
+    return;
+  }
+
+  switch (cmd) {
+  case CMD_READ:
+  case CMD_FAST_READ:
+  case CMD_PAGE_PROGRAM:
+  case CMD_ERASE_4K:
+  case CMD_ERASE_64K:
+    snp->state = ST_ADDRESS;
+    break;
+  case CMD_READ_ID:
+    snp->state = ST_ID;
+    break;
+  case CMD_READ_STATUS:
+    snp->state = ST_STATUS;
+    break;
+  case CMD_READ_FLAG_STATUS:
+    snp->state = ST_FLAG_STATUS;
+    break;
+  case CMD_WRITE_ENABLE:
+    snp->wel   = true;
+    snp->state = ST_NO_DATA;
+    break;
+  case CMD_WRITE_DISABLE:
+    snp->wel   = false;
+    snp->state = ST_NO_DATA;
+    break;
+  default:
+    /* Erase all is performed on deselection, other commands are not
+       modeled and ignored.*/
+    snp->state = ST_NO_DATA;
+    break;
+  }
+}
+
+static void snor_select(sim_spi_device_t *devp) {
+  SimSerialNOR *snp = (SimSerialNOR *)devp;
+
+  snp->state = ST_COMMAND;
+}
+
+static void snor_unselect(sim_spi_device_t *devp) {
+  SimSerialNOR *snp = (SimSerialNOR *)devp;
+
+  if ((snp->state == ST_COMMAND) || !snp->wel) {
+    return;
+  }
+
+  switch (snp->cmd) {
+  case CMD_PAGE_PROGRAM:
+    if ((snp->state == ST_PROGRAM) && (snp->count > 0U)) {
+      uint32_t base = snp->addr & ~(SIM_SNOR_PAGE_SIZE - 1U);
+      uint32_t i;
+
+      /* Programming can only clear bits.*/
+      for (i = 0U; i < SIM_SNOR_PAGE_SIZE; i++) {
+        snp->config->array[base + i] &= snp->page[i];
+      }
+      snp->stats.programs++;
+      snor_start_busy(snp, snp->config->program_us);
+    }
+    break;
+  case CMD_ERASE_4K:
+    if ((snp->state == ST_ADDRESS) && (snp->count >= 3U)) {
+      snor_erase(snp, 4096U, snp->config->erase_4k_us);
+    }
+    break;
+  case CMD_ERASE_64K:
+    if ((snp->state == ST_ADDRESS) && (snp->count >= 3U)) {
+      snor_erase(snp, 65536U, snp->config->erase_64k_us);
+    }
+    break;
+  case CMD_ERASE_ALL:
+  case CMD_ERASE_ALL_ALT:
+    if (snp->state != ST_NO_DATA) {
+      break;
+    }
+    memset(snp->config->array, 0xFF, snp->config->size);
+    snp->stats.erases++;
+    snor_start_busy(snp, snp->config->erase_all_us);
+    break;
+  default:
+    break;
+  }
+}
+
+static uint8_t snor_exchange(sim_spi_device_t *devp, uint8_t frame) {
+  SimSerialNOR *snp = (SimSerialNOR *)devp;
+  uint8_t data = 0xFFU;
+
+  switch (snp->state) {
+  case ST_COMMAND:
+    snor_command(snp, frame);
+    break;
+  case ST_ADDRESS:
+    snp->addr = ((snp->addr << 8) | frame) & (snp->config->size - 1U);
+    if (++snp->count == 3U) {
+      if (snp->cmd == CMD_READ) {
+        snp->state = ST_READ;
+      }
+      else if (snp->cmd == CMD_FAST_READ) {
+        snp->state = ST_DUMMY;
+      }
+      else if (snp->cmd == CMD_PAGE_PROGRAM) {
+        memset(snp->page, 0xFF, sizeof snp->page);
+        snp->state = ST_PROGRAM;
+        snp->count = 0U;
+      }
+    }
+    break;
+  case ST_DUMMY:
+    snp->state = ST_READ;
+    break;
+  case ST_READ:
+    data = snp->config->array[snp->addr];
+    snp->addr = (snp->addr + 1U) & (snp->config->size - 1U);
+    snp->stats.bytes_read++;
+    break;
+  case ST_PROGRAM:
+    /* Data exceeding the page size wraps within the page.*/
+    snp->page[(snp->addr + snp->count) & (SIM_SNOR_PAGE_SIZE - 1U)] = frame;
+    snp->count++;
+    break;
+  case ST_ID:
+    if (snp->count < snp->config->id_size) {
+      data = snp->config->id[snp->count];
+    }
+    else {
+      data = 0U;
+    }
+    snp->count++;
+    break;
+  case ST_STATUS:
+    data = snp->wel ? STS_WEL : 0U;
+    if (snor_is_busy(snp)) {
+      data |= STS_WIP;
+      snp->stats.busy_polls++;
+    }
+    break;
+  case ST_FLAG_STATUS:
+    if (snor_is_busy(snp)) {
+      data = 0U;
+      snp->stats.busy_polls++;
+    }
+    else {
+      data = FLAGS_READY;
+    }
+    break;
+  default:
+    break;
+  }
+
+  return data;
+}
+
+static const sim_spi_device_vmt_t snor_vmt = {
+  snor_select, snor_unselect, snor_exchange
+};
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ * @note    The memory array content is preserved.
+ *
+ * @param[out] snp      pointer to the @p SimSerialNOR object
+ * @param[in] config    pointer to the @p SimSerialNORConfig object
+ *
+ * @init
+ */
+void simsnorObjectInit(SimSerialNOR *snp, const SimSerialNORConfig *config) {
+
+  osalDbgCheck((config->size & (config->size - 1U)) == 0U);
+
+  snp->spi.vmt    = &snor_vmt;
+  snp->config     = config;
+  snp->wel        = false;
+  snp->busy_until = 0U;
+  snp->state      = ST_COMMAND;
+  snp->cmd        = 0U;
+  snp->count      = 0U;
+  snp->addr       = 0U;
+  simsnorResetStats(snp);
+}
+
+/**
+ * @brief   Resets the device statistics.
+ *
+ * @param[in] snp       pointer to the @p SimSerialNOR object
+ *
+ * @api
+ */
+void simsnorResetStats(SimSerialNOR *snp) {
+
+  snp->stats.bytes_read = 0U;
+  snp->stats.programs   = 0U;
+  snp->stats.erases     = 0U;
+  snp->stats.busy_polls = 0U;
+}
+
+#endif /* HAL_USE_SPI == TRUE */
+
+/** @} */
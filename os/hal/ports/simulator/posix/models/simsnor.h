@@ -0,0 +1,206 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/models/simsnor.h
+ * @brief   Posix simulator JEDEC serial NOR device model header.
+ *
+ * @addtogroup POSIX_SIMSNOR
+ * @{
+ */
+
+#ifndef SIMSNOR_H
+#define SIMSNOR_H
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Program page size.
+ */
+#define SIM_SNOR_PAGE_SIZE                  256U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated serial NOR configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Memory array.
+   * @note    The size must be a power of two.
+   */
+  uint8_t                   *array;
+  /**
+   * @brief   Memory array size.
+   */
+  uint32_t                  size;
+  /**
+   * @brief   Identification data returned by the READ ID command.
+   */
+  const uint8_t             *id;
+  /**
+   * @brief   Size of the identification data.
+   */
+  size_t                    id_size;
+  /**
+   * @brief   Page program time in microseconds.
+   */
+  uint32_t                  program_us;
+  /**
+   * @brief   4kB sub-sector erase time in microseconds.
+   */
+  uint32_t                  erase_4k_us;
+  /**
+   * @brief   64kB sector erase time in microseconds.
+   */
+  uint32_t                  erase_64k_us;
+  /**
+   * @brief   Bulk erase time in microseconds.
+   */
+  uint32_t                  erase_all_us;
+} SimSerialNORConfig;
+
+/**
+ * @brief   Simulated serial NOR statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Bytes read from the array.
+   */
+  uint64_t                  bytes_read;
+  /**
+   * @brief   Programmed pages.
+   */
+  uint32_t                  programs;
+  /**
+   * @brief   Erase operations.
+   */
+  uint32_t                  erases;
+  /**
+   * @brief   Status polls while busy.
+   */
+  uint32_t                  busy_polls;
+} sim_snor_stats_t;
+
+/**
+ * @brief   Structure representing a simulated serial NOR device.
+ * @details The model implements the common JEDEC command set with 3 bytes
+ *          addresses: READ ID, READ, FAST READ, WRITE ENABLE/DISABLE,
+ *          READ STATUS, READ FLAG STATUS, PAGE PROGRAM, 4kB/64kB ERASE
+ *          and BULK ERASE, other commands are accepted and ignored.<br>
+ *          Program and erase operations are performed on the array when
+ *          the chip select is deasserted, then the device reports itself
+ *          busy for the configured operation time.
+ */
+typedef struct {
+  /**
+   * @brief   SPI device interface.
+   */
+  sim_spi_device_t          spi;
+  /**
+   * @brief   Current configuration data.
+   */
+  const SimSerialNORConfig  *config;
+  /**
+   * @brief   Write enable latch.
+   */
+  bool                      wel;
+  /**
+   * @brief   End time of the program or erase operation in progress.
+   */
+  uint64_t                  busy_until;
+  /**
+   * @brief   Current command.
+   */
+  uint8_t                   cmd;
+  /**
+   * @brief   Command state.
+   */
+  uint32_t                  state;
+  /**
+   * @brief   Bytes received in the current state.
+   */
+  uint32_t                  count;
+  /**
+   * @brief   Current address.
+   */
+  uint32_t                  addr;
+  /**
+   * @brief   Page buffer.
+   */
+  uint8_t                   page[SIM_SNOR_PAGE_SIZE];
+  /**
+   * @brief   Device statistics.
+   */
+  sim_snor_stats_t          stats;
+} SimSerialNOR;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the SPI device interface of a model.
+ *
+ * @param[in] snp       pointer to the @p SimSerialNOR object
+ * @return              The @p sim_spi_device_t interface.
+ *
+ * @xclass
+ */
+#define simsnorGetSpiDeviceX(snp) (&(snp)->spi)
+
+/**
+ * @brief   Returns the device statistics.
+ *
+ * @param[in] snp       pointer to the @p SimSerialNOR object
+ * @return              A pointer to the @p sim_snor_stats_t structure.
+ *
+ * @xclass
+ */
+#define simsnorGetStatsX(snp) (&(snp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void simsnorObjectInit(SimSerialNOR *snp, const SimSerialNORConfig *config);
+  void simsnorResetStats(SimSerialNOR *snp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI == TRUE */
+
+#endif /* SIMSNOR_H */
+
+/** @} */
@@ -1,12 +1,22 @@
 # List of all the Posix platform files.
 PLATFORMSRC = ${CHIBIOS}/os/hal/ports/simulator/posix/hal_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/posix/hal_serial_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/hal_mac_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/hal_spi_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/hal_i2c_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/hal_adc_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/simblk.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/models/simregmap.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/models/simlis3dsh.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/models/simlsm6dsl.c \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/models/simsnor.c \
               ${CHIBIOS}/os/hal/ports/simulator/console.c \
               ${CHIBIOS}/os/hal/ports/simulator/hal_pal_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/hal_st_lld.c
 
 # Required include directories
 PLATFORMINC = ${CHIBIOS}/os/hal/ports/simulator/posix \
+              ${CHIBIOS}/os/hal/ports/simulator/posix/models \
               ${CHIBIOS}/os/hal/ports/simulator
 
 # Shared variables
@@ -0,0 +1,434 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/simblk.c
+ * @brief   Posix simulator block device code.
+ * @details The device implements the @p BaseBlockDevice interface on top
+ *          of a disk image file mapped in memory, the image can be
+ *          formatted and inspected on the host using the usual tools.<br>
+ *          Operations can be slowed down by a configurable latency, the
+ *          invoking thread sleeps for the latency time so other threads
+ *          can run like with a DMA capable device. Failures can be
+ *          injected using a callback invoked before each operation.
+ *
+ * @addtogroup POSIX_SIMBLK
+ * @{
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "hal.h"
+#include "simblk.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static bool simblk_is_inserted(void *instance);
+static bool simblk_is_protected(void *instance);
+static bool simblk_connect(void *instance);
+static bool simblk_disconnect(void *instance);
+static bool simblk_read(void *instance, uint32_t startblk,
+                        uint8_t *buffer, uint32_t n);
+static bool simblk_write(void *instance, uint32_t startblk,
+                         const uint8_t *buffer, uint32_t n);
+static bool simblk_sync(void *instance);
+static bool simblk_get_info(void *instance, BlockDeviceInfo *bdip);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct SimBlockDeviceVMT simblk_vmt = {
+  (size_t)0,
+  simblk_is_inserted,
+  simblk_is_protected,
+  simblk_connect,
+  simblk_disconnect,
+  simblk_read,
+  simblk_write,
+  simblk_sync,
+  simblk_get_info
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulates the latency of an operation.
+ *
+ * @param[in] us        latency in microseconds
+ */
+static void simblk_delay(uint32_t us) {
+
+  if (us > 0U) {
+    osalThreadSleep(OSAL_US2I(us));
+  }
+}
+
+/**
+ * @brief   Verifies if the injected failure model fails an operation.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] op        the operation about to be performed
+ * @param[in] startblk  first block of the operation
+ * @param[in] n         number of blocks of the operation
+ * @return              The injected failure.
+ */
+static bool simblk_fault(SimBlockDevice *sbdp, sim_blk_op_t op,
+                         uint32_t startblk, uint32_t n) {
+
+  if ((sbdp->config->fault != NULL) &&
+      sbdp->config->fault(sbdp, op, startblk, n)) {
+    sbdp->stats.faults++;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Maps a volatile disk in anonymous memory.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] config    pointer to the @p SimBlockConfig object
+ * @return              The operation status.
+ */
+static msg_t simblk_map_memory(SimBlockDevice *sbdp,
+                               const SimBlockConfig *config) {
+  void *p;
+
+  if (sbdp->blk_num == 0U) {
+    return HAL_RET_CONFIG_ERROR;
+  }
+
+  sbdp->size = (size_t)sbdp->blk_num * config->blk_size;
+  p = mmap(NULL, sbdp->size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    return HAL_RET_HW_FAILURE;
+  }
+  sbdp->image = (uint8_t *)p;
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Maps a disk image file.
+ * @details The file is created or enlarged if required, read only images
+ *          must be already large enough.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] config    pointer to the @p SimBlockConfig object
+ * @return              The operation status.
+ */
+static msg_t simblk_map_file(SimBlockDevice *sbdp,
+                             const SimBlockConfig *config) {
+  struct stat st;
+  void *p;
+  int fd;
+
+  fd = open(config->path, config->read_only ? O_RDONLY : (O_RDWR | O_CREAT),
+            0644);
+  if (fd < 0) {
+    return HAL_RET_HW_FAILURE;
+  }
+  if (fstat(fd, &st) != 0) {
+    (void) close(fd);
+    return HAL_RET_HW_FAILURE;
+  }
+
+  /* Size derived from the image file if not specified.*/
+  if (sbdp->blk_num == 0U) {
+    sbdp->blk_num = (uint32_t)((size_t)st.st_size / config->blk_size);
+    if (sbdp->blk_num == 0U) {
+      (void) close(fd);
+      return HAL_RET_CONFIG_ERROR;
+    }
+  }
+  sbdp->size = (size_t)sbdp->blk_num * config->blk_size;
+
+  if ((size_t)st.st_size < sbdp->size) {
+    if (config->read_only || (ftruncate(fd, (off_t)sbdp->size) != 0)) {
+      (void) close(fd);
+      return HAL_RET_HW_FAILURE;
+    }
+  }
+
+  p = mmap(NULL, sbdp->size,
+           config->read_only ? PROT_READ : (PROT_READ | PROT_WRITE),
+           MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    (void) close(fd);
+    return HAL_RET_HW_FAILURE;
+  }
+  sbdp->image = (uint8_t *)p;
+  sbdp->fd    = fd;
+
+  return HAL_RET_SUCCESS;
+}
+
+static bool simblk_is_inserted(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  return (sbdp->state != BLK_UNINIT) && (sbdp->state != BLK_STOP);
+}
+
+static bool simblk_is_protected(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  return (sbdp->config != NULL) && sbdp->config->read_only;
+}
+
+static bool simblk_connect(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state == BLK_READY) {
+    return HAL_SUCCESS;
+  }
+  if (sbdp->state != BLK_ACTIVE) {
+    return HAL_FAILED;
+  }
+
+  sbdp->state = BLK_READY;
+  return HAL_SUCCESS;
+}
+
+static bool simblk_disconnect(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state == BLK_ACTIVE) {
+    return HAL_SUCCESS;
+  }
+  if (sbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  sbdp->state = BLK_ACTIVE;
+  return HAL_SUCCESS;
+}
+
+static bool simblk_read(void *instance, uint32_t startblk,
+                        uint8_t *buffer, uint32_t n) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+  uint32_t blk_size;
+
+  if ((sbdp->state != BLK_READY) ||
+      (n > sbdp->blk_num) || (startblk > sbdp->blk_num - n)) {
+    return HAL_FAILED;
+  }
+
+  blk_size = sbdp->config->blk_size;
+  sbdp->state = BLK_READING;
+  simblk_delay(sbdp->config->access_us + (n * sbdp->config->read_us));
+  if (simblk_fault(sbdp, SIM_BLK_OP_READ, startblk, n)) {
+    sbdp->state = BLK_READY;
+    return HAL_FAILED;
+  }
+  memcpy(buffer, sbdp->image + ((size_t)startblk * blk_size),
+         (size_t)n * blk_size);
+  sbdp->stats.reads++;
+  sbdp->stats.blocks_read += n;
+  sbdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool simblk_write(void *instance, uint32_t startblk,
+                         const uint8_t *buffer, uint32_t n) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+  uint32_t blk_size;
+
+  if ((sbdp->state != BLK_READY) || sbdp->config->read_only ||
+      (n > sbdp->blk_num) || (startblk > sbdp->blk_num - n)) {
+    return HAL_FAILED;
+  }
+
+  blk_size = sbdp->config->blk_size;
+  sbdp->state = BLK_WRITING;
+  simblk_delay(sbdp->config->access_us + (n * sbdp->config->write_us));
+  if (simblk_fault(sbdp, SIM_BLK_OP_WRITE, startblk, n)) {
+    sbdp->state = BLK_READY;
+    return HAL_FAILED;
+  }
+  memcpy(sbdp->image + ((size_t)startblk * blk_size), buffer,
+         (size_t)n * blk_size);
+  sbdp->stats.writes++;
+  sbdp->stats.blocks_written += n;
+  sbdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool simblk_sync(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  sbdp->state = BLK_SYNCING;
+  simblk_delay(sbdp->config->access_us);
+  if (simblk_fault(sbdp, SIM_BLK_OP_SYNC, 0U, 0U)) {
+    sbdp->state = BLK_READY;
+    return HAL_FAILED;
+  }
+  if ((sbdp->fd >= 0) && !sbdp->config->read_only) {
+    (void) msync(sbdp->image, sbdp->size, MS_SYNC);
+  }
+  sbdp->stats.syncs++;
+  sbdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool simblk_get_info(void *instance, BlockDeviceInfo *bdip) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  bdip->blk_size = sbdp->config->blk_size;
+  bdip->blk_num  = sbdp->blk_num;
+
+  return HAL_SUCCESS;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] sbdp     pointer to the @p SimBlockDevice object
+ *
+ * @init
+ */
+void simblkObjectInit(SimBlockDevice *sbdp) {
+
+  sbdp->vmt     = &simblk_vmt;
+  sbdp->state   = BLK_STOP;
+  sbdp->config  = NULL;
+  sbdp->image   = NULL;
+  sbdp->size    = (size_t)0;
+  sbdp->blk_num = 0U;
+  sbdp->fd      = -1;
+  simblkResetStats(sbdp);
+}
+
+/**
+ * @brief   Configures and activates the simulated block device.
+ * @details The disk image is opened and mapped in memory, the device is
+ *          left in the @p BLK_ACTIVE state, a connection is required
+ *          before performing I/O operations.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] config    pointer to the @p SimBlockConfig object
+ * @return              The operation status.
+ * @retval HAL_RET_SUCCESS      if the device has been activated.
+ * @retval HAL_RET_CONFIG_ERROR if the configuration is not valid.
+ * @retval HAL_RET_HW_FAILURE   if the disk image cannot be accessed.
+ *
+ * @api
+ */
+msg_t simblkStart(SimBlockDevice *sbdp, const SimBlockConfig *config) {
+  msg_t msg;
+
+  osalDbgCheck((sbdp != NULL) && (config != NULL));
+  osalDbgAssert(sbdp->state == BLK_STOP, "invalid state");
+
+  if (config->blk_size == 0U) {
+    return HAL_RET_CONFIG_ERROR;
+  }
+
+  sbdp->blk_num = config->blk_num;
+  if (config->path == NULL) {
+    msg = simblk_map_memory(sbdp, config);
+  }
+  else {
+    msg = simblk_map_file(sbdp, config);
+  }
+  if (msg != HAL_RET_SUCCESS) {
+    return msg;
+  }
+
+  sbdp->config = config;
+  sbdp->state  = BLK_ACTIVE;
+  simblkResetStats(sbdp);
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Deactivates the simulated block device.
+ * @details The disk image is synchronized and unmapped.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ *
+ * @api
+ */
+void simblkStop(SimBlockDevice *sbdp) {
+
+  osalDbgCheck(sbdp != NULL);
+  osalDbgAssert((sbdp->state == BLK_STOP) || (sbdp->state == BLK_ACTIVE) ||
+                (sbdp->state == BLK_READY), "invalid state");
+
+  if (sbdp->state != BLK_STOP) {
+    if ((sbdp->fd >= 0) && !sbdp->config->read_only) {
+      (void) msync(sbdp->image, sbdp->size, MS_SYNC);
+    }
+    (void) munmap(sbdp->image, sbdp->size);
+    if (sbdp->fd >= 0) {
+      (void) close(sbdp->fd);
+      sbdp->fd = -1;
+    }
+    sbdp->image = NULL;
+    sbdp->state = BLK_STOP;
+  }
+}
+
+/**
+ * @brief   Clears the device statistics.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ *
+ * @api
+ */
+void simblkResetStats(SimBlockDevice *sbdp) {
+
+  memset(&sbdp->stats, 0, sizeof (sbdp->stats));
+}
+
+/** @} */
@@ -0,0 +1,225 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/simblk.h
+ * @brief   Posix simulator block device header.
+ *
+ * @addtogroup POSIX_SIMBLK
+ * @{
+ */
+
+#ifndef SIMBLK_H
+#define SIMBLK_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated block device operations.
+ */
+typedef enum {
+  SIM_BLK_OP_READ = 0,              /**< Blocks read.                       */
+  SIM_BLK_OP_WRITE = 1,             /**< Blocks write.                      */
+  SIM_BLK_OP_SYNC = 2               /**< Writes synchronization.            */
+} sim_blk_op_t;
+
+/**
+ * @brief   Type of a simulated block device.
+ */
+typedef struct SimBlockDevice SimBlockDevice;
+
+/**
+ * @brief   Failure model callback.
+ * @details The callback is invoked before each operation is performed on
+ *          the disk image, returning @p true makes the operation fail
+ *          without touching the image.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] op        the operation about to be performed
+ * @param[in] startblk  first block of the operation
+ * @param[in] n         number of blocks of the operation, zero for
+ *                      synchronizations
+ * @return              The injected failure.
+ * @retval false        the operation is performed.
+ * @retval true         the operation fails.
+ */
+typedef bool (*sim_blk_fault_t)(SimBlockDevice *sbdp, sim_blk_op_t op,
+                                uint32_t startblk, uint32_t n);
+
+/**
+ * @brief   Simulated block device configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Path of the disk image file.
+   * @details The file is created if it does not exist and it is enlarged
+   *          if smaller than the configured size. If @p NULL then the disk
+   *          is kept in anonymous memory and it is lost on stop.
+   */
+  const char                *path;
+  /**
+   * @brief   Block size in bytes.
+   */
+  uint32_t                  blk_size;
+  /**
+   * @brief   Total number of blocks.
+   * @details If zero then the number of blocks is derived from the size of
+   *          the existing image file.
+   */
+  uint32_t                  blk_num;
+  /**
+   * @brief   Write protected media.
+   * @note    The image file is opened and mapped read only.
+   */
+  bool                      read_only;
+  /**
+   * @brief   Latency of each operation in microseconds.
+   */
+  uint32_t                  access_us;
+  /**
+   * @brief   Additional latency of each read block in microseconds.
+   */
+  uint32_t                  read_us;
+  /**
+   * @brief   Additional latency of each written block in microseconds.
+   */
+  uint32_t                  write_us;
+  /**
+   * @brief   Failure model callback or @p NULL.
+   */
+  sim_blk_fault_t           fault;
+} SimBlockConfig;
+
+/**
+ * @brief   Simulated block device statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Read operations.
+   */
+  uint32_t                  reads;
+  /**
+   * @brief   Write operations.
+   */
+  uint32_t                  writes;
+  /**
+   * @brief   Synchronization operations.
+   */
+  uint32_t                  syncs;
+  /**
+   * @brief   Read blocks.
+   */
+  uint64_t                  blocks_read;
+  /**
+   * @brief   Written blocks.
+   */
+  uint64_t                  blocks_written;
+  /**
+   * @brief   Operations failed because of an injected failure.
+   */
+  uint32_t                  faults;
+} sim_blk_stats_t;
+
+/**
+ * @brief   @p SimBlockDevice specific methods.
+ */
+#define _sim_block_device_methods                                           \
+  _base_block_device_methods
+
+/**
+ * @brief   @p SimBlockDevice specific data.
+ */
+#define _sim_block_device_data                                              \
+  _base_block_device_data                                                   \
+  /* Current configuration data.*/                                          \
+  const SimBlockConfig      *config;                                        \
+  /* Mapped disk image.*/                                                   \
+  uint8_t                   *image;                                         \
+  /* Size of the mapped disk image.*/                                       \
+  size_t                    size;                                           \
+  /* Total number of blocks.*/                                              \
+  uint32_t                  blk_num;                                        \
+  /* Image file descriptor or -1.*/                                         \
+  int                       fd;                                             \
+  /* Device statistics.*/                                                   \
+  sim_blk_stats_t           stats;
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p SimBlockDevice virtual methods table.
+ */
+struct SimBlockDeviceVMT {
+  _sim_block_device_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Simulated block device backed by a memory mapped disk image.
+ */
+struct SimBlockDevice {
+  /** @brief Virtual Methods Table.*/
+  const struct SimBlockDeviceVMT *vmt;
+  _sim_block_device_data
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the device statistics.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @return              A pointer to the @p sim_blk_stats_t structure.
+ *
+ * @xclass
+ */
+#define simblkGetStatsX(sbdp) (&(sbdp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void simblkObjectInit(SimBlockDevice *sbdp);
+  msg_t simblkStart(SimBlockDevice *sbdp, const SimBlockConfig *config);
+  void simblkStop(SimBlockDevice *sbdp);
+  void simblkResetStats(SimBlockDevice *sbdp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMBLK_H */
+
+/** @} */
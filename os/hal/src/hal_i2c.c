@@ -263,6 +263,52 @@ msg_t i2cMasterReceiveTimeout(I2CDriver *i2cp,
   return rdymsg;
 }
 
+#if (I2C_SUPPORTS_ASYNC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous transaction on the I2C bus.
+ * @details The transmit phase is followed by a receive phase after a
+ *          repeated start, one of the two phases can be empty. The
+ *          callback is invoked from ISR context at the end of the
+ *          transaction, errors can be retrieved using @p i2cGetErrors()
+ *          from within the callback.
+ * @pre     In order to use this function the low level driver must
+ *          support asynchronous transactions.
+ * @note    There is no timeout, the transaction is always completed by
+ *          the low level driver.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address (7 bits) without R/W bit
+ * @param[in] txbuf     pointer to transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] end_cb    callback invoked at the end of the transaction
+ *
+ * @iclass
+ */
+void i2cStartMasterTransmitI(I2CDriver *i2cp,
+                             i2caddr_t addr,
+                             const uint8_t *txbuf,
+                             size_t txbytes,
+                             uint8_t *rxbuf,
+                             size_t rxbytes,
+                             i2ccallback_t end_cb) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((i2cp != NULL) && (end_cb != NULL) &&
+               ((txbytes > 0U) || (rxbytes > 0U)) &&
+               ((txbytes == 0U) || (txbuf != NULL)) &&
+               ((rxbytes == 0U) || (rxbuf != NULL)));
+
+  osalDbgAssert(i2cp->state == I2C_READY, "not ready");
+
+  i2cp->errors = I2C_NO_ERROR;
+  i2cp->state  = txbytes > 0U ? I2C_ACTIVE_TX : I2C_ACTIVE_RX;
+  i2cp->end_cb = end_cb;
+  i2c_lld_start_master_transmit(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes);
+}
+#endif /* I2C_SUPPORTS_ASYNC == TRUE */
+
 #if (I2C_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Gains exclusive access to the I2C bus.
@@ -183,6 +183,18 @@
 #include "chconf.h"
 #include "chlicense.h"
 
+/**
+ * @brief   Timeouts heap.
+ * @details If enabled the armed timeouts are kept in a deadlines heap, the
+ *          system tick handler only touches the expired threads and the
+ *          next deadline is found in constant time. If disabled all the
+ *          threads are scanned on each tick or alarm event.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_TIMEOUTS_HEAP) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TIMEOUTS_HEAP            FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -329,7 +341,7 @@
 #error "at least one thread must be defined"
 #endif
 
-#if CH_CFG_MAX_THREADS > 16
+#if CH_CFG_MAX_THREADS > 64
 #error "ChibiOS/NIL is not recommended for thread-intensive applications,"  \
        "consider ChibiOS/RT instead"
 #endif
@@ -446,6 +458,23 @@ typedef uint16_t sysinterval_t;
 typedef uint32_t time_conv_t;
 #endif
 
+#if (CH_CFG_MAX_THREADS <= 8) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a threads mask.
+ * @details One bit for each user thread, the most significant bit is the
+ *          thread with priority zero.
+ * @note    The width is the smallest able to contain
+ *          @p CH_CFG_MAX_THREADS bits.
+ */
+typedef uint8_t thdmask_t;
+#elif CH_CFG_MAX_THREADS <= 16
+typedef uint16_t thdmask_t;
+#elif CH_CFG_MAX_THREADS <= 32
+typedef uint32_t thdmask_t;
+#else
+typedef uint64_t thdmask_t;
+#endif
+
 /**
  * @brief   Type of a structure representing the system.
  */
@@ -494,6 +523,7 @@ typedef threads_queue_t semaphore_t;
  */
 struct nil_threads_queue {
   volatile cnt_t    cnt;        /**< @brief Threads Queue counter.          */
+  thdmask_t         waiters;    /**< @brief Mask of the waiting threads.    */
 };
 
 /**
@@ -514,6 +544,11 @@ struct nil_thread_descriptor {
 struct nil_thread {
   struct port_context   ctx;        /**< @brief Processor context.          */
   tstate_t              state;      /**< @brief Thread state.               */
+#if (CH_CFG_USE_TIMEOUTS_HEAP == TRUE) || defined(__DOXYGEN__)
+  uint8_t               tmpos;      /**< @brief Position in the timeouts
+                                                heap plus one, zero if
+                                                the timeout is disabled.    */
+#endif
   /* Note, the following union contains a pointer/value while the thread is
      in a sleeping state or a wake-up message when the thread is made ready.*/
   union {
@@ -530,8 +565,13 @@ struct nil_thread {
     eventmask_t         ewmask;     /**< @brief Enabled events mask.        */
 #endif
   } u1;
+#if (CH_CFG_USE_TIMEOUTS_HEAP == FALSE) || defined(__DOXYGEN__)
   volatile sysinterval_t timeout;   /**< @brief Timeout counter, zero
                                                 if disabled.                */
+#endif
+#if (CH_CFG_USE_TIMEOUTS_HEAP == TRUE) || defined(__DOXYGEN__)
+  systime_t             deadline;   /**< @brief Timeout deadline.           */
+#endif
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
   eventmask_t           epmask;     /**< @brief Pending events mask.        */
 #endif
@@ -561,6 +601,12 @@ struct nil_os_instance {
    *          or to an higher priority thread if a switch is required.
    */
   thread_t              *next;
+  /**
+   * @brief   Mask of the ready threads.
+   * @note    The idle thread is not part of the mask, it is selected when
+   *          the mask is zero.
+   */
+  thdmask_t             rdmask;
 #if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
   /**
    * @brief   System time.
@@ -577,6 +623,17 @@ struct nil_os_instance {
    */
   systime_t             nexttime;
 #endif
+#if (CH_CFG_USE_TIMEOUTS_HEAP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of armed timeouts.
+   */
+  ucnt_t                tmcnt;
+  /**
+   * @brief   Timeouts heap, the root is the thread with the nearest
+   *          deadline.
+   */
+  thread_t              *tmheap[CH_CFG_MAX_THREADS];
+#endif
 #if (CH_DBG_SYSTEM_STATE_CHECK == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   ISR nesting level.
@@ -617,6 +674,25 @@ struct nil_os_instance {
  */
 #define __CH_STRINGIFY(a) #a
 
+/**
+ * @name    Threads masks macros
+ * @{
+ */
+/**
+ * @brief   Width of a threads mask in bits.
+ */
+#define NIL_THD_MASK_BITS       (sizeof (thdmask_t) * 8U)
+
+/**
+ * @brief   Mask bit of the specified thread.
+ *
+ * @param[in] tp        pointer to a user thread
+ */
+#define NIL_THD_MASK(tp)                                                    \
+  ((thdmask_t)((thdmask_t)1 << (NIL_THD_MASK_BITS - 1U -                    \
+                                (unsigned)((tp) - &nil.threads[0]))))
+/** @} */
+
 /**
  * @name    Threads tables definition macros
  * @{
@@ -961,7 +1037,7 @@ struct nil_os_instance {
  *
  * @param[in] name      the name of the threads queue variable
  */
-#define __THREADS_QUEUE_DATA(name) {(cnt_t)0}
+#define __THREADS_QUEUE_DATA(name) {(cnt_t)0, (thdmask_t)0}
 
 /**
  * @brief   Static threads queue object initializer.
@@ -1223,7 +1299,10 @@ struct nil_os_instance {
  *
  * @init
  */
-#define chThdQueueObjectInit(tqp) ((tqp)->cnt = (cnt_t)0)
+#define chThdQueueObjectInit(tqp) do {                                      \
+  (tqp)->cnt = (cnt_t)0;                                                    \
+  (tqp)->waiters = (thdmask_t)0;                                            \
+} while (false)
 
 /**
  * @brief   Evaluates to @p true if the specified queue is empty.
@@ -1389,7 +1468,7 @@ extern const thread_descriptor_t nil_thd_configs[];
 extern "C" {
 #endif
   thread_t *nil_find_thread(tstate_t state, void *p);
-  cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg);
+  cnt_t nil_ready_all(threads_queue_t *tqp, cnt_t cnt, msg_t msg);
   void chSysInit(void);
   void chSysHalt(const char *reason);
   void chSysTimerHandlerI(void);
@@ -1437,6 +1516,60 @@ extern "C" {
 }
 #endif
 
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Counts the leading zeros of a threads mask.
+ * @note    Compilers supporting the GCC builtins use the CLZ instruction
+ *          where available.
+ *
+ * @param[in] mask      the threads mask, it must not be zero
+ * @return              The number of leading zero bits.
+ *
+ * @notapi
+ */
+static inline unsigned nil_thd_mask_clz(thdmask_t mask) {
+
+#if defined(__GNUC__)
+#if CH_CFG_MAX_THREADS <= 32
+  return (unsigned)__builtin_clzl((unsigned long)mask) -
+         (unsigned)((sizeof (unsigned long) * 8U) - NIL_THD_MASK_BITS);
+#else
+  return (unsigned)__builtin_clzll((unsigned long long)mask) -
+         (unsigned)((sizeof (unsigned long long) * 8U) - NIL_THD_MASK_BITS);
+#endif
+#else
+  unsigned n = 0U;
+  unsigned w = NIL_THD_MASK_BITS / 2U;
+
+  /* Binary search, constant number of steps.*/
+  while (w > 0U) {
+    if ((mask >> (NIL_THD_MASK_BITS - w)) == (thdmask_t)0) {
+      mask <<= w;
+      n += w;
+    }
+    w >>= 1;
+  }
+
+  return n;
+#endif
+}
+
+/**
+ * @brief   Returns the highest priority thread in a threads mask.
+ *
+ * @param[in] mask      the threads mask, it must not be zero
+ * @return              The pointer to the thread.
+ *
+ * @notapi
+ */
+static inline thread_t *nil_thd_mask_first(thdmask_t mask) {
+
+  return &nil.threads[nil_thd_mask_clz(mask)];
+}
+
 /* Optional modules.*/
 #include "chsem.h"
 #include "chevt.h"
@@ -63,7 +63,7 @@
  * @param[in] n         the counter initial value, this value must be
  *                      non-negative
  */
-#define __SEMAPHORE_DATA(name, n) {n}
+#define __SEMAPHORE_DATA(name, n) {n, (thdmask_t)0}
 
 /**
  * @brief   Static semaphore initializer.
@@ -90,7 +90,10 @@
  *
  * @init
  */
-#define chSemObjectInit(sp, n) ((sp)->cnt = (n))
+#define chSemObjectInit(sp, n) do {                                         \
+  (sp)->cnt = (n);                                                          \
+  (sp)->waiters = (thdmask_t)0;                                             \
+} while (false)
 
 /**
  * @brief   Performs a reset operation on the semaphore.
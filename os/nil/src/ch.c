@@ -31,6 +31,19 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMEOUTS_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reference time for the deadlines comparison.
+ * @note    All the armed deadlines lie within one interval after the
+ *          reference time.
+ */
+#if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
+#define TMH_REFTIME()               nil.systime
+#else
+#define TMH_REFTIME()               nil.lasttime
+#endif
+#endif /* CH_CFG_USE_TIMEOUTS_HEAP == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -48,6 +61,163 @@ os_instance_t nil;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMEOUTS_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Compares the deadlines of two threads.
+ *
+ * @param[in] tp1       pointer to the first thread
+ * @param[in] tp2       pointer to the second thread
+ * @return              The comparison result.
+ * @retval true         if the first thread expires before the second one.
+ * @retval false        otherwise.
+ *
+ * @notapi
+ */
+static inline bool tmh_before(thread_t *tp1, thread_t *tp2) {
+  systime_t ref = TMH_REFTIME();
+
+  return chTimeDiffX(ref, tp1->deadline) < chTimeDiffX(ref, tp2->deadline);
+}
+
+/**
+ * @brief   Stores a thread into a heap slot.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] i         heap slot index
+ *
+ * @notapi
+ */
+static inline void tmh_place(thread_t *tp, ucnt_t i) {
+
+  nil.tmheap[i] = tp;
+  tp->tmpos = (uint8_t)(i + (ucnt_t)1);
+}
+
+/**
+ * @brief   Moves a thread toward the heap root.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] i         starting heap slot index
+ *
+ * @notapi
+ */
+static void tmh_sift_up(thread_t *tp, ucnt_t i) {
+
+  while (i > (ucnt_t)0) {
+    ucnt_t parent = (i - (ucnt_t)1) / (ucnt_t)2;
+
+    if (!tmh_before(tp, nil.tmheap[parent])) {
+      break;
+    }
+    tmh_place(nil.tmheap[parent], i);
+    i = parent;
+  }
+  tmh_place(tp, i);
+}
+
+/**
+ * @brief   Moves a thread toward the heap leaves.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] i         starting heap slot index
+ *
+ * @notapi
+ */
+static void tmh_sift_down(thread_t *tp, ucnt_t i) {
+
+  while (true) {
+    ucnt_t child = (i * (ucnt_t)2) + (ucnt_t)1;
+
+    if (child >= nil.tmcnt) {
+      break;
+    }
+    if ((child + (ucnt_t)1 < nil.tmcnt) &&
+        tmh_before(nil.tmheap[child + (ucnt_t)1], nil.tmheap[child])) {
+      child++;
+    }
+    if (!tmh_before(nil.tmheap[child], tp)) {
+      break;
+    }
+    tmh_place(nil.tmheap[child], i);
+    i = child;
+  }
+  tmh_place(tp, i);
+}
+
+/**
+ * @brief   Arms a thread timeout.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] deadline  absolute time of the timeout event
+ *
+ * @notapi
+ */
+static void tmh_insert(thread_t *tp, systime_t deadline) {
+
+  chDbgAssert(tp->tmpos == 0U, "already armed");
+  chDbgAssert(nil.tmcnt < (ucnt_t)CH_CFG_MAX_THREADS, "heap overflow");
+
+  tp->deadline = deadline;
+  nil.tmcnt++;
+  tmh_sift_up(tp, nil.tmcnt - (ucnt_t)1);
+}
+
+/**
+ * @brief   Disarms a thread timeout.
+ *
+ * @param[in] tp        pointer to the thread
+ *
+ * @notapi
+ */
+static void tmh_remove(thread_t *tp) {
+  ucnt_t i = (ucnt_t)tp->tmpos - (ucnt_t)1;
+  thread_t *ltp;
+
+  chDbgAssert(nil.tmheap[i] == tp, "heap corrupted");
+
+  tp->tmpos = 0U;
+  nil.tmcnt--;
+  if (i == nil.tmcnt) {
+    return;
+  }
+
+  /* The last element takes the free slot then it is moved in the right
+     direction.*/
+  ltp = nil.tmheap[nil.tmcnt];
+  if ((i > (ucnt_t)0) &&
+      tmh_before(ltp, nil.tmheap[(i - (ucnt_t)1) / (ucnt_t)2])) {
+    tmh_sift_up(ltp, i);
+  }
+  else {
+    tmh_sift_down(ltp, i);
+  }
+}
+
+/**
+ * @brief   Wakes up the thread with the nearest deadline.
+ * @note    The thread is removed from the heap by @p chSchReadyI().
+ *
+ * @notapi
+ */
+static void tmh_expire_first(void) {
+  thread_t *tp = nil.tmheap[0];
+
+  chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
+
+  /* Timeout on thread queues requires a special handling because the
+     counter must be incremented.*/
+  if (NIL_THD_IS_WTQUEUE(tp)) {
+    tp->u1.tqp->cnt++;
+  }
+  else {
+    if (NIL_THD_IS_SUSPENDED(tp)) {
+      *tp->u1.trp = NULL;
+    }
+  }
+  (void) chSchReadyI(tp, MSG_TIMEOUT);
+}
+#endif /* CH_CFG_USE_TIMEOUTS_HEAP == TRUE */
+
 /*===========================================================================*/
 /* Module interrupt handlers.                                                */
 /*===========================================================================*/
@@ -81,10 +251,9 @@ thread_t *nil_find_thread(tstate_t state, void *p) {
 }
 
 /**
- * @brief   Puts in ready state all thread matching the specified status and
- *          associated object.
+ * @brief   Puts in ready state all thread waiting on the specified queue.
  *
- * @param[in] p         object pointer
+ * @param[in] tqp       pointer to the threads queue object
  * @param[in] cnt       number of threads to be readied as a negative number,
  *                      non negative numbers are ignored
  * @param[in] msg       the wakeup message
@@ -92,20 +261,15 @@ thread_t *nil_find_thread(tstate_t state, void *p) {
  *
  * @notapi
  */
-cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg) {
-  thread_t *tp = nil.threads;;
+cnt_t nil_ready_all(threads_queue_t *tqp, cnt_t cnt, msg_t msg) {
 
   while (cnt < (cnt_t)0) {
 
-    chDbgAssert(tp < &nil.threads[CH_CFG_MAX_THREADS],
-                "pointer out of range");
+    chDbgAssert(tqp->waiters != (thdmask_t)0, "thread not found");
 
-    /* Is this thread waiting on this queue?*/
-    if ((tp->state == NIL_STATE_WTQUEUE) && (tp->u1.p == p)) {
-      cnt++;
-      (void) chSchReadyI(tp, msg);
-    }
-    tp++;
+    /* Readying the thread also removes it from the waiters mask.*/
+    cnt++;
+    (void) chSchReadyI(nil_thd_mask_first(tqp->waiters), msg);
   }
 
   return cnt;
@@ -356,6 +520,48 @@ void chSysTimerHandlerI(void) {
 
   chDbgCheckClassI();
 
+#if CH_CFG_USE_TIMEOUTS_HEAP == TRUE
+#if CH_CFG_ST_TIMEDELTA == 0
+  nil.systime++;
+
+  /* Only the expired threads are touched, the heap root is the nearest
+     deadline.*/
+  while ((nil.tmcnt > (ucnt_t)0) && (nil.tmheap[0]->deadline == nil.systime)) {
+    tmh_expire_first();
+
+    /* Lock released in order to give a preemption chance on those
+       architectures supporting IRQ preemption.*/
+    chSysUnlockFromISR();
+    chSysLockFromISR();
+  }
+#else
+  sysinterval_t elapsed = chTimeDiffX(nil.lasttime, nil.nexttime);
+
+  chDbgAssert(nil.nexttime == port_timer_get_alarm(), "time mismatch");
+
+  /* Only the expired threads are touched, the heap root is the nearest
+     deadline.*/
+  while ((nil.tmcnt > (ucnt_t)0) &&
+         (chTimeDiffX(nil.lasttime, nil.tmheap[0]->deadline) <= elapsed)) {
+    tmh_expire_first();
+
+    /* Lock released in order to give a preemption chance on those
+       architectures supporting IRQ preemption.*/
+    chSysUnlockFromISR();
+    chSysLockFromISR();
+  }
+
+  nil.lasttime = nil.nexttime;
+  if (nil.tmcnt > (ucnt_t)0) {
+    nil.nexttime = nil.tmheap[0]->deadline;
+    port_timer_set_alarm(nil.nexttime);
+  }
+  else {
+    /* No tick event needed.*/
+    port_timer_stop_alarm();
+  }
+#endif
+#else /* CH_CFG_USE_TIMEOUTS_HEAP == FALSE */
 #if CH_CFG_ST_TIMEDELTA == 0
   thread_t *tp = &nil.threads[0];
   nil.systime++;
@@ -446,6 +652,7 @@ void chSysTimerHandlerI(void) {
     port_timer_stop_alarm();
   }
 #endif
+#endif /* CH_CFG_USE_TIMEOUTS_HEAP == FALSE */
 }
 
 /**
@@ -585,9 +792,21 @@ thread_t *chSchReadyI(thread_t *tp, msg_t msg) {
   chDbgAssert(!NIL_THD_IS_READY(tp), "already ready");
   chDbgAssert(nil.next <= nil.current, "priority ordering");
 
+  /* Removing the thread from the queue it is waiting on, if any.*/
+  if (NIL_THD_IS_WTQUEUE(tp)) {
+    tp->u1.tqp->waiters &= (thdmask_t)~NIL_THD_MASK(tp);
+  }
+
   tp->u1.msg = msg;
   tp->state = NIL_STATE_READY;
+#if CH_CFG_USE_TIMEOUTS_HEAP == TRUE
+  if (tp->tmpos != 0U) {
+    tmh_remove(tp);
+  }
+#else
   tp->timeout = (sysinterval_t)0;
+#endif
+  nil.rdmask |= NIL_THD_MASK(tp);
   if (tp < nil.next) {
     nil.next = tp;
   }
@@ -670,6 +889,10 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
 
   /* Storing the wait object for the current thread.*/
   otp->state = newstate;
+  nil.rdmask &= (thdmask_t)~NIL_THD_MASK(otp);
+  if (newstate == NIL_STATE_WTQUEUE) {
+    otp->u1.tqp->waiters |= NIL_THD_MASK(otp);
+  }
 
 #if CH_CFG_ST_TIMEDELTA > 0
   if (timeout != TIME_INFINITE) {
@@ -687,6 +910,11 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
     if (nil.lasttime == nil.nexttime) {
       /* Special case, first thread asking for a timeout.*/
       port_timer_start_alarm(abstime);
+#if CH_CFG_USE_TIMEOUTS_HEAP == TRUE
+      /* The heap is empty, the reference time is moved forward to the
+         current time.*/
+      nil.lasttime = (systime_t)(abstime - (systime_t)timeout);
+#endif
       nil.nexttime = abstime;
     }
     else {
@@ -699,32 +927,39 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
     }
 
     /* Timeout settings.*/
+#if CH_CFG_USE_TIMEOUTS_HEAP == TRUE
+    tmh_insert(otp, abstime);
+#else
     otp->timeout = abstime - nil.lasttime;
+#endif
   }
 #else
 
   /* Timeout settings.*/
+#if CH_CFG_USE_TIMEOUTS_HEAP == TRUE
+  if (timeout != TIME_INFINITE) {
+    tmh_insert(otp, chTimeAddX(nil.systime, timeout));
+  }
+#else
   otp->timeout = timeout;
+#endif
 #endif
 
-  /* Scanning the whole threads array.*/
-  ntp = nil.threads;
-  while (true) {
-    /* Is this thread ready to execute?*/
-    if (NIL_THD_IS_READY(ntp)) {
-      nil.current = nil.next = ntp;
-      if (ntp == &nil.threads[CH_CFG_MAX_THREADS]) {
-        CH_CFG_IDLE_ENTER_HOOK();
-      }
-      port_switch(ntp, otp);
-      return nil.current->u1.msg;
-    }
+  /* The highest priority ready thread is selected from the ready mask, the
+     idle thread if there are no ready threads.*/
+  if (nil.rdmask != (thdmask_t)0) {
+    ntp = nil_thd_mask_first(nil.rdmask);
 
-    /* Points to the next thread in lowering priority order.*/
-    ntp++;
-    chDbgAssert(ntp <= &nil.threads[CH_CFG_MAX_THREADS],
-                "pointer out of range");
+    chDbgAssert(NIL_THD_IS_READY(ntp), "not ready");
+  }
+  else {
+    ntp = &nil.threads[CH_CFG_MAX_THREADS];
+    CH_CFG_IDLE_ENTER_HOOK();
   }
+  nil.current = nil.next = ntp;
+  port_switch(ntp, otp);
+
+  return nil.current->u1.msg;
 }
 
 /**
@@ -1030,16 +1265,12 @@ msg_t chThdEnqueueTimeoutS(threads_queue_t *tqp, sysinterval_t timeout) {
  * @iclass
  */
 void chThdDoDequeueNextI(threads_queue_t *tqp, msg_t msg) {
-  thread_t *tp;
 
   chDbgAssert(tqp->cnt < (cnt_t)0, "empty queue");
+  chDbgAssert(tqp->waiters != (thdmask_t)0, "thread not found");
 
   tqp->cnt++;
-  tp = nil_find_thread(NIL_STATE_WTQUEUE, (void *)tqp);
-
-  chDbgAssert(tp != NULL, "thread not found");
-
-  (void) chSchReadyI(tp, msg);
+  (void) chSchReadyI(nil_thd_mask_first(tqp->waiters), msg);
 }
 
 /**
@@ -1074,7 +1305,7 @@ void chThdDequeueAllI(threads_queue_t *tqp, msg_t msg) {
   chDbgCheckClassI();
   chDbgCheck(tqp != NULL);
 
-  tqp->cnt = nil_ready_all((void *)tqp, tqp->cnt, msg);
+  tqp->cnt = nil_ready_all(tqp, tqp->cnt, msg);
 }
 
 /** @} */
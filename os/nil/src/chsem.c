@@ -156,11 +156,10 @@ void chSemSignalI(semaphore_t *sp) {
   chDbgCheck(sp != NULL);
 
   if (++sp->cnt <= (cnt_t)0) {
-    thread_t *tp = nil_find_thread(NIL_STATE_WTQUEUE, (void *)sp);
 
-    chDbgAssert(tp != NULL, "thread not found");
+    chDbgAssert(sp->waiters != (thdmask_t)0, "thread not found");
 
-    (void) chSchReadyI(tp, MSG_OK);
+    (void) chSchReadyI(nil_thd_mask_first(sp->waiters), MSG_OK);
   }
 }
 
@@ -216,7 +215,7 @@ void chSemResetWithMessageI(semaphore_t *sp, cnt_t n, msg_t msg) {
   sp->cnt = n;
 
   /* Does nothing for cnt >= 0, calling anyway.*/
-  (void) nil_ready_all((void *)sp, cnt, msg);
+  (void) nil_ready_all(sp, cnt, msg);
 }
 
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
@@ -46,6 +46,7 @@
  *          will use or you would be wasting RAM and cycles.
  * @note    This values also defines the number of available priorities
  *          (0..CH_CFG_MAX_THREADS-1).
+ * @note    The maximum value is 64.
  */
 #if !defined(CH_CFG_MAX_THREADS)
 #define CH_CFG_MAX_THREADS                  4
@@ -97,6 +98,16 @@
 #define CH_CFG_ST_TIMEDELTA                 0
 #endif
 
+/**
+ * @brief   Timeouts heap.
+ * @details If enabled the armed timeouts are kept ordered by deadline,
+ *          the time handler only processes the expired threads instead
+ *          of scanning all of them.
+ */
+#if !defined(CH_CFG_USE_TIMEOUTS_HEAP)
+#define CH_CFG_USE_TIMEOUTS_HEAP            FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -283,6 +294,26 @@
 #define CH_CFG_USE_JOBS                     TRUE
 #endif
 
+/**
+ * @brief   Names index APIs.
+ * @details If enabled then the names index APIs are included in the
+ *          kernel, lookups by name in the registry and in the objects
+ *          factory become constant time.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_NAMES_INDEX)
+#define CH_CFG_USE_NAMES_INDEX              FALSE
+#endif
+
+/**
+ * @brief   Number of buckets of each names index.
+ * @note    It must be a power of two.
+ */
+#if !defined(CH_CFG_NAMES_INDEX_BUCKETS)
+#define CH_CFG_NAMES_INDEX_BUCKETS          16
+#endif
+
 /** @} */
 
 /*===========================================================================*/
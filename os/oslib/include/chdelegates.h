@@ -84,10 +84,76 @@ typedef msg_t (*delegate_fn3_t)(msg_t p1, msg_t p2, msg_t p3);
  */
 typedef msg_t (*delegate_fn4_t)(msg_t p1, msg_t p2, msg_t p3, msg_t p4);
 
+/**
+ * @brief   Type of a typed delegate function.
+ * @details The function receives a pointer to a caller-defined structure
+ *          holding its arguments, no marshalling is involved.
+ */
+typedef msg_t (*delegate_call_t)(void *argsp);
+
+/**
+ * @brief   Type of an asynchronous delegate call.
+ */
+typedef struct {
+  delegate_call_t       func;           /**< @brief Function to be called.  */
+  void                  *argsp;         /**< @brief Pointer to the function
+                                                    arguments.              */
+} delegate_async_t;
+
+/**
+ * @brief   Structure representing an asynchronous delegate calls queue.
+ */
+typedef struct {
+  delegate_async_t      *buffer;        /**< @brief Pointer to the calls
+                                                    buffer.                 */
+  delegate_async_t      *top;           /**< @brief Pointer to the location
+                                                    after the buffer.       */
+  delegate_async_t      *wrptr;         /**< @brief Write pointer.          */
+  delegate_async_t      *rdptr;         /**< @brief Read pointer.           */
+  size_t                cnt;            /**< @brief Calls in queue.         */
+  threads_queue_t       qw;             /**< @brief Queued writers.         */
+  thread_reference_t    thread;         /**< @brief Waiting dispatcher.     */
+} delegate_queue_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Data part of a static delegate calls queue initializer.
+ * @details This macro should be used when statically initializing a
+ *          delegate calls queue that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the queue variable
+ * @param[in] buffer    pointer to the queue buffer array of
+ *                      @p delegate_async_t
+ * @param[in] size      number of @p delegate_async_t elements in the buffer
+ *                      array
+ */
+#define __DELEGATE_QUEUE_DATA(name, buffer, size) {                         \
+  (delegate_async_t *)(buffer),                                             \
+  (delegate_async_t *)(buffer) + size,                                      \
+  (delegate_async_t *)(buffer),                                             \
+  (delegate_async_t *)(buffer),                                             \
+  (size_t)0,                                                                \
+  __THREADS_QUEUE_DATA(name.qw),                                            \
+  NULL                                                                      \
+}
+
+/**
+ * @brief   Static delegate calls queue initializer.
+ * @details Statically initialized queues require no explicit
+ *          initialization using @p chDelegateQueueObjectInit().
+ *
+ * @param[in] name      the name of the queue variable
+ * @param[in] buffer    pointer to the queue buffer array of
+ *                      @p delegate_async_t
+ * @param[in] size      number of @p delegate_async_t elements in the buffer
+ *                      array
+ */
+#define DELEGATE_QUEUE_DECL(name, buffer, size)                             \
+  delegate_queue_t name = __DELEGATE_QUEUE_DATA(name, buffer, size)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -103,6 +169,17 @@ extern "C" {
   void chDelegateDispatch(void);
   msg_t chDelegateDispatchTimeout(sysinterval_t timeout);
   msg_t chDelegateCallVeneer(thread_t *tp, delegate_veneer_t veneer, ...);
+  msg_t chDelegateCall(thread_t *tp, delegate_call_t func, void *argsp);
+  void chDelegateQueueObjectInit(delegate_queue_t *dqp,
+                                 delegate_async_t *buf, size_t n);
+  msg_t chDelegatePostTimeout(delegate_queue_t *dqp, delegate_call_t func,
+                              void *argsp, sysinterval_t timeout);
+  msg_t chDelegatePostTimeoutS(delegate_queue_t *dqp, delegate_call_t func,
+                               void *argsp, sysinterval_t timeout);
+  msg_t chDelegatePostI(delegate_queue_t *dqp, delegate_call_t func,
+                        void *argsp);
+  size_t chDelegateDispatchQueueTimeout(delegate_queue_t *dqp,
+                                        sysinterval_t timeout);
 #ifdef __cplusplus
 }
 #endif
@@ -201,6 +278,53 @@ static inline msg_t chDelegateCallDirect4(thread_t *tp, delegate_fn4_t func,
   return chDelegateCallVeneer(tp, __ch_delegate_fn4, func, p1, p2, p3, p4);
 }
 
+/**
+ * @brief   Returns the number of calls in a delegate calls queue.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t structure
+ * @return              The number of queued calls.
+ *
+ * @iclass
+ */
+static inline size_t chDelegateGetUsedCountI(const delegate_queue_t *dqp) {
+
+  chDbgCheckClassI();
+
+  return dqp->cnt;
+}
+
+/**
+ * @brief   Posts an asynchronous call to a delegate calls queue.
+ * @details The caller waits for a free slot if the queue is full.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t structure
+ * @param[in] func      pointer to the function to be called
+ * @param[in] argsp     pointer to the function arguments, it must stay
+ *                      valid until the function has been called
+ *
+ * @api
+ */
+static inline void chDelegatePost(delegate_queue_t *dqp, delegate_call_t func,
+                                  void *argsp) {
+
+  (void) chDelegatePostTimeout(dqp, func, argsp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Asynchronous calls dispatching.
+ * @details The function waits for at least one queued call then executes
+ *          all the calls in queue, including those posted while executing.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t structure
+ * @return              The number of executed calls.
+ *
+ * @api
+ */
+static inline size_t chDelegateDispatchQueue(delegate_queue_t *dqp) {
+
+  return chDelegateDispatchQueueTimeout(dqp, TIME_INFINITE);
+}
+
 #endif /* CH_CFG_USE_DELEGATES == TRUE */
 
 #endif /* CHDELEGATES_H */
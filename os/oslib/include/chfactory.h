@@ -180,6 +180,12 @@ typedef struct ch_dyn_element {
 #else
   const char            *name;
 #endif
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Names index node of this object.
+   */
+  names_node_t          node;
+#endif
 } dyn_element_t;
 
 /**
@@ -187,6 +193,12 @@ typedef struct ch_dyn_element {
  */
 typedef struct ch_dyn_list {
     dyn_element_t       *next;
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+    /**
+     * @brief   Names index of the objects in the list.
+     */
+    names_index_t       names;
+#endif
 } dyn_list_t;
 
 #if (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) || defined(__DOXYGEN__)
@@ -225,6 +225,7 @@
 /*===========================================================================*/
 
 /* OS Library headers.*/
+#include "chnames.h"
 #include "chbsem.h"
 #include "chmboxes.h"
 #include "chmemcore.h"
@@ -0,0 +1,179 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/include/chnames.h
+ * @brief   Names index structures and macros.
+ * @details This module implements an hashed index of named objects, the
+ *          index does not allocate memory, each indexed object embeds a
+ *          @p names_node_t structure pointing to its name.<br>
+ *          The index does not provide any locking, accesses must be
+ *          serialized by the caller, usually a lookup is performed within
+ *          a single critical zone.
+ * @note    The RT registry does not use this module, it keeps its own
+ *          index of the threads names enabled by the same option.
+ *
+ * @addtogroup oslib_names
+ * @{
+ */
+
+#ifndef CHNAMES_H
+#define CHNAMES_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Value of the names length limit meaning no limit.
+ */
+#define CH_NAMES_NO_LIMIT                   ((size_t)0)
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Names index APIs.
+ * @details If enabled then the names index APIs are included in the
+ *          library and the objects factory uses it for its lookups by
+ *          name.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_NAMES_INDEX) || defined(__DOXYGEN__)
+#define CH_CFG_USE_NAMES_INDEX              FALSE
+#endif
+
+/**
+ * @brief   Number of buckets of each names index.
+ * @note    It must be a power of two.
+ */
+#if !defined(CH_CFG_NAMES_INDEX_BUCKETS) || defined(__DOXYGEN__)
+#define CH_CFG_NAMES_INDEX_BUCKETS          16
+#endif
+
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CH_CFG_NAMES_INDEX_BUCKETS < 1) ||                                     \
+    ((CH_CFG_NAMES_INDEX_BUCKETS & (CH_CFG_NAMES_INDEX_BUCKETS - 1)) != 0)
+#error "CH_CFG_NAMES_INDEX_BUCKETS must be a power of two"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a names index node.
+ */
+typedef struct ch_names_node names_node_t;
+
+/**
+ * @brief   Structure representing a names index node.
+ * @note    The node is meant to be embedded into the indexed object.
+ */
+struct ch_names_node {
+  /**
+   * @brief   Next node in the same bucket or @p NULL.
+   */
+  names_node_t          *next;
+  /**
+   * @brief   Indexed name or @p NULL if the node is not indexed.
+   * @note    The name is not copied, the string must stay valid while the
+   *          node is part of an index.
+   */
+  const char            *name;
+  /**
+   * @brief   Hash of the indexed name.
+   */
+  uint32_t              hash;
+};
+
+/**
+ * @brief   Type of a names index.
+ */
+typedef struct ch_names_index {
+  /**
+   * @brief   Maximum number of significant characters in names.
+   */
+  size_t                maxlen;
+  /**
+   * @brief   Buckets of the index.
+   */
+  names_node_t          *buckets[CH_CFG_NAMES_INDEX_BUCKETS];
+} names_index_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the object containing a names index node.
+ *
+ * @param[in] np        pointer to the @p names_node_t structure
+ * @param[in] type      type of the object containing the node
+ * @param[in] field     name of the node field within the object
+ * @return              A pointer to the containing object.
+ */
+#define chNamesGetObject(np, type, field)                                   \
+  ((type *)(void *)((uint8_t *)(np) - offsetof(type, field)))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chNamesObjectInit(names_index_t *nip, size_t maxlen);
+  uint32_t chNamesHashX(names_index_t *nip, const char *name);
+  void chNamesInsertX(names_index_t *nip, names_node_t *np, const char *name);
+  void chNamesRemoveX(names_index_t *nip, names_node_t *np);
+  names_node_t *chNamesFindX(names_index_t *nip, const char *name);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the name of an indexed node.
+ *
+ * @param[in] np        pointer to the @p names_node_t structure
+ * @return              The indexed name.
+ * @retval NULL         if the node is not part of an index.
+ *
+ * @xclass
+ */
+static inline const char *chNamesGetNameX(names_node_t *np) {
+
+  return np->name;
+}
+
+#endif /* CH_CFG_USE_NAMES_INDEX == TRUE */
+
+#endif /* CHNAMES_H */
+
+/** @} */
@@ -38,6 +38,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_FACTORY TRUE,$(CHLIBCONF)),)
 LIBSRC += $(CHIBIOS)/os/oslib/src/chfactory.c
 endif
+ifneq ($(findstring CH_CFG_USE_NAMES_INDEX TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/oslib/src/chnames.c
+endif
 else
 LIBSRC := $(CHIBIOS)/os/oslib/src/chmboxes.c \
           $(CHIBIOS)/os/oslib/src/chmemcore.c \
@@ -46,7 +49,8 @@ LIBSRC := $(CHIBIOS)/os/oslib/src/chmboxes.c \
           $(CHIBIOS)/os/oslib/src/chpipes.c \
           $(CHIBIOS)/os/oslib/src/chobjcaches.c \
           $(CHIBIOS)/os/oslib/src/chdelegates.c \
-          $(CHIBIOS)/os/oslib/src/chfactory.c
+          $(CHIBIOS)/os/oslib/src/chfactory.c \
+          $(CHIBIOS)/os/oslib/src/chnames.c
 endif
 
 # Required include directories
@@ -26,7 +26,11 @@
  *          by other threads. This functionality is especially useful when
  *          encapsulating a library not designed for threading into a
  *          delegate thread. Other threads have access to the library without
- *          having to worry about mutual exclusion.
+ *          having to worry about mutual exclusion.<br>
+ *          Calls can be synchronous, the caller waits for the function
+ *          return value, or asynchronous, the calls are posted into a
+ *          delegate calls queue and the delegate thread executes all the
+ *          queued calls on each wakeup.
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_DELEGATES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -54,6 +58,20 @@
 /**
  * @brief   Type of a structure representing a delegate call.
  */
+typedef struct {
+  /**
+   * @brief   The function to be called.
+   */
+  delegate_call_t   func;
+  /**
+   * @brief   Pointer to the function arguments.
+   */
+  void              *argsp;
+} call_message_t;
+
+/**
+ * @brief   Type of a structure representing a veneer call.
+ */
 typedef struct {
   /**
    * @brief   The delegate veneer function.
@@ -63,7 +81,7 @@ typedef struct {
    * @brief   Pointer to the caller @p va_list object.
    */
   va_list           *argsp;
-} call_message_t;
+} veneer_call_t;
 
 /*===========================================================================*/
 /* Module local variables.                                                   */
@@ -73,6 +91,18 @@ typedef struct {
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Calls a veneer function with its list of arguments.
+ *
+ * @param[in] argsp     pointer to a @p veneer_call_t structure
+ * @return              The veneer return value.
+ */
+static msg_t delegate_veneer_call(void *argsp) {
+  const veneer_call_t *vcp = (const veneer_call_t *)argsp;
+
+  return vcp->veneer(vcp->argsp);
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -157,14 +187,17 @@ msg_t __ch_delegate_fn4(va_list *argsp) {
  */
 msg_t chDelegateCallVeneer(thread_t *tp, delegate_veneer_t veneer, ...) {
   va_list args;
+  veneer_call_t vc;
   call_message_t cm;
   msg_t msg;
 
   va_start(args, veneer);
 
   /* Preparing the call message.*/
-  cm.veneer = veneer;
-  cm.argsp  = &args;
+  vc.veneer = veneer;
+  vc.argsp  = &args;
+  cm.func   = delegate_veneer_call;
+  cm.argsp  = (void *)&vc;
   (void)cm; /* Suppresses a lint warning.*/
 
   /* Sending the message to the dispatcher thread, the return value is
@@ -178,6 +211,37 @@ msg_t chDelegateCallVeneer(thread_t *tp, delegate_veneer_t veneer, ...) {
 
 /*lint -restore*/
 
+/**
+ * @brief   Triggers a typed function call on a delegate thread.
+ * @details The arguments are passed to the function by pointer, there is
+ *          no marshalling and no limit on the number or type of the
+ *          arguments, results larger than a @p msg_t can be returned
+ *          through the arguments structure.
+ * @note    The thread must be executing @p chDelegateDispatch() or
+ *          @p chDelegateDispatchTimeout() in order to have the functions
+ *          called.
+ *
+ * @param[in] tp        pointer to the delegate thread
+ * @param[in] func      pointer to the function to be called
+ * @param[in] argsp     pointer to the function arguments
+ * @return              The function return value.
+ *
+ * @api
+ */
+msg_t chDelegateCall(thread_t *tp, delegate_call_t func, void *argsp) {
+  call_message_t cm;
+
+  chDbgCheck((tp != NULL) && (func != NULL));
+
+  /* Preparing the call message.*/
+  cm.func  = func;
+  cm.argsp = argsp;
+
+  /* Sending the message to the dispatcher thread, the return value is
+     contained in the returned message.*/
+  return chMsgSend(tp, (msg_t)&cm);
+}
+
 /**
  * @brief   Call messages dispatching.
  * @details The function awaits for an incoming call messages and calls the
@@ -194,7 +258,7 @@ void chDelegateDispatch(void) {
 
   tp = chMsgWait();
   cmp = (const call_message_t *)chMsgGet(tp);
-  ret = cmp->veneer(cmp->argsp);
+  ret = cmp->func(cmp->argsp);
 
   chMsgRelease(tp, ret);
 }
@@ -227,13 +291,220 @@ msg_t chDelegateDispatchTimeout(sysinterval_t timeout) {
   }
 
   cmp = (const call_message_t *)chMsgGet(tp);
-  ret = cmp->veneer(cmp->argsp);
+  ret = cmp->func(cmp->argsp);
 
   chMsgRelease(tp, ret);
 
   return MSG_OK;
 }
 
+/**
+ * @brief   Initializes a @p delegate_queue_t object.
+ *
+ * @param[out] dqp      pointer to a @p delegate_queue_t structure
+ * @param[in] buf       pointer to the calls buffer as an array of
+ *                      @p delegate_async_t
+ * @param[in] n         number of elements in the buffer array
+ *
+ * @init
+ */
+void chDelegateQueueObjectInit(delegate_queue_t *dqp,
+                               delegate_async_t *buf, size_t n) {
+
+  chDbgCheck((dqp != NULL) && (buf != NULL) && (n > (size_t)0));
+
+  dqp->buffer = buf;
+  dqp->rdptr  = buf;
+  dqp->wrptr  = buf;
+  dqp->top    = &buf[n];
+  dqp->cnt    = (size_t)0;
+  chThdQueueObjectInit(&dqp->qw);
+  dqp->thread = NULL;
+}
+
+/**
+ * @brief   Posts an asynchronous call to a delegate calls queue.
+ * @details The caller does not wait for the function to be called, the
+ *          function return value is discarded. If the queue is full then
+ *          the caller waits for a free slot.
+ * @note    The delegate thread is only awakened by the first call posted
+ *          into an empty queue, if it has not a higher priority than the
+ *          posting threads then all the calls posted before it gets the
+ *          CPU are executed in a single wakeup.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t structure
+ * @param[in] func      pointer to the function to be called
+ * @param[in] argsp     pointer to the function arguments, it must stay
+ *                      valid until the function has been called
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been posted.
+ * @retval MSG_TIMEOUT  if the queue is full and the call cannot be posted
+ *                      in the specified time.
+ *
+ * @api
+ */
+msg_t chDelegatePostTimeout(delegate_queue_t *dqp, delegate_call_t func,
+                            void *argsp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chDelegatePostTimeoutS(dqp, func, argsp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Posts an asynchronous call to a delegate calls queue.
+ * @details The caller does not wait for the function to be called, the
+ *          function return value is discarded. If the queue is full then
+ *          the caller waits for a free slot.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t structure
+ * @param[in] func      pointer to the function to be called
+ * @param[in] argsp     pointer to the function arguments, it must stay
+ *                      valid until the function has been called
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been posted.
+ * @retval MSG_TIMEOUT  if the queue is full and the call cannot be posted
+ *                      in the specified time.
+ *
+ * @sclass
+ */
+msg_t chDelegatePostTimeoutS(delegate_queue_t *dqp, delegate_call_t func,
+                             void *argsp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chDbgCheckClassS();
+
+  do {
+    msg = chDelegatePostI(dqp, func, argsp);
+    if (msg == MSG_OK) {
+      chSchRescheduleS();
+      break;
+    }
+
+    /* No space in the queue, waiting for a slot to become available.*/
+    msg = chThdEnqueueTimeoutS(&dqp->qw, timeout);
+  } while (msg == MSG_OK);
+
+  return msg;
+}
+
+/**
+ * @brief   Posts an asynchronous call to a delegate calls queue.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is full.
+ * @note    Posting many calls from within a single critical zone or from
+ *          an ISR makes them executed in a single delegate thread wakeup
+ *          regardless of its priority.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t structure
+ * @param[in] func      pointer to the function to be called
+ * @param[in] argsp     pointer to the function arguments, it must stay
+ *                      valid until the function has been called
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been posted.
+ * @retval MSG_TIMEOUT  if the queue is full and the call cannot be posted.
+ *
+ * @iclass
+ */
+msg_t chDelegatePostI(delegate_queue_t *dqp, delegate_call_t func,
+                      void *argsp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((dqp != NULL) && (func != NULL));
+
+  if (dqp->cnt >= (size_t)(dqp->top - dqp->buffer)) {
+    return MSG_TIMEOUT;
+  }
+
+  dqp->wrptr->func  = func;
+  dqp->wrptr->argsp = argsp;
+  dqp->wrptr++;
+  if (dqp->wrptr >= dqp->top) {
+    dqp->wrptr = dqp->buffer;
+  }
+  dqp->cnt++;
+
+  /* If the delegate thread is waiting then it is made ready, it is NULL
+     for the calls following the first one.*/
+  chThdResumeI(&dqp->thread, MSG_OK);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Asynchronous calls dispatching with timeout.
+ * @details The function waits for at least one queued call then executes
+ *          all the calls in queue, including those posted while executing,
+ *          then it returns. The queue is not locked while the functions are
+ *          executed.
+ * @note    Only one thread can dispatch calls from a queue.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of executed calls.
+ * @retval 0            if a timeout occurred.
+ *
+ * @api
+ */
+size_t chDelegateDispatchQueueTimeout(delegate_queue_t *dqp,
+                                      sysinterval_t timeout) {
+  threads_queue_t *qwp = &dqp->qw;
+  size_t n = (size_t)0;
+
+  chDbgCheck(dqp != NULL);
+
+  chSysLock();
+  if (dqp->cnt == (size_t)0) {
+    if (chThdSuspendTimeoutS(&dqp->thread, timeout) != MSG_OK) {
+      chSysUnlock();
+      return (size_t)0;
+    }
+  }
+
+  /* Draining the queue, the slot is freed before calling the function so
+     a waiting writer can post meanwhile.*/
+  do {
+    delegate_async_t da = *dqp->rdptr;
+
+    dqp->rdptr++;
+    if (dqp->rdptr >= dqp->top) {
+      dqp->rdptr = dqp->buffer;
+    }
+    dqp->cnt--;
+
+    /* Rescheduling only if a writer was waiting for a free slot.*/
+    if (!chThdQueueIsEmptyI(qwp)) {
+      chThdDequeueNextI(qwp, MSG_OK);
+      chSchRescheduleS();
+    }
+    chSysUnlock();
+
+    (void) da.func(da.argsp);
+    n++;
+
+    chSysLock();
+  } while (dqp->cnt > (size_t)0);
+  chSysUnlock();
+
+  return n;
+}
+
 #endif /* CH_CFG_USE_DELEGATES == TRUE */
 
 /** @} */
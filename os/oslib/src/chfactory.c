@@ -60,6 +60,16 @@
 #define F_UNLOCK()      chSemSignal(&ch_factory.sem)
 #endif
 
+/*
+ * Dynamic semaphores are registered in the locks profiler using their
+ * factory name, RT only.
+ */
+#if defined(__CHIBIOS_RT__) && (CH_DBG_LOCKS_PROFILING == TRUE)
+#define F_PROFILING     TRUE
+#else
+#define F_PROFILING     FALSE
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -98,6 +108,32 @@ static void copy_name(const char *sp, char *dp) {
 static inline void dyn_list_init(dyn_list_t *dlp) {
 
   dlp->next = (dyn_element_t *)dlp;
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  chNamesObjectInit(&dlp->names, (size_t)CH_CFG_FACTORY_MAX_NAMES_LENGTH);
+#endif
+}
+
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+static inline void dyn_list_index(dyn_element_t *dep, dyn_list_t *dlp) {
+
+  chNamesInsertX(&dlp->names, &dep->node, dep->name);
+}
+
+static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
+  names_node_t *np;
+
+  np = chNamesFindX(&dlp->names, name);
+  if (np == NULL) {
+    return NULL;
+  }
+
+  return chNamesGetObject(np, dyn_element_t, node);
+}
+#else
+static inline void dyn_list_index(dyn_element_t *dep, dyn_list_t *dlp) {
+
+  (void)dep;
+  (void)dlp;
 }
 
 static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
@@ -112,6 +148,7 @@ static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
 
   return NULL;
 }
+#endif
 
 static dyn_element_t *dyn_list_unlink(dyn_element_t *element,
                                       dyn_list_t *dlp) {
@@ -122,6 +159,9 @@ static dyn_element_t *dyn_list_unlink(dyn_element_t *element,
     if (prev->next == element) {
       /* Found.*/
       prev->next = element->next;
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+      chNamesRemoveX(&dlp->names, &element->node);
+#endif
       return element;
     }
 
@@ -157,6 +197,7 @@ static dyn_element_t *dyn_create_object_heap(const char *name,
   copy_name(name, dep->name);
   dep->refs = (ucnt_t)1;
   dep->next = dlp->next;
+  dyn_list_index(dep, dlp);
 
   /* Updating factory list.*/
   dlp->next = dep;
@@ -202,6 +243,7 @@ static dyn_element_t *dyn_create_object_pool(const char *name,
   copy_name(name, dep->name);
   dep->refs = (ucnt_t)1;
   dep->next = dlp->next;
+  dyn_list_index(dep, dlp);
 
   /* Updating factory list.*/
   dlp->next = (dyn_element_t *)dep;
@@ -506,6 +548,9 @@ dyn_semaphore_t *chFactoryCreateSemaphore(const char *name, cnt_t n) {
   if (dsp != NULL) {
     /* Initializing semaphore object dataa.*/
     chSemObjectInit(&dsp->sem, n);
+#if F_PROFILING == TRUE
+    chLockProfRegister(&dsp->sem.prof, dsp->element.name);
+#endif
   }
 
   F_UNLOCK();
@@ -552,6 +597,13 @@ void chFactoryReleaseSemaphore(dyn_semaphore_t *dsp) {
 
   F_LOCK();
 
+#if F_PROFILING == TRUE
+  /* Last reference, the profile goes away with the object.*/
+  if (dsp->element.refs == (ucnt_t)1) {
+    chLockProfUnregister(&dsp->sem.prof);
+  }
+#endif
+
   dyn_release_object_pool(&dsp->element,
                           &ch_factory.sem_list,
                           &ch_factory.sem_pool);
@@ -0,0 +1,250 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/src/chnames.c
+ * @brief   Names index code.
+ * @details Names index.
+ *          <h2>Operation mode</h2>
+ *          A names index allows to find objects by name in constant time.
+ *          Names are not copied, each indexed object embeds a
+ *          @p names_node_t structure pointing to the name storage of the
+ *          object itself and caching the name hash.<br>
+ *          Nodes are linked in a fixed array of buckets, lookups compare
+ *          the cached hashes first and the strings only on hash match.
+ *          Nodes with the same name are returned in insertion order.<br>
+ *          The index performs no locking, the caller is responsible for
+ *          serializing accesses.
+ * @pre     In order to use the names index APIs the
+ *          @p CH_CFG_USE_NAMES_INDEX option must be enabled in @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_names
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* FNV-1a hash parameters.*/
+#define NAMES_HASH_BASIS        2166136261U
+#define NAMES_HASH_PRIME        16777619U
+
+/* Bucket associated to an hash value.*/
+#define NAMES_BUCKET(nip, h)                                                \
+  (&(nip)->buckets[(h) & ((uint32_t)CH_CFG_NAMES_INDEX_BUCKETS - 1U)])
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Compares two names up to the index length limit.
+ *
+ * @param[in] nip       pointer to the @p names_index_t structure
+ * @param[in] s1        first name
+ * @param[in] s2        second name
+ * @return              The comparison result.
+ * @retval true         if the names match.
+ */
+static bool names_match(names_index_t *nip, const char *s1, const char *s2) {
+  /* Note, a zero limit wraps on the first decrement, no limit.*/
+  size_t n = nip->maxlen;
+
+  do {
+    if (*s1 != *s2) {
+      return false;
+    }
+    if (*s1 == '\0') {
+      break;
+    }
+    s1++;
+    s2++;
+    n--;
+  } while (n != (size_t)0);
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a names index.
+ *
+ * @param[out] nip      pointer to the @p names_index_t structure
+ * @param[in] maxlen    maximum number of significant characters in names,
+ *                      @p CH_NAMES_NO_LIMIT for zero terminated names of
+ *                      any length
+ *
+ * @init
+ */
+void chNamesObjectInit(names_index_t *nip, size_t maxlen) {
+  unsigned i;
+
+  chDbgCheck(nip != NULL);
+
+  nip->maxlen = maxlen;
+  for (i = 0U; i < (unsigned)CH_CFG_NAMES_INDEX_BUCKETS; i++) {
+    nip->buckets[i] = NULL;
+  }
+}
+
+/**
+ * @brief   Calculates the hash of a name.
+ * @note    Only the significant characters of the name are hashed.
+ *
+ * @param[in] nip       pointer to the @p names_index_t structure
+ * @param[in] name      the name
+ * @return              The hash value.
+ *
+ * @xclass
+ */
+uint32_t chNamesHashX(names_index_t *nip, const char *name) {
+  uint32_t h = NAMES_HASH_BASIS;
+  /* Note, a zero limit wraps on the first decrement, no limit.*/
+  size_t n = nip->maxlen;
+
+  while (*name != '\0') {
+    h = (h ^ (uint32_t)(uint8_t)*name) * NAMES_HASH_PRIME;
+    name++;
+    n--;
+    if (n == (size_t)0) {
+      break;
+    }
+  }
+
+  return h;
+}
+
+/**
+ * @brief   Adds a node to a names index.
+ * @note    Indexing a node with a @p NULL name just marks it as not
+ *          indexed, this way the node can be later passed to
+ *          @p chNamesRemoveX() safely.
+ * @note    The caller must serialize accesses to the index.
+ *
+ * @param[in] nip       pointer to the @p names_index_t structure
+ * @param[out] np       pointer to the @p names_node_t structure
+ * @param[in] name      name to be indexed or @p NULL
+ *
+ * @xclass
+ */
+void chNamesInsertX(names_index_t *nip, names_node_t *np, const char *name) {
+  names_node_t **npp;
+
+  chDbgCheck((nip != NULL) && (np != NULL));
+
+  np->name = name;
+  if (name == NULL) {
+    return;
+  }
+
+  np->hash = chNamesHashX(nip, name);
+  np->next = NULL;
+
+  /* Appending to the bucket so that duplicated names are found in
+     insertion order.*/
+  npp = NAMES_BUCKET(nip, np->hash);
+  while (*npp != NULL) {
+    npp = &(*npp)->next;
+  }
+  *npp = np;
+}
+
+/**
+ * @brief   Removes a node from a names index.
+ * @note    Removing a node that is not indexed has no effect.
+ * @note    The caller must serialize accesses to the index.
+ *
+ * @param[in] nip       pointer to the @p names_index_t structure
+ * @param[in] np        pointer to the @p names_node_t structure
+ *
+ * @xclass
+ */
+void chNamesRemoveX(names_index_t *nip, names_node_t *np) {
+  names_node_t **npp;
+
+  chDbgCheck((nip != NULL) && (np != NULL));
+
+  if (np->name == NULL) {
+    return;
+  }
+
+  npp = NAMES_BUCKET(nip, np->hash);
+  while (*npp != NULL) {
+    if (*npp == np) {
+      *npp = np->next;
+      break;
+    }
+    npp = &(*npp)->next;
+  }
+  np->name = NULL;
+}
+
+/**
+ * @brief   Finds a node by name.
+ * @note    The caller must serialize accesses to the index.
+ *
+ * @param[in] nip       pointer to the @p names_index_t structure
+ * @param[in] name      the name to be searched
+ * @return              The first node indexed with the specified name.
+ * @retval NULL         if a matching node has not been found.
+ *
+ * @xclass
+ */
+names_node_t *chNamesFindX(names_index_t *nip, const char *name) {
+  names_node_t *np;
+  uint32_t h;
+
+  chDbgCheck((nip != NULL) && (name != NULL));
+
+  h = chNamesHashX(nip, name);
+  np = *NAMES_BUCKET(nip, h);
+  while (np != NULL) {
+    if ((np->hash == h) && names_match(nip, np->name, name)) {
+      return np;
+    }
+    np = np->next;
+  }
+
+  return NULL;
+}
+
+#endif /* CH_CFG_USE_NAMES_INDEX == TRUE */
+
+/** @} */
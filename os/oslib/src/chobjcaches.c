@@ -327,6 +327,10 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
       LRU_REMOVE(objp);
       objp->obj_flags &= ~OC_FLAG_INLRU;
 
+      /* The LRU counter semaphore accounts for the objects in the LRU
+         list, it is decreased like when taking the LRU tail.*/
+      chSemFastWaitI(&ocp->lru_sem);
+
       /* Getting the object semaphore, we know there is no wait so
          using the "fast" variant.*/
       chSemFastWaitI(&objp->obj_sem);
@@ -106,6 +106,7 @@
 #include "chport.h"
 #include "chtm.h"
 #include "chstats.h"
+#include "chlockprof.h"
 #include "chobjects.h"
 #include "chsys.h"
 #include "chinstances.h"
@@ -118,8 +119,10 @@
 #include "chsem.h"
 #include "chmtx.h"
 #include "chcond.h"
+#include "chrwlock.h"
 #include "chevents.h"
 #include "chmsg.h"
+#include "chthdpools.h"
 
 /* OSLIB.*/
 #include "chlib.h"
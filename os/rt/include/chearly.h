@@ -127,6 +127,12 @@ typedef uint8_t         ucnt_t;             /**< Generic unsigned counter.  */
  */
 typedef unsigned core_id_t;
 
+/**
+ * @brief   Type of a cores mask.
+ * @note    Bit N represents the core with identifier N.
+ */
+typedef unsigned core_mask_t;
+
 /**
  * @brief   Type of a thread structure.
  */
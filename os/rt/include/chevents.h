@@ -41,10 +41,38 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Indexed event sources APIs.
+ * @details If enabled then the indexed event sources APIs are included in
+ *          the kernel.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_EVENTS_INDEX) || defined(__DOXYGEN__)
+#define CH_CFG_USE_EVENTS_INDEX             FALSE
+#endif
+
+/**
+ * @brief   Number of listener buckets of each indexed event source.
+ * @details The flag bit @p n is associated to the bucket
+ *          <tt>n % CH_CFG_EVENTS_INDEX_BUCKETS</tt>.
+ * @note    It must be a power of two not greater than the size, in bits,
+ *          of the @p eventflags_t type.
+ */
+#if !defined(CH_CFG_EVENTS_INDEX_BUCKETS) || defined(__DOXYGEN__)
+#define CH_CFG_EVENTS_INDEX_BUCKETS         8
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+#if (CH_CFG_EVENTS_INDEX_BUCKETS < 1) ||                                    \
+    ((CH_CFG_EVENTS_INDEX_BUCKETS & (CH_CFG_EVENTS_INDEX_BUCKETS - 1)) != 0)
+#error "CH_CFG_EVENTS_INDEX_BUCKETS must be a power of two"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -77,6 +105,24 @@ typedef struct event_source {
                                                     Source.                 */
 } event_source_t;
 
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Indexed Event Source structure.
+ * @details Listeners are distributed in buckets by the flags they are
+ *          interested in, a broadcast only scans the buckets associated to
+ *          the broadcasted flags. Listeners interested in flags associated
+ *          to more than one bucket are kept in a separate list that is
+ *          always scanned.
+ */
+typedef struct event_isource {
+  event_source_t        wide;           /**< @brief Listeners not associated
+                                                    to a single bucket.     */
+  event_source_t        buckets[CH_CFG_EVENTS_INDEX_BUCKETS];
+                                        /**< @brief Listeners associated to
+                                                    a single bucket.        */
+} event_isource_t;
+#endif
+
 /**
  * @brief   Event Handler callback function.
  */
@@ -139,6 +185,20 @@ extern "C" {
   void chEvtBroadcastFlags(event_source_t *esp, eventflags_t flags);
   void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags);
   void chEvtDispatch(const evhandler_t *handlers, eventmask_t events);
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+  void chEvtIndexedObjectInit(event_isource_t *iesp);
+  void chEvtIndexedRegisterMaskWithFlagsI(event_isource_t *iesp,
+                                          event_listener_t *elp,
+                                          eventmask_t events,
+                                          eventflags_t wflags);
+  void chEvtIndexedRegisterMaskWithFlags(event_isource_t *iesp,
+                                         event_listener_t *elp,
+                                         eventmask_t events,
+                                         eventflags_t wflags);
+  void chEvtIndexedUnregister(event_isource_t *iesp, event_listener_t *elp);
+  void chEvtIndexedBroadcastFlags(event_isource_t *iesp, eventflags_t flags);
+  void chEvtIndexedBroadcastFlagsI(event_isource_t *iesp, eventflags_t flags);
+#endif
 #if (CH_CFG_OPTIMIZE_SPEED == TRUE) || (CH_CFG_USE_EVENTS_TIMEOUT == FALSE)
   eventmask_t chEvtWaitOne(eventmask_t events);
   eventmask_t chEvtWaitAny(eventmask_t events);
@@ -288,6 +348,28 @@ static inline eventmask_t chEvtGetEventsX(void) {
   return __sch_get_currthread()->epending;
 }
 
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Verifies if there is at least one @p event_listener_t registered.
+ *
+ * @param[in] iesp      pointer to the @p event_isource_t structure
+ * @return              The event source status.
+ *
+ * @iclass
+ */
+static inline bool chEvtIndexedIsListeningI(event_isource_t *iesp) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_CFG_EVENTS_INDEX_BUCKETS; i++) {
+    if (chEvtIsListeningI(&iesp->buckets[i])) {
+      return true;
+    }
+  }
+
+  return chEvtIsListeningI(&iesp->wide);
+}
+#endif /* CH_CFG_USE_EVENTS_INDEX == TRUE */
+
 #endif /* CH_CFG_USE_EVENTS == TRUE */
 
 #endif /* CHEVENTS_H */
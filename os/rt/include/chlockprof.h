@@ -0,0 +1,206 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rt/include/chlockprof.h
+ * @brief   Locks contention profiler macros and structures.
+ *
+ * @addtogroup lock_profiler
+ * @{
+ */
+
+#ifndef CHLOCKPROF_H
+#define CHLOCKPROF_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Profiled lock types
+ * @{
+ */
+#define CH_LOCK_SEMAPHORE           (uint8_t)0  /**< @brief Semaphore.      */
+#define CH_LOCK_MUTEX               (uint8_t)1  /**< @brief Mutex.          */
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Locks contention profiler.
+ * @details If enabled then mutexes and semaphores collect acquisition,
+ *          contention, wait time and hold time statistics.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_LOCKS_PROFILING) || defined(__DOXYGEN__)
+#define CH_DBG_LOCKS_PROFILING              FALSE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CH_DBG_LOCKS_PROFILING == TRUE) && (PORT_SUPPORTS_RT == FALSE)
+#error "CH_DBG_LOCKS_PROFILING requires PORT_SUPPORTS_RT"
+#endif
+
+#if (CH_DBG_LOCKS_PROFILING == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a lock profile structure.
+ */
+typedef struct ch_lock_profile lock_profile_t;
+
+/**
+ * @brief   Structure representing a lock profile.
+ * @note    Times are expressed in realtime counter cycles.
+ */
+struct ch_lock_profile {
+  /**
+   * @brief   Next registered profile or @p NULL.
+   */
+  lock_profile_t        *next;
+  /**
+   * @brief   Registered name or @p NULL.
+   */
+  const char            *name;
+  /**
+   * @brief   Type of the owner lock object.
+   */
+  uint8_t               type;
+  /**
+   * @brief   Number of successful acquisitions.
+   */
+  ucnt_t                n_acquired;
+  /**
+   * @brief   Number of acquisition attempts that had to wait.
+   */
+  ucnt_t                n_contended;
+  /**
+   * @brief   Number of priority inheritance boosts caused by waiters.
+   */
+  ucnt_t                n_boosts;
+  /**
+   * @brief   Cumulative wait time.
+   */
+  rttime_t              wait_cumulative;
+  /**
+   * @brief   Longest wait time.
+   */
+  rtcnt_t               wait_max;
+  /**
+   * @brief   Longest hold time.
+   * @note    Only mutexes have an owner, this field is not updated for
+   *          semaphores.
+   */
+  rtcnt_t               hold_max;
+  /**
+   * @brief   Last acquisition time stamp.
+   */
+  rtcnt_t               last;
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static lock profile initializer.
+ *
+ * @param[in] t         type of the lock object
+ */
+#define __LOCK_PROFILE_DATA(t)                                              \
+  , {NULL, NULL, (t), (ucnt_t)0, (ucnt_t)0, (ucnt_t)0, (rttime_t)0,         \
+     (rtcnt_t)0, (rtcnt_t)0, (rtcnt_t)0}
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void __lkprof_acquired(lock_profile_t *lpp);
+  void __lkprof_contended(lock_profile_t *lpp, rtcnt_t start);
+  void __lkprof_released(lock_profile_t *lpp);
+  void chLockProfObjectInit(lock_profile_t *lpp, uint8_t type);
+  void chLockProfRegister(lock_profile_t *lpp, const char *name);
+  void chLockProfUnregister(lock_profile_t *lpp);
+  void chLockProfReset(lock_profile_t *lpp);
+  lock_profile_t *chLockProfFirstS(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Accounts a priority inheritance boost.
+ * @note    Internal use only.
+ *
+ * @param[in] lpp       pointer to the @p lock_profile_t structure
+ *
+ * @notapi
+ */
+static inline void __lkprof_boost(lock_profile_t *lpp) {
+
+  lpp->n_boosts++;
+}
+
+/**
+ * @brief   Returns the profile following the specified one.
+ * @note    The list must not be modified while it is being scanned so the
+ *          whole scan must be performed in the same critical zone.
+ *
+ * @param[in] lpp       pointer to the @p lock_profile_t structure
+ * @return              The next registered profile.
+ * @retval NULL         if there are no more registered profiles.
+ *
+ * @sclass
+ */
+static inline lock_profile_t *chLockProfNextS(lock_profile_t *lpp) {
+
+  chDbgCheckClassS();
+
+  return lpp->next;
+}
+
+#else /* CH_DBG_LOCKS_PROFILING == FALSE */
+
+/* Stub macros for when the profiler is disabled.*/
+#define __LOCK_PROFILE_DATA(t)
+#define chLockProfObjectInit(lpp, type)
+#define __lkprof_acquired(lpp)
+#define __lkprof_contended(lpp, start)
+#define __lkprof_released(lpp)
+#define __lkprof_boost(lpp)
+
+#endif /* CH_DBG_LOCKS_PROFILING == FALSE */
+
+#endif /* CHLOCKPROF_H */
+
+/** @} */
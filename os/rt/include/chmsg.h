@@ -67,6 +67,7 @@ extern "C" {
   thread_t *chMsgWaitS(void);
   thread_t *chMsgWaitTimeoutS(sysinterval_t timeout);
   thread_t *chMsgPollS(void);
+  thread_t *chMsgReleaseWaitS(thread_t *tp, msg_t msg);
   void chMsgRelease(thread_t *tp, msg_t msg);
 #ifdef __cplusplus
 }
@@ -211,6 +212,30 @@ static inline void chMsgReleaseS(thread_t *tp, msg_t msg) {
   chSchWakeupS(tp, msg);
 }
 
+/**
+ * @brief   Releases a sender thread and waits for the next message.
+ * @details This is the combination of @p chMsgRelease() and
+ *          @p chMsgWait() done atomically.
+ * @pre     Invoke this function only after a message has been received
+ *          using @p chMsgWait().
+ * @note    The reference counter of the sender thread is not increased, the
+ *          returned pointer is a temporary reference.
+ *
+ * @param[in] tp        pointer to the thread to be released
+ * @param[in] msg       message to be returned to the sender
+ * @return              A pointer to the thread carrying the next message.
+ *
+ * @api
+ */
+static inline thread_t *chMsgReleaseWait(thread_t *tp, msg_t msg) {
+
+  chSysLock();
+  tp = chMsgReleaseWaitS(tp, msg);
+  chSysUnlock();
+
+  return tp;
+}
+
 #endif /* CH_CFG_USE_MESSAGES == TRUE */
 
 #endif /* CHMSG_H */
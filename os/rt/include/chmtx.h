@@ -28,8 +28,6 @@
 #ifndef CHMTX_H
 #define CHMTX_H
 
-#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
-
 /*===========================================================================*/
 /* Module constants.                                                         */
 /*===========================================================================*/
@@ -38,6 +36,24 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Priority ceiling mutexes.
+ * @details If enabled then mutexes can be initialized with a static
+ *          priority ceiling, the owner of a ceiling mutex is immediately
+ *          raised to the ceiling priority instead of using the priority
+ *          inheritance protocol.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_MUTEXES_CEILING) || defined(__DOXYGEN__)
+#define CH_CFG_USE_MUTEXES_CEILING          FALSE
+#endif
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) && (CH_CFG_USE_MUTEXES == FALSE)
+#error "CH_CFG_USE_MUTEXES_CEILING requires CH_CFG_USE_MUTEXES"
+#endif
+
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -64,6 +80,14 @@ struct ch_mutex {
 #if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
   cnt_t                 cnt;        /**< @brief Mutex recursion counter.    */
 #endif
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+  tprio_t               ceiling;    /**< @brief Priority ceiling, zero for
+                                                priority inheritance
+                                                mutexes.                    */
+#endif
+#if (CH_DBG_LOCKS_PROFILING == TRUE) || defined(__DOXYGEN__)
+  lock_profile_t        prof;       /**< @brief Contention profile.         */
+#endif
 };
 
 /*===========================================================================*/
@@ -71,18 +95,46 @@ struct ch_mutex {
 /*===========================================================================*/
 
 /**
- * @brief   Data part of a static mutex initializer.
- * @details This macro should be used when statically initializing a mutex
- *          that is part of a bigger structure.
+ * @brief   Ceiling part of a static mutex initializer.
+ *
+ * @param[in] ceiling   the priority ceiling
+ *
+ * @notapi
+ */
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+#define __MUTEX_CEILING(ceiling) , (tprio_t)(ceiling)
+#else
+#define __MUTEX_CEILING(ceiling)
+#endif
+
+/**
+ * @brief   Data part of a static ceiling mutex initializer.
+ * @details This macro should be used when statically initializing a
+ *          ceiling mutex that is part of a bigger structure.
+ * @note    A zero ceiling specifies a priority inheritance mutex.
  *
  * @param[in] name      the name of the mutex variable
+ * @param[in] ceiling   the priority ceiling
  */
 #if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
-#define __MUTEX_DATA(name) {__CH_QUEUE_DATA(name.queue), NULL, NULL, 0}
+#define __MUTEX_CEILING_DATA(name, ceiling)                                 \
+  {__CH_QUEUE_DATA(name.queue), NULL, NULL, 0 __MUTEX_CEILING(ceiling)      \
+   __LOCK_PROFILE_DATA(CH_LOCK_MUTEX)}
 #else
-#define __MUTEX_DATA(name) {__CH_QUEUE_DATA(name.queue), NULL, NULL}
+#define __MUTEX_CEILING_DATA(name, ceiling)                                 \
+  {__CH_QUEUE_DATA(name.queue), NULL, NULL __MUTEX_CEILING(ceiling)         \
+   __LOCK_PROFILE_DATA(CH_LOCK_MUTEX)}
 #endif
 
+/**
+ * @brief   Data part of a static mutex initializer.
+ * @details This macro should be used when statically initializing a mutex
+ *          that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the mutex variable
+ */
+#define __MUTEX_DATA(name) __MUTEX_CEILING_DATA(name, 0)
+
 /**
  * @brief   Static mutex initializer.
  * @details Statically initialized mutexes require no explicit initialization
@@ -92,6 +144,19 @@ struct ch_mutex {
  */
 #define MUTEX_DECL(name) mutex_t name = __MUTEX_DATA(name)
 
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Static ceiling mutex initializer.
+ * @details Statically initialized mutexes require no explicit initialization
+ *          using @p chMtxObjectInitCeiling().
+ *
+ * @param[in] name      the name of the mutex variable
+ * @param[in] ceiling   the priority ceiling
+ */
+#define MUTEX_CEILING_DECL(name, ceiling)                                   \
+  mutex_t name = __MUTEX_CEILING_DATA(name, ceiling)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -100,6 +165,9 @@ struct ch_mutex {
 extern "C" {
 #endif
   void chMtxObjectInit(mutex_t *mp);
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+  void chMtxObjectInitCeiling(mutex_t *mp, tprio_t ceiling);
+#endif
   void chMtxLock(mutex_t *mp);
   void chMtxLockS(mutex_t *mp);
   bool chMtxTryLock(mutex_t *mp);
@@ -108,6 +176,7 @@ extern "C" {
   void chMtxUnlockS(mutex_t *mp);
   void chMtxUnlockAll(void);
   void chMtxUnlockAllS(void);
+  tprio_t __mtx_owner_prio(thread_t *tp);
 #ifdef __cplusplus
 }
 #endif
@@ -36,10 +36,99 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Threads migration between OS instances.
+ * @details If enabled then threads have a cores affinity mask and can be
+ *          moved to another OS instance using @p chThdMigrate().
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_SMP_MODE.
+ */
+#if !defined(CH_CFG_USE_THREADS_MIGRATION) || defined(__DOXYGEN__)
+#define CH_CFG_USE_THREADS_MIGRATION        FALSE
+#endif
+
+/**
+ * @brief   Load balancing interval.
+ * @details Idle OS instances pull ready threads waiting on other instances,
+ *          the check is performed by the idle thread at most once every
+ *          @p CH_CFG_SMP_BALANCE_INTERVAL system ticks. Zero disables the
+ *          load balancing.
+ * @note    The default is zero.
+ * @note    Requires @p CH_CFG_USE_THREADS_MIGRATION.
+ */
+#if !defined(CH_CFG_SMP_BALANCE_INTERVAL) || defined(__DOXYGEN__)
+#define CH_CFG_SMP_BALANCE_INTERVAL         0
+#endif
+
+/**
+ * @brief   Reader-Writer Locks APIs.
+ * @details If enabled then the reader-writer locks APIs are included in
+ *          the kernel.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_RWLOCKS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_RWLOCKS                  FALSE
+#endif
+
+/**
+ * @brief   Maximum number of reader-writer locks held by a thread.
+ * @details Each thread has this number of hold records, a record is used
+ *          for each reader-writer lock held by the thread at the same
+ *          time. The records are required by the priority inheritance
+ *          on reader-writer locks.
+ * @note    The default is 4.
+ * @note    Requires @p CH_CFG_USE_RWLOCKS.
+ */
+#if !defined(CH_CFG_RWLOCKS_MAX_HELD) || defined(__DOXYGEN__)
+#define CH_CFG_RWLOCKS_MAX_HELD             4
+#endif
+
+/**
+ * @brief   Names index.
+ * @details If enabled then the registry keeps an hashed index of the
+ *          threads names and @p chRegFindThreadByName() does not scan
+ *          the registry.
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_REGISTRY.
+ */
+#if !defined(CH_CFG_USE_NAMES_INDEX) || defined(__DOXYGEN__)
+#define CH_CFG_USE_NAMES_INDEX              FALSE
+#endif
+
+/**
+ * @brief   Number of buckets of the registry names index.
+ * @note    It must be a power of two.
+ */
+#if !defined(CH_CFG_NAMES_INDEX_BUCKETS) || defined(__DOXYGEN__)
+#define CH_CFG_NAMES_INDEX_BUCKETS          16
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) && (CH_CFG_SMP_MODE == FALSE)
+#error "CH_CFG_USE_THREADS_MIGRATION requires CH_CFG_SMP_MODE"
+#endif
+
+#if (CH_CFG_SMP_BALANCE_INTERVAL > 0) &&                                    \
+    (CH_CFG_USE_THREADS_MIGRATION == FALSE)
+#error "CH_CFG_SMP_BALANCE_INTERVAL requires CH_CFG_USE_THREADS_MIGRATION"
+#endif
+
+#if (CH_CFG_SMP_BALANCE_INTERVAL > 0) && (CH_CFG_NO_IDLE_THREAD == TRUE)
+#error "CH_CFG_SMP_BALANCE_INTERVAL requires the idle thread"
+#endif
+
+#if (CH_CFG_NAMES_INDEX_BUCKETS < 1) ||                                     \
+    ((CH_CFG_NAMES_INDEX_BUCKETS & (CH_CFG_NAMES_INDEX_BUCKETS - 1)) != 0)
+#error "CH_CFG_NAMES_INDEX_BUCKETS must be a power of two"
+#endif
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) && (CH_CFG_RWLOCKS_MAX_HELD < 1)
+#error "invalid CH_CFG_RWLOCKS_MAX_HELD value specified"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -130,6 +219,13 @@ typedef struct ch_registry {
    * @brief   Registry queue header.
    */
   ch_queue_t                    queue;
+#if ((CH_CFG_USE_REGISTRY == TRUE) && (CH_CFG_USE_NAMES_INDEX == TRUE)) ||   \
+    defined(__DOXYGEN__)
+  /**
+   * @brief   Buckets of the registry names index.
+   */
+  thread_t                      *names[CH_CFG_NAMES_INDEX_BUCKETS];
+#endif
 } registry_t;
 
 /**
@@ -147,6 +243,30 @@ typedef struct ch_threads_queue {
   ch_queue_t                    queue;
 } threads_queue_t;
 
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a reader-writer lock hold record.
+ */
+typedef struct ch_rwlock_hold {
+  /**
+   * @brief   Next hold record of the readers of the same lock.
+   */
+  struct ch_rwlock_hold         *next;
+  /**
+   * @brief   The held lock or @p NULL if the record is free.
+   */
+  struct ch_rwlock              *rwp;
+  /**
+   * @brief   Thread owning the record.
+   */
+  thread_t                      *owner;
+  /**
+   * @brief   Number of accesses to the lock.
+   */
+  cnt_t                         cnt;
+} rwlock_hold_t;
+#endif
+
 /**
  * @brief   Structure representing a thread.
  * @note    Not all the listed fields are always needed, by switching off some
@@ -185,11 +305,27 @@ struct ch_thread {
    * @brief   OS instance owner of this thread.
    */
   os_instance_t                 *owner;
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Cores the thread is allowed to run on.
+   */
+  core_mask_t                   affinity;
+#endif
 #if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   Thread name or @p NULL.
    */
   const char                    *name;
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Next thread in the same names index bucket.
+   */
+  thread_t                      *rnext;
+  /**
+   * @brief   Hash of the thread name.
+   */
+  uint32_t                      rhash;
+#endif
 #endif
 #if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE) ||  \
     defined(__DOXYGEN__)
@@ -323,6 +459,12 @@ struct ch_thread {
    */
   tprio_t                       realprio;
 #endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Records of the reader-writer locks held by this thread.
+   */
+  rwlock_hold_t                 rwlholds[CH_CFG_RWLOCKS_MAX_HELD];
+#endif
 #if ((CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)) ||      \
     defined(__DOXYGEN__)
   /**
@@ -412,6 +554,12 @@ struct ch_os_instance {
    * @brief   Core associated to this instance.
    */
   core_id_t                     core_id;
+#if (CH_CFG_SMP_BALANCE_INTERVAL > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Time of the last load balancing check.
+   */
+  systime_t                     balance_time;
+#endif
 #if (CH_CFG_SMP_MODE == FALSE) || defined(__DOXYGEN__)
   /**
    * @brief   Runtime Faults Collection Unit for this instance.
@@ -484,6 +632,12 @@ typedef struct ch_system {
    */
   rfcu_t                        rfcu;
 #endif
+#if (CH_DBG_LOCKS_PROFILING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Registered lock profiles list.
+   */
+  lock_profile_t                *lkprof_list;
+#endif
 #if defined(PORT_SYSTEM_EXTRA_FIELDS) || defined(__DOXYGEN__)
   /* Extra fields from port layer.*/
   PORT_SYSTEM_EXTRA_FIELDS
@@ -100,13 +100,26 @@ typedef struct {
 #define REG_HEADER(oip) (&(oip)->reglist.queue)
 #endif
 
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Access to the registry structure.
+ */
+#if (CH_CFG_SMP_MODE == TRUE) || defined(__DOXYGEN__)
+#define REG_LIST(oip) (&ch_system.reglist)
+#else
+#define REG_LIST(oip) (&(oip)->reglist)
+#endif
+
 /**
  * @brief   Removes a thread from the registry list.
  * @note    This macro is not meant for use in application code.
  *
  * @param[in] tp        thread to remove from the registry
  */
-#define REG_REMOVE(tp) (void) ch_queue_dequeue(&(tp)->rqueue)
+#define REG_REMOVE(tp) do {                                                 \
+  (void) ch_queue_dequeue(&(tp)->rqueue);                                   \
+  __reg_index_remove(REG_LIST((tp)->owner), (tp));                          \
+} while (false)
 
 /**
  * @brief   Adds a thread to the registry list.
@@ -115,7 +128,15 @@ typedef struct {
  * @param[in] oip       pointer to the OS instance
  * @param[in] tp        thread to add to the registry
  */
+#define REG_INSERT(oip, tp) do {                                            \
+  ch_queue_insert(REG_HEADER(oip), &(tp)->rqueue);                          \
+  __reg_index_insert(REG_LIST(oip), (tp));                                  \
+} while (false)
+
+#else /* CH_CFG_USE_NAMES_INDEX == FALSE */
+#define REG_REMOVE(tp) (void) ch_queue_dequeue(&(tp)->rqueue)
 #define REG_INSERT(oip, tp) ch_queue_insert(REG_HEADER(oip), &(tp)->rqueue)
+#endif /* CH_CFG_USE_NAMES_INDEX == FALSE */
 
 /*===========================================================================*/
 /* External declarations.                                                    */
@@ -130,6 +151,11 @@ extern "C" {
   thread_t *chRegFindThreadByName(const char *name);
   thread_t *chRegFindThreadByPointer(thread_t *tp);
   thread_t *chRegFindThreadByWorkingArea(stkalign_t *wa);
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  void __reg_index_insert(registry_t *rp, thread_t *tp);
+  void __reg_index_remove(registry_t *rp, thread_t *tp);
+  void __reg_set_name(thread_t *tp, const char *name);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -149,6 +175,13 @@ extern "C" {
  * @init
  */
 static inline void __reg_object_init(registry_t *rp) {
+#if (CH_CFG_USE_REGISTRY == TRUE) && (CH_CFG_USE_NAMES_INDEX == TRUE)
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_CFG_NAMES_INDEX_BUCKETS; i++) {
+    rp->names[i] = NULL;
+  }
+#endif
 
   ch_queue_init(&rp->queue);
 }
@@ -165,7 +198,11 @@ static inline void __reg_object_init(registry_t *rp) {
 static inline void chRegSetThreadName(const char *name) {
 
 #if CH_CFG_USE_REGISTRY == TRUE
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  __reg_set_name(__sch_get_currthread(), name);
+#else
   __sch_get_currthread()->name = name;
+#endif
 #else
   (void)name;
 #endif
@@ -205,7 +242,11 @@ static inline const char *chRegGetThreadNameX(thread_t *tp) {
 static inline void chRegSetThreadNameX(thread_t *tp, const char *name) {
 
 #if CH_CFG_USE_REGISTRY == TRUE
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  __reg_set_name(tp, name);
+#else
   tp->name = name;
+#endif
 #else
   (void)tp;
   (void)name;
@@ -0,0 +1,224 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rt/include/chrwlock.h
+ * @brief   Reader-Writer Locks macros and structures.
+ *
+ * @addtogroup rwlocks
+ * @{
+ */
+
+#ifndef CHRWLOCK_H
+#define CHRWLOCK_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_MUTEXES == FALSE
+#error "CH_CFG_USE_RWLOCKS requires CH_CFG_USE_MUTEXES"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a reader-writer lock structure.
+ */
+typedef struct ch_rwlock rwlock_t;
+
+/**
+ * @brief   Reader-writer lock structure.
+ */
+struct ch_rwlock {
+  ch_queue_t            rqueue;     /**< @brief Queue of the threads waiting
+                                                for read access.            */
+  ch_queue_t            wqueue;     /**< @brief Queue of the threads waiting
+                                                for write access.           */
+  thread_t              *writer;    /**< @brief Writer @p thread_t pointer
+                                                or @p NULL.                 */
+  rwlock_hold_t         *rholds;    /**< @brief Hold records of the
+                                                readers or @p NULL.         */
+  rwlock_hold_t         *upper;     /**< @brief Hold record a priority
+                                                update resumes from after
+                                                this lock, only used while
+                                                updating.                   */
+  cnt_t                 readers;    /**< @brief Number of readers holding
+                                                the lock.                   */
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static reader-writer lock initializer.
+ * @details This macro should be used when statically initializing a
+ *          reader-writer lock that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the reader-writer lock variable
+ */
+#define __RWLOCK_DATA(name) {__CH_QUEUE_DATA(name.rqueue),                  \
+                             __CH_QUEUE_DATA(name.wqueue),                  \
+                             NULL, NULL, NULL, (cnt_t)0}
+
+/**
+ * @brief   Static reader-writer lock initializer.
+ * @details Statically initialized reader-writer locks require no explicit
+ *          initialization using @p chRwlObjectInit().
+ *
+ * @param[in] name      the name of the reader-writer lock variable
+ */
+#define RWLOCK_DECL(name) rwlock_t name = __RWLOCK_DATA(name)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chRwlObjectInit(rwlock_t *rwp);
+  msg_t chRwlReadLockTimeout(rwlock_t *rwp, sysinterval_t timeout);
+  msg_t chRwlReadLockTimeoutS(rwlock_t *rwp, sysinterval_t timeout);
+  bool chRwlTryReadLock(rwlock_t *rwp);
+  bool chRwlTryReadLockS(rwlock_t *rwp);
+  void chRwlReadUnlock(rwlock_t *rwp);
+  void chRwlReadUnlockS(rwlock_t *rwp);
+  msg_t chRwlWriteLockTimeout(rwlock_t *rwp, sysinterval_t timeout);
+  msg_t chRwlWriteLockTimeoutS(rwlock_t *rwp, sysinterval_t timeout);
+  bool chRwlTryWriteLock(rwlock_t *rwp);
+  bool chRwlTryWriteLockS(rwlock_t *rwp);
+  void chRwlWriteUnlock(rwlock_t *rwp);
+  void chRwlWriteUnlockS(rwlock_t *rwp);
+  tprio_t __rwl_holds_prio(thread_t *tp, tprio_t prio);
+  void __rwl_requeue_i(thread_t *tp);
+  void __rwl_timeout_i(thread_t *tp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Acquires the lock for read access.
+ * @details The lock is shared with the other readers, the invoking thread
+ *          waits if a writer owns the lock or is waiting for it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+static inline void chRwlReadLock(rwlock_t *rwp) {
+
+  (void) chRwlReadLockTimeout(rwp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Acquires the lock for read access.
+ * @details The lock is shared with the other readers, the invoking thread
+ *          waits if a writer owns the lock or is waiting for it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @sclass
+ */
+static inline void chRwlReadLockS(rwlock_t *rwp) {
+
+  (void) chRwlReadLockTimeoutS(rwp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Acquires the lock for write access.
+ * @details The lock is exclusive, the invoking thread waits until all the
+ *          readers and the current writer have released it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+static inline void chRwlWriteLock(rwlock_t *rwp) {
+
+  (void) chRwlWriteLockTimeout(rwp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Acquires the lock for write access.
+ * @details The lock is exclusive, the invoking thread waits until all the
+ *          readers and the current writer have released it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @sclass
+ */
+static inline void chRwlWriteLockS(rwlock_t *rwp) {
+
+  (void) chRwlWriteLockTimeoutS(rwp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Returns the number of readers holding the lock.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @return              The number of readers.
+ *
+ * @iclass
+ */
+static inline cnt_t chRwlGetReadersI(rwlock_t *rwp) {
+
+  chDbgCheckClassI();
+
+  return rwp->readers;
+}
+
+/**
+ * @brief   Returns the thread holding the lock for write access.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @return              The writer thread.
+ * @retval NULL         if the lock is not owned by a writer.
+ *
+ * @iclass
+ */
+static inline thread_t *chRwlGetWriterI(rwlock_t *rwp) {
+
+  chDbgCheckClassI();
+
+  return rwp->writer;
+}
+
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#endif /* CHRWLOCK_H */
+
+/** @} */
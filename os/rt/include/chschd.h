@@ -79,6 +79,10 @@
 #define CH_STATE_WTMSG      (tstate_t)14     /**< @brief Waiting for a
                                                   message.                  */
 #define CH_STATE_FINAL      (tstate_t)15     /**< @brief Thread terminated. */
+#define CH_STATE_WTRDLOCK   (tstate_t)16     /**< @brief On a rwlock for
+                                                  read access.              */
+#define CH_STATE_WTWRLOCK   (tstate_t)17     /**< @brief On a rwlock for
+                                                  write access.             */
 
 /**
  * @brief   Thread states as array of strings.
@@ -88,7 +92,7 @@
 #define CH_STATE_NAMES                                                     \
   "READY", "CURRENT", "WTSTART", "SUSPENDED", "QUEUED", "WTSEM", "WTMTX",  \
   "WTCOND", "SLEEPING", "WTEXIT", "WTOREVT", "WTANDEVT", "SNDMSGQ",        \
-  "SNDMSG", "WTMSG", "FINAL"
+  "SNDMSG", "WTMSG", "FINAL", "WTRDLOCK", "WTWRLOCK"
 /** @} */
 
 /**
@@ -104,6 +108,8 @@
                                                  from a Memory Pool.        */
 #define CH_FLAG_TERMINATE   (tmode_t)4U     /**< @brief Termination requested
                                                  flag.                      */
+#define CH_FLAG_TIMED       (tmode_t)8U     /**< @brief Waiting with a
+                                                 timeout armed.             */
 /** @} */
 
 /*===========================================================================*/
@@ -152,12 +158,19 @@ extern "C" {
   void chSchGoSleepS(tstate_t newstate);
   msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout);
   void chSchWakeupS(thread_t *ntp, msg_t msg);
+  void chSchHandoffS(thread_t *ntp, msg_t msg, tstate_t newstate);
   void chSchRescheduleS(void);
   bool chSchIsPreemptionRequired(void);
   void chSchDoPreemption(void);
   void chSchPreemption(void);
   void chSchDoYieldS(void);
   thread_t *chSchSelectFirst(void);
+#if CH_CFG_USE_THREADS_MIGRATION == TRUE
+  msg_t chSchMigrateS(thread_t *tp, os_instance_t *oip);
+#endif
+#if CH_CFG_SMP_BALANCE_INTERVAL > 0
+  void chSchBalance(void);
+#endif
 #if CH_CFG_OPTIMIZE_SPEED == FALSE
   void ch_sch_prio_insert(ch_queue_t *qp, ch_queue_t *tp);
 #endif /* CH_CFG_OPTIMIZE_SPEED == FALSE */
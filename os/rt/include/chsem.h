@@ -53,6 +53,9 @@ typedef struct ch_semaphore {
   ch_queue_t            queue;      /**< @brief Queue of the threads sleeping
                                                 on this semaphore.          */
   cnt_t                 cnt;        /**< @brief The semaphore counter.      */
+#if (CH_DBG_LOCKS_PROFILING == TRUE) || defined(__DOXYGEN__)
+  lock_profile_t        prof;       /**< @brief Contention profile.         */
+#endif
 } semaphore_t;
 
 /*===========================================================================*/
@@ -68,7 +71,8 @@ typedef struct ch_semaphore {
  * @param[in] n         the counter initial value, this value must be
  *                      non-negative
  */
-#define __SEMAPHORE_DATA(name, n) {__CH_QUEUE_DATA(name.queue), n}
+#define __SEMAPHORE_DATA(name, n) {__CH_QUEUE_DATA(name.queue), n           \
+                                   __LOCK_PROFILE_DATA(CH_LOCK_SEMAPHORE)}
 
 /**
  * @brief   Static semaphore initializer.
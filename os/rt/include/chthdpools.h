@@ -0,0 +1,222 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rt/include/chthdpools.h
+ * @brief   Threads pools macros and structures.
+ *
+ * @addtogroup threads_pools
+ * @{
+ */
+
+#ifndef CHTHDPOOLS_H
+#define CHTHDPOOLS_H
+
+/*lint -sem(chThdPoolExit, r_no)*/
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Threads pools APIs.
+ * @details If enabled then the threads pools APIs are included in the
+ *          kernel.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_THREADS_POOLS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_THREADS_POOLS            FALSE
+#endif
+
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a threads pool worker.
+ */
+typedef struct ch_pool_worker pool_worker_t;
+
+/**
+ * @brief   Structure representing a parked worker.
+ * @note    This structure is allocated on the worker stack.
+ */
+struct ch_pool_worker {
+  /**
+   * @brief   Next parked worker or @p NULL.
+   */
+  pool_worker_t         *next;
+  /**
+   * @brief   Reference to the parked worker thread.
+   */
+  thread_reference_t    tr;
+  /**
+   * @brief   Function to be executed.
+   */
+  tfunc_t               pf;
+  /**
+   * @brief   Function argument.
+   */
+  void                  *arg;
+};
+
+/**
+ * @brief   Type of a threads pool.
+ */
+typedef struct ch_threads_pool {
+  /**
+   * @brief   Stack of the parked workers.
+   */
+  pool_worker_t         *idle;
+  /**
+   * @brief   Queue of the threads waiting for a parked worker.
+   */
+  threads_queue_t       waiting;
+  /**
+   * @brief   Name assigned to the workers.
+   */
+  const char            *name;
+  /**
+   * @brief   Number of workers in the pool.
+   */
+  cnt_t                 workers;
+  /**
+   * @brief   Number of parked workers.
+   */
+  cnt_t                 parked;
+} threads_pool_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static threads pool initializer.
+ * @details This macro should be used when statically initializing a
+ *          threads pool that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the threads pool variable
+ * @param[in] wname     the name to be assigned to the workers
+ */
+#define __THREADS_POOL_DATA(name, wname) {                                  \
+  NULL,                                                                     \
+  __THREADS_QUEUE_DATA(name.waiting),                                       \
+  (wname),                                                                  \
+  (cnt_t)0,                                                                 \
+  (cnt_t)0                                                                  \
+}
+
+/**
+ * @brief   Static threads pool initializer.
+ * @details Statically initialized threads pools require no explicit
+ *          initialization using @p chThdPoolObjectInit().
+ *
+ * @param[in] name      the name of the threads pool variable
+ * @param[in] wname     the name to be assigned to the workers
+ */
+#define THREADS_POOL_DECL(name, wname)                                      \
+  threads_pool_t name = __THREADS_POOL_DATA(name, wname)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chThdPoolObjectInit(threads_pool_t *tpp, const char *name);
+  thread_t *chThdPoolAddStatic(threads_pool_t *tpp, void *wsp, size_t size,
+                               tprio_t prio);
+  msg_t chThdPoolStartI(threads_pool_t *tpp, tprio_t prio,
+                        tfunc_t pf, void *arg);
+  msg_t chThdPoolStartTimeoutS(threads_pool_t *tpp, tprio_t prio,
+                               tfunc_t pf, void *arg, sysinterval_t timeout);
+  msg_t chThdPoolStartTimeout(threads_pool_t *tpp, tprio_t prio,
+                              tfunc_t pf, void *arg, sysinterval_t timeout);
+  void chThdPoolExit(threads_pool_t *tpp, msg_t msg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Runs a function on a parked worker.
+ * @details The invoking thread waits until a worker is available.
+ *
+ * @param[in] tpp       pointer to the @p threads_pool_t structure
+ * @param[in] prio      priority of the worker while executing the function
+ * @param[in] pf        the function to be executed
+ * @param[in] arg       the function argument
+ *
+ * @api
+ */
+static inline void chThdPoolStart(threads_pool_t *tpp, tprio_t prio,
+                                  tfunc_t pf, void *arg) {
+
+  (void) chThdPoolStartTimeout(tpp, prio, pf, arg, TIME_INFINITE);
+}
+
+/**
+ * @brief   Returns the number of workers in the pool.
+ *
+ * @param[in] tpp       pointer to the @p threads_pool_t structure
+ * @return              The number of workers.
+ *
+ * @iclass
+ */
+static inline cnt_t chThdPoolGetWorkersI(threads_pool_t *tpp) {
+
+  chDbgCheckClassI();
+
+  return tpp->workers;
+}
+
+/**
+ * @brief   Returns the number of parked workers.
+ *
+ * @param[in] tpp       pointer to the @p threads_pool_t structure
+ * @return              The number of workers ready to execute a function.
+ *
+ * @iclass
+ */
+static inline cnt_t chThdPoolGetParkedI(threads_pool_t *tpp) {
+
+  chDbgCheckClassI();
+
+  return tpp->parked;
+}
+
+#endif /* CH_CFG_USE_THREADS_POOLS == TRUE */
+
+#endif /* CHTHDPOOLS_H */
+
+/** @} */
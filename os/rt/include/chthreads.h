@@ -34,6 +34,11 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Affinity mask allowing all cores.
+ */
+#define CH_AFFINITY_ALL                     ((core_mask_t)-1)
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -85,6 +90,14 @@ typedef struct {
    */
   os_instance_t     *instance;
 #endif
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief         Cores the thread is allowed to run on.
+   * @note          Zero means no restrictions, threads can be moved to
+   *                any OS instance.
+   */
+  core_mask_t       affinity;
+#endif
 } thread_descriptor_t;
 
 /*===========================================================================*/
@@ -174,7 +187,7 @@ typedef struct {
  * @name    Threads initializers
  * @{
  */
-#if (CH_CFG_SMP_MODE != FALSE) || defined(__DOXYGEN__)
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Thread descriptor initializer with no affinity.
  *
@@ -185,6 +198,17 @@ typedef struct {
  * @param[in] funcp     thread function pointer
  * @param[in] arg       thread argument
  */
+#define THD_DESCRIPTOR(name, wbase, wend, prio, funcp, arg) {               \
+  (name),                                                                   \
+  (wbase),                                                                  \
+  (wend),                                                                   \
+  (prio),                                                                   \
+  (funcp),                                                                  \
+  (arg),                                                                    \
+  NULL,                                                                     \
+  (core_mask_t)0                                                            \
+}
+#elif CH_CFG_SMP_MODE != FALSE
 #define THD_DESCRIPTOR(name, wbase, wend, prio, funcp, arg) {               \
   (name),                                                                   \
   (wbase),                                                                  \
@@ -205,6 +229,7 @@ typedef struct {
 }
 #endif
 
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Thread descriptor initializer with no affinity.
  *
@@ -216,6 +241,17 @@ typedef struct {
  * @param[in] arg       thread argument
  * @param[in] oip       instance affinity
  */
+#define THD_DESCRIPTOR_AFFINITY(name, wbase, wend, prio, funcp, arg, oip) { \
+  (name),                                                                   \
+  (wbase),                                                                  \
+  (wend),                                                                   \
+  (prio),                                                                   \
+  (funcp),                                                                  \
+  (arg),                                                                    \
+  (oip),                                                                    \
+  (core_mask_t)0                                                            \
+}
+#else
 #define THD_DESCRIPTOR_AFFINITY(name, wbase, wend, prio, funcp, arg, oip) { \
   (name),                                                                   \
   (wbase),                                                                  \
@@ -225,8 +261,42 @@ typedef struct {
   (arg),                                                                    \
   (oip)                                                                     \
 }
+#endif
+
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Thread descriptor initializer with instance and cores affinity.
+ *
+ * @param[in] name      thread name
+ * @param[in] wbase     pointer to the working area base
+ * @param[in] wend      pointer to the working area end
+ * @param[in] prio      thread priority
+ * @param[in] funcp     thread function pointer
+ * @param[in] arg       thread argument
+ * @param[in] oip       instance affinity
+ * @param[in] mask      cores the thread is allowed to run on
+ */
+#define THD_DESCRIPTOR_MASK(name, wbase, wend, prio, funcp, arg, oip,       \
+                            mask) {                                         \
+  (name),                                                                   \
+  (wbase),                                                                  \
+  (wend),                                                                   \
+  (prio),                                                                   \
+  (funcp),                                                                  \
+  (arg),                                                                    \
+  (oip),                                                                    \
+  (mask)                                                                    \
+}
+#endif
 /** @} */
 
+/**
+ * @brief   Affinity mask of a single core.
+ *
+ * @param[in] n         the core identifier
+ */
+#define CH_AFFINITY_CORE(n)                 ((core_mask_t)1U << (n))
+
 /**
  * @name    Macro Functions
  * @{
@@ -323,6 +393,10 @@ extern "C" {
   void chThdSleepUntil(systime_t time);
   systime_t chThdSleepUntilWindowed(systime_t prev, systime_t next);
   void chThdYield(void);
+#if CH_CFG_USE_THREADS_MIGRATION == TRUE
+  msg_t chThdMigrate(thread_t *tp, os_instance_t *oip);
+  msg_t chThdSetAffinity(thread_t *tp, core_mask_t mask);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -356,6 +430,21 @@ static inline tprio_t chThdGetPriorityX(void) {
   return chThdGetSelfX()->hdr.pqueue.prio;
 }
 
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the cores affinity mask of a thread.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The affinity mask.
+ *
+ * @xclass
+ */
+static inline core_mask_t chThdGetAffinityX(thread_t *tp) {
+
+  return tp->affinity;
+}
+#endif
+
 /**
  * @brief   Returns the number of ticks consumed by the specified thread.
  * @note    This function is only available when the
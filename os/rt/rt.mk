@@ -27,6 +27,9 @@ endif
 ifneq ($(findstring CH_DBG_STATISTICS TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chstats.c
 endif
+ifneq ($(findstring CH_DBG_LOCKS_PROFILING TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chlockprof.c
+endif
 ifneq ($(findstring CH_CFG_USE_REGISTRY TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chregistry.c
 endif
@@ -39,6 +42,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_CONDVARS TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chcond.c
 endif
+ifneq ($(findstring CH_CFG_USE_RWLOCKS TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chrwlock.c
+endif
 ifneq ($(findstring CH_CFG_USE_EVENTS TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chevents.c
 endif
@@ -48,6 +54,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_DYNAMIC TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chdynamic.c
 endif
+ifneq ($(findstring CH_CFG_USE_THREADS_POOLS TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chthdpools.c
+endif
 else
 KERNSRC := $(CHIBIOS)/os/rt/src/chsys.c \
            $(CHIBIOS)/os/rt/src/chrfcu.c \
@@ -59,13 +68,16 @@ KERNSRC := $(CHIBIOS)/os/rt/src/chsys.c \
            $(CHIBIOS)/os/rt/src/chthreads.c \
            $(CHIBIOS)/os/rt/src/chtm.c \
            $(CHIBIOS)/os/rt/src/chstats.c \
+           $(CHIBIOS)/os/rt/src/chlockprof.c \
            $(CHIBIOS)/os/rt/src/chregistry.c \
            $(CHIBIOS)/os/rt/src/chsem.c \
            $(CHIBIOS)/os/rt/src/chmtx.c \
            $(CHIBIOS)/os/rt/src/chcond.c \
+           $(CHIBIOS)/os/rt/src/chrwlock.c \
            $(CHIBIOS)/os/rt/src/chevents.c \
            $(CHIBIOS)/os/rt/src/chmsg.c \
-           $(CHIBIOS)/os/rt/src/chdynamic.c
+           $(CHIBIOS)/os/rt/src/chdynamic.c \
+           $(CHIBIOS)/os/rt/src/chthdpools.c
 endif
 
 # Required include directories
@@ -49,7 +49,12 @@
  *          Event Source will be signaled with an events mask.<br>
  *          An unlimited number of Event Sources can exists in a system and
  *          each thread can be listening on an unlimited number of
- *          them.
+ *          them.<br>
+ *          Indexed Event Sources distribute their listeners in buckets
+ *          by the flags the listeners are interested in, broadcasting
+ *          flags only scans the listeners that can be interested in
+ *          them. This is useful for sources with many listeners each one
+ *          interested in few flags.
  * @pre     In order to use the Events APIs the @p CH_CFG_USE_EVENTS option
  *          must be enabled in @p chconf.h.
  * @post    Enabling events requires 1-4 (depending on the architecture)
@@ -65,6 +70,15 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+/* Size in bits of the eventflags_t type.*/
+#define EVT_FLAGS_BITS          (sizeof (eventflags_t) * 8U)
+
+/* Mask with a bit set for each bucket of an indexed event source.*/
+#define EVT_ALL_BUCKETS                                                     \
+  ((eventflags_t)-1 >> (EVT_FLAGS_BITS - (size_t)CH_CFG_EVENTS_INDEX_BUCKETS))
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -81,6 +95,87 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Signals all the Event Listeners in a list.
+ *
+ * @param[in] esp       pointer to the @p event_source_t structure
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @notapi
+ */
+static void evt_broadcast_flags(event_source_t *esp, eventflags_t flags) {
+  event_listener_t *elp;
+
+  elp = esp->next;
+  /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+  while (elp != (event_listener_t *)esp) {
+  /*lint -restore*/
+    elp->flags |= flags;
+    /* When flags == 0 the thread will always be signaled because the
+       source does not emit any flag.*/
+    if ((flags == (eventflags_t)0) ||
+        ((flags & elp->wflags) != (eventflags_t)0)) {
+      chEvtSignalI(elp->listener, elp->events);
+    }
+    elp = elp->next;
+  }
+}
+
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Folds a flags mask on the buckets of an indexed event source.
+ *
+ * @param[in] flags     the flags mask
+ * @return              A mask with a bit set for each bucket associated to
+ *                      at least one of the flags.
+ *
+ * @notapi
+ */
+static eventflags_t evt_fold_flags(eventflags_t flags) {
+  eventflags_t m = (eventflags_t)0;
+
+  while (flags != (eventflags_t)0) {
+    m |= flags & EVT_ALL_BUCKETS;
+    /* Note, shifting in two steps because the number of buckets can be
+       equal to the size of the type.*/
+    flags = (eventflags_t)(flags >> (CH_CFG_EVENTS_INDEX_BUCKETS - 1)) >> 1;
+  }
+
+  return m;
+}
+
+/**
+ * @brief   Returns the listeners list associated to a flags mask.
+ * @details Listeners interested in flags associated to exactly one bucket
+ *          are put in that bucket, all the other listeners are put in the
+ *          list that is scanned on each broadcast.
+ *
+ * @param[in] iesp      pointer to the @p event_isource_t structure
+ * @param[in] wflags    mask of flags the listener is interested in
+ * @return              The listeners list.
+ *
+ * @notapi
+ */
+static event_source_t *evt_get_list(event_isource_t *iesp,
+                                    eventflags_t wflags) {
+  eventflags_t m = evt_fold_flags(wflags);
+  unsigned i;
+
+  if ((m == (eventflags_t)0) ||
+      ((m & (m - (eventflags_t)1)) != (eventflags_t)0)) {
+    return &iesp->wide;
+  }
+
+  i = 0U;
+  while ((m & (eventflags_t)1) == (eventflags_t)0) {
+    m >>= 1;
+    i++;
+  }
+
+  return &iesp->buckets[i];
+}
+#endif /* CH_CFG_USE_EVENTS_INDEX == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -344,24 +439,11 @@ void chEvtSignal(thread_t *tp, eventmask_t events) {
  * @iclass
  */
 void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
-  event_listener_t *elp;
 
   chDbgCheckClassI();
   chDbgCheck(esp != NULL);
 
-  elp = esp->next;
-  /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
-  while (elp != (event_listener_t *)esp) {
-  /*lint -restore*/
-    elp->flags |= flags;
-    /* When flags == 0 the thread will always be signaled because the
-       source does not emit any flag.*/
-    if ((flags == (eventflags_t)0) ||
-        ((flags & elp->wflags) != (eventflags_t)0)) {
-      chEvtSignalI(elp->listener, elp->events);
-    }
-    elp = elp->next;
-  }
+  evt_broadcast_flags(esp, flags);
 }
 
 /**
@@ -631,6 +713,169 @@ eventmask_t chEvtWaitAllTimeout(eventmask_t events, sysinterval_t timeout) {
 }
 #endif /* CH_CFG_USE_EVENTS_TIMEOUT == TRUE */
 
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an Indexed Event Source.
+ * @note    This function can be invoked before the kernel is initialized
+ *          because it just prepares a @p event_isource_t structure.
+ *
+ * @param[out] iesp     pointer to the @p event_isource_t structure
+ *
+ * @init
+ */
+void chEvtIndexedObjectInit(event_isource_t *iesp) {
+  unsigned i;
+
+  chDbgCheck(iesp != NULL);
+  chDbgAssert((size_t)CH_CFG_EVENTS_INDEX_BUCKETS <= EVT_FLAGS_BITS,
+              "too many buckets");
+
+  chEvtObjectInit(&iesp->wide);
+  for (i = 0U; i < (unsigned)CH_CFG_EVENTS_INDEX_BUCKETS; i++) {
+    chEvtObjectInit(&iesp->buckets[i]);
+  }
+}
+
+/**
+ * @brief   Registers an Event Listener on an Indexed Event Source.
+ * @details Once a thread has registered as listener on an event source it
+ *          will be notified of the events broadcasted there with flags
+ *          matching @p wflags.
+ * @note    Listeners interested in few flags are faster to broadcast,
+ *          registering with all flags set is allowed but the listener is
+ *          scanned on each broadcast.
+ *
+ * @param[in] iesp      pointer to the @p event_isource_t structure
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ * @param[in] events    events to be ORed to the thread when
+ *                      the event source is broadcasted
+ * @param[in] wflags    mask of flags the listening thread is interested in
+ *
+ * @iclass
+ */
+void chEvtIndexedRegisterMaskWithFlagsI(event_isource_t *iesp,
+                                        event_listener_t *elp,
+                                        eventmask_t events,
+                                        eventflags_t wflags) {
+
+  chDbgCheckClassI();
+  chDbgCheck((iesp != NULL) && (elp != NULL));
+
+  chEvtRegisterMaskWithFlagsI(evt_get_list(iesp, wflags),
+                              elp, events, wflags);
+}
+
+/**
+ * @brief   Registers an Event Listener on an Indexed Event Source.
+ * @details Once a thread has registered as listener on an event source it
+ *          will be notified of the events broadcasted there with flags
+ *          matching @p wflags.
+ * @note    Listeners interested in few flags are faster to broadcast,
+ *          registering with all flags set is allowed but the listener is
+ *          scanned on each broadcast.
+ *
+ * @param[in] iesp      pointer to the @p event_isource_t structure
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ * @param[in] events    events to be ORed to the thread when
+ *                      the event source is broadcasted
+ * @param[in] wflags    mask of flags the listening thread is interested in
+ *
+ * @api
+ */
+void chEvtIndexedRegisterMaskWithFlags(event_isource_t *iesp,
+                                       event_listener_t *elp,
+                                       eventmask_t events,
+                                       eventflags_t wflags) {
+
+  chSysLock();
+  chEvtIndexedRegisterMaskWithFlagsI(iesp, elp, events, wflags);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Unregisters an Event Listener from its Indexed Event Source.
+ * @note    If the event listener is not registered on the specified event
+ *          source then the function does nothing.
+ * @note    The @p wflags field of the listener must not be modified while
+ *          the listener is registered.
+ *
+ * @param[in] iesp      pointer to the @p event_isource_t structure
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ *
+ * @api
+ */
+void chEvtIndexedUnregister(event_isource_t *iesp, event_listener_t *elp) {
+
+  chDbgCheck((iesp != NULL) && (elp != NULL));
+
+  chEvtUnregister(evt_get_list(iesp, elp->wflags), elp);
+}
+
+/**
+ * @brief   Signals the Event Listeners interested in the specified flags.
+ * @details Only the listeners in the buckets associated to @p flags and
+ *          the listeners not associated to a single bucket are scanned,
+ *          the flags are ORed only to the scanned listeners. Listeners
+ *          that are not scanned are not interested in the flags so the
+ *          result of @p chEvtGetAndClearFlags() is not affected.
+ * @note    Broadcasting with @p flags equal to zero signals all the
+ *          listeners, all the buckets are scanned.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] iesp      pointer to the @p event_isource_t structure
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @iclass
+ */
+void chEvtIndexedBroadcastFlagsI(event_isource_t *iesp, eventflags_t flags) {
+  eventflags_t m;
+  event_source_t *esp;
+
+  chDbgCheckClassI();
+  chDbgCheck(iesp != NULL);
+
+  if (flags == (eventflags_t)0) {
+    m = EVT_ALL_BUCKETS;
+  }
+  else {
+    m = evt_fold_flags(flags);
+  }
+
+  evt_broadcast_flags(&iesp->wide, flags);
+  esp = &iesp->buckets[0];
+  while (m != (eventflags_t)0) {
+    if ((m & (eventflags_t)1) != (eventflags_t)0) {
+      evt_broadcast_flags(esp, flags);
+    }
+    m >>= 1;
+    esp++;
+  }
+}
+
+/**
+ * @brief   Signals the Event Listeners interested in the specified flags.
+ * @details Only the listeners in the buckets associated to @p flags and
+ *          the listeners not associated to a single bucket are scanned.
+ * @note    Broadcasting with @p flags equal to zero signals all the
+ *          listeners, all the buckets are scanned.
+ *
+ * @param[in] iesp      pointer to the @p event_isource_t structure
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @api
+ */
+void chEvtIndexedBroadcastFlags(event_isource_t *iesp, eventflags_t flags) {
+
+  chSysLock();
+  chEvtIndexedBroadcastFlagsI(iesp, flags);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_CFG_USE_EVENTS_INDEX == TRUE */
+
 #endif /* CH_CFG_USE_EVENTS == TRUE */
 
 /** @} */
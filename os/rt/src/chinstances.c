@@ -64,6 +64,11 @@ static void __idle_thread(void *p) {
   (void)p;
 
   while (true) {
+#if CH_CFG_SMP_BALANCE_INTERVAL > 0
+    /* Pulling work from busier instances before going to sleep.*/
+    chSchBalance();
+#endif
+
     /*lint -save -e522 [2.2] Apparently no side effects because it contains
       an asm instruction.*/
     port_wait_for_interrupt();
@@ -124,6 +129,11 @@ void chInstanceObjectInit(os_instance_t *oip,
   /* Virtual timers list initialization.*/
   __vt_object_init(&oip->vtlist);
 
+#if CH_CFG_SMP_BALANCE_INTERVAL > 0
+  /* Load balancing checks start after one interval.*/
+  oip->balance_time = (systime_t)0;
+#endif
+
   /* Debug support initialization.*/
   __dbg_object_init(&oip->dbg);
 
@@ -159,6 +169,11 @@ void chInstanceObjectInit(os_instance_t *oip,
   /* Setting up the caller as current thread.*/
   oip->rlist.current->state = CH_STATE_CURRENT;
 
+#if CH_CFG_USE_THREADS_MIGRATION == TRUE
+  /* The main thread is bound to its instance.*/
+  oip->rlist.current->affinity = CH_AFFINITY_CORE(core_id);
+#endif
+
   /* User instance initialization hook.*/
   CH_CFG_OS_INSTANCE_INIT_HOOK(oip);
 
@@ -170,7 +185,10 @@ void chInstanceObjectInit(os_instance_t *oip,
       .wend     = oicp->idlethread_end,
       .prio     = IDLEPRIO,
       .funcp    = __idle_thread,
-      .arg      = NULL
+      .arg      = NULL,
+#if CH_CFG_USE_THREADS_MIGRATION == TRUE
+      .affinity = CH_AFFINITY_CORE(core_id)
+#endif
     };
 
 #if CH_DBG_FILL_THREADS == TRUE
@@ -0,0 +1,212 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rt/src/chlockprof.c
+ * @brief   Locks contention profiler code.
+ *
+ * @addtogroup lock_profiler
+ * @details Locks contention profiler services. Mutexes and semaphores
+ *          collect statistics about acquisitions, contention, wait times
+ *          and, for mutexes, hold times. Profiles can be registered with
+ *          a name into a system-wide list in order to be inspected at
+ *          runtime.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_DBG_LOCKS_PROFILING == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Accounts a lock acquisition.
+ * @note    Internal use only.
+ *
+ * @param[in] lpp       pointer to the @p lock_profile_t structure
+ *
+ * @notapi
+ */
+void __lkprof_acquired(lock_profile_t *lpp) {
+
+  lpp->n_acquired++;
+  lpp->last = chSysGetRealtimeCounterX();
+}
+
+/**
+ * @brief   Accounts a wait on a lock.
+ * @note    Internal use only.
+ *
+ * @param[in] lpp       pointer to the @p lock_profile_t structure
+ * @param[in] start     time stamp taken before going to sleep
+ *
+ * @notapi
+ */
+void __lkprof_contended(lock_profile_t *lpp, rtcnt_t start) {
+  rtcnt_t wait = chSysGetRealtimeCounterX() - start;
+
+  lpp->n_contended++;
+  lpp->wait_cumulative += (rttime_t)wait;
+  if (wait > lpp->wait_max) {
+    lpp->wait_max = wait;
+  }
+}
+
+/**
+ * @brief   Accounts a lock release.
+ * @note    Internal use only.
+ *
+ * @param[in] lpp       pointer to the @p lock_profile_t structure
+ *
+ * @notapi
+ */
+void __lkprof_released(lock_profile_t *lpp) {
+  rtcnt_t hold = chSysGetRealtimeCounterX() - lpp->last;
+
+  if (hold > lpp->hold_max) {
+    lpp->hold_max = hold;
+  }
+}
+
+/**
+ * @brief   Initializes a @p lock_profile_t structure.
+ * @note    Internal use only.
+ *
+ * @param[out] lpp      pointer to the @p lock_profile_t structure
+ * @param[in] type      type of the owner lock object
+ *
+ * @notapi
+ */
+void chLockProfObjectInit(lock_profile_t *lpp, uint8_t type) {
+
+  lpp->next = NULL;
+  lpp->name = NULL;
+  lpp->type = type;
+  lpp->last = (rtcnt_t)0;
+  chLockProfReset(lpp);
+}
+
+/**
+ * @brief   Clears the statistics of a lock profile.
+ *
+ * @param[in] lpp       pointer to the @p lock_profile_t structure
+ *
+ * @xclass
+ */
+void chLockProfReset(lock_profile_t *lpp) {
+
+  lpp->n_acquired      = (ucnt_t)0;
+  lpp->n_contended     = (ucnt_t)0;
+  lpp->n_boosts        = (ucnt_t)0;
+  lpp->wait_cumulative = (rttime_t)0;
+  lpp->wait_max        = (rtcnt_t)0;
+  lpp->hold_max        = (rtcnt_t)0;
+}
+
+/**
+ * @brief   Adds a lock profile to the registered profiles list.
+ * @note    The lock object must be unregistered before it goes out of
+ *          scope.
+ *
+ * @param[in] lpp       pointer to the @p lock_profile_t structure
+ * @param[in] name      name to be assigned to the profile, the string
+ *                      must stay valid while the profile is registered
+ *
+ * @api
+ */
+void chLockProfRegister(lock_profile_t *lpp, const char *name) {
+
+  chDbgCheck(lpp != NULL);
+
+  chSysLock();
+  lpp->name = name;
+  lpp->next = ch_system.lkprof_list;
+  ch_system.lkprof_list = lpp;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Removes a lock profile from the registered profiles list.
+ * @note    Removing a profile that is not registered has no effect.
+ *
+ * @param[in] lpp       pointer to the @p lock_profile_t structure
+ *
+ * @api
+ */
+void chLockProfUnregister(lock_profile_t *lpp) {
+  lock_profile_t **lppp;
+
+  chDbgCheck(lpp != NULL);
+
+  chSysLock();
+  lppp = &ch_system.lkprof_list;
+  while (*lppp != NULL) {
+    if (*lppp == lpp) {
+      *lppp = lpp->next;
+      lpp->next = NULL;
+      break;
+    }
+    lppp = &(*lppp)->next;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the first registered lock profile.
+ * @note    The list must not be modified while it is being scanned so the
+ *          whole scan must be performed in the same critical zone.
+ *
+ * @return              The first registered profile.
+ * @retval NULL         if there are no registered profiles.
+ *
+ * @sclass
+ */
+lock_profile_t *chLockProfFirstS(void) {
+
+  chDbgCheckClassS();
+
+  return ch_system.lkprof_list;
+}
+
+#endif /* CH_DBG_LOCKS_PROFILING == TRUE */
+
+/** @} */
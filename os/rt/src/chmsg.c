@@ -71,6 +71,8 @@
  * @brief   Sends a message to the specified thread.
  * @details The sender is stopped until the receiver executes a
  *          @p chMsgRelease()after receiving the message.
+ * @note    If the receiver is waiting for a message then the CPU is handed
+ *          directly to it, without going through the ready list.
  *
  * @param[in] tp        the pointer to the thread
  * @param[in] msg       the message
@@ -87,9 +89,11 @@ msg_t chMsgSend(thread_t *tp, msg_t msg) {
   currtp->u.sentmsg = msg;
   __ch_msg_insert(&tp->msgqueue, currtp);
   if (tp->state == CH_STATE_WTMSG) {
-    (void) chSchReadyI(tp);
+    chSchHandoffS(tp, MSG_OK, CH_STATE_SNDMSGQ);
+  }
+  else {
+    chSchGoSleepS(CH_STATE_SNDMSGQ);
   }
-  chSchGoSleepS(CH_STATE_SNDMSGQ);
   msg = currtp->u.rdymsg;
   chSysUnlock();
 
@@ -195,6 +199,47 @@ thread_t *chMsgPollS(void) {
   return tp;
 }
 
+/**
+ * @brief   Releases a sender thread and waits for the next message.
+ * @details This is the combination of @p chMsgReleaseS() and
+ *          @p chMsgWaitS() done atomically. If there are no other messages
+ *          in queue then the CPU is handed directly to the released
+ *          thread, a client calling @p chMsgSend() in a loop and a server
+ *          using this function then exchange messages without going
+ *          through the ready list.
+ * @pre     Invoke this function only after a message has been received
+ *          using @p chMsgWait().
+ * @post    After receiving a message the function @p chMsgGet() must be
+ *          called in order to retrieve the message and then this function
+ *          or @p chMsgRelease() must be invoked in order to acknowledge the
+ *          reception and send the answer.
+ * @note    The reference counter of the sender thread is not increased, the
+ *          returned pointer is a temporary reference.
+ *
+ * @param[in] tp        pointer to the thread to be released
+ * @param[in] msg       message to be returned to the sender
+ * @return              A pointer to the thread carrying the next message.
+ *
+ * @sclass
+ */
+thread_t *chMsgReleaseWaitS(thread_t *tp, msg_t msg) {
+  thread_t *currtp = chThdGetSelfX();
+
+  chDbgCheckClassS();
+  chDbgAssert(tp->state == CH_STATE_SNDMSG, "invalid state");
+
+  if (!chMsgIsPendingI(currtp)) {
+    chSchHandoffS(tp, msg, CH_STATE_WTMSG);
+  }
+  else {
+    chSchWakeupS(tp, msg);
+  }
+  tp = threadref(ch_queue_fifo_remove(&currtp->msgqueue));
+  tp->state = CH_STATE_SNDMSG;
+
+  return tp;
+}
+
 /**
  * @brief   Releases a sender thread specifying a response message.
  * @pre     Invoke this function only after a message has been received
@@ -89,10 +89,68 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Raises the priority of a mutex owner to the mutex ceiling.
+ *
+ * @param[in] tp        the new owner of the mutex
+ * @param[in] mp        pointer to the @p mutex_t structure
+ */
+static inline void mtx_raise_to_ceiling(thread_t *tp, mutex_t *mp) {
+
+  if (tp->hdr.pqueue.prio < mp->ceiling) {
+    tp->hdr.pqueue.prio = mp->ceiling;
+  }
+}
+#endif /* CH_CFG_USE_MUTEXES_CEILING == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+/**
+ * @brief   Recalculates the priority of a thread owning mutexes.
+ * @details The priority is the highest among the thread base priority,
+ *          the ceilings of the owned ceiling mutexes and the priorities
+ *          of the threads waiting on the owned mutexes and on the held
+ *          reader-writer locks.
+ * @note    Internal use only, all the unlock paths use this function in
+ *          order to drop the inherited priority.
+ *
+ * @param[in] tp        the thread
+ * @return              The calculated priority.
+ *
+ * @notapi
+ */
+tprio_t __mtx_owner_prio(thread_t *tp) {
+  tprio_t newprio = tp->realprio;
+  mutex_t *lmp = tp->mtxlist;
+
+  while (lmp != NULL) {
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+    /* Owned ceiling mutexes keep the priority at their ceiling.*/
+    if (lmp->ceiling > newprio) {
+      newprio = lmp->ceiling;
+    }
+#endif
+    /* If the highest priority thread waiting in the mutexes list has a
+       greater priority than the current thread base priority then the
+       final priority will have at least that priority.*/
+    if (chMtxQueueNotEmptyS(lmp) &&
+        ((threadref(lmp->queue.next))->hdr.pqueue.prio > newprio)) {
+      newprio = (threadref(lmp->queue.next))->hdr.pqueue.prio;
+    }
+    lmp = lmp->next;
+  }
+
+#if CH_CFG_USE_RWLOCKS == TRUE
+  /* Threads waiting on the held reader-writer locks.*/
+  newprio = __rwl_holds_prio(tp, newprio);
+#endif
+
+  return newprio;
+}
+
 /**
  * @brief   Initializes s @p mutex_t structure.
  *
@@ -109,7 +167,38 @@ void chMtxObjectInit(mutex_t *mp) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   mp->cnt = (cnt_t)0;
 #endif
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+  mp->ceiling = (tprio_t)0;
+#endif
+  chLockProfObjectInit(&mp->prof, CH_LOCK_MUTEX);
+}
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a @p mutex_t structure as a ceiling mutex.
+ * @details Ceiling mutexes use the immediate priority ceiling protocol,
+ *          the owner priority is raised to the ceiling as soon as the
+ *          mutex is acquired so the owner cannot be preempted by other
+ *          threads using the same mutex. There is no priority inheritance
+ *          chain to be walked when locking and unlocking.
+ * @note    The ceiling must be equal or greater than the base priority
+ *          of any thread locking the mutex. A thread locking the mutex
+ *          while running at an inherited priority above the ceiling
+ *          boosts the owner as with the priority inheritance protocol.
+ *
+ * @param[out] mp       pointer to a @p mutex_t structure
+ * @param[in] ceiling   the priority ceiling
+ *
+ * @init
+ */
+void chMtxObjectInitCeiling(mutex_t *mp, tprio_t ceiling) {
+
+  chDbgCheck(ceiling > IDLEPRIO);
+
+  chMtxObjectInit(mp);
+  mp->ceiling = ceiling;
 }
+#endif /* CH_CFG_USE_MUTEXES_CEILING == TRUE */
 
 /**
  * @brief   Locks the specified mutex.
@@ -159,12 +248,23 @@ void chMtxLockS(mutex_t *mp) {
          boosting the priority of all the affected threads to equal the
          priority of the running thread requesting the mutex.*/
       thread_t *tp = mp->owner;
+#if CH_DBG_LOCKS_PROFILING == TRUE
+      rtcnt_t start = chSysGetRealtimeCounterX();
+#endif
+
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+      chDbgAssert((mp->ceiling == (tprio_t)0) ||
+                  (currtp->realprio <= mp->ceiling), "ceiling violation");
+#endif
 
       /* Does the running thread have higher priority than the mutex
-         owning thread? */
+         owning thread? The owner of a ceiling mutex already runs at the
+         ceiling priority, it is boosted only if the running thread has
+         inherited a priority above the ceiling.*/
       while (tp->hdr.pqueue.prio < currtp->hdr.pqueue.prio) {
         /* Make priority of thread tp match the running thread's priority.*/
         tp->hdr.pqueue.prio = currtp->hdr.pqueue.prio;
+        __lkprof_boost(&mp->prof);
 
         /* The following states need priority queues reordering.*/
         switch (tp->state) {
@@ -175,6 +275,15 @@ void chMtxLockS(mutex_t *mp) {
           tp = tp->u.wtmtxp->owner;
           /*lint -e{9042} [16.1] Continues the while.*/
           continue;
+#if CH_CFG_USE_RWLOCKS == TRUE
+        case CH_STATE_WTRDLOCK:
+          /* Falls through.*/
+        case CH_STATE_WTWRLOCK:
+          /* Re-enqueues tp on the reader-writer lock, the lock holders
+             are updated by the lock code.*/
+          __rwl_requeue_i(tp);
+          break;
+#endif
 #if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
     ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
      (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)) ||                           \
@@ -219,6 +328,8 @@ void chMtxLockS(mutex_t *mp) {
          the mutex to this thread.*/
       chDbgAssert(mp->owner == currtp, "not owner");
       chDbgAssert(currtp->mtxlist == mp, "not owned");
+      __lkprof_contended(&mp->prof, start);
+      __lkprof_acquired(&mp->prof);
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
       chDbgAssert(mp->cnt == (cnt_t)1, "counter is not one");
     }
@@ -234,6 +345,12 @@ void chMtxLockS(mutex_t *mp) {
     mp->owner = currtp;
     mp->next = currtp->mtxlist;
     currtp->mtxlist = mp;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+    chDbgAssert((mp->ceiling == (tprio_t)0) ||
+                (currtp->realprio <= mp->ceiling), "ceiling violation");
+    mtx_raise_to_ceiling(currtp, mp);
+#endif
+    __lkprof_acquired(&mp->prof);
   }
 }
 
@@ -308,6 +425,12 @@ bool chMtxTryLockS(mutex_t *mp) {
   mp->owner = currtp;
   mp->next = currtp->mtxlist;
   currtp->mtxlist = mp;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+  chDbgAssert((mp->ceiling == (tprio_t)0) ||
+              (currtp->realprio <= mp->ceiling), "ceiling violation");
+  mtx_raise_to_ceiling(currtp, mp);
+#endif
+  __lkprof_acquired(&mp->prof);
   return true;
 }
 
@@ -325,7 +448,6 @@ bool chMtxTryLockS(mutex_t *mp) {
  */
 void chMtxUnlock(mutex_t *mp) {
   thread_t *currtp = chThdGetSelfX();
-  mutex_t *lmp;
 
   chDbgCheck(mp != NULL);
 
@@ -340,6 +462,7 @@ void chMtxUnlock(mutex_t *mp) {
 #endif
 
     chDbgAssert(currtp->mtxlist == mp, "not next in list");
+    __lkprof_released(&mp->prof);
 
     /* Removes the top mutex from the thread's owned mutexes list and marks
        it as not owned. Note, it is assumed to be the same mutex passed as
@@ -350,24 +473,9 @@ void chMtxUnlock(mutex_t *mp) {
     if (chMtxQueueNotEmptyS(mp)) {
       thread_t *tp;
 
-      /* Recalculates the optimal thread priority by scanning the owned
-         mutexes list.*/
-      tprio_t newprio = currtp->realprio;
-      lmp = currtp->mtxlist;
-      while (lmp != NULL) {
-        /* If the highest priority thread waiting in the mutexes list has a
-           greater priority than the current thread base priority then the
-           final priority will have at least that priority.*/
-        if (chMtxQueueNotEmptyS(lmp) &&
-            ((threadref(lmp->queue.next))->hdr.pqueue.prio > newprio)) {
-          newprio = (threadref(lmp->queue.next))->hdr.pqueue.prio;
-        }
-        lmp = lmp->next;
-      }
-
       /* Assigns to the current thread the highest priority among all the
-         waiting threads.*/
-      currtp->hdr.pqueue.prio = newprio;
+         waiting threads, scanning the owned mutexes list.*/
+      currtp->hdr.pqueue.prio = __mtx_owner_prio(currtp);
 
       /* Awakens the highest priority thread waiting for the unlocked mutex and
          assigns the mutex to it.*/
@@ -378,6 +486,9 @@ void chMtxUnlock(mutex_t *mp) {
       mp->owner = tp;
       mp->next = tp->mtxlist;
       tp->mtxlist = mp;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+      mtx_raise_to_ceiling(tp, mp);
+#endif
 
       /* Note, not using chSchWakeupS() because that function expects the
          current thread to have the higher or equal priority than the ones
@@ -388,6 +499,14 @@ void chMtxUnlock(mutex_t *mp) {
     }
     else {
       mp->owner = NULL;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+      /* Dropping the ceiling priority, a higher priority thread could
+         have been made ready while this thread was owning the mutex.*/
+      if (mp->ceiling != (tprio_t)0) {
+        currtp->hdr.pqueue.prio = __mtx_owner_prio(currtp);
+        chSchRescheduleS();
+      }
+#endif
     }
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   }
@@ -412,7 +531,6 @@ void chMtxUnlock(mutex_t *mp) {
  */
 void chMtxUnlockS(mutex_t *mp) {
   thread_t *currtp = chThdGetSelfX();
-  mutex_t *lmp;
 
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
@@ -426,6 +544,7 @@ void chMtxUnlockS(mutex_t *mp) {
 #endif
 
     chDbgAssert(currtp->mtxlist == mp, "not next in list");
+    __lkprof_released(&mp->prof);
 
     /* Removes the top mutex from the thread's owned mutexes list and marks
        it as not owned. Note, it is assumed to be the same mutex passed as
@@ -436,24 +555,9 @@ void chMtxUnlockS(mutex_t *mp) {
     if (chMtxQueueNotEmptyS(mp)) {
       thread_t *tp;
 
-      /* Recalculates the optimal thread priority by scanning the owned
-         mutexes list.*/
-      tprio_t newprio = currtp->realprio;
-      lmp = currtp->mtxlist;
-      while (lmp != NULL) {
-        /* If the highest priority thread waiting in the mutexes list has a
-           greater priority than the current thread base priority then the
-           final priority will have at least that priority.*/
-        if (chMtxQueueNotEmptyS(lmp) &&
-            ((threadref(lmp->queue.next))->hdr.pqueue.prio > newprio)) {
-          newprio = threadref(lmp->queue.next)->hdr.pqueue.prio;
-        }
-        lmp = lmp->next;
-      }
-
       /* Assigns to the current thread the highest priority among all the
-         waiting threads.*/
-      currtp->hdr.pqueue.prio = newprio;
+         waiting threads, scanning the owned mutexes list.*/
+      currtp->hdr.pqueue.prio = __mtx_owner_prio(currtp);
 
       /* Awakens the highest priority thread waiting for the unlocked mutex and
          assigns the mutex to it.*/
@@ -464,10 +568,19 @@ void chMtxUnlockS(mutex_t *mp) {
       mp->owner = tp;
       mp->next = tp->mtxlist;
       tp->mtxlist = mp;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+      mtx_raise_to_ceiling(tp, mp);
+#endif
       (void) chSchReadyI(tp);
     }
     else {
       mp->owner = NULL;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+      /* Dropping the ceiling priority.*/
+      if (mp->ceiling != (tprio_t)0) {
+        currtp->hdr.pqueue.prio = __mtx_owner_prio(currtp);
+      }
+#endif
     }
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   }
@@ -494,6 +607,7 @@ void chMtxUnlockAllS(void) {
     do {
       mutex_t *mp = currtp->mtxlist;
       currtp->mtxlist = mp->next;
+      __lkprof_released(&mp->prof);
       if (chMtxQueueNotEmptyS(mp)) {
         thread_t *tp;
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -503,6 +617,9 @@ void chMtxUnlockAllS(void) {
         mp->owner   = tp;
         mp->next    = tp->mtxlist;
         tp->mtxlist = mp;
+#if CH_CFG_USE_MUTEXES_CEILING == TRUE
+        mtx_raise_to_ceiling(tp, mp);
+#endif
         (void) chSchReadyI(tp);
       }
       else {
@@ -512,7 +629,7 @@ void chMtxUnlockAllS(void) {
         mp->owner = NULL;
       }
     } while (currtp->mtxlist != NULL);
-    currtp->hdr.pqueue.prio = currtp->realprio;
+    currtp->hdr.pqueue.prio = __mtx_owner_prio(currtp);
     chSchRescheduleS();
   }
 }
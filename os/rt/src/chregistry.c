@@ -51,6 +51,20 @@
 
 #if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
 
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+/* FNV-1a hash parameters.*/
+#define REG_HASH_BASIS          2166136261U
+#define REG_HASH_PRIME          16777619U
+
+/* Names index bucket associated to an hash value.*/
+#define REG_BUCKET(rp, h)                                                   \
+  (&(rp)->names[(h) & ((uint32_t)CH_CFG_NAMES_INDEX_BUCKETS - 1U)])
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -67,6 +81,25 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Calculates the hash of a thread name.
+ *
+ * @param[in] name      the thread name
+ * @return              The hash value.
+ */
+static uint32_t reg_hash(const char *name) {
+  uint32_t h = REG_HASH_BASIS;
+
+  while (*name != '\0') {
+    h = (h ^ (uint32_t)(uint8_t)*name) * REG_HASH_PRIME;
+    name++;
+  }
+
+  return h;
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -228,6 +261,33 @@ thread_t *chRegNextThread(thread_t *tp) {
  * @api
  */
 thread_t *chRegFindThreadByName(const char *name) {
+#if CH_CFG_USE_NAMES_INDEX == TRUE
+  thread_t *ctp;
+  uint32_t h;
+
+  chDbgCheck(name != NULL);
+
+  h = reg_hash(name);
+
+  /* Single lookup in the names index, the cached hashes are compared
+     first and the names only on hash match.*/
+  chSysLock();
+  ctp = *REG_BUCKET(REG_LIST(currcore), h);
+  while ((ctp != NULL) &&
+         ((ctp->rhash != h) || (strcmp(ctp->name, name) != 0))) {
+    ctp = ctp->rnext;
+  }
+  if (ctp != NULL) {
+#if CH_CFG_USE_DYNAMIC == TRUE
+    chDbgAssert(ctp->refs < (trefs_t)255, "too many references");
+
+    ctp->refs++;
+#endif
+  }
+  chSysUnlock();
+
+  return ctp;
+#else
   thread_t *ctp;
 
   /* Scanning registry.*/
@@ -240,6 +300,7 @@ thread_t *chRegFindThreadByName(const char *name) {
   } while (ctp != NULL);
 
   return NULL;
+#endif
 }
 
 /**
@@ -299,6 +360,87 @@ thread_t *chRegFindThreadByWorkingArea(stkalign_t *wa) {
 }
 #endif
 
+#if (CH_CFG_USE_NAMES_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Adds a thread to the registry names index.
+ * @note    Threads without a name are not indexed.
+ * @note    Internal use only, the caller must be in a critical zone.
+ *
+ * @param[in] rp        pointer to the @p registry_t structure
+ * @param[in] tp        pointer to the thread
+ *
+ * @notapi
+ */
+void __reg_index_insert(registry_t *rp, thread_t *tp) {
+  thread_t **tpp;
+
+  if (tp->name == NULL) {
+    return;
+  }
+
+  tp->rhash = reg_hash(tp->name);
+  tp->rnext = NULL;
+
+  /* Appending to the bucket so that duplicated names are found in
+     creation order, as with a registry scan.*/
+  tpp = REG_BUCKET(rp, tp->rhash);
+  while (*tpp != NULL) {
+    tpp = &(*tpp)->rnext;
+  }
+  *tpp = tp;
+}
+
+/**
+ * @brief   Removes a thread from the registry names index.
+ * @note    Removing a thread that is not indexed has no effect.
+ * @note    Internal use only, the caller must be in a critical zone.
+ *
+ * @param[in] rp        pointer to the @p registry_t structure
+ * @param[in] tp        pointer to the thread
+ *
+ * @notapi
+ */
+void __reg_index_remove(registry_t *rp, thread_t *tp) {
+  thread_t **tpp;
+
+  if (tp->name == NULL) {
+    return;
+  }
+
+  tpp = REG_BUCKET(rp, tp->rhash);
+  while (*tpp != NULL) {
+    if (*tpp == tp) {
+      *tpp = tp->rnext;
+      break;
+    }
+    tpp = &(*tpp)->rnext;
+  }
+}
+
+/**
+ * @brief   Changes the name of a thread updating the names index.
+ * @note    Internal use only.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] name      thread name as a zero terminated string or @p NULL
+ *
+ * @xclass
+ */
+void __reg_set_name(thread_t *tp, const char *name) {
+  syssts_t sts;
+
+  /* Entering a reentrant critical zone.*/
+  sts = chSysGetStatusAndLockX();
+
+  __reg_index_remove(REG_LIST(tp->owner), tp);
+  tp->name = name;
+  __reg_index_insert(REG_LIST(tp->owner), tp);
+
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
+}
+#endif
+
 #endif /* CH_CFG_USE_REGISTRY == TRUE */
 
 /** @} */
@@ -0,0 +1,758 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rt/src/chrwlock.c
+ * @brief   Reader-Writer Locks code.
+ *
+ * @addtogroup rwlocks
+ * @details Reader-writer locks related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          A reader-writer lock can be held by any number of readers or
+ *          by a single writer. The lock gives preference to writers, a
+ *          reader cannot enter while a writer is waiting, so writers
+ *          cannot be starved by a continuous flow of readers.<br>
+ *          Waiting threads are queued by priority. When a writer
+ *          releases the lock then the next writer is served, if any,
+ *          else all the waiting readers enter together.
+ *          <h2>Priority Inheritance</h2>
+ *          A thread waiting on the lock raises the priority of the writer
+ *          owning it or of all the readers holding it. Each thread keeps
+ *          a record of the held locks so the inherited priority is
+ *          recalculated, together with the priority inherited through
+ *          mutexes, when a lock or a mutex is released or when a waiting
+ *          thread gives up on timeout.
+ * @note    A thread can hold up to @p CH_CFG_RWLOCKS_MAX_HELD locks at
+ *          the same time with priority inheritance.
+ * @note    Locks are not recursive, a thread holding the lock for read
+ *          must not try to acquire it again while writers could be
+ *          waiting.
+ * @pre     In order to use the reader-writer locks APIs the
+ *          @p CH_CFG_USE_RWLOCKS option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns a hold record of a thread.
+ *
+ * @param[in] tp        the thread
+ * @param[in] rwp       pointer to the held @p rwlock_t structure or @p NULL
+ *                      for a free record
+ * @return              The hold record.
+ * @retval NULL         if there is no such record.
+ */
+static rwlock_hold_t *rwl_get_hold(thread_t *tp, rwlock_t *rwp) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_CFG_RWLOCKS_MAX_HELD; i++) {
+    if (tp->rwlholds[i].rwp == rwp) {
+      return &tp->rwlholds[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Records an access to the lock by a thread.
+ * @note    A thread holding more than @p CH_CFG_RWLOCKS_MAX_HELD locks
+ *          is not tracked on the exceeding locks and does not inherit
+ *          priority through them.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] tp        the thread accessing the lock
+ */
+static void rwl_hold(rwlock_t *rwp, thread_t *tp) {
+  rwlock_hold_t *hp;
+
+  /* Nested read accesses share the same record.*/
+  hp = rwl_get_hold(tp, rwp);
+  if (hp != NULL) {
+    hp->cnt++;
+    return;
+  }
+
+  hp = rwl_get_hold(tp, NULL);
+  chDbgAssert(hp != NULL, "too many locks held");
+  if (hp != NULL) {
+    hp->rwp = rwp;
+    hp->cnt = (cnt_t)1;
+    if (rwp->writer != tp) {
+      hp->next    = rwp->rholds;
+      rwp->rholds = hp;
+    }
+  }
+}
+
+/**
+ * @brief   Releases an access to the lock by a thread.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] tp        the thread releasing the lock
+ */
+static void rwl_release(rwlock_t *rwp, thread_t *tp) {
+  rwlock_hold_t *hp;
+
+  hp = rwl_get_hold(tp, rwp);
+  if ((hp != NULL) && (--hp->cnt == (cnt_t)0)) {
+    hp->rwp = NULL;
+    if (rwp->writer != tp) {
+      rwlock_hold_t **hpp = &rwp->rholds;
+
+      /* Removing the record from the readers list.*/
+      while (*hpp != hp) {
+        hpp = &(*hpp)->next;
+      }
+      *hpp = hp->next;
+    }
+  }
+}
+
+/**
+ * @brief   Returns the highest priority among the waiters on a queue.
+ *
+ * @param[in] qp        pointer to the queue
+ * @param[in] prio      the priority to be compared
+ * @return              The highest priority.
+ */
+static inline tprio_t rwl_queue_prio(ch_queue_t *qp, tprio_t prio) {
+
+  if (ch_queue_notempty(qp) && (threadref(qp->next)->hdr.pqueue.prio > prio)) {
+    return threadref(qp->next)->hdr.pqueue.prio;
+  }
+
+  return prio;
+}
+
+/**
+ * @brief   Re-enqueues a thread waiting on a lock after a priority change.
+ *
+ * @param[in] tp        the thread waiting on the lock
+ * @return              The lock the thread is waiting on.
+ */
+static rwlock_t *rwl_requeue(thread_t *tp) {
+  rwlock_t *rwp = (rwlock_t *)tp->u.wtobjp;
+
+  if (tp->state == CH_STATE_WTRDLOCK) {
+    ch_sch_prio_insert(&rwp->rqueue, ch_queue_dequeue(&tp->hdr.queue));
+  }
+  else {
+    ch_sch_prio_insert(&rwp->wqueue, ch_queue_dequeue(&tp->hdr.queue));
+  }
+
+  return rwp;
+}
+
+/**
+ * @brief   Updates the priority of a thread after a change in its locks.
+ * @details The priority is recalculated from the held mutexes and
+ *          reader-writer locks, the change is propagated along the chain
+ *          of the mutexes the thread is waiting on. If the chain ends on a
+ *          reader-writer lock then the lock is returned, its holders have
+ *          to be updated by the caller.
+ *
+ * @param[in] tp        the thread to be updated
+ * @return              The lock whose holders have to be updated.
+ * @retval NULL         if the propagation ended.
+ */
+static rwlock_t *rwl_update_prio(thread_t *tp) {
+
+  while (true) {
+    tprio_t prio = __mtx_owner_prio(tp);
+
+    if (prio == tp->hdr.pqueue.prio) {
+      break;
+    }
+    tp->hdr.pqueue.prio = prio;
+
+    /* The following states need priority queues reordering.*/
+    switch (tp->state) {
+    case CH_STATE_WTMTX:
+      ch_sch_prio_insert(&tp->u.wtmtxp->queue,
+                         ch_queue_dequeue(&tp->hdr.queue));
+      tp = tp->u.wtmtxp->owner;
+      /*lint -e{9042} [16.1] Continues the while.*/
+      continue;
+    case CH_STATE_WTRDLOCK:
+      /* Falls through.*/
+    case CH_STATE_WTWRLOCK:
+      return rwl_requeue(tp);
+#if (CH_CFG_USE_CONDVARS == TRUE) ||                                        \
+    ((CH_CFG_USE_SEMAPHORES == TRUE) &&                                     \
+     (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)) ||                           \
+    ((CH_CFG_USE_MESSAGES == TRUE) &&                                       \
+     (CH_CFG_USE_MESSAGES_PRIORITY == TRUE))
+#if CH_CFG_USE_CONDVARS == TRUE
+    case CH_STATE_WTCOND:
+#endif
+#if (CH_CFG_USE_SEMAPHORES == TRUE) &&                                      \
+    (CH_CFG_USE_SEMAPHORES_PRIORITY == TRUE)
+    case CH_STATE_WTSEM:
+#endif
+#if (CH_CFG_USE_MESSAGES == TRUE) && (CH_CFG_USE_MESSAGES_PRIORITY == TRUE)
+    case CH_STATE_SNDMSGQ:
+#endif
+      /* Re-enqueues tp with its new priority on the queue.*/
+      ch_sch_prio_insert(&tp->u.wtmtxp->queue,
+                         ch_queue_dequeue(&tp->hdr.queue));
+      break;
+#endif
+    case CH_STATE_READY:
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+      /* Prevents an assertion in chSchReadyI().*/
+      tp->state = CH_STATE_CURRENT;
+#endif
+      /* Re-enqueues tp with its new priority on the ready list.*/
+      (void) chSchReadyI(threadref(ch_queue_dequeue(&tp->hdr.queue)));
+      break;
+    default:
+      /* Nothing to do for other states.*/
+      break;
+    }
+    break;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Returns the first hold record of a lock.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @return              The hold record of the writer or the first one of
+ *                      the readers.
+ * @retval NULL         if the lock is not held by tracked threads.
+ */
+static rwlock_hold_t *rwl_first_hold(rwlock_t *rwp) {
+
+  if (rwp->writer != NULL) {
+    return rwl_get_hold(rwp->writer, rwp);
+  }
+
+  return rwp->rholds;
+}
+
+/**
+ * @brief   Updates the priority of all the threads holding the lock.
+ * @details The change is propagated to the holders of the locks the
+ *          holders are waiting on, the locks tree is walked iteratively,
+ *          each lock entered records the hold record the walk resumes from
+ *          when all its holders have been updated.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ */
+static void rwl_update_holders(rwlock_t *rwp) {
+  rwlock_hold_t *hp;
+
+  hp = rwl_first_hold(rwp);
+  while (hp != NULL) {
+    rwlock_t *nrwp = rwl_update_prio(hp->owner);
+
+    /* Entering the lock the holder is waiting on, locks already entered
+       are skipped, it would be a deadlock.*/
+    if ((nrwp != NULL) && (nrwp != rwp) && (nrwp->upper == NULL)) {
+      rwlock_hold_t *nhp = rwl_first_hold(nrwp);
+
+      if (nhp != NULL) {
+        nrwp->upper = hp;
+        hp = nhp;
+        /*lint -e{9042} [16.1] Continues the while.*/
+        continue;
+      }
+    }
+
+    /* Next holder, leaving the locks whose holders have all been
+       updated.*/
+    while ((hp->rwp->writer != NULL) || (hp->next == NULL)) {
+      rwlock_t *lrwp = hp->rwp;
+
+      if (lrwp == rwp) {
+        return;
+      }
+      hp = lrwp->upper;
+      lrwp->upper = NULL;
+    }
+    hp = hp->next;
+  }
+}
+
+/**
+ * @brief   Gives the lock to the highest priority waiting writer.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ */
+static void rwl_wakeup_writer(rwlock_t *rwp) {
+  thread_t *tp;
+
+  tp = threadref(ch_queue_fifo_remove(&rwp->wqueue));
+  rwp->writer = tp;
+  rwl_hold(rwp, tp);
+
+  /* Readers and writers still waiting may have higher priority than the
+     new writer.*/
+  tp->hdr.pqueue.prio = __mtx_owner_prio(tp);
+  chSchReadyI(tp)->u.rdymsg = MSG_OK;
+}
+
+/**
+ * @brief   Gives the lock to all the waiting readers.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ */
+static void rwl_wakeup_readers(rwlock_t *rwp) {
+
+  while (ch_queue_notempty(&rwp->rqueue)) {
+    thread_t *tp = threadref(ch_queue_fifo_remove(&rwp->rqueue));
+
+    rwp->readers++;
+    rwl_hold(rwp, tp);
+    chSchReadyI(tp)->u.rdymsg = MSG_OK;
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the highest priority among the waiters on the locks
+ *          held by a thread.
+ * @note    Internal use only, the mutexes code uses this function in
+ *          order to recalculate the priority of a thread.
+ *
+ * @param[in] tp        the thread
+ * @param[in] prio      the priority to be compared
+ * @return              The highest priority.
+ *
+ * @notapi
+ */
+tprio_t __rwl_holds_prio(thread_t *tp, tprio_t prio) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_CFG_RWLOCKS_MAX_HELD; i++) {
+    rwlock_t *rwp = tp->rwlholds[i].rwp;
+
+    if (rwp != NULL) {
+      prio = rwl_queue_prio(&rwp->rqueue, prio);
+      prio = rwl_queue_prio(&rwp->wqueue, prio);
+    }
+  }
+
+  return prio;
+}
+
+/**
+ * @brief   Re-enqueues a thread waiting on a lock after a priority change.
+ * @details The priority change is propagated to all the threads holding
+ *          the lock.
+ * @note    Internal use only, the priority inheritance code uses this
+ *          function in order to propagate a boost along locks chains.
+ *
+ * @param[in] tp        the thread waiting on the lock
+ *
+ * @notapi
+ */
+void __rwl_requeue_i(thread_t *tp) {
+
+  rwl_update_holders(rwl_requeue(tp));
+}
+
+/**
+ * @brief   Handles a timeout on a reader-writer lock.
+ * @note    Internal use only, invoked from the scheduler timeout handler
+ *          with the thread still in the lock queue.
+ *
+ * @param[in] tp        the thread that timed out
+ *
+ * @notapi
+ */
+void __rwl_timeout_i(thread_t *tp) {
+  rwlock_t *rwp = (rwlock_t *)tp->u.wtobjp;
+
+  (void) ch_queue_dequeue(&tp->hdr.queue);
+
+  /* If the last waiting writer gave up then the readers held back by the
+     writer preference can enter.*/
+  if ((tp->state == CH_STATE_WTWRLOCK) && (rwp->writer == NULL) &&
+      ch_queue_isempty(&rwp->wqueue)) {
+    rwl_wakeup_readers(rwp);
+  }
+
+  /* The thread is no more in the lock queue, it must not be re-enqueued
+     by the priority updates, the caller makes it ready.*/
+  tp->state = CH_STATE_CURRENT;
+
+  /* The holders lose the priority inherited from the thread.*/
+  rwl_update_holders(rwp);
+}
+
+/**
+ * @brief   Initializes a @p rwlock_t structure.
+ *
+ * @param[out] rwp      pointer to a @p rwlock_t structure
+ *
+ * @init
+ */
+void chRwlObjectInit(rwlock_t *rwp) {
+
+  chDbgCheck(rwp != NULL);
+
+  ch_queue_init(&rwp->rqueue);
+  ch_queue_init(&rwp->wqueue);
+  rwp->writer  = NULL;
+  rwp->rholds  = NULL;
+  rwp->upper   = NULL;
+  rwp->readers = (cnt_t)0;
+}
+
+/**
+ * @brief   Acquires the lock for read access with timeout specification.
+ * @details The lock is shared with the other readers, the invoking thread
+ *          waits if a writer owns the lock or is waiting for it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying the operation result.
+ * @retval MSG_OK       if the lock has been acquired.
+ * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chRwlReadLockTimeout(rwlock_t *rwp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chRwlReadLockTimeoutS(rwp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Acquires the lock for read access with timeout specification.
+ * @details The lock is shared with the other readers, the invoking thread
+ *          waits if a writer owns the lock or is waiting for it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying the operation result.
+ * @retval MSG_OK       if the lock has been acquired.
+ * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chRwlReadLockTimeoutS(rwlock_t *rwp, sysinterval_t timeout) {
+  thread_t *currtp = chThdGetSelfX();
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+  chDbgAssert(rwp->writer != currtp, "already owned");
+
+  /* Readers enter if there are no writers owning or waiting for the lock.*/
+  if ((rwp->writer == NULL) && ch_queue_isempty(&rwp->wqueue)) {
+    rwp->readers++;
+    rwl_hold(rwp, currtp);
+
+    return MSG_OK;
+  }
+
+  if (unlikely(TIME_IMMEDIATE == timeout)) {
+    return MSG_TIMEOUT;
+  }
+
+  /* Sleep on the lock, priority inheritance toward the lock holders.*/
+  ch_sch_prio_insert(&rwp->rqueue, &currtp->hdr.queue);
+  currtp->u.wtobjp = rwp;
+  rwl_update_holders(rwp);
+
+  return chSchGoSleepTimeoutS(CH_STATE_WTRDLOCK, timeout);
+}
+
+/**
+ * @brief   Tries to acquire the lock for read access.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @return              The operation status.
+ * @retval true         if the lock has been successfully acquired
+ * @retval false        if the lock attempt failed.
+ *
+ * @api
+ */
+bool chRwlTryReadLock(rwlock_t *rwp) {
+  bool b;
+
+  chSysLock();
+  b = chRwlTryReadLockS(rwp);
+  chSysUnlock();
+
+  return b;
+}
+
+/**
+ * @brief   Tries to acquire the lock for read access.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @return              The operation status.
+ * @retval true         if the lock has been successfully acquired
+ * @retval false        if the lock attempt failed.
+ *
+ * @sclass
+ */
+bool chRwlTryReadLockS(rwlock_t *rwp) {
+
+  return chRwlReadLockTimeoutS(rwp, TIME_IMMEDIATE) == MSG_OK;
+}
+
+/**
+ * @brief   Releases the lock held for read access.
+ * @details The last reader leaving gives the lock to the waiting writer,
+ *          if any.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRwlReadUnlock(rwlock_t *rwp) {
+
+  chSysLock();
+  chRwlReadUnlockS(rwp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases the lock held for read access.
+ * @details The last reader leaving gives the lock to the waiting writer,
+ *          if any.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @sclass
+ */
+void chRwlReadUnlockS(rwlock_t *rwp) {
+  thread_t *currtp = chThdGetSelfX();
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+  chDbgAssert(rwp->readers > (cnt_t)0, "not read locked");
+
+  rwp->readers--;
+  rwl_release(rwp, currtp);
+
+  /* The reader could have inherited a priority through the lock.*/
+  if (currtp->hdr.pqueue.prio != currtp->realprio) {
+    currtp->hdr.pqueue.prio = __mtx_owner_prio(currtp);
+  }
+
+  if ((rwp->readers == (cnt_t)0) && ch_queue_notempty(&rwp->wqueue)) {
+    rwl_wakeup_writer(rwp);
+  }
+}
+
+/**
+ * @brief   Acquires the lock for write access with timeout specification.
+ * @details The lock is exclusive, the invoking thread waits until all the
+ *          readers and the current writer have released it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying the operation result.
+ * @retval MSG_OK       if the lock has been acquired.
+ * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chRwlWriteLockTimeout(rwlock_t *rwp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chRwlWriteLockTimeoutS(rwp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Acquires the lock for write access with timeout specification.
+ * @details The lock is exclusive, the invoking thread waits until all the
+ *          readers and the current writer have released it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying the operation result.
+ * @retval MSG_OK       if the lock has been acquired.
+ * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chRwlWriteLockTimeoutS(rwlock_t *rwp, sysinterval_t timeout) {
+  thread_t *currtp = chThdGetSelfX();
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+  chDbgAssert(rwp->writer != currtp, "already owned");
+
+  if ((rwp->writer == NULL) && (rwp->readers == (cnt_t)0)) {
+    rwp->writer = currtp;
+    rwl_hold(rwp, currtp);
+
+    return MSG_OK;
+  }
+
+  if (unlikely(TIME_IMMEDIATE == timeout)) {
+    return MSG_TIMEOUT;
+  }
+
+  /* Sleep on the lock, priority inheritance toward the lock holders. The
+     thread that releases the lock makes this thread the owner.*/
+  ch_sch_prio_insert(&rwp->wqueue, &currtp->hdr.queue);
+  currtp->u.wtobjp = rwp;
+  rwl_update_holders(rwp);
+
+  return chSchGoSleepTimeoutS(CH_STATE_WTWRLOCK, timeout);
+}
+
+/**
+ * @brief   Tries to acquire the lock for write access.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @return              The operation status.
+ * @retval true         if the lock has been successfully acquired
+ * @retval false        if the lock attempt failed.
+ *
+ * @api
+ */
+bool chRwlTryWriteLock(rwlock_t *rwp) {
+  bool b;
+
+  chSysLock();
+  b = chRwlTryWriteLockS(rwp);
+  chSysUnlock();
+
+  return b;
+}
+
+/**
+ * @brief   Tries to acquire the lock for write access.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @return              The operation status.
+ * @retval true         if the lock has been successfully acquired
+ * @retval false        if the lock attempt failed.
+ *
+ * @sclass
+ */
+bool chRwlTryWriteLockS(rwlock_t *rwp) {
+
+  return chRwlWriteLockTimeoutS(rwp, TIME_IMMEDIATE) == MSG_OK;
+}
+
+/**
+ * @brief   Releases the lock held for write access.
+ * @details The lock is given to the next waiting writer, if any, else
+ *          all the waiting readers enter.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRwlWriteUnlock(rwlock_t *rwp) {
+
+  chSysLock();
+  chRwlWriteUnlockS(rwp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases the lock held for write access.
+ * @details The lock is given to the next waiting writer, if any, else
+ *          all the waiting readers enter.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @sclass
+ */
+void chRwlWriteUnlockS(rwlock_t *rwp) {
+  thread_t *currtp = chThdGetSelfX();
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL);
+  chDbgAssert(rwp->writer == currtp, "not owner");
+
+  rwl_release(rwp, currtp);
+  rwp->writer = NULL;
+  currtp->hdr.pqueue.prio = __mtx_owner_prio(currtp);
+
+  /* Writers are preferred.*/
+  if (ch_queue_notempty(&rwp->wqueue)) {
+    rwl_wakeup_writer(rwp);
+  }
+  else {
+    rwl_wakeup_readers(rwp);
+  }
+}
+
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+/** @} */
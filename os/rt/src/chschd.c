@@ -217,6 +217,13 @@ static void __sch_wakeup(virtual_timer_t *vtp, void *p) {
     /* States requiring dequeuing.*/
     (void) ch_queue_dequeue(&tp->hdr.queue);
     break;
+#if CH_CFG_USE_RWLOCKS == TRUE
+  case CH_STATE_WTRDLOCK:
+    /* Falls through.*/
+  case CH_STATE_WTWRLOCK:
+    __rwl_timeout_i(tp);
+    break;
+#endif
   default:
     /* Any other state, nothing to do.*/
     break;
@@ -232,6 +239,69 @@ static void __sch_wakeup(virtual_timer_t *vtp, void *p) {
   return;
 }
 
+#if (CH_CFG_SMP_BALANCE_INTERVAL > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Pulls a ready thread from the busiest OS instance.
+ * @details The instance with the most ready threads waiting is selected,
+ *          its highest priority thread allowed to run on the specified
+ *          instance is moved to the specified instance ready list.
+ * @note    Threads woken from a timed wait are not moved until they run,
+ *          the timeout could still be armed on their instance.
+ *
+ * @param[in] oip       pointer to the destination OS instance
+ * @return              The moved thread or @p NULL.
+ *
+ * @notapi
+ */
+static thread_t *__sch_pull_thread(os_instance_t *oip) {
+  core_mask_t mask = CH_AFFINITY_CORE(oip->core_id);
+  thread_t *tp = NULL;
+  unsigned maxn = 0U;
+  core_id_t core_id;
+
+  for (core_id = 0U; core_id < (core_id_t)PORT_CORES_NUMBER; core_id++) {
+    os_instance_t *rip = ch_system.instances[core_id];
+    ch_priority_queue_t *pqp;
+    thread_t *ctp = NULL;
+    unsigned n = 0U;
+
+    /* Idle instances are going to run their own ready threads.*/
+    if ((rip == NULL) || (rip == oip) ||
+        (rip->rlist.current->hdr.pqueue.prio == IDLEPRIO)) {
+      continue;
+    }
+
+    /* Counting the waiting threads, the idle thread is the last one.*/
+    pqp = rip->rlist.pqueue.next;
+    while ((pqp != &rip->rlist.pqueue) && (pqp->prio > IDLEPRIO)) {
+      if ((ctp == NULL) && ((threadref(pqp)->affinity & mask) != 0U) &&
+          ((threadref(pqp)->flags & CH_FLAG_TIMED) == 0U)) {
+        ctp = threadref(pqp);
+      }
+      n++;
+      pqp = pqp->next;
+    }
+
+    if ((ctp != NULL) && (n > maxn)) {
+      maxn = n;
+      tp   = ctp;
+    }
+  }
+
+  if (tp != NULL) {
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+    /* Prevents an assertion in __sch_ready_behind().*/
+    tp->state = CH_STATE_CURRENT;
+#endif
+    (void) ch_queue_dequeue(&tp->hdr.queue);
+    tp->owner = oip;
+    (void) __sch_ready_behind(tp);
+  }
+
+  return tp;
+}
+#endif /* CH_CFG_SMP_BALANCE_INTERVAL > 0 */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -365,7 +435,15 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
     virtual_timer_t vt;
 
     chVTDoSetI(&vt, timeout, __sch_wakeup, (void *)tp);
+#if CH_CFG_USE_THREADS_MIGRATION == TRUE
+    /* The timer belongs to the local timers list, the thread cannot be
+       moved to another instance until the timer has been handled.*/
+    tp->flags |= CH_FLAG_TIMED;
     chSchGoSleepS(newstate);
+    tp->flags &= (tmode_t)~CH_FLAG_TIMED;
+#else
+    chSchGoSleepS(newstate);
+#endif
     if (chVTIsArmedI(&vt)) {
       chVTDoResetI(&vt);
     }
@@ -446,6 +524,72 @@ void chSchWakeupS(thread_t *ntp, msg_t msg) {
   }
 }
 
+/**
+ * @brief   Hands the CPU to a waiting thread.
+ * @details The current thread goes to sleep into the specified state and
+ *          the specified thread is made running directly, without going
+ *          through the ready list. This is the fast path of a synchronous
+ *          call where the caller blocks waiting for the thread it wakes.
+ * @pre     The thread must not be already inserted in any list through its
+ *          @p next and @p prev or list corruption would occur.
+ * @note    If the thread belongs to another core or it is not the highest
+ *          priority runnable thread then it is made ready and the current
+ *          thread goes to sleep normally, the result is the same but
+ *          without the direct switch.
+ *
+ * @param[in] ntp       the thread to be made running
+ * @param[in] msg       the wakeup message
+ * @param[in] newstate  the new state of the current thread
+ *
+ * @sclass
+ */
+void chSchHandoffS(thread_t *ntp, msg_t msg, tstate_t newstate) {
+  os_instance_t *oip = currcore;
+  thread_t *otp = __instance_get_currthread(oip);
+
+  chDbgCheckClassS();
+
+  chDbgAssert(otp != chSysGetIdleThreadX(), "sleeping in idle thread");
+  chDbgAssert(otp->owner == oip, "invalid core");
+
+  /* Storing the message to be retrieved by the target thread when it will
+     restart execution.*/
+  ntp->u.rdymsg = msg;
+
+  /* The direct switch is only possible if the target thread would be the
+     next selected thread anyway, threads in the ready list with the same
+     priority come first.*/
+#if CH_CFG_SMP_MODE == TRUE
+  if (unlikely((ntp->owner != oip) ||
+               (ntp->hdr.pqueue.prio <= oip->rlist.pqueue.next->prio))) {
+#else
+  if (unlikely(ntp->hdr.pqueue.prio <= oip->rlist.pqueue.next->prio)) {
+#endif
+    (void) chSchReadyI(ntp);
+    chSchGoSleepS(newstate);
+    return;
+  }
+
+  /* Tracing the event.*/
+  __trace_ready(ntp, msg);
+
+  /* New state.*/
+  otp->state = newstate;
+
+#if CH_CFG_TIME_QUANTUM > 0
+  /* The thread is renouncing its remaining time slices so it will have a new
+     time quantum when it will wakeup.*/
+  otp->ticks = (tslices_t)CH_CFG_TIME_QUANTUM;
+#endif
+
+  /* The target thread becomes current, the ready list is not touched.*/
+  ntp->state = CH_STATE_CURRENT;
+  __instance_set_currthread(oip, ntp);
+
+  /* Swap operation as tail call.*/
+  chSysSwitch(ntp, otp);
+}
+
 /**
  * @brief   Performs a reschedule if a higher priority thread is runnable.
  * @details If a thread with a higher priority than the current thread is in
@@ -645,4 +789,124 @@ thread_t *chSchSelectFirst(void) {
   return ntp;
 }
 
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves a thread to another OS instance.
+ * @details Ready threads are moved to the ready list of the destination
+ *          instance, waiting threads change owner and will be made ready
+ *          on the destination instance when woken. The current thread
+ *          moves itself, it is queued on the destination instance and the
+ *          next local thread is switched in.<br>
+ *          Threads waiting with a timeout cannot be moved until they run
+ *          again, the timeout is armed on the timers list of the current
+ *          instance.
+ * @note    The destination instance cannot pick a moved current thread
+ *          before the kernel lock is released, after its context has been
+ *          saved by the context switch.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] oip       pointer to the destination OS instance
+ * @return              The operation result.
+ * @retval MSG_OK       if the thread has been moved or already belongs to
+ *                      the destination instance.
+ * @retval MSG_RESET    if the destination core is not in the thread
+ *                      affinity mask, the thread is running on another core,
+ *                      it is waiting with a timeout or it is terminated.
+ *
+ * @sclass
+ */
+msg_t chSchMigrateS(thread_t *tp, os_instance_t *oip) {
+  os_instance_t *cip = currcore;
+
+  chDbgCheckClassS();
+  chDbgCheck((tp != NULL) && (oip != NULL));
+
+  if ((tp->state == CH_STATE_FINAL) ||
+      ((tp->affinity & CH_AFFINITY_CORE(oip->core_id)) == 0U) ||
+      ((tp->flags & CH_FLAG_TIMED) != 0U)) {
+    return MSG_RESET;
+  }
+
+  if (tp->owner == oip) {
+    return MSG_OK;
+  }
+
+  switch (tp->state) {
+  case CH_STATE_CURRENT:
+    if (tp->owner != cip) {
+      /* Running on another core.*/
+      return MSG_RESET;
+    }
+    else {
+      thread_t *ntp;
+
+      /* The thread goes in the destination ready list.*/
+      tp->owner = oip;
+      (void) __sch_ready_behind(tp);
+      chSysNotifyInstance(oip);
+
+      /* Next thread in the local ready list becomes current.*/
+      ntp = threadref(ch_pqueue_remove_highest(&cip->rlist.pqueue));
+      ntp->state = CH_STATE_CURRENT;
+      __instance_set_currthread(cip, ntp);
+
+      /* Handling idle-enter hook.*/
+      if (ntp->hdr.pqueue.prio == IDLEPRIO) {
+        CH_CFG_IDLE_ENTER_HOOK();
+      }
+
+      /* Returning after being resumed by the destination instance.*/
+      chSysSwitch(ntp, tp);
+    }
+    break;
+  case CH_STATE_READY:
+#if CH_DBG_ENABLE_ASSERTS == TRUE
+    /* Prevents an assertion in chSchReadyI().*/
+    tp->state = CH_STATE_CURRENT;
+#endif
+    (void) ch_queue_dequeue(&tp->hdr.queue);
+    tp->owner = oip;
+    (void) chSchReadyI(tp);
+    break;
+  default:
+    /* Waiting threads are made ready on the new owner when woken.*/
+    tp->owner = oip;
+    break;
+  }
+
+  return MSG_OK;
+}
+#endif /* CH_CFG_USE_THREADS_MIGRATION == TRUE */
+
+#if (CH_CFG_SMP_BALANCE_INTERVAL > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Load balancing.
+ * @details If the balancing interval elapsed then a ready thread waiting
+ *          on the busiest OS instance is pulled into the current instance
+ *          and made running.
+ * @note    Not a user function, it is meant to be invoked by the idle
+ *          thread.
+ *
+ * @special
+ */
+void chSchBalance(void) {
+  os_instance_t *oip = currcore;
+  systime_t now = chVTGetSystemTimeX();
+
+  if (chTimeDiffX(oip->balance_time, now) <
+      (sysinterval_t)CH_CFG_SMP_BALANCE_INTERVAL) {
+    return;
+  }
+
+  chSysLock();
+  oip->balance_time = now;
+  (void) __sch_pull_thread(oip);
+
+  /* Threads made ready here by other instances are served too, their
+     notification could still be pending.*/
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_CFG_SMP_BALANCE_INTERVAL > 0 */
+
 /** @} */
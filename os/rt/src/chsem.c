@@ -100,6 +100,7 @@ void chSemObjectInit(semaphore_t *sp, cnt_t n) {
 
   ch_queue_init(&sp->queue);
   sp->cnt = n;
+  chLockProfObjectInit(&sp->prof, CH_LOCK_SEMAPHORE);
 }
 
 /**
@@ -198,12 +199,20 @@ msg_t chSemWaitS(semaphore_t *sp) {
 
   if (--sp->cnt < (cnt_t)0) {
     thread_t *currtp = chThdGetSelfX();
+#if CH_DBG_LOCKS_PROFILING == TRUE
+    rtcnt_t start = chSysGetRealtimeCounterX();
+#endif
     currtp->u.wtsemp = sp;
     sem_insert(&sp->queue, currtp);
     chSchGoSleepS(CH_STATE_WTSEM);
+    __lkprof_contended(&sp->prof, start);
+    if (currtp->u.rdymsg == MSG_OK) {
+      __lkprof_acquired(&sp->prof);
+    }
 
     return currtp->u.rdymsg;
   }
+  __lkprof_acquired(&sp->prof);
 
   return MSG_OK;
 }
@@ -271,11 +280,26 @@ msg_t chSemWaitTimeoutS(semaphore_t *sp, sysinterval_t timeout) {
       return MSG_TIMEOUT;
     }
     thread_t *currtp = chThdGetSelfX();
+#if CH_DBG_LOCKS_PROFILING == TRUE
+    rtcnt_t start = chSysGetRealtimeCounterX();
+    msg_t msg;
+#endif
     currtp->u.wtsemp = sp;
     sem_insert(&sp->queue, currtp);
 
+#if CH_DBG_LOCKS_PROFILING == TRUE
+    msg = chSchGoSleepTimeoutS(CH_STATE_WTSEM, timeout);
+    __lkprof_contended(&sp->prof, start);
+    if (msg == MSG_OK) {
+      __lkprof_acquired(&sp->prof);
+    }
+
+    return msg;
+#else
     return chSchGoSleepTimeoutS(CH_STATE_WTSEM, timeout);
+#endif
   }
+  __lkprof_acquired(&sp->prof);
 
   return MSG_OK;
 }
@@ -388,12 +412,20 @@ msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw) {
   }
   if (--spw->cnt < (cnt_t)0) {
     thread_t *currtp = chThdGetSelfX();
+#if CH_DBG_LOCKS_PROFILING == TRUE
+    rtcnt_t start = chSysGetRealtimeCounterX();
+#endif
     sem_insert(&spw->queue, currtp);
     currtp->u.wtsemp = spw;
     chSchGoSleepS(CH_STATE_WTSEM);
     msg = currtp->u.rdymsg;
+    __lkprof_contended(&spw->prof, start);
+    if (msg == MSG_OK) {
+      __lkprof_acquired(&spw->prof);
+    }
   }
   else {
+    __lkprof_acquired(&spw->prof);
     chSchRescheduleS();
     msg = MSG_OK;
   }
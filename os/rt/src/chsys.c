@@ -180,6 +180,11 @@ void chSysInit(void) {
   __rfcu_object_init(&ch_system.rfcu);
 #endif
 
+#if CH_DBG_LOCKS_PROFILING == TRUE
+  /* Lock profiles list initialization.*/
+  ch_system.lkprof_list = NULL;
+#endif
+
   /* User system initialization hook.*/
   CH_CFG_SYSTEM_INIT_HOOK();
 
@@ -0,0 +1,330 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rt/src/chthdpools.c
+ * @brief   Threads pools code.
+ *
+ * @addtogroup threads_pools
+ * @details Threads pools related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          A threads pool is a set of worker threads created once and then
+ *          parked waiting for a function to execute. Starting a function
+ *          on a pool just resumes a parked worker, the thread object is
+ *          not initialized again, the working area is not filled again and
+ *          the registry is not touched.<br>
+ *          When the function returns the worker is parked again and is
+ *          immediately available for a new function. Parked workers are
+ *          reused in LIFO order in order to keep the most recently used
+ *          stacks warm.<br>
+ *          Workers are not reinitialized between functions: the name is
+ *          restored to the pool name when the worker is parked and the
+ *          pending events are cleared when the worker is resumed, the
+ *          priority is the one specified when starting the function.
+ *          Any other state changed by a function, as an example the
+ *          thread affinity, is inherited by the next function.
+ * @pre     In order to use the threads pools APIs the
+ *          @p CH_CFG_USE_THREADS_POOLS option must be enabled in
+ *          @p chconf.h.
+ * @note    Functions executed by workers must return or terminate the
+ *          worker using @p chThdPoolExit(), terminating a worker using
+ *          @p chThdExit() directly leaves the pool workers count wrong.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Worker threads function.
+ *
+ * @param[in] arg       pointer to the @p threads_pool_t structure
+ */
+static void pool_worker(void *arg) {
+  threads_pool_t *tpp = (threads_pool_t *)arg;
+  thread_t *tp = chThdGetSelfX();
+  pool_worker_t w;
+
+  w.tr = NULL;
+  while (true) {
+    chSysLock();
+
+#if CH_CFG_USE_MUTEXES == TRUE
+    chDbgAssert(tp->mtxlist == NULL, "mutexes still owned");
+#endif
+
+#if CH_CFG_USE_REGISTRY == TRUE
+    /* Restoring the worker name, the function could have changed it.*/
+    if (chRegGetThreadNameX(tp) != tpp->name) {
+      chRegSetThreadName(tpp->name);
+    }
+#endif
+
+    /* Parking the worker, a thread waiting for a worker, if any, is
+       made ready.*/
+    w.next = tpp->idle;
+    tpp->idle = &w;
+    tpp->parked++;
+    chThdDequeueNextI(&tpp->waiting, MSG_OK);
+    (void) chThdSuspendS(&w.tr);
+
+#if CH_CFG_USE_EVENTS == TRUE
+    /* Events signaled to previous functions or to the parked worker are
+       not delivered to the new function.*/
+    tp->epending = (eventmask_t)0;
+#endif
+
+    chSysUnlock();
+
+    /* Executing the function assigned to this worker.*/
+    w.pf(w.arg);
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a threads pool.
+ *
+ * @param[out] tpp      pointer to the @p threads_pool_t structure
+ * @param[in] name      name to be assigned to the workers
+ *
+ * @init
+ */
+void chThdPoolObjectInit(threads_pool_t *tpp, const char *name) {
+
+  chDbgCheck(tpp != NULL);
+
+  tpp->idle    = NULL;
+  chThdQueueObjectInit(&tpp->waiting);
+  tpp->name    = name;
+  tpp->workers = (cnt_t)0;
+  tpp->parked  = (cnt_t)0;
+}
+
+/**
+ * @brief   Adds a worker to a threads pool.
+ * @details A worker thread is created into a static memory area, the worker
+ *          becomes available after it has been parked, this happens the
+ *          first time it is scheduled.
+ *
+ * @param[in] tpp       pointer to the @p threads_pool_t structure
+ * @param[out] wsp      pointer to a working area dedicated to the worker
+ * @param[in] size      size of the working area
+ * @param[in] prio      initial priority level of the worker
+ * @return              The pointer to the @p thread_t structure allocated for
+ *                      the worker into the working space area.
+ *
+ * @api
+ */
+thread_t *chThdPoolAddStatic(threads_pool_t *tpp, void *wsp, size_t size,
+                             tprio_t prio) {
+  thread_descriptor_t td = THD_DESCRIPTOR(tpp->name,
+                                          (stkalign_t *)wsp,
+                                          (stkalign_t *)((uint8_t *)wsp + size),
+                                          prio,
+                                          pool_worker,
+                                          (void *)tpp);
+
+  chDbgCheck(tpp != NULL);
+
+  chSysLock();
+  tpp->workers++;
+  chSysUnlock();
+
+  return chThdCreate(&td);
+}
+
+/**
+ * @brief   Runs a function on a parked worker.
+ * @details The worker is resumed with the specified priority, the priority
+ *          is retained after the function returns until the worker is
+ *          started again.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note
+ *          that interrupt handlers always reschedule on exit so an
+ *          explicit reschedule must not be performed in ISRs.
+ *
+ * @param[in] tpp       pointer to the @p threads_pool_t structure
+ * @param[in] prio      priority of the worker while executing the function
+ * @param[in] pf        the function to be executed
+ * @param[in] arg       the function argument
+ * @return              The operation status.
+ * @retval MSG_OK       if the function has been assigned to a worker.
+ * @retval MSG_TIMEOUT  if there are no parked workers.
+ *
+ * @iclass
+ */
+msg_t chThdPoolStartI(threads_pool_t *tpp, tprio_t prio,
+                      tfunc_t pf, void *arg) {
+  pool_worker_t *wp;
+  thread_t *tp;
+
+  chDbgCheckClassI();
+  chDbgCheck((tpp != NULL) && (prio <= HIGHPRIO) && (pf != NULL));
+
+  wp = tpp->idle;
+  if (wp == NULL) {
+    return MSG_TIMEOUT;
+  }
+  tpp->idle = wp->next;
+  tpp->parked--;
+
+  /* Assigning the function to the worker.*/
+  wp->pf  = pf;
+  wp->arg = arg;
+
+  /* The worker is suspended and owns no mutexes so its priority can be
+     changed directly.*/
+  tp = wp->tr;
+  tp->hdr.pqueue.prio = prio;
+#if CH_CFG_USE_MUTEXES == TRUE
+  tp->realprio = prio;
+#endif
+
+  chThdResumeI(&wp->tr, MSG_OK);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Runs a function on a parked worker.
+ * @details If there are no parked workers then the invoking thread waits
+ *          until one becomes available or the specified timeout expires.
+ * @note    The timeout is restarted if a worker becomes available but it
+ *          is taken by another thread before the invoking thread runs.
+ *
+ * @param[in] tpp       pointer to the @p threads_pool_t structure
+ * @param[in] prio      priority of the worker while executing the function
+ * @param[in] pf        the function to be executed
+ * @param[in] arg       the function argument
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function has been assigned to a worker.
+ * @retval MSG_TIMEOUT  if a worker did not become available within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chThdPoolStartTimeoutS(threads_pool_t *tpp, tprio_t prio,
+                             tfunc_t pf, void *arg, sysinterval_t timeout) {
+
+  chDbgCheckClassS();
+  chDbgCheck(tpp != NULL);
+
+  while (tpp->idle == NULL) {
+    msg_t msg = chThdEnqueueTimeoutS(&tpp->waiting, timeout);
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  (void) chThdPoolStartI(tpp, prio, pf, arg);
+  chSchRescheduleS();
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Runs a function on a parked worker.
+ * @details If there are no parked workers then the invoking thread waits
+ *          until one becomes available or the specified timeout expires.
+ * @note    The timeout is restarted if a worker becomes available but it
+ *          is taken by another thread before the invoking thread runs.
+ *
+ * @param[in] tpp       pointer to the @p threads_pool_t structure
+ * @param[in] prio      priority of the worker while executing the function
+ * @param[in] pf        the function to be executed
+ * @param[in] arg       the function argument
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function has been assigned to a worker.
+ * @retval MSG_TIMEOUT  if a worker did not become available within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chThdPoolStartTimeout(threads_pool_t *tpp, tprio_t prio,
+                            tfunc_t pf, void *arg, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chThdPoolStartTimeoutS(tpp, prio, pf, arg, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Terminates the invoking worker.
+ * @details The worker is removed from the pool and terminated, the exit
+ *          code is stored like in @p chThdExit().
+ * @pre     This function can only be called by a function executed by a
+ *          worker of the specified pool.
+ *
+ * @param[in] tpp       pointer to the @p threads_pool_t structure
+ * @param[in] msg       worker exit code
+ *
+ * @api
+ */
+void chThdPoolExit(threads_pool_t *tpp, msg_t msg) {
+
+  chDbgCheck(tpp != NULL);
+
+  chSysLock();
+  chDbgAssert(tpp->workers > (cnt_t)0, "no workers");
+  tpp->workers--;
+  chThdExitS(msg);
+  /* The thread never returns here.*/
+}
+
+#endif /* CH_CFG_USE_THREADS_POOLS == TRUE */
+
+/** @} */
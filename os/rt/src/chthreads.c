@@ -95,6 +95,9 @@ thread_t *__thd_object_init(os_instance_t *oip,
   tp->state             = CH_STATE_WTSTART;
   tp->flags             = CH_FLAG_MODE_STATIC;
   tp->owner             = oip;
+#if CH_CFG_USE_THREADS_MIGRATION == TRUE
+  tp->affinity          = CH_AFFINITY_ALL;
+#endif
 #if CH_CFG_TIME_QUANTUM > 0
   tp->ticks             = (tslices_t)CH_CFG_TIME_QUANTUM;
 #endif
@@ -102,6 +105,16 @@ thread_t *__thd_object_init(os_instance_t *oip,
   tp->realprio          = prio;
   tp->mtxlist           = NULL;
 #endif
+#if CH_CFG_USE_RWLOCKS == TRUE
+  {
+    unsigned i;
+
+    for (i = 0U; i < (unsigned)CH_CFG_RWLOCKS_MAX_HELD; i++) {
+      tp->rwlholds[i].rwp   = NULL;
+      tp->rwlholds[i].owner = tp;
+    }
+  }
+#endif
 #if CH_CFG_USE_EVENTS == TRUE
   tp->epending          = (eventmask_t)0;
 #endif
@@ -194,6 +207,23 @@ thread_t *chThdCreateSuspendedI(const thread_descriptor_t *tdp) {
   PORT_SETUP_CONTEXT(tp, tdp->wbase, tp, tdp->funcp, tdp->arg);
 
   /* The thread object is initialized but not started.*/
+#if CH_CFG_USE_THREADS_MIGRATION == TRUE
+  if (tdp->instance != NULL) {
+    tp = __thd_object_init(tdp->instance, tp, tdp->name, tdp->prio);
+  }
+  else {
+    tp = __thd_object_init(currcore, tp, tdp->name, tdp->prio);
+  }
+
+  /* Cores affinity, no restrictions if not specified.*/
+  if (tdp->affinity != (core_mask_t)0) {
+    tp->affinity = tdp->affinity;
+  }
+  chDbgAssert((tp->affinity & CH_AFFINITY_CORE(tp->owner->core_id)) != 0U,
+              "instance not in affinity");
+
+  return tp;
+#else
 #if CH_CFG_SMP_MODE != FALSE
   if (tdp->instance != NULL) {
     return __thd_object_init(tdp->instance, tp, tdp->name, tdp->prio);
@@ -201,6 +231,7 @@ thread_t *chThdCreateSuspendedI(const thread_descriptor_t *tdp) {
 #endif
 
   return __thd_object_init(currcore, tp, tdp->name, tdp->prio);
+#endif
 }
 
 /**
@@ -910,4 +941,89 @@ void chThdDequeueAllI(threads_queue_t *tqp, msg_t msg) {
   }
 }
 
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves a thread to another OS instance.
+ * @details Ready threads are moved to the ready list of the destination
+ *          instance, waiting threads will be made ready on the destination
+ *          instance when woken. The current thread can move itself, the
+ *          function returns after the thread has been resumed on the core
+ *          associated to the destination instance.
+ * @note    Threads running on other cores cannot be moved.
+ * @note    Threads waiting with a timeout, sleeping threads included, cannot
+ *          be moved until they run again.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] oip       pointer to the destination OS instance
+ * @return              The operation result.
+ * @retval MSG_OK       if the thread has been moved or already belongs to
+ *                      the destination instance.
+ * @retval MSG_RESET    if the destination core is not in the thread
+ *                      affinity mask, the thread is running on another core,
+ *                      it is waiting with a timeout or it is terminated.
+ *
+ * @api
+ */
+msg_t chThdMigrate(thread_t *tp, os_instance_t *oip) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chSchMigrateS(tp, oip);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Changes the cores affinity mask of a thread.
+ * @details If the thread owner instance is not allowed by the new mask then
+ *          the thread is moved to the first running instance allowed by the
+ *          mask.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] mask      cores the thread is allowed to run on, zero means
+ *                      no restrictions
+ * @return              The operation result.
+ * @retval MSG_OK       if the mask has been changed.
+ * @retval MSG_RESET    if the thread could not be moved to an allowed
+ *                      instance, the mask is not changed.
+ *
+ * @api
+ */
+msg_t chThdSetAffinity(thread_t *tp, core_mask_t mask) {
+  msg_t msg = MSG_OK;
+  core_mask_t oldmask;
+
+  chDbgCheck(tp != NULL);
+
+  if (mask == (core_mask_t)0) {
+    mask = CH_AFFINITY_ALL;
+  }
+
+  chSysLock();
+  oldmask = tp->affinity;
+  tp->affinity = mask;
+  if ((mask & CH_AFFINITY_CORE(tp->owner->core_id)) == 0U) {
+    core_id_t core_id;
+
+    msg = MSG_RESET;
+    for (core_id = 0U; core_id < (core_id_t)PORT_CORES_NUMBER; core_id++) {
+      os_instance_t *oip = ch_system.instances[core_id];
+
+      if ((oip != NULL) && ((mask & CH_AFFINITY_CORE(core_id)) != 0U)) {
+        msg = chSchMigrateS(tp, oip);
+        break;
+      }
+    }
+
+    if (msg != MSG_OK) {
+      tp->affinity = oldmask;
+    }
+  }
+  chSysUnlock();
+
+  return msg;
+}
+#endif /* CH_CFG_USE_THREADS_MIGRATION == TRUE */
+
 /** @} */
@@ -0,0 +1,157 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    sb/common/sbring.h
+ * @brief   Sandbox batched system calls ring.
+ * @details The ring is allocated by the sandbox in its data region and
+ *          registered once with the host. The sandbox queues system calls
+ *          in the submission queue then a single system call makes the
+ *          host process all of them, results are posted in the completion
+ *          queue.
+ *
+ * @addtogroup ARM_SANDBOX_RING
+ * @{
+ */
+
+#ifndef SBRING_H
+#define SBRING_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of entries in the submission and completion queues.
+ */
+#define SB_RING_ENTRIES         32U
+
+/**
+ * @name    Ring system calls numbers
+ * @note    These calls cannot be queued in a ring.
+ * @{
+ */
+#define SB_SVC_RING_SETUP       12U
+#define SB_SVC_RING_ENTER       13U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a submission queue entry.
+ * @details Any system call can be queued, parameters are the same passed
+ *          in registers by the trap.
+ */
+typedef struct {
+  /**
+   * @brief   System call number.
+   */
+  uint32_t                      n;
+  /**
+   * @brief   System call parameters.
+   */
+  uint32_t                      r0;
+  uint32_t                      r1;
+  uint32_t                      r2;
+  uint32_t                      r3;
+  /**
+   * @brief   Value copied in the matching completion entry.
+   */
+  uint32_t                      user_data;
+} sb_ring_sqe_t;
+
+/**
+ * @brief   Type of a completion queue entry.
+ */
+typedef struct {
+  /**
+   * @brief   Value from the submission entry.
+   */
+  uint32_t                      user_data;
+  /**
+   * @brief   System call result.
+   */
+  uint32_t                      result;
+} sb_ring_cqe_t;
+
+/**
+ * @brief   Type of a batched system calls ring.
+ * @note    Counters are free running, entries are indexed modulo
+ *          @p SB_RING_ENTRIES.
+ */
+typedef struct {
+  /**
+   * @brief   Submissions consumed, written by the host.
+   */
+  volatile uint32_t             sq_head;
+  /**
+   * @brief   Submissions queued, written by the sandbox.
+   */
+  volatile uint32_t             sq_tail;
+  /**
+   * @brief   Completions consumed, written by the sandbox.
+   */
+  volatile uint32_t             cq_head;
+  /**
+   * @brief   Completions posted, written by the host.
+   */
+  volatile uint32_t             cq_tail;
+  /**
+   * @brief   Submission queue.
+   */
+  sb_ring_sqe_t                 sq[SB_RING_ENTRIES];
+  /**
+   * @brief   Completion queue.
+   */
+  sb_ring_cqe_t                 cq[SB_RING_ENTRIES];
+} sb_ring_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* SBRING_H */
+
+/** @} */
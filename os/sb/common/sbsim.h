@@ -0,0 +1,185 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    sb/common/sbsim.h
+ * @brief   Simulator sandbox host/client interface.
+ * @details On the Posix simulator each sandbox runs as a child process of
+ *          the simulator. System calls are not trapped, the client writes
+ *          the call number and parameters into a ring shared with the host
+ *          then waits on a futex for the completion counter to advance.
+ *
+ * @addtogroup ARM_SANDBOX_SIMULATOR
+ * @{
+ */
+
+#ifndef SBSIM_H
+#define SBSIM_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Image header magic numbers
+ * @note    Must match @p SB_MAGIC1 and @p SB_MAGIC2 in the host.
+ * @{
+ */
+#define SB_SIM_MAGIC1           0xFE9154C0U
+#define SB_SIM_MAGIC2           0x0C4519EFU
+/** @} */
+
+/**
+ * @brief   Number of slots in a syscall ring, must be a power of two.
+ */
+#define SB_SIM_RING_SIZE        8U
+
+/**
+ * @brief   Number of the exit system call.
+ * @note    This call is not completed by the host, the client process
+ *          terminates right after posting it.
+ */
+#define SB_SIM_SVC_EXIT         1U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a marshalled system call.
+ */
+typedef struct {
+  /**
+   * @brief   System call number.
+   */
+  uint32_t                      n;
+  /**
+   * @brief   Parameters, @p r0 also receives the result.
+   */
+  uint32_t                      r0;
+  uint32_t                      r1;
+  uint32_t                      r2;
+  uint32_t                      r3;
+} sb_sim_slot_t;
+
+/**
+ * @brief   Type of a syscall ring shared between host and client.
+ * @note    The client is not trusted, the host copies each slot before
+ *          processing it.
+ */
+typedef struct {
+  /**
+   * @brief   Submissions counter, advanced by the client.
+   */
+  volatile uint32_t             head;
+  /**
+   * @brief   Completions counter, advanced by the host.
+   * @note    This is the futex word the client waits on.
+   */
+  volatile uint32_t             tail;
+  /**
+   * @brief   Non-zero while the client is sleeping on the futex.
+   */
+  volatile uint32_t             waiting;
+  /**
+   * @brief   Set by the client before leaving.
+   */
+  volatile uint32_t             exited;
+  /**
+   * @brief   Requests slots.
+   */
+  sb_sim_slot_t                 slots[SB_SIM_RING_SIZE];
+} sb_sim_ring_t;
+
+/**
+ * @brief   Type of a sandbox main function.
+ */
+typedef uint32_t (*sb_sim_main_t)(void);
+
+/**
+ * @brief   Type of a client runtime entry point.
+ */
+typedef void (*sb_sim_start_t)(sb_sim_ring_t *ringp, sb_sim_main_t mainf);
+
+/**
+ * @brief   Type of a simulated sandbox image.
+ * @details The first four fields have the same layout of the sandbox
+ *          header, the entry points follow the header as the code would
+ *          do in a real image.
+ */
+typedef struct {
+  uint32_t                      hdr_magic1;
+  uint32_t                      hdr_magic2;
+  uint32_t                      hdr_size;
+  uint32_t                      user;
+  /**
+   * @brief   Client runtime entry point.
+   */
+  sb_sim_start_t                start;
+  /**
+   * @brief   Sandbox main function.
+   */
+  sb_sim_main_t                 main;
+} sb_sim_image_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Defines a sandbox image.
+ * @details The image is meant to be the code region of the sandbox
+ *          configuration, the sandbox process starts from @p mainf.
+ *
+ * @param[in] name      name of the image object
+ * @param[in] mainf     sandbox main function
+ */
+#define SB_SIM_IMAGE(name, mainf)                                           \
+  const sb_sim_image_t name = {                                             \
+    SB_SIM_MAGIC1, SB_SIM_MAGIC2, 4U * sizeof (uint32_t), 0U,               \
+    __sb_sim_start, (mainf)                                                 \
+  }
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void __sb_sim_start(sb_sim_ring_t *ringp, sb_sim_main_t mainf);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* SBSIM_H */
+
+/** @} */
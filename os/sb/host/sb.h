@@ -117,6 +117,15 @@
 #error "invalid SB_NUM_REGIONS value"
 #endif
 
+/**
+ * @brief   Sandboxes hosted as child processes of the Posix simulator.
+ */
+#if defined(PORT_ARCHITECTURE_SIMIA32) || defined(__DOXYGEN__)
+#define SB_HOST_SIMULATOR                   TRUE
+#else
+#define SB_HOST_SIMULATOR                   FALSE
+#endif
+
 #if (PORT_SWITCHED_REGIONS_NUMBER > 0) &&                                   \
     (PORT_SWITCHED_REGIONS_NUMBER != SB_NUM_REGIONS)
 #error "SB_NUM_REGIONS not matching PORT_SWITCHED_REGIONS_NUMBER"
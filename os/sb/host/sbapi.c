@@ -52,6 +52,8 @@
 #define SB_SVC9_HANDLER         sb_api_wait_any_timeout
 #define SB_SVC10_HANDLER        sb_api_wait_all_timeout
 #define SB_SVC11_HANDLER        sb_api_broadcast_flags
+#define SB_SVC12_HANDLER        sb_api_ring_setup
+#define SB_SVC13_HANDLER        sb_api_ring_enter
 /** @} */
 
 #define __SVC(x) asm volatile ("svc " #x)
@@ -1110,4 +1112,86 @@ void sb_api_broadcast_flags(struct port_extctx *ectxp) {
 #endif
 }
 
+void sb_api_ring_setup(struct port_extctx *ectxp) {
+  sb_class_t *sbcp = (sb_class_t *)chThdGetSelfX()->ctx.syscall.p;
+  sb_ring_t *rp = (sb_ring_t *)ectxp->r0;
+
+  /* NULL unregisters the ring.*/
+  if (rp == NULL) {
+    sbcp->ring = NULL;
+    ectxp->r0 = SB_ERR_NOERROR;
+    return;
+  }
+
+  /* The ring is validated once here, the regions cannot change.*/
+  if (((ectxp->r0 & 3U) != 0U) ||
+      !sb_is_valid_write_range(sbcp, (void *)rp, sizeof (sb_ring_t))) {
+    ectxp->r0 = SB_ERR_EFAULT;
+    return;
+  }
+
+  sbcp->ring = rp;
+  ectxp->r0 = SB_ERR_NOERROR;
+}
+
+void sb_api_ring_enter(struct port_extctx *ectxp) {
+  sb_class_t *sbcp = (sb_class_t *)chThdGetSelfX()->ctx.syscall.p;
+  sb_ring_t *rp = sbcp->ring;
+  uint32_t sqh, sqt, cqh, cqt, done;
+
+  if (rp == NULL) {
+    ectxp->r0 = SB_ERR_EINVAL;
+    return;
+  }
+
+  /* Working on a copy of the counters, the ring is writable by the
+     sandbox.*/
+  sqh = rp->sq_head;
+  sqt = rp->sq_tail;
+  cqh = rp->cq_head;
+  cqt = rp->cq_tail;
+  if (((sqt - sqh) > SB_RING_ENTRIES) || ((cqt - cqh) > SB_RING_ENTRIES)) {
+    ectxp->r0 = SB_ERR_EINVAL;
+    return;
+  }
+
+  /* All the queued requests are served in a single pass, stopping if
+     the completion queue becomes full.*/
+  done = 0U;
+  while ((sqh != sqt) && ((cqt - cqh) < SB_RING_ENTRIES)) {
+    const sb_ring_sqe_t *sqep = &rp->sq[sqh & (SB_RING_ENTRIES - 1U)];
+    sb_ring_cqe_t *cqep = &rp->cq[cqt & (SB_RING_ENTRIES - 1U)];
+    struct port_extctx ectx;
+    uint32_t n, user_data;
+
+    n         = sqep->n;
+    user_data = sqep->user_data;
+    ectx.r0   = sqep->r0;
+    ectx.r1   = sqep->r1;
+    ectx.r2   = sqep->r2;
+    ectx.r3   = sqep->r3;
+
+    /* Ring calls cannot be nested.*/
+    if ((n == SB_SVC_RING_SETUP) || (n == SB_SVC_RING_ENTER) || (n > 255U)) {
+      ectx.r0 = SB_ERR_EINVAL;
+    }
+    else {
+      sb_syscalls[n](&ectx);
+    }
+
+    cqep->user_data = user_data;
+    cqep->result    = ectx.r0;
+    sqh++;
+    cqt++;
+    done++;
+
+    /* Progress is published after each request because handlers can
+       block or terminate the sandbox.*/
+    rp->sq_head = sqh;
+    rp->cq_tail = cqt;
+  }
+
+  ectxp->r0 = done;
+}
+
 /** @} */
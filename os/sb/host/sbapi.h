@@ -99,9 +99,12 @@ typedef struct {
 /* External declarations.                                                    */
 /*===========================================================================*/
 
+extern const port_syscall_t sb_syscalls[256];
+
 #ifdef __cplusplus
 extern "C" {
 #endif
+  void __sb_abort(msg_t msg);
   void sb_api_stdio(struct port_extctx *ectxp);
   void sb_api_exit(struct port_extctx *ctxp);
   void sb_api_get_systime(struct port_extctx *ctxp);
@@ -114,6 +117,8 @@ extern "C" {
   void sb_api_wait_any_timeout(struct port_extctx *ctxp);
   void sb_api_wait_all_timeout(struct port_extctx *ctxp);
   void sb_api_broadcast_flags(struct port_extctx *ctxp);
+  void sb_api_ring_setup(struct port_extctx *ctxp);
+  void sb_api_ring_enter(struct port_extctx *ctxp);
 #ifdef __cplusplus
 }
 #endif
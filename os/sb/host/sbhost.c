@@ -96,14 +96,20 @@ void sbObjectInit(sb_class_t *sbcp) {
 
   sbcp->config = NULL;
   sbcp->tp     = NULL;
+  sbcp->ring   = NULL;
 #if CH_CFG_USE_MESSAGES == TRUE
   sbcp->msg_tp = NULL;
 #endif
 #if CH_CFG_USE_EVENTS == TRUE
   chEvtObjectInit(&sbcp->es);
 #endif
+#if SB_HOST_SIMULATOR == TRUE
+  sb_sim_object_init(sbcp);
+#endif
 }
 
+#if (SB_HOST_SIMULATOR == FALSE) || defined(__DOXYGEN__)
+
 /**
  * @brief   Starts a sandboxed thread.
  *
@@ -133,6 +139,7 @@ thread_t *sbStartThread(sb_class_t *sbcp, const sb_config_t *config,
 
   /* Linking configuration information.*/
   sbcp->config = config;
+  sbcp->ring   = NULL;
 
   unprivileged_thread_descriptor_t utd = {
     .name       = name,
@@ -163,6 +170,7 @@ thread_t *sbStartThread(sb_class_t *sbcp, const sb_config_t *config,
 
   return utp;
 }
+#endif /* SB_HOST_SIMULATOR == FALSE */
 
 #if (CH_CFG_USE_MESSAGES == TRUE) || defined(__DOXYGEN__)
 /**
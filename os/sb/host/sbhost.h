@@ -29,8 +29,14 @@
 #define SBHOST_H
 
 #include "sberr.h"
+#include "sbring.h"
 #include "sbapi.h"
 
+#if SB_HOST_SIMULATOR == TRUE
+#include <sys/types.h>
+#include "sbsim.h"
+#endif
+
 /*===========================================================================*/
 /* Module constants.                                                         */
 /*===========================================================================*/
@@ -141,7 +147,7 @@ typedef struct {
 /**
  * @brief   Type of a sandbox object.
  */
-typedef struct {
+typedef struct sb_class {
   /**
    * @brief   Pointer to the sandbox configuration data.
    */
@@ -158,6 +164,42 @@ typedef struct {
 #endif
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
   event_source_t                es;
+#endif
+  /**
+   * @brief   Batched system calls ring, @p NULL if not registered.
+   * @note    The ring is located in the sandbox data region.
+   */
+  sb_ring_t                     *ring;
+#if (SB_HOST_SIMULATOR == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Simulator process state.
+   */
+  struct {
+    /**
+     * @brief   Next running sandbox in the polled list.
+     */
+    struct sb_class             *next;
+    /**
+     * @brief   Process identifier of the sandbox, zero if not running.
+     */
+    pid_t                       pid;
+    /**
+     * @brief   Syscall ring shared with the process.
+     */
+    sb_sim_ring_t               *ring;
+    /**
+     * @brief   Host copy of the completions counter.
+     */
+    uint32_t                    tail;
+    /**
+     * @brief   Host thread waiting for a request.
+     */
+    thread_reference_t          trp;
+    /**
+     * @brief   Last liveness check time stamp.
+     */
+    systime_t                   checked;
+  } sim;
 #endif
 } sb_class_t;
 
@@ -207,6 +249,10 @@ extern "C" {
   msg_t sbSendMessageTimeout(sb_class_t *sbcp,
                              msg_t msg,
                              sysinterval_t timeout);
+#if SB_HOST_SIMULATOR == TRUE
+  void sb_sim_object_init(sb_class_t *sbcp);
+  bool sb_sim_interrupt_pending(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
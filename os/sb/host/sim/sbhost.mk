@@ -0,0 +1,12 @@
+# List of the ChibiOS simulator sandbox host files.
+SBHOSTSRC = $(CHIBIOS)/os/sb/host/sbhost.c \
+            $(CHIBIOS)/os/sb/host/sbapi.c \
+            $(CHIBIOS)/os/sb/host/sbposix.c \
+            $(CHIBIOS)/os/sb/host/sim/sbsimhost.c
+
+SBHOSTINC = $(CHIBIOS)/os/sb/common \
+            $(CHIBIOS)/os/sb/host
+
+# Shared variables
+ALLCSRC    += $(SBHOSTSRC)
+ALLINC     += $(SBHOSTINC)
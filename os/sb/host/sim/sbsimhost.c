@@ -0,0 +1,393 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    sb/host/sim/sbsimhost.c
+ * @brief   Simulator sandbox host backend code.
+ * @details Each sandbox is a child process of the simulator. Writable
+ *          regions are moved into shared memory before forking so that
+ *          pointers passed in system calls have the same meaning on both
+ *          sides. On the host side the sandbox thread is a proxy that
+ *          executes the requests found in the syscall ring using the
+ *          same handlers invoked by the SVC trap on a real target.
+ *
+ * @addtogroup ARM_SANDBOX_SIMULATOR
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/futex.h>
+
+#include "ch.h"
+#include "sb.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Interval between checks of the sandbox processes status.
+ */
+#define SB_SIM_CHECK_INTERVAL           TIME_MS2I(10)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   List of the running sandboxes.
+ */
+static sb_class_t *sb_sim_list;
+
+/**
+ * @brief   Sandbox image, only used in the child process.
+ */
+static const sb_sim_image_t *sb_sim_child_image;
+
+/**
+ * @brief   Syscall ring, only used in the child process.
+ */
+static sb_sim_ring_t *sb_sim_child_ring;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void sb_sim_child_entry(void) {
+
+  sb_sim_child_image->start(sb_sim_child_ring, sb_sim_child_image->main);
+  _exit(0);
+}
+
+/**
+ * @brief   Sandbox process body.
+ * @details The sandbox code runs on a stack placed at the end of the data
+ *          region, as it would on a real target.
+ *
+ * @param[in] config    pointer to the sandbox configuration
+ * @param[in] ringp     pointer to the syscall ring
+ */
+static void sb_sim_child(const sb_config_t *config, sb_sim_ring_t *ringp) {
+  const sb_memory_region_t *dp = &config->regions[config->data_region];
+  ucontext_t uc;
+
+  /* The sandbox does not survive the simulator.*/
+  (void) prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+  sb_sim_child_image =
+      (const sb_sim_image_t *)config->regions[config->code_region].base;
+  sb_sim_child_ring  = ringp;
+
+  (void) getcontext(&uc);
+  uc.uc_stack.ss_sp   = (void *)dp->base;
+  uc.uc_stack.ss_size = (size_t)(dp->end - dp->base);
+  uc.uc_link          = NULL;
+  makecontext(&uc, sb_sim_child_entry, 0);
+  (void) setcontext(&uc);
+
+  _exit(127);
+}
+
+/**
+ * @brief   Moves a region into shared memory preserving its content.
+ *
+ * @param[in] rp        pointer to the region descriptor
+ * @return              The operation status.
+ * @retval false        if the region is not page aligned or the mapping
+ *                      failed.
+ */
+static bool sb_sim_share_region(const sb_memory_region_t *rp) {
+  uint32_t pgmask = (uint32_t)sysconf(_SC_PAGESIZE) - 1U;
+  size_t size = (size_t)(rp->end - rp->base);
+  void *save, *p;
+
+  if (((rp->base & pgmask) != 0U) || ((rp->end & pgmask) != 0U)) {
+    return false;
+  }
+
+  save = malloc(size);
+  if (save == NULL) {
+    return false;
+  }
+  memcpy(save, (const void *)rp->base, size);
+
+  p = mmap((void *)rp->base, size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  if (p == MAP_FAILED) {
+    free(save);
+    return false;
+  }
+
+  memcpy(p, save, size);
+  free(save);
+
+  return true;
+}
+
+/**
+ * @brief   Sandbox proxy thread.
+ * @details Requests are copied out of the ring before being processed
+ *          because the ring is writable by the sandbox.
+ */
+static THD_FUNCTION(sb_sim_thread, arg) {
+  sb_class_t *sbcp = (sb_class_t *)arg;
+  sb_sim_ring_t *ringp = sbcp->sim.ring;
+
+  chThdGetSelfX()->ctx.syscall.p = (const void *)sbcp;
+
+  while (true) {
+    struct port_extctx ectx;
+    sb_sim_slot_t *sp;
+    uint32_t n;
+
+    chSysLock();
+    while (__atomic_load_n(&ringp->head,
+                           __ATOMIC_ACQUIRE) == sbcp->sim.tail) {
+      if (sbcp->sim.pid == 0) {
+        /* The process terminated without calling exit.*/
+        __sb_abort(MSG_RESET);
+      }
+      (void) chThdSuspendS(&sbcp->sim.trp);
+    }
+    chSysUnlock();
+
+    sp = &ringp->slots[sbcp->sim.tail & (SB_SIM_RING_SIZE - 1U)];
+    n       = sp->n;
+    ectx.r0 = sp->r0;
+    ectx.r1 = sp->r1;
+    ectx.r2 = sp->r2;
+    ectx.r3 = sp->r3;
+
+    if (n < 256U) {
+      sb_syscalls[n](&ectx);
+    }
+    else {
+      ectx.r0 = SB_ERR_ENOSYS;
+    }
+
+    /* Completion, the futex is only touched if the client is sleeping.*/
+    sp->r0 = ectx.r0;
+    sbcp->sim.tail++;
+    __atomic_store_n(&ringp->tail, sbcp->sim.tail, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ringp->waiting, __ATOMIC_SEQ_CST) != 0U) {
+      (void) syscall(SYS_futex, &ringp->tail, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulator part of the sandbox object initialization.
+ *
+ * @param[out] sbcp     pointer to the sandbox object
+ *
+ * @notapi
+ */
+void sb_sim_object_init(sb_class_t *sbcp) {
+
+  sbcp->sim.next    = NULL;
+  sbcp->sim.pid     = 0;
+  sbcp->sim.ring    = NULL;
+  sbcp->sim.tail    = 0U;
+  sbcp->sim.trp     = NULL;
+  sbcp->sim.checked = (systime_t)0;
+}
+
+/**
+ * @brief   Sandbox processes interrupt simulation.
+ * @details Wakes up the proxy threads having pending requests and reaps
+ *          terminated sandbox processes. It is meant to be used as
+ *          @p SIM_EXTRA_INTERRUPTS_HANDLER.
+ *
+ * @return              The interrupt status.
+ * @retval true         if a proxy thread has been woken up.
+ *
+ * @notapi
+ */
+bool sb_sim_interrupt_pending(void) {
+  sb_class_t **sbpp;
+  bool b = false;
+
+  CH_IRQ_PROLOGUE();
+
+  sbpp = &sb_sim_list;
+  while (*sbpp != NULL) {
+    sb_class_t *sbcp = *sbpp;
+    systime_t now = chVTGetSystemTimeX();
+
+    /* Checking if the process is still alive.*/
+    if (chTimeDiffX(sbcp->sim.checked, now) >= SB_SIM_CHECK_INTERVAL) {
+      sbcp->sim.checked = now;
+      if (waitpid(sbcp->sim.pid, NULL, WNOHANG) != 0) {
+        sbcp->sim.pid = 0;
+      }
+    }
+
+    chSysLockFromISR();
+    if ((sbcp->sim.pid == 0) ||
+        (__atomic_load_n(&sbcp->sim.ring->head,
+                         __ATOMIC_ACQUIRE) != sbcp->sim.tail)) {
+      if (sbcp->sim.trp != NULL) {
+        chThdResumeI(&sbcp->sim.trp, MSG_OK);
+        b = true;
+      }
+    }
+    chSysUnlockFromISR();
+
+    /* Terminated processes are removed from the list.*/
+    if (sbcp->sim.pid == 0) {
+      *sbpp = sbcp->sim.next;
+      sbcp->sim.next = NULL;
+    }
+    else {
+      sbpp = &sbcp->sim.next;
+    }
+  }
+
+  CH_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/**
+ * @brief   Starts a sandboxed thread.
+ * @details The sandbox is started as a child process of the simulator,
+ *          the returned thread is its proxy on the host side.
+ * @note    Writable regions must be page aligned, they are moved into
+ *          shared memory.
+ *
+ * @param[out] sbcp     pointer to the sandbox object
+ * @param[in] config    pointer to the sandbox configuration
+ * @return              The thread pointer.
+ * @retval NULL         if the sandbox thread creation failed.
+ */
+thread_t *sbStartThread(sb_class_t *sbcp, const sb_config_t *config,
+                        const char *name, void *wsp, size_t size,
+                        tprio_t prio) {
+  const sb_sim_image_t *ip;
+  sb_sim_ring_t *ringp;
+  unsigned i;
+  pid_t pid;
+
+  chDbgCheck(sbcp->sim.pid == 0);
+
+  /* Image location.*/
+  ip = (const sb_sim_image_t *)config->regions[config->code_region].base;
+
+  /* Checking header magic numbers.*/
+  if ((ip->hdr_magic1 != SB_MAGIC1) || (ip->hdr_magic2 != SB_MAGIC2)) {
+    return NULL;
+  }
+
+  /* Checking header size and entry points.*/
+  if ((ip->hdr_size != sizeof (sb_header_t)) ||
+      (ip->start == NULL) || (ip->main == NULL)) {
+    return NULL;
+  }
+
+  /* Writable regions are shared with the process.*/
+  for (i = 0U; i < SB_NUM_REGIONS; i++) {
+    const sb_memory_region_t *rp = &config->regions[i];
+
+    if (rp->writeable && (rp->base != rp->end)) {
+      if (!sb_sim_share_region(rp)) {
+        return NULL;
+      }
+    }
+  }
+
+  /* Syscall ring, allocated on first start and reused.*/
+  ringp = sbcp->sim.ring;
+  if (ringp == NULL) {
+    void *p = mmap(NULL, sizeof (sb_sim_ring_t), PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      return NULL;
+    }
+    ringp = (sb_sim_ring_t *)p;
+    sbcp->sim.ring = ringp;
+  }
+  memset((void *)ringp, 0, sizeof (sb_sim_ring_t));
+
+  /* Buffered output would be flushed twice.*/
+  (void) fflush(stdout);
+  (void) fflush(stderr);
+
+  pid = fork();
+  if (pid < 0) {
+    return NULL;
+  }
+  if (pid == 0) {
+    sb_sim_child(config, ringp);
+  }
+
+  /* Linking configuration information.*/
+  sbcp->config      = config;
+  sbcp->ring        = NULL;
+  sbcp->sim.pid     = pid;
+  sbcp->sim.tail    = 0U;
+  sbcp->sim.trp     = NULL;
+  sbcp->sim.checked = chVTGetSystemTimeX();
+#if CH_CFG_USE_MESSAGES == TRUE
+  sbcp->msg_tp      = NULL;
+#endif
+#if CH_CFG_USE_EVENTS == TRUE
+  chEvtObjectInit(&sbcp->es);
+#endif
+
+  /* Adding to the polled list, requests posted before the proxy starts
+     are found in the ring.*/
+  chSysLock();
+  sbcp->sim.next = sb_sim_list;
+  sb_sim_list    = sbcp;
+  chSysUnlock();
+
+  thread_descriptor_t td = THD_DESCRIPTOR(name,
+                                          (stkalign_t *)wsp,
+                                          (stkalign_t *)wsp +
+                                          (size / sizeof (stkalign_t)),
+                                          prio,
+                                          sb_sim_thread,
+                                          (void *)sbcp);
+  sbcp->tp = chThdCreateSuspended(&td);
+
+  return chThdStart(sbcp->tp);
+}
+
+/** @} */
@@ -55,4 +55,119 @@
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+/**
+ * @brief   Initializes and registers a batched system calls ring.
+ * @note    Only one ring can be registered, a new registration replaces
+ *          the previous one.
+ *
+ * @param[out] rp       pointer to the ring, it must be located in the
+ *                      sandbox data region
+ * @return              The operation result.
+ *
+ * @api
+ */
+uint32_t sbRingInit(sb_ring_t *rp) {
+
+  rp->sq_head = 0U;
+  rp->sq_tail = 0U;
+  rp->cq_head = 0U;
+  rp->cq_tail = 0U;
+
+  return __sb_ring_setup(rp);
+}
+
+/**
+ * @brief   Queues a system call in a ring.
+ * @note    The call is not performed until @p sbRingSubmit() is invoked.
+ *
+ * @param[in] rp        pointer to the ring
+ * @param[in] n         system call number
+ * @param[in] r0        first system call parameter
+ * @param[in] r1        second system call parameter
+ * @param[in] r2        third system call parameter
+ * @param[in] r3        fourth system call parameter
+ * @param[in] user_data value returned in the completion entry
+ * @return              The operation status.
+ * @retval false        if the submission queue is full.
+ *
+ * @api
+ */
+bool sbRingQueue(sb_ring_t *rp, uint32_t n,
+                 uint32_t r0, uint32_t r1, uint32_t r2, uint32_t r3,
+                 uint32_t user_data) {
+  uint32_t tail = rp->sq_tail;
+  sb_ring_sqe_t *sqep;
+
+  if ((tail - rp->sq_head) >= SB_RING_ENTRIES) {
+    return false;
+  }
+
+  sqep = &rp->sq[tail & (SB_RING_ENTRIES - 1U)];
+  sqep->n         = n;
+  sqep->r0        = r0;
+  sqep->r1        = r1;
+  sqep->r2        = r2;
+  sqep->r3        = r3;
+  sqep->user_data = user_data;
+  rp->sq_tail     = tail + 1U;
+
+  return true;
+}
+
+/**
+ * @brief   Submits all the queued system calls with a single trap.
+ * @note    The host stops serving requests when the completion queue is
+ *          full, completions must be consumed or discarded in order to
+ *          make progress.
+ *
+ * @param[in] rp        pointer to the ring
+ * @return              The number of system calls performed or an error.
+ *
+ * @api
+ */
+uint32_t sbRingSubmit(sb_ring_t *rp) {
+
+  if (rp->sq_tail == rp->sq_head) {
+    return 0U;
+  }
+
+  return __sb_ring_enter();
+}
+
+/**
+ * @brief   Fetches a completion entry from a ring.
+ *
+ * @param[in] rp        pointer to the ring
+ * @param[out] cqep     pointer to the completion entry to be filled
+ * @return              The operation status.
+ * @retval false        if there are no completions.
+ *
+ * @api
+ */
+bool sbRingGetCompletion(sb_ring_t *rp, sb_ring_cqe_t *cqep) {
+  uint32_t head = rp->cq_head;
+
+  if (head == rp->cq_tail) {
+    return false;
+  }
+
+  *cqep = rp->cq[head & (SB_RING_ENTRIES - 1U)];
+  rp->cq_head = head + 1U;
+
+  return true;
+}
+
+/**
+ * @brief   Discards all the completion entries in a ring.
+ * @note    Useful when the results of the batched calls are not checked.
+ *
+ * @param[in] rp        pointer to the ring
+ *
+ * @api
+ */
+void sbRingDiscardCompletions(sb_ring_t *rp) {
+
+  rp->cq_head = rp->cq_tail;
+}
+
 /** @} */
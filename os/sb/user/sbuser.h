@@ -29,15 +29,38 @@
 #define SBUSER_H
 
 #include "sberr.h"
+#include "sbring.h"
 
 /*===========================================================================*/
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Common constants
+ * @{
+ */
+#if !defined(FALSE) || defined(__DOXYGEN__)
+#define FALSE                   0
+#endif
+
+#if !defined(TRUE) || defined(__DOXYGEN__)
+#define TRUE                    1
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Sandbox running as a child process of the Posix simulator.
+ * @details System calls are marshalled into the ring shared with the
+ *          simulator instead of using the SVC instruction.
+ */
+#if !defined(SB_USER_SIMULATOR) || defined(__DOXYGEN__)
+#define SB_USER_SIMULATOR       FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -122,6 +145,37 @@ typedef uint32_t eventflags_t;
 #define TIME_MAX_SYSTIME    ((systime_t)-1)
 /** @} */
 
+#if (SB_USER_SIMULATOR == TRUE) || defined(__DOXYGEN__)
+/**
+ * @name   Simulator system call wrappers.
+ * @{
+ */
+#define __syscall0(x)                                                       \
+  (void)__sb_sim_syscall(x, 0U, 0U, 0U, 0U)
+
+#define __syscall0r(x)                                                      \
+  uint32_t r0 __attribute__((unused)) =                                     \
+      __sb_sim_syscall(x, 0U, 0U, 0U, 0U)
+
+#define __syscall1r(x, p1)                                                  \
+  uint32_t r0 __attribute__((unused)) =                                     \
+      __sb_sim_syscall(x, (uint32_t)(p1), 0U, 0U, 0U)
+
+#define __syscall2r(x, p1, p2)                                              \
+  uint32_t r0 __attribute__((unused)) =                                     \
+      __sb_sim_syscall(x, (uint32_t)(p1), (uint32_t)(p2), 0U, 0U)
+
+#define __syscall3r(x, p1, p2, p3)                                          \
+  uint32_t r0 __attribute__((unused)) =                                     \
+      __sb_sim_syscall(x, (uint32_t)(p1), (uint32_t)(p2),                   \
+                       (uint32_t)(p3), 0U)
+
+#define __syscall4r(x, p1, p2, p3, p4)                                      \
+  uint32_t r0 __attribute__((unused)) =                                     \
+      __sb_sim_syscall(x, (uint32_t)(p1), (uint32_t)(p2),                   \
+                       (uint32_t)(p3), (uint32_t)(p4))
+/** @} */
+#else /* SB_USER_SIMULATOR == FALSE */
 /**
  * @name   SVC instruction wrappers.
  * @{
@@ -157,6 +211,7 @@ typedef uint32_t eventflags_t;
   asm volatile ("svc " #x : "=r" (r0) : "r" (r0), "r" (r1),                 \
                                         "r" (r2), "r" (r3) : "memory")
 /** @} */
+#endif /* SB_USER_SIMULATOR == FALSE */
 
 /*===========================================================================*/
 /* External declarations.                                                    */
@@ -165,7 +220,17 @@ typedef uint32_t eventflags_t;
 #ifdef __cplusplus
 extern "C" {
 #endif
-
+#if SB_USER_SIMULATOR == TRUE
+  uint32_t __sb_sim_syscall(uint32_t n, uint32_t r0, uint32_t r1,
+                            uint32_t r2, uint32_t r3);
+#endif
+  uint32_t sbRingInit(sb_ring_t *rp);
+  bool sbRingQueue(sb_ring_t *rp, uint32_t n,
+                   uint32_t r0, uint32_t r1, uint32_t r2, uint32_t r3,
+                   uint32_t user_data);
+  uint32_t sbRingSubmit(sb_ring_t *rp);
+  bool sbRingGetCompletion(sb_ring_t *rp, sb_ring_cqe_t *cqep);
+  void sbRingDiscardCompletions(sb_ring_t *rp);
 #ifdef __cplusplus
 }
 #endif
@@ -428,6 +493,57 @@ static inline uint32_t sbEventBroadcastFlags(eventflags_t flags) {
   return (uint32_t)r0;
 }
 
+/**
+ * @brief   Registers a batched system calls ring.
+ * @note    The ring must be located in the sandbox data region.
+ *
+ * @param[in] rp        pointer to the ring or @p NULL to unregister
+ * @return              The operation result.
+ *
+ * @notapi
+ */
+static inline uint32_t __sb_ring_setup(sb_ring_t *rp) {
+
+  __syscall1r(12, rp);
+  return (uint32_t)r0;
+}
+
+/**
+ * @brief   Serves the requests queued in the registered ring.
+ *
+ * @return              The number of requests served or an error.
+ *
+ * @notapi
+ */
+static inline uint32_t __sb_ring_enter(void) {
+
+  __syscall0r(13);
+  return (uint32_t)r0;
+}
+
+/**
+ * @brief   Queues a Posix-style file write in a ring.
+ *
+ * @param[in] rp        pointer to the ring
+ * @param[in] fd        file descriptor
+ * @param[in] buf       buffer pointer, it must stay valid until submitted
+ * @param[in] count     number of bytes
+ * @param[in] user_data value returned in the completion entry
+ * @return              The operation status.
+ * @retval false        if the submission queue is full.
+ *
+ * @api
+ */
+static inline bool sbRingQueueFileWrite(sb_ring_t *rp,
+                                        uint32_t fd,
+                                        const uint8_t *buf,
+                                        size_t count,
+                                        uint32_t user_data) {
+
+  return sbRingQueue(rp, 0U, (uint32_t)SB_POSIX_WRITE, fd,
+                     (uint32_t)buf, (uint32_t)count, user_data);
+}
+
 /**
  * @brief   Seconds to time interval.
  * @details Converts from seconds to system ticks number.
@@ -0,0 +1,147 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    sb/user/sim/sbsimuser.c
+ * @brief   Simulator sandbox client runtime.
+ *
+ * @addtogroup ARM_SANDBOX_SIMULATOR
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "sbuser.h"
+#include "sbsim.h"
+
+#if SB_USER_SIMULATOR != TRUE
+#error "SB_USER_SIMULATOR not enabled"
+#endif
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of polling cycles before sleeping on the futex.
+ * @note    The host serves requests from its idle loop so most calls
+ *          complete within the spinning window.
+ */
+#define SB_SIM_SPIN_CYCLES      1024U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Syscall ring shared with the host.
+ */
+static sb_sim_ring_t *sb_sim_ringp;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Client runtime entry point.
+ * @details Invoked by the host in the sandbox process, the value returned
+ *          by the sandbox main function is used as exit code.
+ *
+ * @param[in] ringp     pointer to the syscall ring
+ * @param[in] mainf     sandbox main function
+ */
+void __sb_sim_start(sb_sim_ring_t *ringp, sb_sim_main_t mainf) {
+
+  sb_sim_ringp = ringp;
+
+  sbExit((msg_t)mainf());
+}
+
+/**
+ * @brief   Performs a system call through the shared ring.
+ * @note    The exit call is not completed by the host, the process
+ *          terminates right after posting it.
+ *
+ * @param[in] n         system call number
+ * @param[in] r0        first parameter
+ * @param[in] r1        second parameter
+ * @param[in] r2        third parameter
+ * @param[in] r3        fourth parameter
+ * @return              The system call result.
+ */
+uint32_t __sb_sim_syscall(uint32_t n, uint32_t r0, uint32_t r1,
+                          uint32_t r2, uint32_t r3) {
+  sb_sim_ring_t *ringp = sb_sim_ringp;
+  uint32_t ticket = ringp->head;
+  sb_sim_slot_t *sp = &ringp->slots[ticket & (SB_SIM_RING_SIZE - 1U)];
+  unsigned i;
+
+  sp->n  = n;
+  sp->r0 = r0;
+  sp->r1 = r1;
+  sp->r2 = r2;
+  sp->r3 = r3;
+  if (n == SB_SIM_SVC_EXIT) {
+    ringp->exited = 1U;
+  }
+  __atomic_store_n(&ringp->head, ticket + 1U, __ATOMIC_SEQ_CST);
+
+  if (n == SB_SIM_SVC_EXIT) {
+    _exit((int)r0);
+  }
+
+  /* Short spinning phase.*/
+  for (i = 0U; i < SB_SIM_SPIN_CYCLES; i++) {
+    if (__atomic_load_n(&ringp->tail, __ATOMIC_ACQUIRE) != ticket) {
+      return sp->r0;
+    }
+  }
+
+  /* Sleeping until the completions counter moves.*/
+  while (true) {
+    __atomic_store_n(&ringp->waiting, 1U, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ringp->tail, __ATOMIC_SEQ_CST) != ticket) {
+      break;
+    }
+    (void) syscall(SYS_futex, &ringp->tail, FUTEX_WAIT, ticket,
+                   NULL, NULL, 0);
+  }
+  __atomic_store_n(&ringp->waiting, 0U, __ATOMIC_SEQ_CST);
+
+  return sp->r0;
+}
+
+/** @} */
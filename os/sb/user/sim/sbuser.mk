@@ -0,0 +1,13 @@
+# List of the ChibiOS simulator sandbox user files.
+SBUSERSRC = $(CHIBIOS)/os/sb/user/sbuser.c \
+            $(CHIBIOS)/os/sb/user/sim/sbsimuser.c
+
+SBUSERASM =
+
+SBUSERINC = $(CHIBIOS)/os/sb/common \
+            $(CHIBIOS)/os/sb/user
+
+# Shared variables
+ALLXASMSRC += $(SBUSERASM)
+ALLCSRC    += $(SBUSERSRC)
+ALLINC     += $(SBUSERINC)
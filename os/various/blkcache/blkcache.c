@@ -0,0 +1,668 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkcache.c
+ * @brief   Cached block device code.
+ * @details The cached block device implements the @p BaseBlockDevice
+ *          interface on top of another block device, the most recently
+ *          used blocks are kept in an objects cache.<br>
+ *          Single block writes are not performed immediately, written
+ *          blocks are marked dirty and written to the device when evicted
+ *          from the cache or on synchronization. Adjacent dirty blocks are
+ *          coalesced and written using a single multi-block operation.<br>
+ *          Large transfers bypass the cache, this way file data does not
+ *          evict the file system metadata blocks.
+ * @note    Written data is lost if the device is removed before a
+ *          synchronization, file systems synchronize the device when
+ *          files are closed or flushed.
+ *
+ * @addtogroup BLKCACHE
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "blkcache.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* Objects group of the cached blocks.*/
+#define BLKCACHE_GROUP                      0U
+
+/* Flags of a dirty block not owned by a thread.*/
+#define BLKCACHE_DIRTY_FLAGS                (OC_FLAG_INLRU | OC_FLAG_LAZYWRITE)
+
+/* Flags of a valid block not owned by a thread.*/
+#define BLKCACHE_VALID_FLAGS                (OC_FLAG_INLRU | OC_FLAG_INHASH)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static bool blkcache_is_inserted(void *instance);
+static bool blkcache_is_protected(void *instance);
+static bool blkcache_connect(void *instance);
+static bool blkcache_disconnect(void *instance);
+static bool blkcache_read(void *instance, uint32_t startblk,
+                          uint8_t *buffer, uint32_t n);
+static bool blkcache_write(void *instance, uint32_t startblk,
+                           const uint8_t *buffer, uint32_t n);
+static bool blkcache_sync(void *instance);
+static bool blkcache_get_info(void *instance, BlockDeviceInfo *bdip);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct CachedBlockDeviceVMT blkcache_vmt = {
+  (size_t)0,
+  blkcache_is_inserted,
+  blkcache_is_protected,
+  blkcache_connect,
+  blkcache_disconnect,
+  blkcache_read,
+  blkcache_write,
+  blkcache_sync,
+  blkcache_get_info
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Finds a dirty block in the cache.
+ * @note    The cache is only accessed with the device mutex taken so the
+ *          objects not owned by the invoking thread are in the LRU list
+ *          and their state can be inspected directly.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ * @param[in] blk       the block number
+ * @return              The buffer containing the dirty block.
+ * @retval NULL         if the block is not cached or it is not dirty.
+ *
+ * @notapi
+ */
+static blkcache_buffer_t *blkcache_find_dirty(CachedBlockDevice *cbdp,
+                                              uint32_t blk) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)BLKCACHE_CFG_NUM_BUFFERS; i++) {
+    blkcache_buffer_t *bp = &cbdp->buffers[i];
+
+    if (((bp->obj.obj_flags & BLKCACHE_DIRTY_FLAGS) == BLKCACHE_DIRTY_FLAGS) &&
+        (bp->obj.obj_key == blk)) {
+      return bp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Finds the dirty block with the lowest block number.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ * @return              The buffer containing the dirty block.
+ * @retval NULL         if there are no dirty blocks.
+ *
+ * @notapi
+ */
+static blkcache_buffer_t *blkcache_first_dirty(CachedBlockDevice *cbdp) {
+  blkcache_buffer_t *first = NULL;
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)BLKCACHE_CFG_NUM_BUFFERS; i++) {
+    blkcache_buffer_t *bp = &cbdp->buffers[i];
+
+    if (((bp->obj.obj_flags & BLKCACHE_DIRTY_FLAGS) == BLKCACHE_DIRTY_FLAGS) &&
+        ((first == NULL) || (bp->obj.obj_key < first->obj.obj_key))) {
+      first = bp;
+    }
+  }
+
+  return first;
+}
+
+/**
+ * @brief   Writes a dirty block and the dirty blocks following it.
+ * @details The cached dirty blocks adjacent to the specified one are
+ *          written in a single operation.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ * @param[in] bp        buffer owned by the invoking thread
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the blocks have been written.
+ * @retval HAL_FAILED   if the write operation failed.
+ *
+ * @notapi
+ */
+static bool blkcache_write_run(CachedBlockDevice *cbdp,
+                               blkcache_buffer_t *bp) {
+  blkcache_buffer_t *run[BLKCACHE_CFG_MAX_COALESCED];
+  uint32_t startblk = bp->obj.obj_key;
+  const uint8_t *p;
+  uint32_t i, n;
+  bool err;
+
+  /* Collecting the dirty blocks following the specified one, they are
+     owned until written.*/
+  run[0] = bp;
+  n = 1U;
+  while ((n < (uint32_t)BLKCACHE_CFG_MAX_COALESCED) &&
+         (n < cbdp->blk_num - startblk)) {
+    blkcache_buffer_t *nbp = blkcache_find_dirty(cbdp, startblk + n);
+
+    if (nbp == NULL) {
+      break;
+    }
+    (void) chCacheGetObject(&cbdp->cache, BLKCACHE_GROUP, startblk + n);
+    run[n++] = nbp;
+  }
+
+  /* A single block is written directly from its buffer.*/
+  if (n == 1U) {
+    p = bp->data;
+  }
+  else {
+    for (i = 0U; i < n; i++) {
+      memcpy(&cbdp->wbuf[i * cbdp->blk_size], run[i]->data, cbdp->blk_size);
+    }
+    p = cbdp->wbuf;
+  }
+
+  err = blkWrite(cbdp->config->bdp, startblk, p, n);
+  if (!err) {
+    cbdp->stats.writes++;
+    cbdp->stats.blocks_written += n;
+  }
+
+  /* Returning the following blocks to the cache, clean if written.*/
+  for (i = 1U; i < n; i++) {
+    if (!err) {
+      run[i]->obj.obj_flags &= ~OC_FLAG_LAZYWRITE;
+    }
+    chCacheReleaseObject(&cbdp->cache, &run[i]->obj);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Writes all the dirty blocks.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the dirty blocks have been written.
+ * @retval HAL_FAILED   if a write operation failed or a dirty block has
+ *                      been lost since the previous flush.
+ *
+ * @notapi
+ */
+static bool blkcache_flush(CachedBlockDevice *cbdp) {
+  blkcache_buffer_t *bp;
+
+  /* Writing in ascending blocks order so that runs are as long as
+     possible.*/
+  while ((bp = blkcache_first_dirty(cbdp)) != NULL) {
+    bool err;
+
+    (void) chCacheGetObject(&cbdp->cache, BLKCACHE_GROUP, bp->obj.obj_key);
+    err = chCacheWriteObject(&cbdp->cache, &bp->obj, false);
+    chCacheReleaseObject(&cbdp->cache, &bp->obj);
+    if (err) {
+      return HAL_FAILED;
+    }
+  }
+
+  if (cbdp->error) {
+    cbdp->error = false;
+    return HAL_FAILED;
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Cached block reader.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ * @param[in] async     release the object after reading
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool blkcache_readf(objects_cache_t *ocp,
+                           oc_object_t *objp,
+                           bool async) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)objp->dptr;
+  bool err;
+
+  err = blkRead(cbdp->config->bdp, objp->obj_key,
+                ((blkcache_buffer_t *)objp)->data, 1U);
+  if (!err) {
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+  }
+
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Cached block writer.
+ * @note    Asynchronous writes are requested by the cache when a dirty
+ *          block is evicted, the block is lost if the write fails and the
+ *          error is reported by the next synchronization.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ * @param[in] async     release the object after writing
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool blkcache_writef(objects_cache_t *ocp,
+                            oc_object_t *objp,
+                            bool async) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)objp->dptr;
+  bool err;
+
+  err = blkcache_write_run(cbdp, (blkcache_buffer_t *)objp);
+
+  if (async) {
+    cbdp->stats.evictions++;
+    if (err) {
+      cbdp->error = true;
+    }
+    chCacheReleaseObject(ocp, objp);
+  }
+  else if (err) {
+    /* Still dirty.*/
+    objp->obj_flags |= OC_FLAG_LAZYWRITE;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Empties the cache.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ *
+ * @notapi
+ */
+static void blkcache_invalidate(CachedBlockDevice *cbdp) {
+  unsigned i;
+
+  chCacheObjectInit(&cbdp->cache,
+                    (ucnt_t)BLKCACHE_CFG_HASH_SIZE,
+                    cbdp->hash,
+                    (ucnt_t)BLKCACHE_CFG_NUM_BUFFERS,
+                    sizeof (blkcache_buffer_t),
+                    cbdp->buffers,
+                    blkcache_readf,
+                    blkcache_writef);
+
+  /* The objects user pointer refers to the device.*/
+  for (i = 0U; i < (unsigned)BLKCACHE_CFG_NUM_BUFFERS; i++) {
+    cbdp->buffers[i].obj.dptr = (void *)cbdp;
+  }
+  cbdp->error = false;
+}
+
+/**
+ * @brief   Checks the state and the range of a transfer.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ * @param[in] startblk  first block of the transfer
+ * @param[in] n         number of blocks of the transfer
+ * @return              The transfer validity.
+ *
+ * @notapi
+ */
+static bool blkcache_is_valid(CachedBlockDevice *cbdp,
+                              uint32_t startblk, uint32_t n) {
+
+  return (cbdp->state == BLK_READY) &&
+         (n <= cbdp->blk_num) && (startblk <= cbdp->blk_num - n);
+}
+
+static bool blkcache_is_inserted(void *instance) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)instance;
+
+  return blkIsInserted(cbdp->config->bdp);
+}
+
+static bool blkcache_is_protected(void *instance) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)instance;
+
+  return blkIsWriteProtected(cbdp->config->bdp);
+}
+
+static bool blkcache_connect(void *instance) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)instance;
+  BaseBlockDevice *bdp;
+  BlockDeviceInfo bdi;
+
+  osalDbgAssert((cbdp->state == BLK_ACTIVE) || (cbdp->state == BLK_READY),
+                "invalid state");
+
+  osalMutexLock(&cbdp->mutex);
+
+  if (cbdp->state == BLK_READY) {
+    osalMutexUnlock(&cbdp->mutex);
+    return HAL_SUCCESS;
+  }
+
+  cbdp->state = BLK_CONNECTING;
+  bdp = cbdp->config->bdp;
+  if (blkConnect(bdp) || blkGetInfo(bdp, &bdi) ||
+      (bdi.blk_size == 0U) ||
+      (bdi.blk_size > (uint32_t)BLKCACHE_CFG_BUFFER_SIZE)) {
+    cbdp->state = BLK_ACTIVE;
+    osalMutexUnlock(&cbdp->mutex);
+    return HAL_FAILED;
+  }
+  cbdp->blk_size = bdi.blk_size;
+  cbdp->blk_num  = bdi.blk_num;
+  blkcache_invalidate(cbdp);
+  cbdp->state = BLK_READY;
+
+  osalMutexUnlock(&cbdp->mutex);
+
+  return HAL_SUCCESS;
+}
+
+static bool blkcache_disconnect(void *instance) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)instance;
+  bool err;
+
+  osalDbgAssert((cbdp->state == BLK_ACTIVE) || (cbdp->state == BLK_READY),
+                "invalid state");
+
+  osalMutexLock(&cbdp->mutex);
+
+  if (cbdp->state == BLK_ACTIVE) {
+    osalMutexUnlock(&cbdp->mutex);
+    return HAL_SUCCESS;
+  }
+
+  /* Dirty blocks are written before disconnecting, the disconnection is
+     performed anyway.*/
+  cbdp->state = BLK_DISCONNECTING;
+  err = blkcache_flush(cbdp);
+  if (blkDisconnect(cbdp->config->bdp)) {
+    err = HAL_FAILED;
+  }
+  cbdp->state = BLK_ACTIVE;
+
+  osalMutexUnlock(&cbdp->mutex);
+
+  return err;
+}
+
+static bool blkcache_read(void *instance, uint32_t startblk,
+                          uint8_t *buffer, uint32_t n) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)instance;
+  bool err = HAL_SUCCESS;
+  unsigned i;
+
+  osalMutexLock(&cbdp->mutex);
+
+  if (!blkcache_is_valid(cbdp, startblk, n)) {
+    osalMutexUnlock(&cbdp->mutex);
+    return HAL_FAILED;
+  }
+
+  cbdp->state = BLK_READING;
+  if (n >= (uint32_t)BLKCACHE_CFG_BYPASS_THRESHOLD) {
+    /* Large transfer, reading from the device then overwriting the blocks
+       that are dirty in cache.*/
+    err = blkRead(cbdp->config->bdp, startblk, buffer, n);
+    if (!err) {
+      for (i = 0U; i < (unsigned)BLKCACHE_CFG_NUM_BUFFERS; i++) {
+        blkcache_buffer_t *bp = &cbdp->buffers[i];
+
+        if (((bp->obj.obj_flags & BLKCACHE_DIRTY_FLAGS) == BLKCACHE_DIRTY_FLAGS) &&
+            (bp->obj.obj_key - startblk < n)) {
+          memcpy(&buffer[(bp->obj.obj_key - startblk) * cbdp->blk_size],
+                 bp->data, cbdp->blk_size);
+        }
+      }
+    }
+  }
+  else {
+    while (n > 0U) {
+      oc_object_t *objp = chCacheGetObject(&cbdp->cache,
+                                           BLKCACHE_GROUP, startblk);
+
+      if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+        cbdp->stats.misses++;
+        if (chCacheReadObject(&cbdp->cache, objp, false)) {
+          /* The object is still not in sync, it is invalidated on
+             release.*/
+          chCacheReleaseObject(&cbdp->cache, objp);
+          err = HAL_FAILED;
+          break;
+        }
+      }
+      else {
+        cbdp->stats.hits++;
+      }
+      memcpy(buffer, ((blkcache_buffer_t *)objp)->data, cbdp->blk_size);
+      chCacheReleaseObject(&cbdp->cache, objp);
+
+      buffer += cbdp->blk_size;
+      startblk++;
+      n--;
+    }
+  }
+  cbdp->state = BLK_READY;
+
+  osalMutexUnlock(&cbdp->mutex);
+
+  return err;
+}
+
+static bool blkcache_write(void *instance, uint32_t startblk,
+                           const uint8_t *buffer, uint32_t n) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)instance;
+  bool err = HAL_SUCCESS;
+  unsigned i;
+
+  osalMutexLock(&cbdp->mutex);
+
+  if (!blkcache_is_valid(cbdp, startblk, n) ||
+      blkIsWriteProtected(cbdp->config->bdp)) {
+    osalMutexUnlock(&cbdp->mutex);
+    return HAL_FAILED;
+  }
+
+  cbdp->state = BLK_WRITING;
+  if (n >= (uint32_t)BLKCACHE_CFG_BYPASS_THRESHOLD) {
+    /* Large transfer, writing on the device then updating the blocks
+       that are in cache, those are clean now.*/
+    err = blkWrite(cbdp->config->bdp, startblk, buffer, n);
+    if (!err) {
+      cbdp->stats.writes++;
+      cbdp->stats.blocks_written += n;
+      for (i = 0U; i < (unsigned)BLKCACHE_CFG_NUM_BUFFERS; i++) {
+        blkcache_buffer_t *bp = &cbdp->buffers[i];
+
+        if (((bp->obj.obj_flags & BLKCACHE_VALID_FLAGS) == BLKCACHE_VALID_FLAGS) &&
+            (bp->obj.obj_key - startblk < n)) {
+          memcpy(bp->data,
+                 &buffer[(bp->obj.obj_key - startblk) * cbdp->blk_size],
+                 cbdp->blk_size);
+          bp->obj.obj_flags &= ~OC_FLAG_LAZYWRITE;
+        }
+      }
+    }
+  }
+  else {
+    /* Blocks are written in cache and marked dirty, there is no need to
+       read them before.*/
+    while (n > 0U) {
+      oc_object_t *objp = chCacheGetObject(&cbdp->cache,
+                                           BLKCACHE_GROUP, startblk);
+
+      memcpy(((blkcache_buffer_t *)objp)->data, buffer, cbdp->blk_size);
+      objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+      objp->obj_flags |= OC_FLAG_LAZYWRITE;
+      chCacheReleaseObject(&cbdp->cache, objp);
+
+      buffer += cbdp->blk_size;
+      startblk++;
+      n--;
+    }
+  }
+  cbdp->state = BLK_READY;
+
+  osalMutexUnlock(&cbdp->mutex);
+
+  return err;
+}
+
+static bool blkcache_sync(void *instance) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)instance;
+  bool err;
+
+  osalMutexLock(&cbdp->mutex);
+
+  if (cbdp->state != BLK_READY) {
+    osalMutexUnlock(&cbdp->mutex);
+    return HAL_FAILED;
+  }
+
+  cbdp->state = BLK_SYNCING;
+  err = blkcache_flush(cbdp);
+  if (!err) {
+    err = blkSync(cbdp->config->bdp);
+  }
+  cbdp->state = BLK_READY;
+
+  osalMutexUnlock(&cbdp->mutex);
+
+  return err;
+}
+
+static bool blkcache_get_info(void *instance, BlockDeviceInfo *bdip) {
+  CachedBlockDevice *cbdp = (CachedBlockDevice *)instance;
+
+  if (cbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  bdip->blk_size = cbdp->blk_size;
+  bdip->blk_num  = cbdp->blk_num;
+
+  return HAL_SUCCESS;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] cbdp     pointer to the @p CachedBlockDevice object
+ *
+ * @init
+ */
+void blkcacheObjectInit(CachedBlockDevice *cbdp) {
+
+  cbdp->vmt      = &blkcache_vmt;
+  cbdp->state    = BLK_STOP;
+  cbdp->config   = NULL;
+  cbdp->blk_size = 0U;
+  cbdp->blk_num  = 0U;
+  cbdp->error    = false;
+  osalMutexObjectInit(&cbdp->mutex);
+  blkcacheResetStats(cbdp);
+}
+
+/**
+ * @brief   Configures and activates the cached block device.
+ * @details The device is left in the @p BLK_ACTIVE state, the cached
+ *          device is connected when the cached block device is connected.
+ * @note    The cached device must not be accessed directly while the
+ *          cached block device is connected.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ * @param[in] config    pointer to the @p CachedBlockConfig object
+ *
+ * @api
+ */
+void blkcacheStart(CachedBlockDevice *cbdp, const CachedBlockConfig *config) {
+
+  osalDbgCheck((cbdp != NULL) && (config != NULL) && (config->bdp != NULL));
+  osalDbgAssert((cbdp->state == BLK_STOP) || (cbdp->state == BLK_ACTIVE),
+                "invalid state");
+
+  cbdp->config = config;
+  cbdp->state  = BLK_ACTIVE;
+  blkcacheResetStats(cbdp);
+}
+
+/**
+ * @brief   Deactivates the cached block device.
+ * @pre     The device must be disconnected, disconnecting writes the
+ *          dirty blocks.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ *
+ * @api
+ */
+void blkcacheStop(CachedBlockDevice *cbdp) {
+
+  osalDbgCheck(cbdp != NULL);
+  osalDbgAssert((cbdp->state == BLK_STOP) || (cbdp->state == BLK_ACTIVE),
+                "invalid state");
+
+  cbdp->config = NULL;
+  cbdp->state  = BLK_STOP;
+}
+
+/**
+ * @brief   Clears the cache statistics.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ *
+ * @api
+ */
+void blkcacheResetStats(CachedBlockDevice *cbdp) {
+
+  memset(&cbdp->stats, 0, sizeof (cbdp->stats));
+}
+
+/** @} */
@@ -0,0 +1,252 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkcache.h
+ * @brief   Cached block device header.
+ *
+ * @addtogroup BLKCACHE
+ * @{
+ */
+
+#ifndef BLKCACHE_H
+#define BLKCACHE_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of cached blocks.
+ */
+#if !defined(BLKCACHE_CFG_NUM_BUFFERS) || defined(__DOXYGEN__)
+#define BLKCACHE_CFG_NUM_BUFFERS            16
+#endif
+
+/**
+ * @brief   Number of hash table entries.
+ * @note    Must be a power of two not lower than
+ *          @p BLKCACHE_CFG_NUM_BUFFERS.
+ */
+#if !defined(BLKCACHE_CFG_HASH_SIZE) || defined(__DOXYGEN__)
+#define BLKCACHE_CFG_HASH_SIZE              32
+#endif
+
+/**
+ * @brief   Size of the cache buffers.
+ * @note    Devices with blocks larger than this value cannot be cached.
+ */
+#if !defined(BLKCACHE_CFG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define BLKCACHE_CFG_BUFFER_SIZE            512
+#endif
+
+/**
+ * @brief   Maximum number of dirty blocks written in a single operation.
+ * @details Adjacent dirty blocks are coalesced in a staging buffer and
+ *          written to the device using a single multi-block write.
+ */
+#if !defined(BLKCACHE_CFG_MAX_COALESCED) || defined(__DOXYGEN__)
+#define BLKCACHE_CFG_MAX_COALESCED          8
+#endif
+
+/**
+ * @brief   Size of transfers bypassing the cache.
+ * @details Transfers of this number of blocks or more are performed
+ *          directly on the device, this prevents bulk data from evicting
+ *          the cached metadata blocks.
+ */
+#if !defined(BLKCACHE_CFG_BYPASS_THRESHOLD) || defined(__DOXYGEN__)
+#define BLKCACHE_CFG_BYPASS_THRESHOLD       2
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_OBJ_CACHES != TRUE
+#error "BLKCACHE requires CH_CFG_USE_OBJ_CACHES"
+#endif
+
+#if (BLKCACHE_CFG_HASH_SIZE & (BLKCACHE_CFG_HASH_SIZE - 1)) != 0
+#error "BLKCACHE_CFG_HASH_SIZE is not a power of two"
+#endif
+
+#if BLKCACHE_CFG_HASH_SIZE < BLKCACHE_CFG_NUM_BUFFERS
+#error "BLKCACHE_CFG_HASH_SIZE lower than BLKCACHE_CFG_NUM_BUFFERS"
+#endif
+
+#if (BLKCACHE_CFG_BUFFER_SIZE < 16) ||                                      \
+    ((BLKCACHE_CFG_BUFFER_SIZE & (BLKCACHE_CFG_BUFFER_SIZE - 1)) != 0)
+#error "invalid BLKCACHE_CFG_BUFFER_SIZE value"
+#endif
+
+#if (BLKCACHE_CFG_MAX_COALESCED < 1) ||                                     \
+    (BLKCACHE_CFG_MAX_COALESCED >= BLKCACHE_CFG_NUM_BUFFERS)
+#error "invalid BLKCACHE_CFG_MAX_COALESCED value"
+#endif
+
+#if BLKCACHE_CFG_BYPASS_THRESHOLD < 2
+#error "invalid BLKCACHE_CFG_BYPASS_THRESHOLD value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Cached block device configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Cached block device.
+   */
+  BaseBlockDevice           *bdp;
+} CachedBlockConfig;
+
+/**
+ * @brief   Cached block device statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Blocks found in cache.
+   */
+  uint32_t                  hits;
+  /**
+   * @brief   Blocks read from the device.
+   */
+  uint32_t                  misses;
+  /**
+   * @brief   Dirty blocks written because evicted from the cache.
+   */
+  uint32_t                  evictions;
+  /**
+   * @brief   Write operations performed on the device.
+   */
+  uint32_t                  writes;
+  /**
+   * @brief   Blocks written on the device.
+   */
+  uint32_t                  blocks_written;
+} blkcache_stats_t;
+
+/**
+ * @brief   Cache buffer type.
+ */
+typedef struct {
+  /**
+   * @brief   Cached object header.
+   */
+  oc_object_t               obj;
+  /**
+   * @brief   Block data.
+   */
+  uint8_t                   data[BLKCACHE_CFG_BUFFER_SIZE];
+} blkcache_buffer_t;
+
+/**
+ * @brief   @p CachedBlockDevice specific methods.
+ */
+#define _cached_block_device_methods                                        \
+  _base_block_device_methods
+
+/**
+ * @brief   @p CachedBlockDevice specific data.
+ */
+#define _cached_block_device_data                                           \
+  _base_block_device_data                                                   \
+  /* Current configuration data.*/                                          \
+  const CachedBlockConfig   *config;                                        \
+  /* Mutex protecting the device and the cache.*/                           \
+  mutex_t                   mutex;                                          \
+  /* Block size of the connected device.*/                                  \
+  uint32_t                  blk_size;                                       \
+  /* Number of blocks of the connected device.*/                            \
+  uint32_t                  blk_num;                                        \
+  /* A dirty block has been lost because of a write error.*/                \
+  bool                      error;                                          \
+  /* Cache statistics.*/                                                    \
+  blkcache_stats_t          stats;                                          \
+  /* Objects cache.*/                                                       \
+  objects_cache_t           cache;                                          \
+  /* Hash table.*/                                                          \
+  oc_hash_header_t          hash[BLKCACHE_CFG_HASH_SIZE];                   \
+  /* Cache buffers.*/                                                       \
+  blkcache_buffer_t         buffers[BLKCACHE_CFG_NUM_BUFFERS];              \
+  /* Staging buffer for coalesced writes.*/                                 \
+  uint8_t                   wbuf[BLKCACHE_CFG_MAX_COALESCED *               \
+                                 BLKCACHE_CFG_BUFFER_SIZE];
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p CachedBlockDevice virtual methods table.
+ */
+struct CachedBlockDeviceVMT {
+  _cached_block_device_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Write-back cache decorator of a block device.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct CachedBlockDeviceVMT *vmt;
+  _cached_block_device_data
+} CachedBlockDevice;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the cache statistics.
+ *
+ * @param[in] cbdp      pointer to the @p CachedBlockDevice object
+ * @return              A pointer to the @p blkcache_stats_t structure.
+ *
+ * @xclass
+ */
+#define blkcacheGetStatsX(cbdp) (&(cbdp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void blkcacheObjectInit(CachedBlockDevice *cbdp);
+  void blkcacheStart(CachedBlockDevice *cbdp, const CachedBlockConfig *config);
+  void blkcacheStop(CachedBlockDevice *cbdp);
+  void blkcacheResetStats(CachedBlockDevice *cbdp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLKCACHE_H */
+
+/** @} */
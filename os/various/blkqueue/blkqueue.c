@@ -0,0 +1,699 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkqueue.c
+ * @brief   Queued block device code.
+ * @details The queued block device serializes the accesses to another
+ *          block device through a dispatcher thread. Requests can be
+ *          submitted asynchronously by any number of threads, completion
+ *          is notified by callbacks or waited explicitly. The
+ *          @p BaseBlockDevice interface is also implemented, each operation
+ *          is a request waited by the invoking thread.<br>
+ *          Pending requests are served in ascending blocks order starting
+ *          from the last transferred block then wrapping around (C-SCAN),
+ *          adjacent requests of the same kind are merged in a single
+ *          multi-block transfer.<br>
+ *          Requests overlapping a pending request, when at least one of
+ *          them is a write, and synchronizations are served after all the
+ *          requests submitted before them, the results are the same of a
+ *          sequential execution in submission order.
+ * @note    Submitting is performed in a critical section whose length is
+ *          proportional to the number of pending requests.
+ *
+ * @addtogroup BLKQUEUE
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "blkqueue.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static bool blkq_is_inserted(void *instance);
+static bool blkq_is_protected(void *instance);
+static bool blkq_connect(void *instance);
+static bool blkq_disconnect(void *instance);
+static bool blkq_read(void *instance, uint32_t startblk,
+                      uint8_t *buffer, uint32_t n);
+static bool blkq_write(void *instance, uint32_t startblk,
+                       const uint8_t *buffer, uint32_t n);
+static bool blkq_sync(void *instance);
+static bool blkq_get_info(void *instance, BlockDeviceInfo *bdip);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct QueuedBlockDeviceVMT blkq_vmt = {
+  (size_t)0,
+  blkq_is_inserted,
+  blkq_is_protected,
+  blkq_connect,
+  blkq_disconnect,
+  blkq_read,
+  blkq_write,
+  blkq_sync,
+  blkq_get_info
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Checks the range of a request.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[in] rp        pointer to the @p blkq_request_t object
+ * @return              The request validity.
+ *
+ * @notapi
+ */
+static bool blkq_is_valid(QueuedBlockDevice *qbdp, blkq_request_t *rp) {
+
+  return (rp->n > 0U) && (rp->n <= qbdp->blk_num) &&
+         (rp->startblk <= qbdp->blk_num - rp->n);
+}
+
+/**
+ * @brief   Checks if a request must be ordered after a pending request.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[in] rp        pointer to the @p blkq_request_t object
+ * @return              The conflict state.
+ * @retval true         if the request overlaps a pending request and at
+ *                      least one of them is a write.
+ *
+ * @notapi
+ */
+static bool blkq_conflicts(QueuedBlockDevice *qbdp, blkq_request_t *rp) {
+  blkq_request_t *prp = qbdp->pending;
+
+  while (prp != NULL) {
+    if (((rp->op == BLKQ_OP_WRITE) || (prp->op == BLKQ_OP_WRITE)) &&
+        ((rp->startblk - prp->startblk < prp->n) ||
+         (prp->startblk - rp->startblk < rp->n))) {
+      return true;
+    }
+    prp = prp->next;
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Inserts a request in the pending list.
+ * @note    Requests with the same starting block are kept in submission
+ *          order.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[in] rp        pointer to the @p blkq_request_t object
+ *
+ * @notapi
+ */
+static void blkq_insert_pending(QueuedBlockDevice *qbdp, blkq_request_t *rp) {
+  blkq_request_t **rpp = &qbdp->pending;
+
+  while ((*rpp != NULL) && ((*rpp)->startblk <= rp->startblk)) {
+    rpp = &(*rpp)->next;
+  }
+  rp->next = *rpp;
+  *rpp = rp;
+}
+
+/**
+ * @brief   Moves deferred requests in the pending list.
+ * @details The first deferred request is moved, the following ones are
+ *          moved until a synchronization or a conflicting request is
+ *          found.
+ * @note    Must be invoked with an empty pending list.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ *
+ * @notapi
+ */
+static void blkq_promote(QueuedBlockDevice *qbdp) {
+  blkq_request_t *rp = qbdp->deferred;
+
+  while (rp != NULL) {
+    qbdp->deferred = rp->next;
+    blkq_insert_pending(qbdp, rp);
+    if (rp->op == BLKQ_OP_SYNC) {
+      break;
+    }
+    rp = qbdp->deferred;
+    if ((rp != NULL) &&
+        ((rp->op == BLKQ_OP_SYNC) || blkq_conflicts(qbdp, rp))) {
+      break;
+    }
+  }
+  if (qbdp->deferred == NULL) {
+    qbdp->deferred_last = NULL;
+  }
+}
+
+/**
+ * @brief   Fetches the next requests to be served.
+ * @details The first pending request at or after the last transferred block
+ *          is fetched, if there are none then the first pending request.
+ *          Following adjacent requests of the same kind are fetched too.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[out] batch    array of fetched requests
+ * @return              The number of fetched requests.
+ *
+ * @notapi
+ */
+static unsigned blkq_fetch(QueuedBlockDevice *qbdp, blkq_request_t **batch) {
+  blkq_request_t **rpp, *rp;
+  unsigned n;
+  uint32_t blocks;
+
+  if (qbdp->pending == NULL) {
+    blkq_promote(qbdp);
+    if (qbdp->pending == NULL) {
+      return 0U;
+    }
+  }
+
+  rpp = &qbdp->pending;
+  while ((*rpp != NULL) && ((*rpp)->startblk < qbdp->head)) {
+    rpp = &(*rpp)->next;
+  }
+  if (*rpp == NULL) {
+    rpp = &qbdp->pending;
+  }
+
+  rp       = *rpp;
+  *rpp     = rp->next;
+  batch[0] = rp;
+  n        = 1U;
+  if (rp->op == BLKQ_OP_SYNC) {
+    return n;
+  }
+
+  /* Merging the following adjacent requests, if possible.*/
+  blocks = rp->n;
+  if ((qbdp->blk_size <= (uint32_t)BLKQ_CFG_BUFFER_SIZE) &&
+      (blocks < (uint32_t)BLKQ_CFG_MAX_MERGED_BLOCKS) &&
+      blkq_is_valid(qbdp, rp)) {
+    while ((n < (unsigned)BLKQ_CFG_MAX_MERGED_REQUESTS) && (*rpp != NULL) &&
+           ((*rpp)->op == rp->op) &&
+           ((*rpp)->startblk == rp->startblk + rp->n) &&
+           blkq_is_valid(qbdp, *rpp) &&
+           ((*rpp)->n <= (uint32_t)BLKQ_CFG_MAX_MERGED_BLOCKS - blocks)) {
+      rp          = *rpp;
+      *rpp        = rp->next;
+      batch[n++]  = rp;
+      blocks     += rp->n;
+      qbdp->stats.merged++;
+    }
+  }
+  qbdp->head = rp->startblk + rp->n;
+
+  return n;
+}
+
+/**
+ * @brief   Performs a transfer.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[in] batch     array of fetched requests
+ * @param[in] n         number of fetched requests
+ * @return              The transfer result.
+ * @retval MSG_OK       if the transfer succeeded.
+ * @retval MSG_RESET    if the transfer failed or the device is not
+ *                      connected.
+ *
+ * @notapi
+ */
+static msg_t blkq_execute(QueuedBlockDevice *qbdp,
+                          blkq_request_t **batch, unsigned n) {
+  BaseBlockDevice *bdp = qbdp->config->bdp;
+  blkq_request_t *rp = batch[0];
+  uint32_t startblk = rp->startblk;
+  uint32_t blocks;
+  uint8_t *buffer;
+  bool direct, err;
+  unsigned i;
+
+  if (qbdp->state != BLK_READY) {
+    return MSG_RESET;
+  }
+
+  if (rp->op == BLKQ_OP_SYNC) {
+    qbdp->stats.transfers++;
+    return blkSync(bdp) ? MSG_RESET : MSG_OK;
+  }
+
+  if (!blkq_is_valid(qbdp, rp)) {
+    return MSG_RESET;
+  }
+
+  /* Counting the blocks, if the buffers are contiguous then the staging
+     buffer is not required.*/
+  blocks = rp->n;
+  direct = true;
+  for (i = 1U; i < n; i++) {
+    if (batch[i]->buffer !=
+        batch[i - 1U]->buffer + (batch[i - 1U]->n * qbdp->blk_size)) {
+      direct = false;
+    }
+    blocks += batch[i]->n;
+  }
+
+  if (direct) {
+    buffer = rp->buffer;
+  }
+  else {
+    buffer = qbdp->buffer;
+    if (rp->op == BLKQ_OP_WRITE) {
+      for (i = 0U; i < n; i++) {
+        memcpy(buffer, batch[i]->buffer, batch[i]->n * qbdp->blk_size);
+        buffer += batch[i]->n * qbdp->blk_size;
+      }
+      buffer = qbdp->buffer;
+    }
+  }
+
+  qbdp->stats.transfers++;
+  if (rp->op == BLKQ_OP_WRITE) {
+    err = blkWrite(bdp, startblk, buffer, blocks);
+  }
+  else {
+    err = blkRead(bdp, startblk, buffer, blocks);
+    if (!err && !direct) {
+      for (i = 0U; i < n; i++) {
+        memcpy(batch[i]->buffer, buffer, batch[i]->n * qbdp->blk_size);
+        buffer += batch[i]->n * qbdp->blk_size;
+      }
+    }
+  }
+
+  return err ? MSG_RESET : MSG_OK;
+}
+
+/**
+ * @brief   Dispatcher thread.
+ *
+ * @param[in] arg       pointer to the @p QueuedBlockDevice object
+ */
+static THD_FUNCTION(blkq_dispatcher, arg) {
+  QueuedBlockDevice *qbdp = (QueuedBlockDevice *)arg;
+  blkq_request_t *batch[BLKQ_CFG_MAX_MERGED_REQUESTS];
+  unsigned i, n;
+  msg_t msg;
+
+  chRegSetThreadName("blkqueue");
+
+  while (true) {
+    chSysLock();
+    while ((n = blkq_fetch(qbdp, batch)) == 0U) {
+      if (chThdShouldTerminateX()) {
+        chSysUnlock();
+        return;
+      }
+      (void) chThdSuspendS(&qbdp->idle);
+    }
+    chSysUnlock();
+
+    msg = blkq_execute(qbdp, batch, n);
+
+    /* Completing the requests, the waiting threads are resumed then the
+       callbacks are invoked. Callbacks pointers are fetched before
+       completing because waited requests can be deallocated.*/
+    for (i = 0U; i < n; i++) {
+      blkq_request_t *rp = batch[i];
+      blkq_callback_t callback = rp->callback;
+
+      chSysLock();
+      rp->result = msg;
+      rp->done   = true;
+      chThdResumeI(&rp->tr, msg);
+      chSchRescheduleS();
+      chSysUnlock();
+
+      if (callback != NULL) {
+        callback(rp);
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Performs an operation and waits for completion.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[in] op        the operation
+ * @param[in] startblk  first block
+ * @param[in] buffer    data buffer
+ * @param[in] n         number of blocks
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @notapi
+ */
+static bool blkq_perform(QueuedBlockDevice *qbdp, blkq_op_t op,
+                         uint32_t startblk, uint8_t *buffer, uint32_t n) {
+  blkq_request_t req;
+  msg_t msg;
+
+  blkqRequestObjectInit(&req, op, startblk, buffer, n, NULL, NULL);
+
+  chSysLock();
+  blkqSubmitI(qbdp, &req);
+  msg = blkqWaitS(&req);
+  chSysUnlock();
+
+  return msg == MSG_OK ? HAL_SUCCESS : HAL_FAILED;
+}
+
+static bool blkq_is_inserted(void *instance) {
+  QueuedBlockDevice *qbdp = (QueuedBlockDevice *)instance;
+
+  return blkIsInserted(qbdp->config->bdp);
+}
+
+static bool blkq_is_protected(void *instance) {
+  QueuedBlockDevice *qbdp = (QueuedBlockDevice *)instance;
+
+  return blkIsWriteProtected(qbdp->config->bdp);
+}
+
+static bool blkq_connect(void *instance) {
+  QueuedBlockDevice *qbdp = (QueuedBlockDevice *)instance;
+  BaseBlockDevice *bdp;
+  BlockDeviceInfo bdi;
+
+  osalDbgAssert((qbdp->state == BLK_ACTIVE) || (qbdp->state == BLK_READY),
+                "invalid state");
+
+  if (qbdp->state == BLK_READY) {
+    return HAL_SUCCESS;
+  }
+
+  qbdp->state = BLK_CONNECTING;
+  bdp = qbdp->config->bdp;
+  if (blkConnect(bdp) || blkGetInfo(bdp, &bdi) || (bdi.blk_size == 0U)) {
+    qbdp->state = BLK_ACTIVE;
+    return HAL_FAILED;
+  }
+  qbdp->blk_size = bdi.blk_size;
+  qbdp->blk_num  = bdi.blk_num;
+  qbdp->head     = 0U;
+  qbdp->state    = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool blkq_disconnect(void *instance) {
+  QueuedBlockDevice *qbdp = (QueuedBlockDevice *)instance;
+  bool err;
+
+  osalDbgAssert((qbdp->state == BLK_ACTIVE) || (qbdp->state == BLK_READY),
+                "invalid state");
+
+  if (qbdp->state == BLK_ACTIVE) {
+    return HAL_SUCCESS;
+  }
+
+  /* A synchronization is served after all the previously submitted
+     requests, the queue is empty after it.*/
+  err = blkq_perform(qbdp, BLKQ_OP_SYNC, 0U, NULL, 0U);
+  qbdp->state = BLK_DISCONNECTING;
+  if (blkDisconnect(qbdp->config->bdp)) {
+    err = HAL_FAILED;
+  }
+  qbdp->state = BLK_ACTIVE;
+
+  return err;
+}
+
+static bool blkq_read(void *instance, uint32_t startblk,
+                      uint8_t *buffer, uint32_t n) {
+
+  return blkq_perform((QueuedBlockDevice *)instance, BLKQ_OP_READ,
+                      startblk, buffer, n);
+}
+
+static bool blkq_write(void *instance, uint32_t startblk,
+                       const uint8_t *buffer, uint32_t n) {
+
+  return blkq_perform((QueuedBlockDevice *)instance, BLKQ_OP_WRITE,
+                      startblk, (uint8_t *)buffer, n);
+}
+
+static bool blkq_sync(void *instance) {
+
+  return blkq_perform((QueuedBlockDevice *)instance, BLKQ_OP_SYNC,
+                      0U, NULL, 0U);
+}
+
+static bool blkq_get_info(void *instance, BlockDeviceInfo *bdip) {
+  QueuedBlockDevice *qbdp = (QueuedBlockDevice *)instance;
+
+  if (qbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  bdip->blk_size = qbdp->blk_size;
+  bdip->blk_num  = qbdp->blk_num;
+
+  return HAL_SUCCESS;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] qbdp     pointer to the @p QueuedBlockDevice object
+ *
+ * @init
+ */
+void blkqObjectInit(QueuedBlockDevice *qbdp) {
+
+  qbdp->vmt           = &blkq_vmt;
+  qbdp->state         = BLK_STOP;
+  qbdp->config        = NULL;
+  qbdp->blk_size      = 0U;
+  qbdp->blk_num       = 0U;
+  qbdp->pending       = NULL;
+  qbdp->deferred      = NULL;
+  qbdp->deferred_last = NULL;
+  qbdp->head          = 0U;
+  qbdp->dispatcher    = NULL;
+  qbdp->idle          = NULL;
+  blkqResetStats(qbdp);
+}
+
+/**
+ * @brief   Configures and activates the queued block device.
+ * @details The dispatcher thread is created, the device is left in the
+ *          @p BLK_ACTIVE state, the underlying device is connected when
+ *          the queued block device is connected.
+ * @note    The underlying device must not be accessed directly while the
+ *          queued block device is connected.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[in] config    pointer to the @p QueuedBlockConfig object
+ *
+ * @api
+ */
+void blkqStart(QueuedBlockDevice *qbdp, const QueuedBlockConfig *config) {
+
+  osalDbgCheck((qbdp != NULL) && (config != NULL) && (config->bdp != NULL));
+  osalDbgAssert(qbdp->state == BLK_STOP, "invalid state");
+
+  qbdp->config     = config;
+  qbdp->state      = BLK_ACTIVE;
+  blkqResetStats(qbdp);
+  qbdp->dispatcher = chThdCreateStatic(qbdp->wa, sizeof (qbdp->wa),
+                                       config->prio, blkq_dispatcher,
+                                       (void *)qbdp);
+}
+
+/**
+ * @brief   Deactivates the queued block device.
+ * @details The dispatcher thread is terminated.
+ * @pre     The device must be disconnected, disconnecting serves all the
+ *          submitted requests.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ *
+ * @api
+ */
+void blkqStop(QueuedBlockDevice *qbdp) {
+
+  osalDbgCheck(qbdp != NULL);
+  osalDbgAssert((qbdp->state == BLK_STOP) || (qbdp->state == BLK_ACTIVE),
+                "invalid state");
+
+  if (qbdp->state == BLK_ACTIVE) {
+    chThdTerminate(qbdp->dispatcher);
+    chSysLock();
+    chThdResumeI(&qbdp->idle, MSG_OK);
+    chSchRescheduleS();
+    chSysUnlock();
+    (void) chThdWait(qbdp->dispatcher);
+    qbdp->dispatcher = NULL;
+    qbdp->config     = NULL;
+    qbdp->state      = BLK_STOP;
+  }
+}
+
+/**
+ * @brief   Submits a block request.
+ * @details The request is queued and served asynchronously by the
+ *          dispatcher thread.
+ * @pre     The request must not be already queued.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note
+ *          that interrupt handlers always reschedule on exit so an
+ *          explicit reschedule must not be performed in ISRs.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[in] rp        pointer to the @p blkq_request_t object
+ *
+ * @iclass
+ */
+void blkqSubmitI(QueuedBlockDevice *qbdp, blkq_request_t *rp) {
+
+  chDbgCheckClassI();
+  osalDbgCheck((qbdp != NULL) && (rp != NULL));
+  osalDbgAssert(rp->done, "already queued");
+
+  rp->next   = NULL;
+  rp->tr     = NULL;
+  rp->done   = false;
+  rp->result = MSG_OK;
+  qbdp->stats.requests++;
+
+  /* Requests are deferred if they must be served after the pending ones
+     or if there are already deferred requests.*/
+  if ((qbdp->deferred != NULL) || (rp->op == BLKQ_OP_SYNC) ||
+      blkq_conflicts(qbdp, rp)) {
+    if (qbdp->deferred == NULL) {
+      qbdp->deferred = rp;
+    }
+    else {
+      qbdp->deferred_last->next = rp;
+    }
+    qbdp->deferred_last = rp;
+  }
+  else {
+    blkq_insert_pending(qbdp, rp);
+  }
+
+  chThdResumeI(&qbdp->idle, MSG_OK);
+}
+
+/**
+ * @brief   Submits a block request.
+ * @details The request is queued and served asynchronously by the
+ *          dispatcher thread.
+ * @pre     The request must not be already queued.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @param[in] rp        pointer to the @p blkq_request_t object
+ *
+ * @api
+ */
+void blkqSubmit(QueuedBlockDevice *qbdp, blkq_request_t *rp) {
+
+  chSysLock();
+  blkqSubmitI(qbdp, rp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Waits for a request completion.
+ * @note    Only one thread can wait for a request.
+ *
+ * @param[in] rp        pointer to the @p blkq_request_t object
+ * @return              The request result.
+ * @retval MSG_OK       if the request has been served.
+ * @retval MSG_RESET    if the request failed.
+ *
+ * @sclass
+ */
+msg_t blkqWaitS(blkq_request_t *rp) {
+
+  chDbgCheckClassS();
+  osalDbgCheck(rp != NULL);
+
+  if (!rp->done) {
+    return chThdSuspendS(&rp->tr);
+  }
+
+  return rp->result;
+}
+
+/**
+ * @brief   Waits for a request completion.
+ * @note    Only one thread can wait for a request.
+ *
+ * @param[in] rp        pointer to the @p blkq_request_t object
+ * @return              The request result.
+ * @retval MSG_OK       if the request has been served.
+ * @retval MSG_RESET    if the request failed.
+ *
+ * @api
+ */
+msg_t blkqWait(blkq_request_t *rp) {
+  msg_t msg;
+
+  chSysLock();
+  msg = blkqWaitS(rp);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Clears the queue statistics.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ *
+ * @api
+ */
+void blkqResetStats(QueuedBlockDevice *qbdp) {
+
+  memset(&qbdp->stats, 0, sizeof (qbdp->stats));
+}
+
+/** @} */
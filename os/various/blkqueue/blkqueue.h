@@ -0,0 +1,335 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkqueue.h
+ * @brief   Queued block device header.
+ *
+ * @addtogroup BLKQUEUE
+ * @{
+ */
+
+#ifndef BLKQUEUE_H
+#define BLKQUEUE_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Maximum number of requests merged in a single transfer.
+ */
+#if !defined(BLKQ_CFG_MAX_MERGED_REQUESTS) || defined(__DOXYGEN__)
+#define BLKQ_CFG_MAX_MERGED_REQUESTS        8
+#endif
+
+/**
+ * @brief   Maximum number of blocks of a merged transfer.
+ * @details Merged requests whose buffers are not contiguous in memory are
+ *          transferred through a staging buffer of this number of blocks.
+ */
+#if !defined(BLKQ_CFG_MAX_MERGED_BLOCKS) || defined(__DOXYGEN__)
+#define BLKQ_CFG_MAX_MERGED_BLOCKS          16
+#endif
+
+/**
+ * @brief   Maximum block size of merged transfers.
+ * @note    Requests on devices with larger blocks are never merged.
+ */
+#if !defined(BLKQ_CFG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define BLKQ_CFG_BUFFER_SIZE                512
+#endif
+
+/**
+ * @brief   Stack size of the dispatcher thread.
+ * @note    Completion callbacks are executed on this stack.
+ */
+#if !defined(BLKQ_CFG_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define BLKQ_CFG_THREAD_STACK_SIZE          512
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_WAITEXIT != TRUE
+#error "BLKQUEUE requires CH_CFG_USE_WAITEXIT"
+#endif
+
+#if BLKQ_CFG_MAX_MERGED_REQUESTS < 1
+#error "invalid BLKQ_CFG_MAX_MERGED_REQUESTS value"
+#endif
+
+#if BLKQ_CFG_MAX_MERGED_BLOCKS < 1
+#error "invalid BLKQ_CFG_MAX_MERGED_BLOCKS value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Block requests operations.
+ */
+typedef enum {
+  BLKQ_OP_READ = 0,                 /**< Blocks read.                       */
+  BLKQ_OP_WRITE = 1,                /**< Blocks write.                      */
+  BLKQ_OP_SYNC = 2                  /**< Writes synchronization.            */
+} blkq_op_t;
+
+/**
+ * @brief   Type of a block request.
+ */
+typedef struct blkq_request blkq_request_t;
+
+/**
+ * @brief   Block request completion callback.
+ * @note    The callback is invoked by the dispatcher thread after the
+ *          request has been marked as completed, the request can be
+ *          submitted again from within the callback.
+ *
+ * @param[in] rp        pointer to the completed @p blkq_request_t
+ */
+typedef void (*blkq_callback_t)(blkq_request_t *rp);
+
+/**
+ * @brief   Structure representing a block request.
+ */
+struct blkq_request {
+  /**
+   * @brief   Next request in queue.
+   */
+  blkq_request_t            *next;
+  /**
+   * @brief   Requested operation.
+   */
+  blkq_op_t                 op;
+  /**
+   * @brief   First block.
+   */
+  uint32_t                  startblk;
+  /**
+   * @brief   Number of blocks.
+   */
+  uint32_t                  n;
+  /**
+   * @brief   Data buffer.
+   * @note    The buffer is only read by write operations.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Completion callback or @p NULL.
+   */
+  blkq_callback_t           callback;
+  /**
+   * @brief   Callback argument.
+   */
+  void                      *arg;
+  /**
+   * @brief   Thread waiting for completion.
+   */
+  thread_reference_t        tr;
+  /**
+   * @brief   Request completed.
+   */
+  bool                      done;
+  /**
+   * @brief   Request result.
+   */
+  msg_t                     result;
+};
+
+/**
+ * @brief   Queued block device configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Underlying block device.
+   */
+  BaseBlockDevice           *bdp;
+  /**
+   * @brief   Priority of the dispatcher thread.
+   */
+  tprio_t                   prio;
+} QueuedBlockConfig;
+
+/**
+ * @brief   Queued block device statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Submitted requests.
+   */
+  uint32_t                  requests;
+  /**
+   * @brief   Operations performed on the device.
+   */
+  uint32_t                  transfers;
+  /**
+   * @brief   Requests merged into a preceding request.
+   */
+  uint32_t                  merged;
+} blkq_stats_t;
+
+/**
+ * @brief   @p QueuedBlockDevice specific methods.
+ */
+#define _queued_block_device_methods                                        \
+  _base_block_device_methods
+
+/**
+ * @brief   @p QueuedBlockDevice specific data.
+ */
+#define _queued_block_device_data                                           \
+  _base_block_device_data                                                   \
+  /* Current configuration data.*/                                          \
+  const QueuedBlockConfig   *config;                                        \
+  /* Block size of the connected device.*/                                  \
+  uint32_t                  blk_size;                                       \
+  /* Number of blocks of the connected device.*/                            \
+  uint32_t                  blk_num;                                        \
+  /* Requests ready for dispatch, ordered by block number.*/                \
+  blkq_request_t            *pending;                                       \
+  /* Requests waiting for the pending ones, in submission order.*/          \
+  blkq_request_t            *deferred;                                      \
+  /* Last deferred request.*/                                               \
+  blkq_request_t            *deferred_last;                                 \
+  /* Block following the last transfer.*/                                   \
+  uint32_t                  head;                                           \
+  /* Dispatcher thread.*/                                                   \
+  thread_t                  *dispatcher;                                    \
+  /* Reference to the idle dispatcher thread.*/                             \
+  thread_reference_t        idle;                                           \
+  /* Queue statistics.*/                                                    \
+  blkq_stats_t              stats;                                          \
+  /* Dispatcher thread working area.*/                                      \
+  THD_WORKING_AREA(wa, BLKQ_CFG_THREAD_STACK_SIZE);                         \
+  /* Staging buffer for merged transfers.*/                                 \
+  uint8_t                   buffer[BLKQ_CFG_MAX_MERGED_BLOCKS *             \
+                                   BLKQ_CFG_BUFFER_SIZE];
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p QueuedBlockDevice virtual methods table.
+ */
+struct QueuedBlockDeviceVMT {
+  _queued_block_device_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Block device serving requests through a dispatcher thread.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct QueuedBlockDeviceVMT *vmt;
+  _queued_block_device_data
+} QueuedBlockDevice;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the queue statistics.
+ *
+ * @param[in] qbdp      pointer to the @p QueuedBlockDevice object
+ * @return              A pointer to the @p blkq_stats_t structure.
+ *
+ * @xclass
+ */
+#define blkqGetStatsX(qbdp) (&(qbdp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void blkqObjectInit(QueuedBlockDevice *qbdp);
+  void blkqStart(QueuedBlockDevice *qbdp, const QueuedBlockConfig *config);
+  void blkqStop(QueuedBlockDevice *qbdp);
+  void blkqSubmitI(QueuedBlockDevice *qbdp, blkq_request_t *rp);
+  void blkqSubmit(QueuedBlockDevice *qbdp, blkq_request_t *rp);
+  msg_t blkqWaitS(blkq_request_t *rp);
+  msg_t blkqWait(blkq_request_t *rp);
+  void blkqResetStats(QueuedBlockDevice *qbdp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a block request.
+ *
+ * @param[out] rp       pointer to the @p blkq_request_t object
+ * @param[in] op        the requested operation
+ * @param[in] startblk  first block, ignored by synchronizations
+ * @param[in] buffer    data buffer, ignored by synchronizations
+ * @param[in] n         number of blocks, ignored by synchronizations
+ * @param[in] callback  completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @init
+ */
+static inline void blkqRequestObjectInit(blkq_request_t *rp, blkq_op_t op,
+                                         uint32_t startblk, uint8_t *buffer,
+                                         uint32_t n, blkq_callback_t callback,
+                                         void *arg) {
+
+  rp->next     = NULL;
+  rp->op       = op;
+  rp->startblk = startblk;
+  rp->n        = n;
+  rp->buffer   = buffer;
+  rp->callback = callback;
+  rp->arg      = arg;
+  rp->tr       = NULL;
+  rp->done     = true;
+  rp->result   = MSG_OK;
+}
+
+/**
+ * @brief   Returns @p true if the request has been completed.
+ *
+ * @param[in] rp        pointer to the @p blkq_request_t object
+ * @return              The completion state.
+ *
+ * @xclass
+ */
+static inline bool blkqIsCompletedX(blkq_request_t *rp) {
+
+  return rp->done;
+}
+
+#endif /* BLKQUEUE_H */
+
+/** @} */
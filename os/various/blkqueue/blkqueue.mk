@@ -0,0 +1,8 @@
+# Queued block device files.
+BLKQUEUESRC = $(CHIBIOS)/os/various/blkqueue/blkqueue.c
+
+BLKQUEUEINC = $(CHIBIOS)/os/various/blkqueue
+
+# Shared variables
+ALLCSRC += $(BLKQUEUESRC)
+ALLINC  += $(BLKQUEUEINC)
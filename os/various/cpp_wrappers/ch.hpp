@@ -789,6 +789,22 @@ namespace chibios_rt {
 
       chMsgRelease(tp, msg);
     }
+
+    /**
+     * @brief   Releases the message with a reply and waits for the next one.
+     * @post    The reference is set to @p nullptr.
+     *
+     * @param[in] msg           the answer message
+     * @return                  The next sender thread reference.
+     *
+     * @api
+     */
+    ThreadReference releaseMessageWait(msg_t msg) {
+      thread_t *tp = thread_ref;
+      thread_ref = nullptr;
+
+      return ThreadReference(chMsgReleaseWait(tp, msg));
+    }
 #endif /* CH_CFG_USE_MESSAGES == TRUE */
 
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
@@ -1973,6 +1989,22 @@ namespace chibios_rt {
       chMtxObjectInit(&mutex);
     }
 
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+    /**
+     * @brief   Ceiling mutex object constructor.
+     * @details The embedded @p mutex_t structure is initialized as a
+     *          priority ceiling mutex.
+     *
+     * @param[in] ceiling   the priority ceiling
+     *
+     * @init
+     */
+    Mutex(tprio_t ceiling) {
+
+      chMtxObjectInitCeiling(&mutex, ceiling);
+    }
+#endif
+
     /**
      * @brief   Tries to lock a mutex.
      * @details This function attempts to lock a mutex, if the mutex is already
@@ -2301,6 +2333,269 @@ namespace chibios_rt {
   };
 
 #endif /* CH_CFG_USE_CONDVARS == TRUE */
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::RWLock                                                     *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class encapsulating a reader-writer lock.
+   */
+  class RWLock : public SynchronizationObject {
+    /**
+     * @brief   Embedded @p rwlock_t structure.
+     */
+    rwlock_t rwlock;
+
+  public:
+    /**
+     * @brief   RWLock object constructor.
+     * @details The embedded @p rwlock_t structure is initialized.
+     *
+     * @init
+     */
+    RWLock(void) {
+
+      chRwlObjectInit(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock for read access.
+     *
+     * @api
+     */
+    void readLock(void) {
+
+      chRwlReadLock(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock for read access.
+     *
+     * @sclass
+     */
+    void readLockS(void) {
+
+      chRwlReadLockS(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock for read access with timeout specification.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              A message specifying the operation result.
+     * @retval MSG_OK       if the lock has been acquired.
+     * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+     *                      specified timeout.
+     *
+     * @api
+     */
+    msg_t readLock(sysinterval_t timeout) {
+
+      return chRwlReadLockTimeout(&rwlock, timeout);
+    }
+
+    /**
+     * @brief   Acquires the lock for read access with timeout specification.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              A message specifying the operation result.
+     * @retval MSG_OK       if the lock has been acquired.
+     * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+     *                      specified timeout.
+     *
+     * @sclass
+     */
+    msg_t readLockS(sysinterval_t timeout) {
+
+      return chRwlReadLockTimeoutS(&rwlock, timeout);
+    }
+
+    /**
+     * @brief   Tries to acquire the lock for read access.
+     *
+     * @return              The operation status.
+     * @retval true         if the lock has been successfully acquired
+     * @retval false        if the lock attempt failed.
+     *
+     * @api
+     */
+    bool tryReadLock(void) {
+
+      return chRwlTryReadLock(&rwlock);
+    }
+
+    /**
+     * @brief   Releases the lock held for read access.
+     *
+     * @api
+     */
+    void readUnlock(void) {
+
+      chRwlReadUnlock(&rwlock);
+    }
+
+    /**
+     * @brief   Releases the lock held for read access.
+     * @post    This function does not reschedule so a call to a rescheduling
+     *          function must be performed before unlocking the kernel.
+     *
+     * @sclass
+     */
+    void readUnlockS(void) {
+
+      chRwlReadUnlockS(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock for write access.
+     *
+     * @api
+     */
+    void writeLock(void) {
+
+      chRwlWriteLock(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock for write access.
+     *
+     * @sclass
+     */
+    void writeLockS(void) {
+
+      chRwlWriteLockS(&rwlock);
+    }
+
+    /**
+     * @brief   Acquires the lock for write access with timeout specification.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              A message specifying the operation result.
+     * @retval MSG_OK       if the lock has been acquired.
+     * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+     *                      specified timeout.
+     *
+     * @api
+     */
+    msg_t writeLock(sysinterval_t timeout) {
+
+      return chRwlWriteLockTimeout(&rwlock, timeout);
+    }
+
+    /**
+     * @brief   Acquires the lock for write access with timeout specification.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              A message specifying the operation result.
+     * @retval MSG_OK       if the lock has been acquired.
+     * @retval MSG_TIMEOUT  if the lock has not been acquired within the
+     *                      specified timeout.
+     *
+     * @sclass
+     */
+    msg_t writeLockS(sysinterval_t timeout) {
+
+      return chRwlWriteLockTimeoutS(&rwlock, timeout);
+    }
+
+    /**
+     * @brief   Tries to acquire the lock for write access.
+     *
+     * @return              The operation status.
+     * @retval true         if the lock has been successfully acquired
+     * @retval false        if the lock attempt failed.
+     *
+     * @api
+     */
+    bool tryWriteLock(void) {
+
+      return chRwlTryWriteLock(&rwlock);
+    }
+
+    /**
+     * @brief   Releases the lock held for write access.
+     *
+     * @api
+     */
+    void writeUnlock(void) {
+
+      chRwlWriteUnlock(&rwlock);
+    }
+
+    /**
+     * @brief   Releases the lock held for write access.
+     * @post    This function does not reschedule so a call to a rescheduling
+     *          function must be performed before unlocking the kernel.
+     *
+     * @sclass
+     */
+    void writeUnlockS(void) {
+
+      chRwlWriteUnlockS(&rwlock);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ReadLocker                                                 *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   RAII helper for read access to reader-writer locks.
+   */
+  class ReadLocker
+  {
+    RWLock& rwlock;
+
+  public:
+      ReadLocker(RWLock& l) : rwlock(l) {
+
+        rwlock.readLock();
+      }
+
+      ~ReadLocker() {
+
+        rwlock.readUnlock();
+      }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::WriteLocker                                                *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   RAII helper for write access to reader-writer locks.
+   */
+  class WriteLocker
+  {
+    RWLock& rwlock;
+
+  public:
+      WriteLocker(RWLock& l) : rwlock(l) {
+
+        rwlock.writeLock();
+      }
+
+      ~WriteLocker() {
+
+        rwlock.writeUnlock();
+      }
+  };
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
@@ -2983,6 +3278,106 @@ namespace chibios_rt {
    };
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::RecycledThreadsPool                                        *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a pool of recycled threads.
+   * @details The workers are created once and then parked, starting a
+   *          thread object on the pool executes its @p main() function on
+   *          a parked worker instead of creating a new thread.
+   */
+  template<size_t S, size_t N, const char *C>
+  class RecycledThreadsPool {
+    THD_WORKING_AREA(working_areas, S)[N];
+
+  public:
+    /**
+     * @brief   Embedded @p threads_pool_t structure.
+     */
+    threads_pool_t pool;
+
+    /**
+     * @brief   RecycledThreadsPool constructor.
+     *
+     * @init
+     */
+    RecycledThreadsPool(void) {
+
+      chThdPoolObjectInit(&pool, C);
+    }
+
+    /**
+     * @brief   Creates the workers of the pool.
+     *
+     * @param[in] prio          initial priority of the workers
+     *
+     * @api
+     */
+    void addWorkers(tprio_t prio) {
+
+      uint8_t *wsp = (uint8_t *)working_areas;
+
+      for (size_t i = 0; i < N; i++) {
+        (void) chThdPoolAddStatic(&pool, wsp, THD_WORKING_AREA_SIZE(S), prio);
+        wsp += THD_WORKING_AREA_SIZE(S);
+      }
+    }
+
+    /**
+     * @brief   Runs a thread object on a parked worker.
+     * @details The invoking thread waits until a worker is available.
+     *
+     * @param[in] tp            pointer to the thread object
+     * @param[in] prio          priority of the worker while executing
+     *
+     * @api
+     */
+    void start(BaseThread *tp, tprio_t prio) {
+      void _thd_start(void *arg);
+
+      chThdPoolStart(&pool, prio, _thd_start, (void *)tp);
+    }
+
+    /**
+     * @brief   Runs a thread object on a parked worker.
+     * @details If there are no parked workers then the invoking thread waits
+     *          until one becomes available or the specified timeout expires.
+     *
+     * @param[in] tp            pointer to the thread object
+     * @param[in] prio          priority of the worker while executing
+     * @param[in] timeout       the number of ticks before the operation
+     *                          timeouts
+     * @return                  The operation status.
+     *
+     * @api
+     */
+    msg_t startTimeout(BaseThread *tp, tprio_t prio, sysinterval_t timeout) {
+      void _thd_start(void *arg);
+
+      return chThdPoolStartTimeout(&pool, prio, _thd_start, (void *)tp,
+                                   timeout);
+    }
+
+    /**
+     * @brief   Runs a thread object on a parked worker.
+     *
+     * @param[in] tp            pointer to the thread object
+     * @param[in] prio          priority of the worker while executing
+     * @return                  The operation status.
+     * @retval MSG_TIMEOUT      if there are no parked workers.
+     *
+     * @iclass
+     */
+    msg_t startI(BaseThread *tp, tprio_t prio) {
+      void _thd_start(void *arg);
+
+      return chThdPoolStartI(&pool, prio, _thd_start, (void *)tp);
+    }
+  };
+#endif /* CH_CFG_USE_THREADS_POOLS == TRUE */
+
 #if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
   /*------------------------------------------------------------------------*
    * chibios_rt::Heap                                                       *
@@ -3060,6 +3455,357 @@ namespace chibios_rt {
   };
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
+#if (CH_CFG_USE_DELEGATES == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::DelegateArgs                                               *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Arguments of a typed delegate call.
+   * @details The arguments are stored in a recursive structure, the
+   *          function call is expanded at compile time.
+   * @note    Not meant to be used directly.
+   *
+   * @param Ts              types of the function parameters
+   */
+  template <typename... Ts>
+  struct DelegateArgs;
+
+  template <>
+  struct DelegateArgs<> {
+    /**
+     * @brief   Calls the function with the collected arguments.
+     */
+    template <typename R, typename F, typename... Vs>
+    R apply(F func, Vs &... vs) {
+
+      return func(vs...);
+    }
+  };
+
+  template <typename T, typename... Ts>
+  struct DelegateArgs<T, Ts...> {
+    /**
+     * @brief   First argument.
+     */
+    T                       head;
+    /**
+     * @brief   Remaining arguments.
+     */
+    DelegateArgs<Ts...>     tail;
+
+    /**
+     * @brief   Arguments constructor.
+     */
+    template <typename U, typename... Us>
+    DelegateArgs(U &&h, Us &&... t) : head(h), tail(t...) {
+
+    }
+
+    /**
+     * @brief   Calls the function appending this argument to the list.
+     */
+    template <typename R, typename F, typename... Vs>
+    R apply(F func, Vs &... vs) {
+
+      return tail.template apply<R>(func, vs..., head);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::DelegateCall                                               *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Typed delegate call.
+   * @details The call object lives on the caller stack, the delegate thread
+   *          receives a pointer to it.
+   * @note    Not meant to be used directly.
+   *
+   * @param R               type of the function return value
+   * @param Ps              types of the function parameters
+   */
+  template <typename R, typename... Ps>
+  struct DelegateCall {
+    /**
+     * @brief   Function to be called.
+     */
+    R                       (*func)(Ps...);
+    /**
+     * @brief   Function arguments.
+     */
+    DelegateArgs<Ps...>     args;
+    /**
+     * @brief   Function return value.
+     */
+    R                       result;
+
+    /**
+     * @brief   Call constructor.
+     */
+    template <typename... As>
+    DelegateCall(R (*f)(Ps...), As &&... as) : func(f), args(as...) {
+
+    }
+
+    /**
+     * @brief   Veneer executed by the delegate thread.
+     */
+    static msg_t veneer(void *argsp) {
+      DelegateCall *dcp = static_cast<DelegateCall *>(argsp);
+
+      dcp->result = dcp->args.template apply<R>(dcp->func);
+
+      return MSG_OK;
+    }
+
+    /**
+     * @brief   Returns the function return value.
+     */
+    R get(void) {
+
+      return result;
+    }
+  };
+
+  template <typename... Ps>
+  struct DelegateCall<void, Ps...> {
+    void                    (*func)(Ps...);
+    DelegateArgs<Ps...>     args;
+
+    template <typename... As>
+    DelegateCall(void (*f)(Ps...), As &&... as) : func(f), args(as...) {
+
+    }
+
+    static msg_t veneer(void *argsp) {
+      DelegateCall *dcp = static_cast<DelegateCall *>(argsp);
+
+      dcp->args.template apply<void>(dcp->func);
+
+      return MSG_OK;
+    }
+
+    void get(void) {
+
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::Delegates                                                  *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class encapsulating the synchronous delegate calls.
+   */
+  class Delegates {
+  public:
+    /**
+     * @brief   Calls a function on a delegate thread.
+     * @details The arguments marshalling is generated at compile time, the
+     *          function can have any number and type of parameters and
+     *          return value.
+     * @note    The thread must be executing @p dispatch() in order to have
+     *          the functions called.
+     *
+     * @param[in] tp        pointer to the delegate thread
+     * @param[in] func      pointer to the function to be called
+     * @param[in] as        the function arguments
+     * @return              The function return value.
+     *
+     * @api
+     */
+    template <typename R, typename... Ps, typename... As>
+    static R call(thread_t *tp, R (*func)(Ps...), As &&... as) {
+      DelegateCall<R, Ps...> dc(func, as...);
+
+      (void) chDelegateCall(tp, DelegateCall<R, Ps...>::veneer, (void *)&dc);
+
+      return dc.get();
+    }
+
+    /**
+     * @brief   Call messages dispatching.
+     *
+     * @api
+     */
+    static void dispatch(void) {
+
+      chDelegateDispatch();
+    }
+
+    /**
+     * @brief   Call messages dispatching with timeout.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The function outcome.
+     * @retval MSG_OK       if a function has been called.
+     * @retval MSG_TIMEOUT  if a timeout occurred.
+     *
+     * @api
+     */
+    static msg_t dispatch(sysinterval_t timeout) {
+
+      return chDelegateDispatchTimeout(timeout);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::DelegateQueue                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a delegate calls queue and its
+   *          calls buffer.
+   * @details Asynchronous calls take an object pointer, the function or
+   *          method to be called is a template parameter so the veneer is
+   *          generated at compile time and nothing else is stored in the
+   *          queue.
+   *
+   * @param N               number of call slots in the queue
+   */
+  template <size_t N>
+  class DelegateQueue {
+    /**
+     * @brief   Embedded @p delegate_queue_t structure.
+     */
+    delegate_queue_t        dq;
+    /**
+     * @brief   Calls buffer.
+     */
+    delegate_async_t        dq_buf[N];
+
+    template <typename T, void (*F)(T *)>
+    static msg_t fn_veneer(void *argsp) {
+
+      F(static_cast<T *>(argsp));
+
+      return MSG_OK;
+    }
+
+    template <typename T, void (T::*M)(void)>
+    static msg_t method_veneer(void *argsp) {
+
+      (static_cast<T *>(argsp)->*M)();
+
+      return MSG_OK;
+    }
+
+  public:
+    /**
+     * @brief   DelegateQueue constructor.
+     *
+     * @init
+     */
+    DelegateQueue(void) {
+
+      chDelegateQueueObjectInit(&dq, dq_buf, N);
+    }
+
+    /**
+     * @brief   Posts an asynchronous function call.
+     * @details Usage: <code>queue.post<T, func>(objp)</code>.
+     *
+     * @param[in] objp      pointer to the object passed to the function, it
+     *                      must stay valid until the function has been called
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the call has been posted.
+     * @retval MSG_TIMEOUT  if the queue is full and the call cannot be
+     *                      posted in the specified time.
+     *
+     * @api
+     */
+    template <typename T, void (*F)(T *)>
+    msg_t post(T *objp, sysinterval_t timeout = TIME_INFINITE) {
+
+      return chDelegatePostTimeout(&dq, fn_veneer<T, F>, (void *)objp,
+                                   timeout);
+    }
+
+    /**
+     * @brief   Posts an asynchronous method call.
+     * @details Usage: <code>queue.post<T, &T::method>(objp)</code>.
+     *
+     * @param[in] objp      pointer to the object, it must stay valid until
+     *                      the method has been called
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the call has been posted.
+     * @retval MSG_TIMEOUT  if the queue is full and the call cannot be
+     *                      posted in the specified time.
+     *
+     * @api
+     */
+    template <typename T, void (T::*M)(void)>
+    msg_t post(T *objp, sysinterval_t timeout = TIME_INFINITE) {
+
+      return chDelegatePostTimeout(&dq, method_veneer<T, M>, (void *)objp,
+                                   timeout);
+    }
+
+    /**
+     * @brief   Posts an asynchronous function call.
+     *
+     * @param[in] objp      pointer to the object passed to the function, it
+     *                      must stay valid until the function has been called
+     * @return              The operation status.
+     * @retval MSG_OK       if the call has been posted.
+     * @retval MSG_TIMEOUT  if the queue is full.
+     *
+     * @iclass
+     */
+    template <typename T, void (*F)(T *)>
+    msg_t postI(T *objp) {
+
+      return chDelegatePostI(&dq, fn_veneer<T, F>, (void *)objp);
+    }
+
+    /**
+     * @brief   Posts an asynchronous method call.
+     *
+     * @param[in] objp      pointer to the object, it must stay valid until
+     *                      the method has been called
+     * @return              The operation status.
+     * @retval MSG_OK       if the call has been posted.
+     * @retval MSG_TIMEOUT  if the queue is full.
+     *
+     * @iclass
+     */
+    template <typename T, void (T::*M)(void)>
+    msg_t postI(T *objp) {
+
+      return chDelegatePostI(&dq, method_veneer<T, M>, (void *)objp);
+    }
+
+    /**
+     * @brief   Asynchronous calls dispatching.
+     * @details Waits for at least one queued call then executes all the
+     *          calls in queue.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The number of executed calls.
+     * @retval 0            if a timeout occurred.
+     *
+     * @api
+     */
+    size_t dispatch(sysinterval_t timeout = TIME_INFINITE) {
+
+      return chDelegateDispatchQueueTimeout(&dq, timeout);
+    }
+  };
+#endif /* CH_CFG_USE_DELEGATES == TRUE */
+
   /*------------------------------------------------------------------------*
    * chibios_rt::BaseSequentialStreamInterface                              *
    *------------------------------------------------------------------------*/
@@ -4,7 +4,8 @@ FATFSSRC = $(CHIBIOS)/os/various/fatfs_bindings/fatfs_diskio.c \
            $(CHIBIOS)/ext/fatfs/source/ff.c \
            $(CHIBIOS)/ext/fatfs/source/ffunicode.c
 
-FATFSINC = $(CHIBIOS)/ext/fatfs/source
+FATFSINC = $(CHIBIOS)/os/various/fatfs_bindings \
+           $(CHIBIOS)/ext/fatfs/source
 
 # Shared variables
 ALLCSRC += $(FATFSSRC)
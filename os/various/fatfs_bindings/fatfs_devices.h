@@ -0,0 +1,57 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_devices.h
+ * @brief   FatFS block devices bindings.
+ * @details Each FatFS physical drive is associated to a @p BaseBlockDevice
+ *          object, any block device implementation can be used. If the
+ *          MMC_SPI or SDC driver is enabled then drive 0 is associated by
+ *          default to @p FATFS_HAL_DEVICE.
+ *
+ * @addtogroup FATFS_DEVICES
+ * @{
+ */
+
+#ifndef FATFS_DEVICES_H
+#define FATFS_DEVICES_H
+
+/**
+ * @brief   Number of physical drives.
+ */
+#if !defined(FATFS_MAX_DRIVES) || defined(__DOXYGEN__)
+#define FATFS_MAX_DRIVES                    FF_VOLUMES
+#endif
+
+/**
+ * @brief   Erase block size in sectors returned to FatFS.
+ */
+#if !defined(FATFS_ERASE_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define FATFS_ERASE_BLOCK_SIZE              256U
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void fatfsSetBlockDevice(BYTE pdrv, BaseBlockDevice *bdp);
+  BaseBlockDevice *fatfsGetBlockDevice(BYTE pdrv);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FATFS_DEVICES_H */
+
+/** @} */
@@ -9,25 +9,23 @@
 #include "ffconf.h"
 #include "ff.h"
 #include "diskio.h"
+#include "fatfs_devices.h"
 
-#if HAL_USE_MMC_SPI && HAL_USE_SDC
-#error "cannot specify both MMC_SPI and SDC drivers"
-#endif
-
+/* The MMC or SDC driver, if enabled, is the default device of drive 0.*/
 #if !defined(FATFS_HAL_DEVICE)
 #if HAL_USE_MMC_SPI
 #define FATFS_HAL_DEVICE MMCD1
-#else
+#elif HAL_USE_SDC
 #define FATFS_HAL_DEVICE SDCD1
 #endif
 #endif
 
+#if defined(FATFS_HAL_DEVICE)
 #if HAL_USE_MMC_SPI
 extern MMCDriver FATFS_HAL_DEVICE;
 #elif HAL_USE_SDC
 extern SDCDriver FATFS_HAL_DEVICE;
-#else
-#error "MMC_SPI or SDC driver must be specified"
+#endif
 #endif
 
 #if HAL_USE_RTC
@@ -37,8 +35,33 @@ extern RTCDriver RTCD1;
 /*-----------------------------------------------------------------------*/
 /* Correspondence between physical drive number and physical drive.      */
 
-#define MMC     0
-#define SDC     0
+static BaseBlockDevice *drives[FATFS_MAX_DRIVES] = {
+#if defined(FATFS_HAL_DEVICE)
+  (BaseBlockDevice *)&FATFS_HAL_DEVICE
+#endif
+};
+
+static BaseBlockDevice *get_drive(BYTE pdrv) {
+
+  if (pdrv >= FATFS_MAX_DRIVES)
+    return NULL;
+  return drives[pdrv];
+}
+
+/*-----------------------------------------------------------------------*/
+/* Attach a block device to a drive                                      */
+
+void fatfsSetBlockDevice(BYTE pdrv, BaseBlockDevice *bdp)
+{
+  osalDbgCheck(pdrv < FATFS_MAX_DRIVES);
+
+  drives[pdrv] = bdp;
+}
+
+BaseBlockDevice *fatfsGetBlockDevice(BYTE pdrv)
+{
+  return get_drive(pdrv);
+}
 
 
 
@@ -49,30 +72,8 @@ DSTATUS disk_initialize (
     BYTE pdrv         /* Physical drive number (0..) */
 )
 {
-  DSTATUS stat;
-
-  switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
-    stat = 0;
-    /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      stat |= STA_NOINIT;
-    if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
-      stat |=  STA_PROTECT;
-    return stat;
-#else
-  case SDC:
-    stat = 0;
-    /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      stat |= STA_NOINIT;
-    if (sdcIsWriteProtected(&FATFS_HAL_DEVICE))
-      stat |=  STA_PROTECT;
-    return stat;
-#endif
-  }
-  return STA_NOINIT;
+  /* It is initialized externally, just reads the status.*/
+  return disk_status(pdrv);
 }
 
 
@@ -84,30 +85,19 @@ DSTATUS disk_status (
     BYTE pdrv         /* Physical drive number (0..) */
 )
 {
+  BaseBlockDevice *bdp = get_drive(pdrv);
   DSTATUS stat;
 
-  switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
-    stat = 0;
-    /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      stat |= STA_NOINIT;
-    if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
-      stat |= STA_PROTECT;
-    return stat;
-#else
-  case SDC:
-    stat = 0;
-    /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      stat |= STA_NOINIT;
-    if (sdcIsWriteProtected(&FATFS_HAL_DEVICE))
-      stat |= STA_PROTECT;
-    return stat;
-#endif
-  }
-  return STA_NOINIT;
+  if (bdp == NULL)
+    return STA_NOINIT;
+
+  stat = 0;
+  /* It is initialized externally, just reads the status.*/
+  if (blkGetDriverState(bdp) != BLK_READY)
+    stat |= STA_NOINIT;
+  if (blkIsWriteProtected(bdp))
+    stat |= STA_PROTECT;
+  return stat;
 }
 
 
@@ -122,32 +112,15 @@ DRESULT disk_read (
     UINT count        /* Number of sectors to read (1..255) */
 )
 {
-  switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      return RES_NOTRDY;
-    if (mmcStartSequentialRead(&FATFS_HAL_DEVICE, sector))
-      return RES_ERROR;
-    while (count > 0) {
-      if (mmcSequentialRead(&FATFS_HAL_DEVICE, buff))
-        return RES_ERROR;
-      buff += MMCSD_BLOCK_SIZE;
-      count--;
-    }
-    if (mmcStopSequentialRead(&FATFS_HAL_DEVICE))
-        return RES_ERROR;
-    return RES_OK;
-#else
-  case SDC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      return RES_NOTRDY;
-    if (sdcRead(&FATFS_HAL_DEVICE, sector, buff, count))
-      return RES_ERROR;
-    return RES_OK;
-#endif
-  }
-  return RES_PARERR;
+  BaseBlockDevice *bdp = get_drive(pdrv);
+
+  if (bdp == NULL)
+    return RES_PARERR;
+  if (blkGetDriverState(bdp) != BLK_READY)
+    return RES_NOTRDY;
+  if (blkRead(bdp, sector, buff, count))
+    return RES_ERROR;
+  return RES_OK;
 }
 
 
@@ -163,34 +136,17 @@ DRESULT disk_write (
     UINT count        /* Number of sectors to write (1..255) */
 )
 {
-  switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-        return RES_NOTRDY;
-    if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
-        return RES_WRPRT;
-    if (mmcStartSequentialWrite(&FATFS_HAL_DEVICE, sector))
-        return RES_ERROR;
-    while (count > 0) {
-        if (mmcSequentialWrite(&FATFS_HAL_DEVICE, buff))
-            return RES_ERROR;
-        buff += MMCSD_BLOCK_SIZE;
-        count--;
-    }
-    if (mmcStopSequentialWrite(&FATFS_HAL_DEVICE))
-        return RES_ERROR;
-    return RES_OK;
-#else
-  case SDC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      return RES_NOTRDY;
-    if (sdcWrite(&FATFS_HAL_DEVICE, sector, buff, count))
-      return RES_ERROR;
-    return RES_OK;
-#endif
-  }
-  return RES_PARERR;
+  BaseBlockDevice *bdp = get_drive(pdrv);
+
+  if (bdp == NULL)
+    return RES_PARERR;
+  if (blkGetDriverState(bdp) != BLK_READY)
+    return RES_NOTRDY;
+  if (blkIsWriteProtected(bdp))
+    return RES_WRPRT;
+  if (blkWrite(bdp, sector, buff, count))
+    return RES_ERROR;
+  return RES_OK;
 }
 #endif /* _FS_READONLY */
 
@@ -205,54 +161,50 @@ DRESULT disk_ioctl (
     void *buff        /* Buffer to send/receive control data */
 )
 {
-  (void)buff;
+  BaseBlockDevice *bdp = get_drive(pdrv);
+  BlockDeviceInfo bdi;
 
-  switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
-    switch (cmd) {
-    case CTRL_SYNC:
-        return RES_OK;
+  if (bdp == NULL)
+    return RES_PARERR;
+
+  switch (cmd) {
+  case CTRL_SYNC:
+    if (blkSync(bdp))
+      return RES_ERROR;
+    return RES_OK;
+  case GET_SECTOR_COUNT:
+    if (blkGetInfo(bdp, &bdi))
+      return RES_ERROR;
+    *((DWORD *)buff) = bdi.blk_num;
+    return RES_OK;
 #if FF_MAX_SS > FF_MIN_SS
-    case GET_SECTOR_SIZE:
-        *((WORD *)buff) = MMCSD_BLOCK_SIZE;
-        return RES_OK;
+  case GET_SECTOR_SIZE:
+    if (blkGetInfo(bdp, &bdi))
+      return RES_ERROR;
+    *((WORD *)buff) = (WORD)bdi.blk_size;
+    return RES_OK;
 #endif
+  case GET_BLOCK_SIZE:
+    *((DWORD *)buff) = FATFS_ERASE_BLOCK_SIZE;
+    return RES_OK;
 #if FF_USE_TRIM
-    case CTRL_TRIM:
-        mmcErase(&FATFS_HAL_DEVICE, *((DWORD *)buff), *((DWORD *)buff + 1));
-        return RES_OK;
-#endif
-    default:
-        return RES_PARERR;
-    }
+  case CTRL_TRIM:
+    /* Erasing is only supported by the MMC and SDC drivers, for the other
+       devices trimming is just an hint.*/
+#if defined(FATFS_HAL_DEVICE)
+    if (bdp == (BaseBlockDevice *)&FATFS_HAL_DEVICE) {
+#if HAL_USE_MMC_SPI
+      mmcErase(&FATFS_HAL_DEVICE, *((DWORD *)buff), *((DWORD *)buff + 1));
 #else
-  case SDC:
-    switch (cmd) {
-    case CTRL_SYNC:
-        return RES_OK;
-    case GET_SECTOR_COUNT:
-        *((DWORD *)buff) = mmcsdGetCardCapacity(&FATFS_HAL_DEVICE);
-        return RES_OK;
-#if FF_MAX_SS > FF_MIN_SS
-    case GET_SECTOR_SIZE:
-        *((WORD *)buff) = MMCSD_BLOCK_SIZE;
-        return RES_OK;
+      sdcErase(&FATFS_HAL_DEVICE, *((DWORD *)buff), *((DWORD *)buff + 1));
 #endif
-    case GET_BLOCK_SIZE:
-        *((DWORD *)buff) = 256; /* 512b blocks in one erase block */
-        return RES_OK;
-#if FF_USE_TRIM
-    case CTRL_TRIM:
-        sdcErase(&FATFS_HAL_DEVICE, *((DWORD *)buff), *((DWORD *)buff + 1));
-        return RES_OK;
-#endif
-    default:
-        return RES_PARERR;
     }
 #endif
+    return RES_OK;
+#endif
+  default:
+    return RES_PARERR;
   }
-  return RES_PARERR;
 }
 
 DWORD get_fattime(void) {
@@ -67,9 +67,28 @@
 #define CH_LWIP_USE_MEM_POOLS FALSE
 #endif
 
-#if CH_LWIP_USE_MEM_POOLS 
+#if CH_LWIP_USE_BATCHED_MBOXES
+/* Batched mailboxes are all allocated with the size of the largest one so
+   that they can be recycled through a single pool.*/
+#define CH_LWIP_MAX(a, b) ((a) > (b) ? (a) : (b))
+#ifndef CH_LWIP_MBOX_SIZE
+#define CH_LWIP_MBOX_SIZE                                                   \
+  CH_LWIP_MAX(CH_LWIP_MAX(TCPIP_MBOX_SIZE, DEFAULT_ACCEPTMBOX_SIZE),        \
+              CH_LWIP_MAX(CH_LWIP_MAX(DEFAULT_RAW_RECVMBOX_SIZE,            \
+                                      DEFAULT_UDP_RECVMBOX_SIZE),           \
+                          DEFAULT_TCP_RECVMBOX_SIZE))
+#endif
+#endif
+
+#if CH_LWIP_USE_MEM_POOLS || CH_LWIP_USE_BATCHED_MBOXES
 static MEMORYPOOL_DECL(lwip_sys_arch_sem_pool, sizeof(semaphore_t), 4, chCoreAllocAlignedI);
+#endif
+#if CH_LWIP_USE_BATCHED_MBOXES
+static MEMORYPOOL_DECL(lwip_sys_arch_mbox_pool, sizeof(lwip_mbox_t) + sizeof(void *) * CH_LWIP_MBOX_SIZE, PORT_NATURAL_ALIGN, chCoreAllocAlignedI);
+#elif CH_LWIP_USE_MEM_POOLS
 static MEMORYPOOL_DECL(lwip_sys_arch_mbox_pool, sizeof(mailbox_t) + sizeof(msg_t) * TCPIP_MBOX_SIZE, 4, chCoreAllocAlignedI);
+#endif
+#if CH_LWIP_USE_MEM_POOLS
 static MEMORYPOOL_DECL(lwip_sys_arch_thread_pool, THD_WORKING_AREA_SIZE(TCPIP_THREAD_STACKSIZE), PORT_WORKING_AREA_ALIGN, chCoreAllocAlignedI);
 #endif
 
@@ -79,7 +98,7 @@ void sys_init(void) {
 
 err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
-#if !CH_LWIP_USE_MEM_POOLS
+#if !CH_LWIP_USE_MEM_POOLS && !CH_LWIP_USE_BATCHED_MBOXES
   *sem = chHeapAlloc(NULL, sizeof(semaphore_t));
 #else
   *sem = chPoolAlloc(&lwip_sys_arch_sem_pool);
@@ -98,7 +117,7 @@ err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
 void sys_sem_free(sys_sem_t *sem) {
 
-#if !CH_LWIP_USE_MEM_POOLS
+#if !CH_LWIP_USE_MEM_POOLS && !CH_LWIP_USE_BATCHED_MBOXES
   chHeapFree(*sem);
 #else
   chPoolFree(&lwip_sys_arch_sem_pool, *sem);
@@ -146,6 +165,209 @@ void sys_sem_set_invalid(sys_sem_t *sem) {
   *sem = SYS_SEM_NULL;
 }
 
+#if CH_LWIP_USE_BATCHED_MBOXES
+err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
+  lwip_mbox_t *mbp;
+
+  osalDbgCheck((size > 0) && (size <= CH_LWIP_MBOX_SIZE));
+
+  mbp = chPoolAlloc(&lwip_sys_arch_mbox_pool);
+  if (mbp == NULL) {
+    *mbox = SYS_MBOX_NULL;
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+
+  mbp->reader   = NULL;
+  mbp->consumer = NULL;
+  chThdQueueObjectInit(&mbp->qw);
+  mbp->size   = (size_t)size;
+  mbp->used   = (size_t)0;
+  mbp->wridx  = (size_t)0;
+  mbp->rdidx  = (size_t)0;
+  mbp->batch  = (size_t)0;
+  mbp->taken  = (size_t)0;
+  *mbox = mbp;
+  SYS_STATS_INC_USED(mbox);
+  return ERR_OK;
+}
+
+void sys_mbox_free(sys_mbox_t *mbox) {
+  lwip_mbox_t *mbp = *mbox;
+
+  chSysLock();
+  if (mbp->used > mbp->taken) {
+    // If there are messages still present in the mailbox when the mailbox
+    // is deallocated, it is an indication of a programming error in lwIP
+    // and the developer should be notified.
+    SYS_STATS_INC(mbox.err);
+  }
+  chThdDequeueAllI(&mbp->qw, MSG_RESET);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  chPoolFree(&lwip_sys_arch_mbox_pool, mbp);
+  *mbox = SYS_MBOX_NULL;
+  SYS_STATS_DEC(mbox.used);
+}
+
+/*
+ * Puts a message in a mailbox, must be called from within a lock.
+ */
+static bool mbox_post_i(lwip_mbox_t *mbp, void *msg) {
+
+  if (mbp->used >= mbp->size) {
+    return false;
+  }
+
+  mbp->buffer[mbp->wridx] = msg;
+  if (++mbp->wridx >= mbp->size) {
+    mbp->wridx = (size_t)0;
+  }
+  mbp->used++;
+
+  /* Waking up the consumer, if waiting.*/
+  chThdResumeI(&mbp->reader, MSG_OK);
+
+  return true;
+}
+
+void sys_mbox_post(sys_mbox_t *mbox, void *msg) {
+  lwip_mbox_t *mbp = *mbox;
+
+  chSysLock();
+  while (!mbox_post_i(mbp, msg)) {
+    if (chThdEnqueueTimeoutS(&mbp->qw, TIME_INFINITE) == MSG_RESET) {
+      chSysUnlock();
+      return;
+    }
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
+  lwip_mbox_t *mbp = *mbox;
+
+  chSysLock();
+  if (!mbox_post_i(mbp, msg)) {
+    chSysUnlock();
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+  return ERR_OK;
+}
+
+err_t sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg) {
+  bool posted;
+
+  chSysLockFromISR();
+  posted = mbox_post_i(*mbox, msg);
+  chSysUnlockFromISR();
+
+  if (!posted) {
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  return ERR_OK;
+}
+
+/*
+ * Fetches a message from the current batch if not empty. The owner of
+ * the batch can do this without entering the kernel lock because the
+ * batch slots are not released to the producers until the next batch is
+ * started; other threads must call this from within a lock.
+ */
+static inline bool mbox_fetch_from_batch(lwip_mbox_t *mbp, void **msg) {
+
+  if (mbp->taken >= mbp->batch) {
+    return false;
+  }
+
+  if (msg != NULL) {
+    *msg = mbp->buffer[mbp->rdidx];
+  }
+  if (++mbp->rdidx >= mbp->size) {
+    mbp->rdidx = (size_t)0;
+  }
+  mbp->taken++;
+
+  return true;
+}
+
+/*
+ * Releases the slots of the current batch and starts a new one with all
+ * the pending messages, must be called from within a lock.
+ */
+static void mbox_new_batch_s(lwip_mbox_t *mbp) {
+
+  if (mbp->taken > (size_t)0) {
+    mbp->used -= mbp->taken;
+    chThdDequeueAllI(&mbp->qw, MSG_OK);
+  }
+  mbp->batch = mbp->used;
+  mbp->taken = (size_t)0;
+}
+
+/*
+ * Fetches a message from within a lock, the current batch is continued if
+ * not exhausted else a new one is started. The calling thread becomes the
+ * owner of the batch.
+ */
+static bool mbox_fetch_s(lwip_mbox_t *mbp, void **msg) {
+
+  mbp->consumer = chThdGetSelfX();
+  if (mbox_fetch_from_batch(mbp, msg)) {
+    return true;
+  }
+  mbox_new_batch_s(mbp);
+  return mbox_fetch_from_batch(mbp, msg);
+}
+
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
+  lwip_mbox_t *mbp = *mbox;
+  systime_t start;
+  sysinterval_t tmo, elapsed;
+
+  /* Fast path, no kernel lock, only for the owner of the current batch.*/
+  if ((mbp->consumer == chThdGetSelfX()) && mbox_fetch_from_batch(mbp, msg)) {
+    return 0;
+  }
+
+  chSysLock();
+  tmo = timeout > 0 ? TIME_MS2I((time_msecs_t)timeout) : TIME_INFINITE;
+  start = chVTGetSystemTimeX();
+  while (!mbox_fetch_s(mbp, msg)) {
+    osalDbgAssert(mbp->reader == NULL, "multiple consumers");
+
+    if (chThdSuspendTimeoutS(&mbp->reader, tmo) != MSG_OK) {
+      chSysUnlock();
+      return SYS_ARCH_TIMEOUT;
+    }
+  }
+  elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+  chSchRescheduleS();
+  chSysUnlock();
+  return (u32_t)TIME_I2MS(elapsed);
+}
+
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg) {
+  lwip_mbox_t *mbp = *mbox;
+  bool fetched;
+
+  /* Always within a lock because this is also used by the tcpip thread
+     for draining mailboxes owned by other threads.*/
+  chSysLock();
+  fetched = mbox_fetch_s(mbp, msg);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return fetched ? 0 : SYS_MBOX_EMPTY;
+}
+
+#else /* !CH_LWIP_USE_BATCHED_MBOXES */
 err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
 
 #if !CH_LWIP_USE_MEM_POOLS
@@ -224,6 +446,8 @@ u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg) {
   return 0;
 }
 
+#endif /* !CH_LWIP_USE_BATCHED_MBOXES */
+
 int sys_mbox_valid(sys_mbox_t *mbox) {
   return *mbox != SYS_MBOX_NULL;
 }
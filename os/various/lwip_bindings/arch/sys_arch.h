@@ -53,12 +53,62 @@
 #ifndef __SYS_ARCH_H__
 #define __SYS_ARCH_H__
 
+/*
+ * If enabled, lwIP mailboxes are implemented by a ring buffer with a single
+ * consumer fetching all the pending messages in one critical section, the
+ * following fetches are served outside the kernel lock until the batch is
+ * exhausted. Mailboxes and semaphores are recycled through memory pools.
+ */
+#ifndef CH_LWIP_USE_BATCHED_MBOXES
+#define CH_LWIP_USE_BATCHED_MBOXES FALSE
+#endif
+
+#if CH_LWIP_USE_BATCHED_MBOXES
+/*
+ * Batched mailbox. Messages are fetched outside the kernel lock only by
+ * the thread owning the current batch, a fetch from another thread takes
+ * the lock and moves the batch ownership. Because of this, only one thread
+ * at a time can be fetching from a mailbox. A thread can drain a mailbox
+ * whose consumer is blocked waiting, as netconn_drain() does.
+ */
+typedef struct {
+  /* Consumer thread waiting for messages.*/
+  thread_reference_t    reader;
+  /* Thread owning the current batch.*/
+  thread_t              *consumer;
+  /* Producer threads waiting for free slots.*/
+  threads_queue_t       qw;
+  /* Number of slots in the buffer.*/
+  size_t                size;
+  /* Slots in use, including the current batch.*/
+  size_t                used;
+  /* Next slot to be written.*/
+  size_t                wridx;
+  /* Next slot to be read.*/
+  size_t                rdidx;
+  /* Messages in the current batch.*/
+  size_t                batch;
+  /* Messages already fetched from the current batch.*/
+  size_t                taken;
+  /* Messages buffer.*/
+  void                  *buffer[];
+} lwip_mbox_t;
+#endif
+
 typedef semaphore_t *   sys_sem_t;
+#if CH_LWIP_USE_BATCHED_MBOXES
+typedef lwip_mbox_t *   sys_mbox_t;
+#else
 typedef mailbox_t *     sys_mbox_t;
+#endif
 typedef thread_t *      sys_thread_t;
 typedef syssts_t        sys_prot_t;
 
+#if CH_LWIP_USE_BATCHED_MBOXES
+#define SYS_MBOX_NULL   (lwip_mbox_t *)0
+#else
 #define SYS_MBOX_NULL   (mailbox_t *)0
+#endif
 #define SYS_THREAD_NULL (thread_t *)0
 #define SYS_SEM_NULL    (semaphore_t *)0
 
@@ -92,6 +92,75 @@ thread_reference_t lwip_trp = NULL;
  */
 static THD_WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
 
+#if LWIP_USE_ZERO_COPY || defined(__DOXYGEN__)
+#if !MAC_USE_ZERO_COPY
+#error "LWIP_USE_ZERO_COPY requires MAC_USE_ZERO_COPY"
+#endif
+
+#if ETH_PAD_SIZE
+#error "LWIP_USE_ZERO_COPY requires ETH_PAD_SIZE == 0"
+#endif
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "LWIP_USE_ZERO_COPY requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+/*
+ * Custom pbuf referencing a MAC receive buffer, the MAC descriptor is
+ * owned by the pbuf until it is freed.
+ */
+typedef struct {
+  struct pbuf_custom    pc;
+  MACReceiveDescriptor  rd;
+} lwip_rx_pbuf_t;
+
+/*
+ * Pool of zero-copy receive pbufs.
+ */
+static lwip_rx_pbuf_t rx_pbufs[LWIP_ZERO_COPY_RX_PBUFS];
+static memory_pool_t rx_pbufs_pool;
+
+/*
+ * Called by lwIP when a zero-copy receive pbuf is freed, the descriptor
+ * is returned to the MAC.
+ */
+static void rx_pbuf_free(struct pbuf *p) {
+  lwip_rx_pbuf_t *rxp = (lwip_rx_pbuf_t *)p;
+
+  macReleaseReceiveDescriptor(&rxp->rd);
+  chPoolFree(&rx_pbufs_pool, rxp);
+}
+
+/*
+ * Wraps the frame referenced by a receive descriptor into a custom pbuf.
+ * Returns NULL if there are no free custom pbufs or if the frame is not
+ * contained in a single MAC buffer, in this case the descriptor is left
+ * untouched.
+ */
+static struct pbuf *low_level_input_zero_copy(MACReceiveDescriptor *rdp) {
+  lwip_rx_pbuf_t *rxp;
+  const uint8_t *buf;
+  size_t size;
+
+  rxp = chPoolAlloc(&rx_pbufs_pool);
+  if (rxp == NULL)
+    return NULL;
+
+  /* Working on a copy, the original descriptor is still usable by the
+     copy path if the frame is fragmented.*/
+  rxp->rd = *rdp;
+  buf = macGetNextReceiveBuffer(&rxp->rd, &size);
+  if ((buf == NULL) || (size != rdp->size)) {
+    chPoolFree(&rx_pbufs_pool, rxp);
+    return NULL;
+  }
+
+  rxp->pc.custom_free_function = rx_pbuf_free;
+  return pbuf_alloced_custom(PBUF_RAW, (u16_t)size, PBUF_REF, &rxp->pc,
+                             (void *)buf, (u16_t)size);
+}
+#endif /* LWIP_USE_ZERO_COPY */
+
 /*
  * Initialization.
  */
@@ -136,9 +205,27 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p) {
   pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
 #endif
 
+#if LWIP_USE_ZERO_COPY
+  /* Gathers the pbuf chain directly into the MAC buffers.*/
+  {
+    u16_t offset = 0;
+    uint8_t *buf;
+    size_t size;
+
+    (void)q;
+    while ((offset < p->tot_len) &&
+           ((buf = macGetNextTransmitBuffer(&td, p->tot_len - offset,
+                                            &size)) != NULL)) {
+      if (size > (size_t)(p->tot_len - offset))
+        size = (size_t)(p->tot_len - offset);
+      offset += pbuf_copy_partial(p, buf, (u16_t)size, offset);
+    }
+  }
+#else
   /* Iterates through the pbuf chain. */
   for(q = p; q != NULL; q = q->next)
     macWriteTransmitDescriptor(&td, (uint8_t *)q->payload, (size_t)q->len);
+#endif
   macReleaseTransmitDescriptor(&td);
 
   MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
@@ -188,18 +275,31 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
   len += ETH_PAD_SIZE;        /* allow room for Ethernet padding */
 #endif
 
-  /* We allocate a pbuf chain of pbufs from the pool. */
-  *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+#if LWIP_USE_ZERO_COPY
+  /* The frame is passed to lwIP without copying it, the descriptor is
+     released when the pbuf is freed.*/
+  *pbuf = low_level_input_zero_copy(&rd);
+  if (*pbuf != NULL)
+    q = NULL;
+  else
+#endif
+  {
+    /* We allocate a pbuf chain of pbufs from the pool. */
+    *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+    q = *pbuf;
+  }
 
   if (*pbuf != NULL) {
 #if ETH_PAD_SIZE
     pbuf_header(*pbuf, -ETH_PAD_SIZE); /* drop the padding word */
 #endif
 
-    /* Iterates through the pbuf chain. */
-    for(q = *pbuf; q != NULL; q = q->next)
-      macReadReceiveDescriptor(&rd, (uint8_t *)q->payload, (size_t)q->len);
-    macReleaseReceiveDescriptor(&rd);
+    /* Iterates through the pbuf chain, nothing to do in zero-copy mode. */
+    if (q != NULL) {
+      for(; q != NULL; q = q->next)
+        macReadReceiveDescriptor(&rd, (uint8_t *)q->payload, (size_t)q->len);
+      macReleaseReceiveDescriptor(&rd);
+    }
 
     MIB2_STATS_NETIF_ADD(netif, ifinoctets, (*pbuf)->tot_len);
 
@@ -366,6 +466,11 @@ static THD_FUNCTION(lwip_thread, p) {
     thisif.hostname = LWIP_NETIF_HOSTNAME_STRING;
 #endif
 
+#if LWIP_USE_ZERO_COPY
+  chPoolObjectInit(&rx_pbufs_pool, sizeof (lwip_rx_pbuf_t), NULL);
+  chPoolLoadArray(&rx_pbufs_pool, rx_pbufs, LWIP_ZERO_COPY_RX_PBUFS);
+#endif
+
   macStart(&ETHD1, &mac_config);
 
   MIB2_INIT_NETIF(&thisif, snmp_ifType_ethernet_csmacd, 0);
@@ -61,6 +61,30 @@
 #define LWIP_THREAD_STACK_SIZE              672
 #endif
 
+/**
+ * @brief   Zero-copy frames handling.
+ * @details If enabled, received frames are passed to lwIP as custom pbufs
+ *          referencing the MAC receive buffers, the MAC descriptors are
+ *          returned to the driver when lwIP frees the pbufs. Transmitted
+ *          pbuf chains are gathered directly into the MAC transmit buffers.
+ * @note    Requires @p MAC_USE_ZERO_COPY and @p LWIP_SUPPORT_CUSTOM_PBUF,
+ *          @p ETH_PAD_SIZE must be zero.
+ */
+#if !defined(LWIP_USE_ZERO_COPY) || defined(__DOXYGEN__)
+#define LWIP_USE_ZERO_COPY                  FALSE
+#endif
+
+/**
+ * @brief   Maximum number of received frames held by lwIP in zero-copy mode.
+ * @details When all the zero-copy pbufs are in use, received frames are
+ *          copied into @p PBUF_POOL pbufs.
+ * @note    There is no point in making this larger than the number of MAC
+ *          receive descriptors.
+ */
+#if !defined(LWIP_ZERO_COPY_RX_PBUFS) || defined(__DOXYGEN__)
+#define LWIP_ZERO_COPY_RX_PBUFS             4
+#endif
+
 /**
  * @brief   Link poll interval.
  */
@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -183,6 +184,67 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if (SHELL_CMD_LOCKS_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_locks(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static const char *types[] = {"sem", "mtx"};
+  lock_profile_t top[SHELL_CMD_LOCKS_TOP_MAX];
+  lock_profile_t *lpp;
+  unsigned i, cnt = 0U, n = SHELL_CMD_LOCKS_TOP_MAX;
+
+  if (argc > 1) {
+    shellUsage(chp, "locks [n]");
+    return;
+  }
+  if (argc == 1) {
+    n = (unsigned)atoi(argv[0]);
+    if ((n == 0U) || (n > SHELL_CMD_LOCKS_TOP_MAX)) {
+      n = SHELL_CMD_LOCKS_TOP_MAX;
+    }
+  }
+
+  /* Snapshot of the hottest locks ordered by cumulative wait time, the
+     list is scanned within a single critical zone.*/
+  chSysLock();
+  lpp = chLockProfFirstS();
+  while (lpp != NULL) {
+    i = cnt;
+    if (cnt < n) {
+      cnt++;
+    }
+    while ((i > 0U) &&
+           (lpp->wait_cumulative > top[i - 1U].wait_cumulative)) {
+      if (i < n) {
+        top[i] = top[i - 1U];
+      }
+      i--;
+    }
+    if (i < n) {
+      top[i] = *lpp;
+    }
+    lpp = chLockProfNextS(lpp);
+  }
+  chSysUnlock();
+
+  chprintf(chp, "type      acq     cont   boosts wait avg wait max hold max name" SHELL_NEWLINE_STR);
+  for (i = 0U; i < cnt; i++) {
+    uint32_t avg = 0U;
+
+    if (top[i].n_contended > (ucnt_t)0) {
+      avg = (uint32_t)(top[i].wait_cumulative / (rttime_t)top[i].n_contended);
+    }
+    chprintf(chp, "%4s %8lu %8lu %8lu %8lu %8lu %8lu %s" SHELL_NEWLINE_STR,
+             types[top[i].type],
+             (uint32_t)top[i].n_acquired,
+             (uint32_t)top[i].n_contended,
+             (uint32_t)top[i].n_boosts,
+             avg,
+             (uint32_t)top[i].wait_max,
+             (uint32_t)top[i].hold_max,
+             top[i].name == NULL ? "" : top[i].name);
+  }
+}
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static THD_FUNCTION(test_rt, arg) {
   BaseSequentialStream *chp = (BaseSequentialStream *)arg;
@@ -250,6 +312,9 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads", cmd_threads},
 #endif
+#if SHELL_CMD_LOCKS_ENABLED == TRUE
+  {"locks", cmd_locks},
+#endif
 #if SHELL_CMD_TEST_ENABLED == TRUE
   {"test", cmd_test},
 #endif
@@ -57,6 +57,14 @@
 #define SHELL_CMD_THREADS_ENABLED           TRUE
 #endif
 
+#if !defined(SHELL_CMD_LOCKS_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_LOCKS_ENABLED             TRUE
+#endif
+
+#if !defined(SHELL_CMD_LOCKS_TOP_MAX) || defined(__DOXYGEN__)
+#define SHELL_CMD_LOCKS_TOP_MAX             8
+#endif
+
 #if !defined(SHELL_CMD_TEST_ENABLED) || defined(__DOXYGEN__)
 #define SHELL_CMD_TEST_ENABLED              TRUE
 #endif
@@ -81,6 +89,14 @@
 #error "SHELL_CMD_THREADS_ENABLED requires CH_CFG_USE_REGISTRY"
 #endif
 
+/* The locks command is only available when the RT locks profiler is
+   enabled.*/
+#if (SHELL_CMD_LOCKS_ENABLED == TRUE) &&                                    \
+    (defined(__CHIBIOS_NIL__) || (CH_DBG_LOCKS_PROFILING == FALSE))
+#undef SHELL_CMD_LOCKS_ENABLED
+#define SHELL_CMD_LOCKS_ENABLED             FALSE
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
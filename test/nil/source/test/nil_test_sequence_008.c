@@ -41,6 +41,8 @@
  * - @subpage nil_test_008_005
  * - @subpage nil_test_008_006
  * - @subpage nil_test_008_007
+ * - @subpage nil_test_008_008
+ * - @subpage nil_test_008_009
  * .
  */
 
@@ -104,6 +106,22 @@ static THD_FUNCTION(bmk_thread4, p) {
   chSysUnlock();
 }
 
+#if CH_CFG_USE_SEMAPHORES
+static THD_FUNCTION(bmk_thread7, p) {
+
+  (void)p;
+  while (chSemWait(&sem1) == MSG_OK) {
+  }
+}
+
+static THD_FUNCTION(bmk_thread8, p) {
+
+  (void)p;
+  while (chSemWaitTimeout(&sem1, TIME_MS2I(1000)) != MSG_RESET) {
+  }
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -309,6 +327,9 @@ static void nil_test_008_003_execute(void) {
       chSchWakeupS(tp, MSG_OK);
       chSysUnlock();
       n += 4;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
     } while (chVTIsSystemTimeWithinX(start, end));
   }
   test_end_step(2);
@@ -382,6 +403,9 @@ static void nil_test_008_004_execute(void) {
     do {
       chThdWait(chThdCreate(&td));
       n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
     } while (chVTIsSystemTimeWithinX(start, end));
   }
   test_end_step(1);
@@ -446,6 +470,9 @@ static void nil_test_008_005_execute(void) {
     do {
       chThdWait(chThdCreate(&td));
       n++;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
     } while (chVTIsSystemTimeWithinX(start, end));
   }
   test_end_step(1);
@@ -541,25 +568,225 @@ static const testcase_t nil_test_008_006 = {
 };
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
 /**
- * @page nil_test_008_007 [8.7] RAM Footprint
+ * @page nil_test_008_007 [8.7] Semaphores ping-pong performance
  *
  * <h2>Description</h2>
- * The memory size of the various kernel objects is printed.
+ * A thread with higher priority waits on a semaphore into a loop, the
+ * tester thread signals the semaphore as fast as possible. Each signal
+ * and each wait cause a context switch.<br> The performance is
+ * calculated by measuring the number of iterations after a second of
+ * continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES == TRUE
+ * .
  *
  * <h2>Test Steps</h2>
- * - [8.7.1] The size of the system area is printed.
- * - [8.7.2] The size of a thread structure is printed.
- * - [8.7.3] The size of a semaphore structure is printed.
- * - [8.7.4] The size of an event source is printed.
- * - [8.7.5] The size of an event listener is printed.
- * - [8.7.6] The size of a mailbox is printed.
+ * - [8.7.1] The waiting thread is started at an higher priority than
+ *   the current thread.
+ * - [8.7.2] The semaphore is signaled as fast as possible in a one
+ *   second time window.
+ * - [8.7.3] The waiting thread is stopped by resetting the semaphore.
+ * - [8.7.4] Score is printed.
  * .
  */
 
+static void nil_test_008_007_setup(void) {
+  chSemObjectInit(&sem1, 0);
+}
+
 static void nil_test_008_007_execute(void) {
+  thread_t *tp;
+  uint32_t n;
+
+  /* [8.7.1] The waiting thread is started at an higher priority than
+     the current thread.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "waiter",
+      .wbase = wa_common,
+      .wend  = THD_WORKING_AREA_END(wa_common),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = bmk_thread7,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [8.7.2] The semaphore is signaled as fast as possible in a one
+     second time window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      n += 4;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [8.7.3] The waiting thread is stopped by resetting the semaphore.*/
+  test_set_step(3);
+  {
+    chSemReset(&sem1, 0);
+    chThdWait(tp);
+  }
+  test_end_step(3);
+
+  /* [8.7.4] Score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_print(" wait+signal/S, ");
+    test_printn(n << 1);
+    test_println(" ctxswc/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t nil_test_008_007 = {
+  "Semaphores ping-pong performance",
+  nil_test_008_007_setup,
+  NULL,
+  nil_test_008_007_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
-  /* [8.7.1] The size of the system area is printed.*/
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page nil_test_008_008 [8.8] Timeouts ping-pong performance
+ *
+ * <h2>Description</h2>
+ * A thread with higher priority waits on a semaphore with a timeout
+ * into a loop, the tester thread signals the semaphore as fast as
+ * possible. Each wait arms a timeout and each signal disarms it before
+ * its expiration.<br> The performance is calculated by measuring the
+ * number of iterations after a second of continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.8.1] The waiting thread is started at an higher priority than
+ *   the current thread.
+ * - [8.8.2] The semaphore is signaled as fast as possible in a one
+ *   second time window.
+ * - [8.8.3] The waiting thread is stopped by resetting the semaphore.
+ * - [8.8.4] Score is printed.
+ * .
+ */
+
+static void nil_test_008_008_setup(void) {
+  chSemObjectInit(&sem1, 0);
+}
+
+static void nil_test_008_008_execute(void) {
+  thread_t *tp;
+  uint32_t n;
+
+  /* [8.8.1] The waiting thread is started at an higher priority than
+     the current thread.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "waiter",
+      .wbase = wa_common,
+      .wend  = THD_WORKING_AREA_END(wa_common),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = bmk_thread8,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [8.8.2] The semaphore is signaled as fast as possible in a one
+     second time window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      chSemSignal(&sem1);
+      n += 4;
+#if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+#endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [8.8.3] The waiting thread is stopped by resetting the semaphore.*/
+  test_set_step(3);
+  {
+    chSemReset(&sem1, 0);
+    chThdWait(tp);
+  }
+  test_end_step(3);
+
+  /* [8.8.4] Score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" timeouts arm+disarm/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t nil_test_008_008 = {
+  "Timeouts ping-pong performance",
+  nil_test_008_008_setup,
+  NULL,
+  nil_test_008_008_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES == TRUE */
+
+/**
+ * @page nil_test_008_009 [8.9] RAM Footprint
+ *
+ * <h2>Description</h2>
+ * The memory size of the various kernel objects is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.9.1] The size of the system area is printed.
+ * - [8.9.2] The size of a thread structure is printed.
+ * - [8.9.3] The size of a semaphore structure is printed.
+ * - [8.9.4] The size of an event source is printed.
+ * - [8.9.5] The size of an event listener is printed.
+ * - [8.9.6] The size of a mailbox is printed.
+ * .
+ */
+
+static void nil_test_008_009_execute(void) {
+
+  /* [8.9.1] The size of the system area is printed.*/
   test_set_step(1);
   {
     test_print("--- OS    : ");
@@ -568,7 +795,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(1);
 
-  /* [8.7.2] The size of a thread structure is printed.*/
+  /* [8.9.2] The size of a thread structure is printed.*/
   test_set_step(2);
   {
     test_print("--- Thread: ");
@@ -577,7 +804,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(2);
 
-  /* [8.7.3] The size of a semaphore structure is printed.*/
+  /* [8.9.3] The size of a semaphore structure is printed.*/
   test_set_step(3);
   {
 #if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
@@ -588,7 +815,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(3);
 
-  /* [8.7.4] The size of an event source is printed.*/
+  /* [8.9.4] The size of an event source is printed.*/
   test_set_step(4);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -599,7 +826,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(4);
 
-  /* [8.7.5] The size of an event listener is printed.*/
+  /* [8.9.5] The size of an event listener is printed.*/
   test_set_step(5);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -610,7 +837,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(5);
 
-  /* [8.7.6] The size of a mailbox is printed.*/
+  /* [8.9.6] The size of a mailbox is printed.*/
   test_set_step(6);
   {
 #if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
@@ -622,11 +849,11 @@ static void nil_test_008_007_execute(void) {
   test_end_step(6);
 }
 
-static const testcase_t nil_test_008_007 = {
+static const testcase_t nil_test_008_009 = {
   "RAM Footprint",
   NULL,
   NULL,
-  nil_test_008_007_execute
+  nil_test_008_009_execute
 };
 
 /****************************************************************************
@@ -649,7 +876,13 @@ const testcase_t * const nil_test_sequence_008_array[] = {
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
   &nil_test_008_006,
 #endif
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
   &nil_test_008_007,
+#endif
+#if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
+  &nil_test_008_008,
+#endif
+  &nil_test_008_009,
   NULL
 };
 
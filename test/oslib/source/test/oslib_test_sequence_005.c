@@ -37,6 +37,8 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_005_001
+ * - @subpage oslib_test_005_002
+ * - @subpage oslib_test_005_003
  * .
  */
 
@@ -110,6 +112,60 @@ static THD_FUNCTION(Thread1, arg) {
   chThdExit(0x0FA5);
 }
 
+typedef struct {
+  char              a;
+  char              b;
+  char              c;
+} dis_args_t;
+
+static msg_t dis_typed(void *argsp) {
+  const dis_args_t *ap = (const dis_args_t *)argsp;
+
+  test_emit_token(ap->a);
+  test_emit_token(ap->b);
+  test_emit_token(ap->c);
+
+  return (msg_t)ap->a;
+}
+
+static msg_t dis_typed_end(void *argsp) {
+
+  (void)argsp;
+  test_emit_token('Z');
+  exit_flag = true;
+
+  return (msg_t)0xAA55;
+}
+
+static delegate_queue_t dis_queue;
+static delegate_async_t dis_buffer[8];
+static size_t dis_max_batch;
+static const char dis_tokens[8] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H'};
+
+static msg_t dis_async(void *argsp) {
+
+  test_emit_token(*(const char *)argsp);
+
+  return MSG_OK;
+}
+
+static THD_FUNCTION(Thread2, arg) {
+  size_t n;
+
+  (void)arg;
+
+  exit_flag = false;
+  dis_max_batch = (size_t)0;
+  do {
+    n = chDelegateDispatchQueue(&dis_queue);
+    if (n > dis_max_batch) {
+      dis_max_batch = n;
+    }
+  } while (!exit_flag);
+
+  chThdExit(0x0FA5);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -190,6 +246,152 @@ static const testcase_t oslib_test_005_001 = {
   oslib_test_005_001_execute
 };
 
+/**
+ * @page oslib_test_005_002 [5.2] Typed calls test
+ *
+ * <h2>Description</h2>
+ * The typed call API is tested for functionality.
+ *
+ * <h2>Test Steps</h2>
+ * - [5.2.1] Starting the dispatcher thread.
+ * - [5.2.2] Calling functions with arguments structures, checking the
+ *   result and the emitted tokens.
+ * - [5.2.3] Waiting for the thread to terminate.
+ * .
+ */
+
+static void oslib_test_005_002_execute(void) {
+  thread_t *tp;
+
+  /* [5.2.1] Starting the dispatcher thread.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "dispatcher",
+      .wbase = waThread1,
+      .wend  = THD_WORKING_AREA_END(waThread1),
+      .prio  = chThdGetPriorityX() + 1,
+      .funcp = Thread1,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [5.2.2] Calling functions with arguments structures, checking the
+     result and the emitted tokens.*/
+  test_set_step(2);
+  {
+    dis_args_t args1 = {'A', 'B', 'C'};
+    dis_args_t args2 = {'D', 'E', 'F'};
+    msg_t retval;
+
+    retval = chDelegateCall(tp, dis_typed, (void *)&args1);
+    test_assert(retval == (msg_t)'A', "invalid return value");
+    retval = chDelegateCall(tp, dis_typed, (void *)&args2);
+    test_assert(retval == (msg_t)'D', "invalid return value");
+    retval = chDelegateCall(tp, dis_typed_end, NULL);
+    test_assert(retval == 0xAA55, "invalid return value");
+    test_assert_sequence("ABCDEFZ", "unexpected tokens");
+  }
+  test_end_step(2);
+
+  /* [5.2.3] Waiting for the thread to terminate.*/
+  test_set_step(3);
+  {
+    msg_t msg = chThdWait(tp);
+    test_assert(msg == 0x0FA5, "invalid exit code");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_005_002 = {
+  "Typed calls test",
+  NULL,
+  NULL,
+  oslib_test_005_002_execute
+};
+
+/**
+ * @page oslib_test_005_003 [5.3] Asynchronous calls test
+ *
+ * <h2>Description</h2>
+ * The asynchronous calls API is tested for functionality, calls posted
+ * together are expected to be executed in a single dispatcher wakeup.
+ *
+ * <h2>Test Steps</h2>
+ * - [5.3.1] Initializing the queue and starting the dispatcher thread.
+ * - [5.3.2] Posting eight calls from a critical zone, a ninth call is
+ *   rejected because the queue is full.
+ * - [5.3.3] Posting the termination call, waiting for the thread to
+ *   terminate and checking the emitted tokens.
+ * .
+ */
+
+static void oslib_test_005_003_execute(void) {
+  thread_t *tp;
+
+  /* [5.3.1] Initializing the queue and starting the dispatcher thread.*/
+  test_set_step(1);
+  {
+    chDelegateQueueObjectInit(&dis_queue, dis_buffer, 8);
+    thread_descriptor_t td = {
+      .name  = "dispatcher",
+      .wbase = waThread1,
+      .wend  = THD_WORKING_AREA_END(waThread1),
+      .prio  = chThdGetPriorityX() + 1,
+      .funcp = Thread2,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [5.3.2] Posting eight calls from a critical zone, a ninth call is
+     rejected because the queue is full.*/
+  test_set_step(2);
+  {
+    unsigned i, n;
+    msg_t msg;
+
+    chSysLock();
+    n = 0U;
+    for (i = 0U; i < 8U; i++) {
+      if (chDelegatePostI(&dis_queue, dis_async, (void *)&dis_tokens[i]) == MSG_OK) {
+        n++;
+      }
+    }
+    msg = chDelegatePostI(&dis_queue, dis_async, (void *)&dis_tokens[0]);
+    chSchRescheduleS();
+    chSysUnlock();
+
+    test_assert(n == 8U, "post failed");
+    test_assert(msg == MSG_TIMEOUT, "queue not full");
+  }
+  test_end_step(2);
+
+  /* [5.3.3] Posting the termination call, waiting for the thread to
+     terminate and checking the emitted tokens.*/
+  test_set_step(3);
+  {
+    msg_t msg;
+
+    chDelegatePost(&dis_queue, dis_typed_end, NULL);
+    msg = chThdWait(tp);
+    test_assert(msg == 0x0FA5, "invalid exit code");
+    test_assert_sequence("ABCDEFGHZ", "unexpected tokens");
+    test_assert(dis_max_batch >= (size_t)8, "calls not batched");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_005_003 = {
+  "Asynchronous calls test",
+  NULL,
+  NULL,
+  oslib_test_005_003_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -199,6 +401,8 @@ static const testcase_t oslib_test_005_001 = {
  */
 const testcase_t * const oslib_test_sequence_005_array[] = {
   &oslib_test_005_001,
+  &oslib_test_005_002,
+  &oslib_test_005_003,
   NULL
 };
 
@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_006_001
+ * - @subpage oslib_test_006_002
  * .
  */
 
@@ -243,6 +244,110 @@ static const testcase_t oslib_test_006_001 = {
   oslib_test_006_001_execute
 };
 
+/**
+ * @page oslib_test_006_002 [6.2] LRU counter accounting
+ *
+ * <h2>Description</h2>
+ * The LRU counter semaphore is checked while objects are retrieved and
+ * released, cache hits and cache misses must both keep the counter
+ * equal to the number of objects in the LRU list.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Cache initialization, all objects are in the LRU list.
+ * - [6.2.2] Getting and releasing an object not in cache, the object is
+ *   marked as valid before release.
+ * - [6.2.3] Getting and releasing the same object repeatedly, each
+ *   retrieval is a cache hit taking the object from the LRU list.
+ * - [6.2.4] Getting all objects without releasing them, the LRU list is
+ *   emptied, then releasing them.
+ * .
+ */
+
+static void oslib_test_006_002_execute(void) {
+  oc_object_t *objp;
+
+  /* [6.2.1] Cache initialization, all objects are in the LRU list.*/
+  test_set_step(1);
+  {
+    chCacheObjectInit(&cache1,
+                      NUM_HASH_ENTRIES,
+                      hash_headers,
+                      NUM_OBJECTS,
+                      sizeof (cached_object_t),
+                      objects,
+                      obj_read,
+                      obj_write);
+    test_assert_lock(chSemGetCounterI(&cache1.lru_sem) == (cnt_t)NUM_OBJECTS,
+                     "wrong LRU counter");
+  }
+  test_end_step(1);
+
+  /* [6.2.2] Getting and releasing an object not in cache, the object is
+     marked as valid before release.*/
+  test_set_step(2);
+  {
+    objp = chCacheGetObject(&cache1, 0U, 0U);
+    test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U, "in sync");
+    test_assert_lock(chSemGetCounterI(&cache1.lru_sem) ==
+                     (cnt_t)(NUM_OBJECTS - 1), "wrong LRU counter");
+
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+    chCacheReleaseObject(&cache1, objp);
+    test_assert_lock(chSemGetCounterI(&cache1.lru_sem) == (cnt_t)NUM_OBJECTS,
+                     "wrong LRU counter");
+  }
+  test_end_step(2);
+
+  /* [6.2.3] Getting and releasing the same object repeatedly, each
+     retrieval is a cache hit taking the object from the LRU list.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    for (i = 0; i < 4; i++) {
+      objp = chCacheGetObject(&cache1, 0U, 0U);
+      test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U, "not in sync");
+      test_assert_lock(chSemGetCounterI(&cache1.lru_sem) ==
+                       (cnt_t)(NUM_OBJECTS - 1), "wrong LRU counter");
+
+      chCacheReleaseObject(&cache1, objp);
+      test_assert_lock(chSemGetCounterI(&cache1.lru_sem) == (cnt_t)NUM_OBJECTS,
+                       "wrong LRU counter");
+    }
+  }
+  test_end_step(3);
+
+  /* [6.2.4] Getting all objects without releasing them, the LRU list is
+     emptied, then releasing them.*/
+  test_set_step(4);
+  {
+    oc_object_t *objps[NUM_OBJECTS];
+    unsigned i;
+
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      objps[i] = chCacheGetObject(&cache1, 0U, (uint32_t)i);
+    }
+    test_assert_lock(chSemGetCounterI(&cache1.lru_sem) == (cnt_t)0,
+                     "wrong LRU counter");
+
+    for (i = 0; i < NUM_OBJECTS; i++) {
+      chCacheReleaseObject(&cache1, objps[i]);
+    }
+    test_assert_lock(chSemGetCounterI(&cache1.lru_sem) == (cnt_t)NUM_OBJECTS,
+                     "wrong LRU counter");
+
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_006_002 = {
+  "LRU counter accounting",
+  NULL,
+  NULL,
+  oslib_test_006_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -252,6 +357,7 @@ static const testcase_t oslib_test_006_001 = {
  */
 const testcase_t * const oslib_test_sequence_006_array[] = {
   &oslib_test_006_001,
+  &oslib_test_006_002,
   NULL
 };
 
@@ -34,6 +34,9 @@
  * - @subpage rt_test_005_002
  * - @subpage rt_test_005_003
  * - @subpage rt_test_005_004
+ * - @subpage rt_test_005_005
+ * - @subpage rt_test_005_006
+ * - @subpage rt_test_005_007
  * .
  */
 
@@ -46,6 +49,70 @@ static THD_FUNCTION(thread, p) {
   test_emit_token(*(char *)p);
 }
 
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+static os_instance_t * volatile ran_on;
+static volatile bool spinning;
+
+static THD_FUNCTION(thread1, p) {
+
+  ran_on = currcore;
+  test_emit_token(*(char *)p);
+}
+
+static THD_FUNCTION(thread2, p) {
+
+  chThdSleepMilliseconds(50);
+  ran_on = currcore;
+  test_emit_token(*(char *)p);
+}
+
+static THD_FUNCTION(thread3, p) {
+
+  while (spinning) {
+  }
+  test_emit_token(*(char *)p);
+}
+
+static thread_t *create_pinned(void *wap, tprio_t prio, tfunc_t funcp,
+                               void *arg) {
+  os_instance_t *oip = currcore;
+  stkalign_t *wbase = (stkalign_t *)wap;
+  thread_descriptor_t td = THD_DESCRIPTOR_MASK("pinned", wbase,
+                                   wbase + (WA_SIZE / sizeof (stkalign_t)),
+                                   prio, funcp, arg, oip,
+                                   CH_AFFINITY_CORE(oip->core_id));
+
+  return chThdCreate(&td);
+}
+
+static os_instance_t *find_instance(void) {
+  core_id_t core_id;
+
+  for (core_id = 0U; core_id < (core_id_t)PORT_CORES_NUMBER; core_id++) {
+    os_instance_t *oip = ch_system.instances[core_id];
+
+    if ((oip != NULL) && (oip != currcore)) {
+      return oip;
+    }
+  }
+
+  return NULL;
+}
+
+static core_mask_t running_mask(void) {
+  core_mask_t mask = (core_mask_t)0;
+  core_id_t core_id;
+
+  for (core_id = 0U; core_id < (core_id_t)PORT_CORES_NUMBER; core_id++) {
+    if (ch_system.instances[core_id] != NULL) {
+      mask |= CH_AFFINITY_CORE(core_id);
+    }
+  }
+
+  return mask;
+}
+#endif /* CH_CFG_USE_THREADS_MIGRATION == TRUE */
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -339,6 +406,335 @@ static const testcase_t rt_test_005_004 = {
 };
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_005 [5.5] Threads migration
+ *
+ * <h2>Description</h2>
+ * Threads are moved between OS instances using chThdMigrate(). Ready
+ * threads are moved, threads waiting with a timeout and terminated
+ * threads are expected to be refused. If another OS instance is running
+ * then a thread and the tester thread itself are moved to it.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_THREADS_MIGRATION == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.5.1] Thread A is created at priority P(-1) restricted to the
+ *   current core, it is ready and not running. Moving it to its own
+ *   instance is expected to succeed leaving it in place.
+ * - [5.5.2] Thread A is created at priority P(+1), it sleeps for 50mS.
+ *   Moving it is expected to fail because its timeout is armed, the
+ *   timeout is expected to wake it on its instance.
+ * - [5.5.3] Thread A is created at priority P(+1) and terminates.
+ *   Moving it is expected to fail.
+ * - [5.5.4] If another OS instance is running then thread A is created
+ *   at priority P(-1), it is allowed to run on the current core and on
+ *   the other one and it is moved to the other instance. A is expected
+ *   to run on the other instance.
+ * - [5.5.5] If another OS instance is running then the tester thread,
+ *   allowed to run on all cores, moves itself to it and then back to
+ *   its instance. The tester thread affinity mask is restored.
+ * .
+ */
+
+static void rt_test_005_005_execute(void) {
+  tprio_t prio;
+  os_instance_t *cip, *oip;
+  core_mask_t mask;
+  msg_t msg;
+
+  /* [5.5.1] Thread A is created at priority P(-1) restricted to the
+     current core, it is ready and not running. Moving it to its own
+     instance is expected to succeed leaving it in place.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    cip = currcore;
+    threads[0] = create_pinned(wa[0], prio-1, thread1, "A");
+    msg = chThdMigrate(threads[0], cip);
+    test_assert(msg == MSG_OK, "migration failed");
+    test_assert(threads[0]->owner == cip, "wrong owner");
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+    test_assert(ran_on == cip, "wrong instance");
+  }
+  test_end_step(1);
+
+  /* [5.5.2] Thread A is created at priority P(+1), it sleeps for 50mS.
+     Moving it is expected to fail because its timeout is armed, the
+     timeout is expected to wake it on its instance.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread2, "A");
+    msg = chThdMigrate(threads[0], cip);
+    test_assert(msg == MSG_RESET, "waiting thread moved");
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+    test_assert(ran_on == cip, "wrong instance");
+  }
+  test_end_step(2);
+
+  /* [5.5.3] Thread A is created at priority P(+1) and terminates.
+     Moving it is expected to fail.*/
+  test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread1, "A");
+    msg = chThdMigrate(threads[0], cip);
+    test_assert(msg == MSG_RESET, "terminated thread moved");
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+  }
+  test_end_step(3);
+
+  /* [5.5.4] If another OS instance is running then thread A is created
+     at priority P(-1), it is allowed to run on the current core and on
+     the other one and it is moved to the other instance. A is expected
+     to run on the other instance.*/
+  test_set_step(4);
+  {
+    oip = find_instance();
+    if (oip != NULL) {
+      threads[0] = create_pinned(wa[0], prio-1, thread1, "A");
+      msg = chThdSetAffinity(threads[0], CH_AFFINITY_CORE(cip->core_id) |
+                                         CH_AFFINITY_CORE(oip->core_id));
+      test_assert(msg == MSG_OK, "mask refused");
+      msg = chThdMigrate(threads[0], oip);
+      test_assert(msg == MSG_OK, "migration failed");
+      test_wait_threads();
+      test_assert_sequence("A", "invalid sequence");
+      test_assert(ran_on == oip, "wrong instance");
+    }
+  }
+  test_end_step(4);
+
+  /* [5.5.5] If another OS instance is running then the tester thread,
+     allowed to run on all cores, moves itself to it and then back to
+     its instance. The tester thread affinity mask is restored.*/
+  test_set_step(5);
+  {
+    if (oip != NULL) {
+      mask = chThdGetAffinityX(chThdGetSelfX());
+      (void) chThdSetAffinity(chThdGetSelfX(), CH_AFFINITY_ALL);
+      msg = chThdMigrate(chThdGetSelfX(), oip);
+      test_assert(msg == MSG_OK, "migration failed");
+      test_assert(currcore == oip, "not moved");
+      msg = chThdMigrate(chThdGetSelfX(), cip);
+      test_assert(msg == MSG_OK, "migration failed");
+      test_assert(currcore == cip, "not moved back");
+      msg = chThdSetAffinity(chThdGetSelfX(), mask);
+      test_assert(msg == MSG_OK, "mask refused");
+    }
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_005_005 = {
+  "Threads migration",
+  NULL,
+  NULL,
+  rt_test_005_005_execute
+};
+#endif /* CH_CFG_USE_THREADS_MIGRATION == TRUE */
+
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_006 [5.6] Threads affinity
+ *
+ * <h2>Description</h2>
+ * The cores affinity mask of a thread is changed using
+ * chThdSetAffinity(). A thread is expected to stay on its instance
+ * while allowed by the mask, masks not allowing any running instance
+ * are expected to be refused. If another OS instance is running then
+ * the thread is restricted to it and is expected to be moved there.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_THREADS_MIGRATION == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.6.1] A zero mask is set on the tester thread, it is expected to
+ *   allow all cores. The previous mask is restored, the tester thread
+ *   is expected to stay on its instance.
+ * - [5.6.2] Thread A is created at priority P(-1) restricted to the
+ *   current core. Moving A to another running OS instance is expected
+ *   to fail because the mask does not allow it. A mask not allowing any
+ *   running instance is expected to be refused keeping the previous
+ *   mask.
+ * - [5.6.3] If another OS instance is running then A is restricted to
+ *   its core, A is expected to be moved and to run on that instance.
+ * .
+ */
+
+static void rt_test_005_006_execute(void) {
+  tprio_t prio;
+  os_instance_t *cip, *oip;
+  core_mask_t mask;
+  msg_t msg;
+
+  /* [5.6.1] A zero mask is set on the tester thread, it is expected to
+     allow all cores. The previous mask is restored, the tester thread
+     is expected to stay on its instance.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    cip = currcore;
+    mask = chThdGetAffinityX(chThdGetSelfX());
+    msg = chThdSetAffinity(chThdGetSelfX(), (core_mask_t)0);
+    test_assert(msg == MSG_OK, "mask refused");
+    test_assert(chThdGetAffinityX(chThdGetSelfX()) == CH_AFFINITY_ALL, "wrong mask");
+    msg = chThdSetAffinity(chThdGetSelfX(), mask);
+    test_assert(msg == MSG_OK, "mask refused");
+    test_assert(chThdGetAffinityX(chThdGetSelfX()) == mask, "wrong mask");
+    test_assert(currcore == cip, "tester moved");
+  }
+  test_end_step(1);
+
+  /* [5.6.2] Thread A is created at priority P(-1) restricted to the
+     current core. Moving A to another running OS instance is expected
+     to fail because the mask does not allow it. A mask not allowing any
+     running instance is expected to be refused keeping the previous
+     mask.*/
+  test_set_step(2);
+  {
+    threads[0] = create_pinned(wa[0], prio-1, thread1, "A");
+    mask = CH_AFFINITY_CORE(cip->core_id);
+    oip = find_instance();
+    if (oip != NULL) {
+      msg = chThdMigrate(threads[0], oip);
+      test_assert(msg == MSG_RESET, "moved outside the mask");
+    }
+    if (~running_mask() != (core_mask_t)0) {
+      msg = chThdSetAffinity(threads[0], ~running_mask());
+      test_assert(msg == MSG_RESET, "mask accepted");
+      test_assert(chThdGetAffinityX(threads[0]) == mask, "mask changed");
+    }
+    test_assert(threads[0]->owner == cip, "wrong owner");
+    test_assert_sequence("", "thread ran");
+  }
+  test_end_step(2);
+
+  /* [5.6.3] If another OS instance is running then A is restricted to
+     its core, A is expected to be moved and to run on that instance.*/
+  test_set_step(3);
+  {
+    if (oip != NULL) {
+      msg = chThdSetAffinity(threads[0], CH_AFFINITY_CORE(oip->core_id));
+      test_assert(msg == MSG_OK, "mask refused");
+      test_assert(threads[0]->owner == oip, "not moved");
+    }
+    else {
+      oip = cip;
+    }
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+    test_assert(ran_on == oip, "wrong instance");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_005_006 = {
+  "Threads affinity",
+  NULL,
+  NULL,
+  rt_test_005_006_execute
+};
+#endif /* CH_CFG_USE_THREADS_MIGRATION == TRUE */
+
+#if (CH_CFG_SMP_BALANCE_INTERVAL > 0) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_005_007 [5.7] Load balancing
+ *
+ * <h2>Description</h2>
+ * The idle OS instances pull ready threads waiting on busy instances
+ * using chSchBalance(). Threads are expected to be pulled only by
+ * instances allowed by their affinity mask.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_SMP_BALANCE_INTERVAL > 0
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [5.7.1] Thread A is created at priority P(-1) restricted to the
+ *   current core, then a balancing pass is performed. A is expected to
+ *   be left waiting on its instance.
+ * - [5.7.2] If another OS instance is running then thread B is created
+ *   at priority P(-1) and restricted to its core, B keeps that instance
+ *   busy. Thread A is created at priority P(-2), it is allowed to run
+ *   on the current core and on the other one, then it is moved behind
+ *   B. The tester thread waits for A, the current instance becomes idle
+ *   and is expected to pull A.
+ * .
+ */
+
+static void rt_test_005_007_execute(void) {
+  tprio_t prio;
+  os_instance_t *cip, *oip;
+  msg_t msg;
+
+  /* [5.7.1] Thread A is created at priority P(-1) restricted to the
+     current core, then a balancing pass is performed. A is expected to
+     be left waiting on its instance.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    cip = currcore;
+    threads[0] = create_pinned(wa[0], prio-1, thread1, "A");
+    chSchBalance();
+    test_assert(threads[0]->owner == cip, "wrong owner");
+    test_assert_sequence("", "thread ran");
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+    test_assert(ran_on == cip, "wrong instance");
+  }
+  test_end_step(1);
+
+  /* [5.7.2] If another OS instance is running then thread B is created
+     at priority P(-1) and restricted to its core, B keeps that instance
+     busy. Thread A is created at priority P(-2), it is allowed to run
+     on the current core and on the other one, then it is moved behind
+     B. The tester thread waits for A, the current instance becomes idle
+     and is expected to pull A.*/
+  test_set_step(2);
+  {
+    oip = find_instance();
+    if (oip != NULL) {
+      spinning = true;
+      threads[1] = create_pinned(wa[1], prio-1, thread3, "B");
+      msg = chThdSetAffinity(threads[1], CH_AFFINITY_CORE(oip->core_id));
+      test_assert(msg == MSG_OK, "mask refused");
+      threads[0] = create_pinned(wa[0], prio-2, thread1, "A");
+      msg = chThdSetAffinity(threads[0], CH_AFFINITY_CORE(cip->core_id) |
+                                         CH_AFFINITY_CORE(oip->core_id));
+      test_assert(msg == MSG_OK, "mask refused");
+      msg = chThdMigrate(threads[0], oip);
+      test_assert(msg == MSG_OK, "migration failed");
+      chThdWait(threads[0]);
+      threads[0] = NULL;
+      spinning = false;
+      test_wait_threads();
+      test_assert_sequence("AB", "invalid sequence");
+      test_assert(ran_on == cip, "not pulled");
+    }
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_005_007 = {
+  "Load balancing",
+  NULL,
+  NULL,
+  rt_test_005_007_execute
+};
+#endif /* CH_CFG_SMP_BALANCE_INTERVAL > 0 */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -352,6 +748,15 @@ const testcase_t * const rt_test_sequence_005_array[] = {
   &rt_test_005_003,
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   &rt_test_005_004,
+#endif
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+  &rt_test_005_005,
+#endif
+#if (CH_CFG_USE_THREADS_MIGRATION == TRUE) || defined(__DOXYGEN__)
+  &rt_test_005_006,
+#endif
+#if (CH_CFG_SMP_BALANCE_INTERVAL > 0) || defined(__DOXYGEN__)
+  &rt_test_005_007,
 #endif
   NULL
 };
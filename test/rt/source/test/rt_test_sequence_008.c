@@ -45,6 +45,17 @@
  * - @subpage rt_test_008_007
  * - @subpage rt_test_008_008
  * - @subpage rt_test_008_009
+ * - @subpage rt_test_008_010
+ * - @subpage rt_test_008_011
+ * - @subpage rt_test_008_012
+ * - @subpage rt_test_008_013
+ * - @subpage rt_test_008_014
+ * - @subpage rt_test_008_015
+ * - @subpage rt_test_008_016
+ * - @subpage rt_test_008_017
+ * - @subpage rt_test_008_018
+ * - @subpage rt_test_008_019
+ * - @subpage rt_test_008_020
  * .
  */
 
@@ -228,6 +239,107 @@ static THD_FUNCTION(thread9, p) {
 }
 #endif /* CH_CFG_USE_CONDVARS */
 
+#if CH_CFG_USE_RWLOCKS || defined(__DOXYGEN__)
+static RWLOCK_DECL(rw1);
+static RWLOCK_DECL(rw2);
+
+static THD_FUNCTION(thread10R, p) {
+
+  chRwlReadLock(&rw1);
+  test_emit_token(*(char *)p);
+  chRwlReadUnlock(&rw1);
+}
+
+static THD_FUNCTION(thread10W, p) {
+
+  chRwlWriteLock(&rw1);
+  test_emit_token(*(char *)p);
+  chRwlWriteUnlock(&rw1);
+}
+
+static THD_FUNCTION(thread11, p) {
+
+  if (chRwlWriteLockTimeout(&rw1, TIME_MS2I(50)) == MSG_OK) {
+    chRwlWriteUnlock(&rw1);
+  }
+  else {
+    test_emit_token(*(char *)p);
+  }
+}
+
+static THD_FUNCTION(thread15, p) {
+
+  chRwlReadLock(&rw1);
+  chThdSleepMilliseconds(50);
+  test_emit_token(*(char *)p);
+  chRwlReadUnlock(&rw1);
+}
+
+#if CH_CFG_USE_CONDVARS || defined(__DOXYGEN__)
+static THD_FUNCTION(thread16, p) {
+
+  chRwlReadLock(&rw1);
+  chMtxLock(&m1);
+  chCondWait(&c1);
+  test_emit_token(*(char *)p);
+  chMtxUnlock(&m1);
+  chRwlReadUnlock(&rw1);
+}
+#endif
+
+static THD_FUNCTION(thread17, p) {
+
+  chRwlReadLock(&rw2);
+  chThdSleepMilliseconds(100);
+  test_emit_token(*(char *)p);
+  chRwlReadUnlock(&rw2);
+}
+
+static THD_FUNCTION(thread18, p) {
+
+  chRwlReadLock(&rw2);
+  chRwlWriteLock(&rw1);
+  test_emit_token(*(char *)p);
+  chRwlWriteUnlock(&rw1);
+  chRwlReadUnlock(&rw2);
+}
+
+static THD_FUNCTION(thread19, p) {
+
+  chRwlWriteLock(&rw2);
+  test_emit_token(*(char *)p);
+  chRwlWriteUnlock(&rw2);
+}
+#endif /* CH_CFG_USE_RWLOCKS */
+
+#if CH_CFG_USE_MUTEXES_CEILING || defined(__DOXYGEN__)
+static THD_FUNCTION(thread12, p) {
+
+  chMtxLock(&m1);
+  if (chThdGetPriorityX() == m1.ceiling) {
+    test_emit_token(*(char *)p);
+  }
+  chMtxUnlock(&m1);
+}
+
+static THD_FUNCTION(thread13, p) {
+
+  chMtxLock(&m2);
+  chThdSleepMilliseconds(20);
+  chMtxLock(&m1);
+  test_emit_token(*(char *)p);
+  chMtxUnlock(&m1);
+  chMtxUnlock(&m2);
+}
+
+static THD_FUNCTION(thread14, p) {
+
+  chMtxLock(&m2);
+  test_emit_token(*(char *)p);
+  chMtxUnlock(&m2);
+}
+#endif /* CH_CFG_USE_MUTEXES_CEILING */
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -1078,36 +1190,1090 @@ static const testcase_t rt_test_008_009 = {
 };
 #endif /* CH_CFG_USE_CONDVARS == TRUE */
 
-/****************************************************************************
- * Exported data.
- ****************************************************************************/
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_010 [8.10] Reader-writer lock, read and write access
+ *
+ * <h2>Description</h2>
+ * The tester thread acquires a reader-writer lock for read and for
+ * write access verifying that readers share the lock while a writer
+ * owns it exclusively.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.10.1] The lock is acquired twice for read access, a write access
+ *   attempt must fail.
+ * - [8.10.2] The read accesses are released, the lock must be free.
+ * - [8.10.3] The lock is acquired for write access.
+ * - [8.10.4] The write access is released, the lock must be free.
+ * .
+ */
+
+static void rt_test_008_010_setup(void) {
+  chRwlObjectInit(&rw1);
+}
+
+static void rt_test_008_010_execute(void) {
+
+  /* [8.10.1] The lock is acquired twice for read access, a write access
+     attempt must fail.*/
+  test_set_step(1);
+  {
+    chRwlReadLock(&rw1);
+    chRwlReadLock(&rw1);
+    test_assert(rw1.readers == 2, "wrong readers count");
+    test_assert(!chRwlTryWriteLock(&rw1), "write access allowed to readers");
+  }
+  test_end_step(1);
+
+  /* [8.10.2] The read accesses are released, the lock must be free.*/
+  test_set_step(2);
+  {
+    chRwlReadUnlock(&rw1);
+    chRwlReadUnlock(&rw1);
+    test_assert(rw1.readers == 0, "still read locked");
+    test_assert(rw1.writer == NULL, "unexpected writer");
+  }
+  test_end_step(2);
+
+  /* [8.10.3] The lock is acquired for write access.*/
+  test_set_step(3);
+  {
+    chRwlWriteLock(&rw1);
+    test_assert(rw1.writer == chThdGetSelfX(), "not owner");
+    test_assert(rw1.readers == 0, "unexpected readers");
+  }
+  test_end_step(3);
+
+  /* [8.10.4] The write access is released, the lock must be free.*/
+  test_set_step(4);
+  {
+    chRwlWriteUnlock(&rw1);
+    test_assert(rw1.writer == NULL, "still write locked");
+    test_assert(chRwlTryReadLock(&rw1), "read access not allowed");
+    chRwlReadUnlock(&rw1);
+  }
+  test_end_step(4);
+}
 
+static const testcase_t rt_test_008_010 = {
+  "Reader-writer lock, read and write access",
+  rt_test_008_010_setup,
+  NULL,
+  rt_test_008_010_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Array of test cases.
+ * @page rt_test_008_011 [8.11] Reader-writer lock, writer preference and priority inheritance
+ *
+ * <h2>Description</h2>
+ * The tester thread holds the lock for read access, a writer thread and
+ * then a reader thread with increasing priorities queue on the lock.
+ * The reader must wait because of the writer preference and the tester
+ * thread must inherit the priority of both waiting threads.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.11.1] Reading current base priority then acquiring the lock for
+ *   read access.
+ * - [8.11.2] Thread A is created at priority P(+1), it waits for write
+ *   access and boosts the tester thread priority at P(+1).
+ * - [8.11.3] Thread B is created at priority P(+2), it waits for read
+ *   access because there is a writer waiting and boosts the tester
+ *   thread priority at P(+2).
+ * - [8.11.4] Releasing the read access, the tester thread priority goes
+ *   back to P(0), TA acquires the lock, then TB.
+ * - [8.11.5] Checking the order of operations.
+ * .
  */
-const testcase_t * const rt_test_sequence_008_array[] = {
-  &rt_test_008_001,
-#if (CH_DBG_THREADS_PROFILING == TRUE) || defined(__DOXYGEN__)
-  &rt_test_008_002,
-#endif
-#if (CH_DBG_THREADS_PROFILING == TRUE) || defined(__DOXYGEN__)
-  &rt_test_008_003,
-#endif
-  &rt_test_008_004,
-#if (CH_CFG_USE_MUTEXES_RECURSIVE == FALSE) || defined(__DOXYGEN__)
-  &rt_test_008_005,
-#endif
-#if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
-  &rt_test_008_006,
-#endif
-#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
-  &rt_test_008_007,
-#endif
-#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
-  &rt_test_008_008,
-#endif
-#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
-  &rt_test_008_009,
+
+static void rt_test_008_011_setup(void) {
+  chRwlObjectInit(&rw1);
+}
+
+static void rt_test_008_011_execute(void) {
+  tprio_t prio;
+
+  /* [8.11.1] Reading current base priority then acquiring the lock for
+     read access.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chRwlReadLock(&rw1);
+  }
+  test_end_step(1);
+
+  /* [8.11.2] Thread A is created at priority P(+1), it waits for write
+     access and boosts the tester thread priority at P(+1).*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread10W, "A");
+    test_assert(chThdGetPriorityX() == prio + 1, "wrong priority level");
+  }
+  test_end_step(2);
+
+  /* [8.11.3] Thread B is created at priority P(+2), it waits for read
+     access because there is a writer waiting and boosts the tester
+     thread priority at P(+2).*/
+  test_set_step(3);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread10R, "B");
+    test_assert(chThdGetPriorityX() == prio + 2, "wrong priority level");
+    test_assert(!chRwlTryReadLock(&rw1), "writer preference violated");
+  }
+  test_end_step(3);
+
+  /* [8.11.4] Releasing the read access, the tester thread priority goes
+     back to P(0), TA acquires the lock, then TB.*/
+  test_set_step(4);
+  {
+    chRwlReadUnlock(&rw1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+  }
+  test_end_step(4);
+
+  /* [8.11.5] Checking the order of operations.*/
+  test_set_step(5);
+  {
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+    test_assert((rw1.readers == 0) && (rw1.writer == NULL), "not released");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_008_011 = {
+  "Reader-writer lock, writer preference and priority inheritance",
+  rt_test_008_011_setup,
+  NULL,
+  rt_test_008_011_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_012 [8.12] Reader-writer lock, timeouts
+ *
+ * <h2>Description</h2>
+ * The tester thread holds the lock for read access, a writer thread
+ * waits on the lock with a timeout and a reader thread waits behind it.
+ * When the writer gives up the reader must be able to enter.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.12.1] Reading current base priority then acquiring the lock for
+ *   read access.
+ * - [8.12.2] Thread A is created at priority P(+1), it waits for write
+ *   access with a 50mS timeout.
+ * - [8.12.3] Thread B is created at priority P(+2), it waits for read
+ *   access because there is a writer waiting.
+ * - [8.12.4] A read access with timeout is attempted, it must time out
+ *   because there is a writer waiting.
+ * - [8.12.5] Waiting for TA to time out, TB enters the lock then TA
+ *   completes.
+ * - [8.12.6] Releasing the read access, the tester thread priority goes
+ *   back to P(0).
+ * .
+ */
+
+static void rt_test_008_012_setup(void) {
+  chRwlObjectInit(&rw1);
+}
+
+static void rt_test_008_012_execute(void) {
+  tprio_t prio;
+
+  /* [8.12.1] Reading current base priority then acquiring the lock for
+     read access.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chRwlReadLock(&rw1);
+  }
+  test_end_step(1);
+
+  /* [8.12.2] Thread A is created at priority P(+1), it waits for write
+     access with a 50mS timeout.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread11, "A");
+  }
+  test_end_step(2);
+
+  /* [8.12.3] Thread B is created at priority P(+2), it waits for read
+     access because there is a writer waiting.*/
+  test_set_step(3);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread10R, "B");
+  }
+  test_end_step(3);
+
+  /* [8.12.4] A read access with timeout is attempted, it must time out
+     because there is a writer waiting.*/
+  test_set_step(4);
+  {
+    test_assert(chRwlReadLockTimeout(&rw1, TIME_MS2I(10)) == MSG_TIMEOUT,
+                "not timed out");
+    test_assert_sequence("", "invalid sequence");
+  }
+  test_end_step(4);
+
+  /* [8.12.5] Waiting for TA to time out, TB enters the lock then TA
+     completes.*/
+  test_set_step(5);
+  {
+    chThdSleepMilliseconds(100);
+    test_wait_threads();
+    test_assert_sequence("BA", "invalid sequence");
+    test_assert(rw1.readers == 1, "wrong readers count");
+  }
+  test_end_step(5);
+
+  /* [8.12.6] Releasing the read access, the tester thread priority goes
+     back to P(0).*/
+  test_set_step(6);
+  {
+    chRwlReadUnlock(&rw1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_assert(rw1.readers == 0, "still read locked");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t rt_test_008_012 = {
+  "Reader-writer lock, timeouts",
+  rt_test_008_012_setup,
+  NULL,
+  rt_test_008_012_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_013 [8.13] Ceiling mutex, priority raise and restore
+ *
+ * <h2>Description</h2>
+ * The tester thread locks a ceiling mutex and its priority is
+ * immediately raised to the ceiling, a lower priority thread using the
+ * same mutex cannot preempt the owner. The original priority is
+ * restored on unlock.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES_CEILING == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.13.1] Reading current base priority then locking the ceiling
+ *   mutex, the priority must be raised at P(+2).
+ * - [8.13.2] Thread A is created at priority P(+1), it must not preempt
+ *   the mutex owner.
+ * - [8.13.3] Unlocking the mutex, the priority goes back to P(0) and TA
+ *   locks the mutex at the ceiling priority.
+ * .
+ */
+
+static void rt_test_008_013_setup(void) {
+  chMtxObjectInitCeiling(&m1, chThdGetPriorityX() + 2);
+}
+
+static void rt_test_008_013_execute(void) {
+  tprio_t prio;
+
+  /* [8.13.1] Reading current base priority then locking the ceiling
+     mutex, the priority must be raised at P(+2).*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chMtxLock(&m1);
+    test_assert(chThdGetPriorityX() == prio + 2, "not raised to ceiling");
+  }
+  test_end_step(1);
+
+  /* [8.13.2] Thread A is created at priority P(+1), it must not preempt
+     the mutex owner.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread12, "A");
+    test_assert_sequence("", "preempted by a mutex user");
+  }
+  test_end_step(2);
+
+  /* [8.13.3] Unlocking the mutex, the priority goes back to P(0) and TA
+     locks the mutex at the ceiling priority.*/
+  test_set_step(3);
+  {
+    chMtxUnlock(&m1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_008_013 = {
+  "Ceiling mutex, priority raise and restore",
+  rt_test_008_013_setup,
+  NULL,
+  rt_test_008_013_execute
+};
+#endif /* CH_CFG_USE_MUTEXES_CEILING == TRUE */
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_014 [8.14] Ceiling mutex, owner waiting
+ *
+ * <h2>Description</h2>
+ * The tester thread locks a ceiling mutex and then sleeps, a lower
+ * priority thread tries to lock the mutex and is queued without
+ * boosting the owner. On unlock the mutex is handed to the waiting
+ * thread with its priority raised to the ceiling.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES_CEILING == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.14.1] Reading current base priority then locking the ceiling
+ *   mutex.
+ * - [8.14.2] Thread A is created at priority P(+1) then the tester
+ *   thread sleeps, TA is queued on the mutex and the owner priority
+ *   does not change.
+ * - [8.14.3] Unlocking the mutex, the priority goes back to P(0) and TA
+ *   owns the mutex at the ceiling priority.
+ * .
+ */
+
+static void rt_test_008_014_setup(void) {
+  chMtxObjectInitCeiling(&m1, chThdGetPriorityX() + 2);
+}
+
+static void rt_test_008_014_execute(void) {
+  tprio_t prio;
+
+  /* [8.14.1] Reading current base priority then locking the ceiling
+     mutex.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chMtxLock(&m1);
+  }
+  test_end_step(1);
+
+  /* [8.14.2] Thread A is created at priority P(+1) then the tester
+     thread sleeps, TA is queued on the mutex and the owner priority
+     does not change.*/
+  test_set_step(2);
+  {
+    bool b;
+
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread12, "A");
+    chThdSleepMilliseconds(10);
+    chSysLock();
+    b = chMtxQueueNotEmptyS(&m1);
+    chSysUnlock();
+    test_assert(b, "not queued");
+    test_assert(chThdGetPriorityX() == prio + 2, "wrong priority level");
+  }
+  test_end_step(2);
+
+  /* [8.14.3] Unlocking the mutex, the priority goes back to P(0) and TA
+     owns the mutex at the ceiling priority.*/
+  test_set_step(3);
+  {
+    chMtxUnlock(&m1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_008_014 = {
+  "Ceiling mutex, owner waiting",
+  rt_test_008_014_setup,
+  NULL,
+  rt_test_008_014_execute
+};
+#endif /* CH_CFG_USE_MUTEXES_CEILING == TRUE */
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_015 [8.15] Ceiling mutex, boosted requester
+ *
+ * <h2>Description</h2>
+ * Thread A locks a normal mutex and inherits a priority above the
+ * ceiling from thread B waiting on it, then TA tries to lock the
+ * ceiling mutex owned by the tester thread. The tester thread must
+ * inherit the priority of TA as with a normal mutex.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES_CEILING == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.15.1] Reading current base priority then locking the ceiling
+ *   mutex, the priority must be raised at P(+2).
+ * - [8.15.2] Thread A is created at priority P(+1) then the tester
+ *   thread sleeps, TA locks the normal mutex and sleeps.
+ * - [8.15.3] Thread B is created at priority P(+3), it waits on the
+ *   normal mutex and boosts TA at P(+3), the tester thread priority
+ *   does not change.
+ * - [8.15.4] The tester thread sleeps, TA wakes up and waits on the
+ *   ceiling mutex, the tester thread must inherit the priority of TA.
+ * - [8.15.5] Unlocking the ceiling mutex, the priority goes back to
+ *   P(0), TA then TB complete.
+ * .
+ */
+
+static void rt_test_008_015_setup(void) {
+  chMtxObjectInitCeiling(&m1, chThdGetPriorityX() + 2);
+  chMtxObjectInit(&m2);
+}
+
+static void rt_test_008_015_execute(void) {
+  tprio_t prio;
+
+  /* [8.15.1] Reading current base priority then locking the ceiling
+     mutex, the priority must be raised at P(+2).*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chMtxLock(&m1);
+    test_assert(chThdGetPriorityX() == prio + 2, "not raised to ceiling");
+  }
+  test_end_step(1);
+
+  /* [8.15.2] Thread A is created at priority P(+1) then the tester
+     thread sleeps, TA locks the normal mutex and sleeps.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread13, "A");
+    chThdSleepMilliseconds(10);
+  }
+  test_end_step(2);
+
+  /* [8.15.3] Thread B is created at priority P(+3), it waits on the
+     normal mutex and boosts TA at P(+3), the tester thread priority
+     does not change.*/
+  test_set_step(3);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+3, thread14, "B");
+    test_assert(chThdGetPriorityX() == prio + 2, "wrong priority level");
+  }
+  test_end_step(3);
+
+  /* [8.15.4] The tester thread sleeps, TA wakes up and waits on the
+     ceiling mutex, the tester thread must inherit the priority of TA.*/
+  test_set_step(4);
+  {
+    chThdSleepMilliseconds(20);
+    test_assert(chThdGetPriorityX() == prio + 3, "not boosted");
+  }
+  test_end_step(4);
+
+  /* [8.15.5] Unlocking the ceiling mutex, the priority goes back to
+     P(0), TA then TB complete.*/
+  test_set_step(5);
+  {
+    chMtxUnlock(&m1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_008_015 = {
+  "Ceiling mutex, boosted requester",
+  rt_test_008_015_setup,
+  NULL,
+  rt_test_008_015_execute
+};
+#endif /* CH_CFG_USE_MUTEXES_CEILING == TRUE */
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_016 [8.16] Reader-writer lock, mutex released while holding the lock
+ *
+ * <h2>Description</h2>
+ * The tester thread holds the lock for read access and a mutex, a
+ * writer thread waiting on the lock and a thread waiting on the mutex
+ * raise its priority. Releasing the mutex must not drop the priority
+ * inherited through the lock.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.16.1] Reading current base priority then acquiring the lock for
+ *   read access and the mutex.
+ * - [8.16.2] Thread A is created at priority P(+2), it waits for write
+ *   access and boosts the tester thread priority at P(+2).
+ * - [8.16.3] Thread B is created at priority P(+1), it waits on the
+ *   mutex.
+ * - [8.16.4] Releasing the mutex, the tester thread priority must stay
+ *   at P(+2) because of the writer waiting on the lock.
+ * - [8.16.5] Releasing the read access, the tester thread priority goes
+ *   back to P(0), TA acquires the lock, then TB completes.
+ * .
+ */
+
+static void rt_test_008_016_setup(void) {
+  chRwlObjectInit(&rw1);
+  chMtxObjectInit(&m1);
+}
+
+static void rt_test_008_016_execute(void) {
+  tprio_t prio;
+
+  /* [8.16.1] Reading current base priority then acquiring the lock for
+     read access and the mutex.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chRwlReadLock(&rw1);
+    chMtxLock(&m1);
+  }
+  test_end_step(1);
+
+  /* [8.16.2] Thread A is created at priority P(+2), it waits for write
+     access and boosts the tester thread priority at P(+2).*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+2, thread10W, "A");
+    test_assert(chThdGetPriorityX() == prio + 2, "wrong priority level");
+  }
+  test_end_step(2);
+
+  /* [8.16.3] Thread B is created at priority P(+1), it waits on the
+     mutex.*/
+  test_set_step(3);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+1, thread1, "B");
+    test_assert(chThdGetPriorityX() == prio + 2, "wrong priority level");
+  }
+  test_end_step(3);
+
+  /* [8.16.4] Releasing the mutex, the tester thread priority must stay
+     at P(+2) because of the writer waiting on the lock.*/
+  test_set_step(4);
+  {
+    chMtxUnlock(&m1);
+    test_assert(chThdGetPriorityX() == prio + 2, "wrong priority level");
+    test_assert_sequence("", "invalid sequence");
+  }
+  test_end_step(4);
+
+  /* [8.16.5] Releasing the read access, the tester thread priority goes
+     back to P(0), TA acquires the lock, then TB completes.*/
+  test_set_step(5);
+  {
+    chRwlReadUnlock(&rw1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_wait_threads();
+    test_assert_sequence("AB", "invalid sequence");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_008_016 = {
+  "Reader-writer lock, mutex released while holding the lock",
+  rt_test_008_016_setup,
+  NULL,
+  rt_test_008_016_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_017 [8.17] Reader-writer lock, priority inheritance toward all readers
+ *
+ * <h2>Description</h2>
+ * The tester thread and a reader thread hold the lock for read access,
+ * a writer thread waits on the lock raising the priority of both
+ * readers. The tester thread leaves first, the remaining reader must
+ * keep the inherited priority and inherit the priority of a further
+ * waiting thread.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.17.1] Reading current base priority then acquiring the lock for
+ *   read access.
+ * - [8.17.2] Thread C is created at priority P(-1), it acquires the
+ *   lock for read access and holds it for 50mS.
+ * - [8.17.3] Thread A is created at priority P(+1), it waits for write
+ *   access and boosts both readers at P(+1).
+ * - [8.17.4] Releasing the read access, the tester thread priority goes
+ *   back to P(0) while TC keeps P(+1).
+ * - [8.17.5] Thread B is created at priority P(+2), it waits for read
+ *   access because there is a writer waiting and boosts TC at P(+2).
+ * - [8.17.6] Waiting for TC to release the lock, TA acquires it, then
+ *   TB.
+ * .
+ */
+
+static void rt_test_008_017_setup(void) {
+  chRwlObjectInit(&rw1);
+}
+
+static void rt_test_008_017_execute(void) {
+  tprio_t prio;
+
+  /* [8.17.1] Reading current base priority then acquiring the lock for
+     read access.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chRwlReadLock(&rw1);
+  }
+  test_end_step(1);
+
+  /* [8.17.2] Thread C is created at priority P(-1), it acquires the
+     lock for read access and holds it for 50mS.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio-1, thread15, "C");
+    chThdSleepMilliseconds(10);
+    test_assert(rw1.readers == 2, "wrong readers count");
+  }
+  test_end_step(2);
+
+  /* [8.17.3] Thread A is created at priority P(+1), it waits for write
+     access and boosts both readers at P(+1).*/
+  test_set_step(3);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+1, thread10W, "A");
+    test_assert(chThdGetPriorityX() == prio + 1, "wrong priority level");
+    test_assert(threads[0]->hdr.pqueue.prio == prio + 1, "reader not boosted");
+  }
+  test_end_step(3);
+
+  /* [8.17.4] Releasing the read access, the tester thread priority goes
+     back to P(0) while TC keeps P(+1).*/
+  test_set_step(4);
+  {
+    chRwlReadUnlock(&rw1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_assert(threads[0]->hdr.pqueue.prio == prio + 1, "reader boost lost");
+  }
+  test_end_step(4);
+
+  /* [8.17.5] Thread B is created at priority P(+2), it waits for read
+     access because there is a writer waiting and boosts TC at P(+2).*/
+  test_set_step(5);
+  {
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+2, thread10R, "B");
+    test_assert(threads[0]->hdr.pqueue.prio == prio + 2, "reader not boosted");
+  }
+  test_end_step(5);
+
+  /* [8.17.6] Waiting for TC to release the lock, TA acquires it, then
+     TB.*/
+  test_set_step(6);
+  {
+    test_wait_threads();
+    test_assert_sequence("CAB", "invalid sequence");
+    test_assert((rw1.readers == 0) && (rw1.writer == NULL), "not released");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t rt_test_008_017 = {
+  "Reader-writer lock, priority inheritance toward all readers",
+  rt_test_008_017_setup,
+  NULL,
+  rt_test_008_017_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_018 [8.18] Reader-writer lock, priority restored on timeout
+ *
+ * <h2>Description</h2>
+ * The tester thread holds the lock for read access, a writer thread
+ * waiting with a timeout raises its priority. When the writer gives up
+ * the tester thread priority must go back to its base level.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.18.1] Reading current base priority then acquiring the lock for
+ *   read access.
+ * - [8.18.2] Thread A is created at priority P(+1), it waits for write
+ *   access with a 50mS timeout and boosts the tester thread priority at
+ *   P(+1).
+ * - [8.18.3] Waiting for TA to time out, the tester thread priority
+ *   goes back to P(0) while still holding the lock.
+ * - [8.18.4] Releasing the read access.
+ * .
+ */
+
+static void rt_test_008_018_setup(void) {
+  chRwlObjectInit(&rw1);
+}
+
+static void rt_test_008_018_execute(void) {
+  tprio_t prio;
+
+  /* [8.18.1] Reading current base priority then acquiring the lock for
+     read access.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chRwlReadLock(&rw1);
+  }
+  test_end_step(1);
+
+  /* [8.18.2] Thread A is created at priority P(+1), it waits for write
+     access with a 50mS timeout and boosts the tester thread priority at
+     P(+1).*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread11, "A");
+    test_assert(chThdGetPriorityX() == prio + 1, "wrong priority level");
+  }
+  test_end_step(2);
+
+  /* [8.18.3] Waiting for TA to time out, the tester thread priority
+     goes back to P(0) while still holding the lock.*/
+  test_set_step(3);
+  {
+    chThdSleepMilliseconds(100);
+    test_wait_threads();
+    test_assert_sequence("A", "invalid sequence");
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_assert(rw1.readers == 1, "wrong readers count");
+  }
+  test_end_step(3);
+
+  /* [8.18.4] Releasing the read access.*/
+  test_set_step(4);
+  {
+    chRwlReadUnlock(&rw1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_assert(rw1.readers == 0, "still read locked");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_008_018 = {
+  "Reader-writer lock, priority restored on timeout",
+  rt_test_008_018_setup,
+  NULL,
+  rt_test_008_018_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#if ((CH_CFG_USE_RWLOCKS == TRUE) && (CH_CFG_USE_CONDVARS == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_019 [8.19] Reader-writer lock, boosted reader waiting on a condition variable
+ *
+ * <h2>Description</h2>
+ * A reader thread holding the lock waits on a condition variable behind
+ * a higher priority thread, a writer thread waiting on the lock boosts
+ * the reader above the other thread. The reader is expected to be moved
+ * ahead in the condition variable queue and to be woken first.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_RWLOCKS == TRUE) && (CH_CFG_USE_CONDVARS == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.19.1] Reading current base priority.
+ * - [8.19.2] Thread C is created at priority P(+1), it acquires the
+ *   lock for read access then waits on the condition variable. Thread B
+ *   is created at priority P(+2), it waits on the condition variable
+ *   ahead of TC.
+ * - [8.19.3] Thread A is created at priority P(+3), it waits for write
+ *   access and boosts TC at P(+3), TC is expected to be moved ahead of
+ *   TB in the condition variable queue.
+ * - [8.19.4] Signaling the condition variable twice, TC is woken first
+ *   and releases the lock, TA acquires it, then TB is woken.
+ * .
+ */
+
+static void rt_test_008_019_setup(void) {
+  chRwlObjectInit(&rw1);
+}
+
+static void rt_test_008_019_execute(void) {
+  tprio_t prio;
+
+  /* [8.19.1] Reading current base priority.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+  }
+  test_end_step(1);
+
+  /* [8.19.2] Thread C is created at priority P(+1), it acquires the
+     lock for read access then waits on the condition variable. Thread B
+     is created at priority P(+2), it waits on the condition variable
+     ahead of TC.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread16, "C");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread6, "B");
+    test_assert(rw1.readers == 1, "wrong readers count");
+    test_assert(c1.queue.next == &threads[1]->hdr.queue, "wrong queue order");
+  }
+  test_end_step(2);
+
+  /* [8.19.3] Thread A is created at priority P(+3), it waits for write
+     access and boosts TC at P(+3), TC is expected to be moved ahead of
+     TB in the condition variable queue.*/
+  test_set_step(3);
+  {
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+3, thread10W, "A");
+    test_assert(threads[0]->hdr.pqueue.prio == prio + 3, "reader not boosted");
+    test_assert(c1.queue.next == &threads[0]->hdr.queue, "reader not requeued");
+  }
+  test_end_step(3);
+
+  /* [8.19.4] Signaling the condition variable twice, TC is woken first
+     and releases the lock, TA acquires it, then TB is woken.*/
+  test_set_step(4);
+  {
+    chCondSignal(&c1);
+    chCondSignal(&c1);
+    test_wait_threads();
+    test_assert_sequence("CAB", "invalid sequence");
+    test_assert((rw1.readers == 0) && (rw1.writer == NULL), "not released");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_008_019 = {
+  "Reader-writer lock, boosted reader waiting on a condition variable",
+  rt_test_008_019_setup,
+  NULL,
+  rt_test_008_019_execute
+};
+#endif /* (CH_CFG_USE_RWLOCKS == TRUE) && (CH_CFG_USE_CONDVARS == TRUE) */
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_008_020 [8.20] Reader-writer lock, priority inheritance along a locks chain
+ *
+ * <h2>Description</h2>
+ * Two readers hold a second lock, one of them waits for write access on
+ * the first lock held for read by the tester thread and by another
+ * reader. A writer thread waiting on the second lock is expected to
+ * boost the readers of both locks, the propagation has to reach the
+ * first lock through the waiting reader and then continue with the
+ * other reader of the second lock.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.20.1] Reading current base priority then acquiring the first
+ *   lock for read access.
+ * - [8.20.2] Thread D is created at priority P(+1), it acquires the
+ *   first lock for read access and holds it for 50mS. Thread B is
+ *   created at priority P(+1), it acquires the second lock for read
+ *   access and holds it for 100mS.
+ * - [8.20.3] Thread C is created at priority P(+1), it acquires the
+ *   second lock for read access then waits for write access on the
+ *   first lock, the tester thread is boosted at P(+1).
+ * - [8.20.4] Thread A is created at priority P(+3), it waits for write
+ *   access on the second lock. All the readers of both locks are
+ *   expected to be boosted at P(+3).
+ * - [8.20.5] Releasing the first lock, the tester thread priority goes
+ *   back to P(0) while TD keeps P(+3).
+ * - [8.20.6] Waiting for the threads, TD releases the first lock and TC
+ *   acquires it, then TB releases the second lock and TA acquires it.
+ * .
+ */
+
+static void rt_test_008_020_setup(void) {
+  chRwlObjectInit(&rw1);
+  chRwlObjectInit(&rw2);
+}
+
+static void rt_test_008_020_execute(void) {
+  tprio_t prio;
+
+  /* [8.20.1] Reading current base priority then acquiring the first
+     lock for read access.*/
+  test_set_step(1);
+  {
+    prio = chThdGetPriorityX();
+    chRwlReadLock(&rw1);
+  }
+  test_end_step(1);
+
+  /* [8.20.2] Thread D is created at priority P(+1), it acquires the
+     first lock for read access and holds it for 50mS. Thread B is
+     created at priority P(+1), it acquires the second lock for read
+     access and holds it for 100mS.*/
+  test_set_step(2);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread15, "D");
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+1, thread17, "B");
+    test_assert((rw1.readers == 2) && (rw2.readers == 1), "wrong readers count");
+  }
+  test_end_step(2);
+
+  /* [8.20.3] Thread C is created at priority P(+1), it acquires the
+     second lock for read access then waits for write access on the
+     first lock, the tester thread is boosted at P(+1).*/
+  test_set_step(3);
+  {
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+1, thread18, "C");
+    test_assert(rw2.readers == 2, "wrong readers count");
+    test_assert(chThdGetPriorityX() == prio + 1, "wrong priority level");
+  }
+  test_end_step(3);
+
+  /* [8.20.4] Thread A is created at priority P(+3), it waits for write
+     access on the second lock. All the readers of both locks are
+     expected to be boosted at P(+3).*/
+  test_set_step(4);
+  {
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, prio+3, thread19, "A");
+    test_assert(chThdGetPriorityX() == prio + 3, "tester not boosted");
+    test_assert(threads[0]->hdr.pqueue.prio == prio + 3, "TD not boosted");
+    test_assert(threads[1]->hdr.pqueue.prio == prio + 3, "TB not boosted");
+    test_assert(threads[2]->hdr.pqueue.prio == prio + 3, "TC not boosted");
+    test_assert((rw1.upper == NULL) && (rw2.upper == NULL), "cursor not cleared");
+  }
+  test_end_step(4);
+
+  /* [8.20.5] Releasing the first lock, the tester thread priority goes
+     back to P(0) while TD keeps P(+3).*/
+  test_set_step(5);
+  {
+    chRwlReadUnlock(&rw1);
+    test_assert(chThdGetPriorityX() == prio, "wrong priority level");
+    test_assert(threads[0]->hdr.pqueue.prio == prio + 3, "TD boost lost");
+  }
+  test_end_step(5);
+
+  /* [8.20.6] Waiting for the threads, TD releases the first lock and TC
+     acquires it, then TB releases the second lock and TA acquires it.*/
+  test_set_step(6);
+  {
+    test_wait_threads();
+    test_assert_sequence("DCBA", "invalid sequence");
+    test_assert((rw1.readers == 0) && (rw1.writer == NULL), "not released");
+    test_assert((rw2.readers == 0) && (rw2.writer == NULL), "not released");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t rt_test_008_020 = {
+  "Reader-writer lock, priority inheritance along a locks chain",
+  rt_test_008_020_setup,
+  NULL,
+  rt_test_008_020_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const rt_test_sequence_008_array[] = {
+  &rt_test_008_001,
+#if (CH_DBG_THREADS_PROFILING == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_002,
+#endif
+#if (CH_DBG_THREADS_PROFILING == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_003,
+#endif
+  &rt_test_008_004,
+#if (CH_CFG_USE_MUTEXES_RECURSIVE == FALSE) || defined(__DOXYGEN__)
+  &rt_test_008_005,
+#endif
+#if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_006,
+#endif
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_007,
+#endif
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_008,
+#endif
+#if (CH_CFG_USE_CONDVARS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_009,
+#endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_010,
+#endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_011,
+#endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_012,
+#endif
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_013,
+#endif
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_014,
+#endif
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_015,
+#endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_016,
+#endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_017,
+#endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_018,
+#endif
+#if ((CH_CFG_USE_RWLOCKS == TRUE) && (CH_CFG_USE_CONDVARS == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_008_019,
+#endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_008_020,
 #endif
   NULL
 };
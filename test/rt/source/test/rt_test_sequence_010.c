@@ -42,6 +42,7 @@
  * - @subpage rt_test_010_005
  * - @subpage rt_test_010_006
  * - @subpage rt_test_010_007
+ * - @subpage rt_test_010_008
  * .
  */
 
@@ -73,6 +74,10 @@ static THD_FUNCTION(evt_thread7, p) {
   chEvtBroadcast(&es2);
 }
 
+#if CH_CFG_USE_EVENTS_INDEX
+static event_isource_t ies1;
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -573,6 +578,125 @@ static const testcase_t rt_test_010_007 = {
   rt_test_010_007_execute
 };
 
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_010_008 [10.8] Indexed event sources
+ *
+ * <h2>Description</h2>
+ * Listeners interested in different flags are registered on an indexed
+ * event source, the test verifies that broadcasting flags only signals
+ * the interested listeners, that broadcasting without flags signals all
+ * the listeners and that unregistered listeners are no more signaled.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS_INDEX == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.8.1] Registering four listeners interested in flags 1, 2, 0x100
+ *   and in all flags respectively, with the default number of buckets
+ *   the first and third listeners share the same bucket.
+ * - [10.8.2] Broadcasting flag 1, only the first listener and the
+ *   listener interested in all flags are expected to be signaled.
+ * - [10.8.3] Broadcasting flags 2 and 0x100, the second and third
+ *   listeners and the listener interested in all flags are expected to
+ *   be signaled.
+ * - [10.8.4] Broadcasting without flags, all the listeners are expected
+ *   to be signaled.
+ * - [10.8.5] Unregistering the listeners, a broadcast is not expected
+ *   to signal any event.
+ * .
+ */
+
+static void rt_test_010_008_setup(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+  chEvtIndexedObjectInit(&ies1);
+}
+
+static void rt_test_010_008_execute(void) {
+  eventmask_t m;
+  event_listener_t el1, el2, el3, el4;
+
+  /* [10.8.1] Registering four listeners interested in flags 1, 2, 0x100
+     and in all flags respectively, with the default number of buckets
+     the first and third listeners share the same bucket.*/
+  test_set_step(1);
+  {
+    chEvtIndexedRegisterMaskWithFlags(&ies1, &el1, EVENT_MASK(0), (eventflags_t)1);
+    chEvtIndexedRegisterMaskWithFlags(&ies1, &el2, EVENT_MASK(1), (eventflags_t)2);
+    chEvtIndexedRegisterMaskWithFlags(&ies1, &el3, EVENT_MASK(2), (eventflags_t)0x100);
+    chEvtIndexedRegisterMaskWithFlags(&ies1, &el4, EVENT_MASK(3), (eventflags_t)-1);
+    test_assert(chEvtIndexedIsListeningI(&ies1), "not listening");
+  }
+  test_end_step(1);
+
+  /* [10.8.2] Broadcasting flag 1, only the first listener and the
+     listener interested in all flags are expected to be signaled.*/
+  test_set_step(2);
+  {
+    chEvtIndexedBroadcastFlags(&ies1, (eventflags_t)1);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(0) | EVENT_MASK(3)), "wrong events mask");
+    test_assert(chEvtGetAndClearFlags(&el1) == (eventflags_t)1, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el3) == (eventflags_t)0, "unexpected flags");
+    test_assert(chEvtGetAndClearFlags(&el4) == (eventflags_t)1, "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [10.8.3] Broadcasting flags 2 and 0x100, the second and third
+     listeners and the listener interested in all flags are expected to
+     be signaled.*/
+  test_set_step(3);
+  {
+    chEvtIndexedBroadcastFlags(&ies1, (eventflags_t)0x102);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(1) | EVENT_MASK(2) | EVENT_MASK(3)),
+                "wrong events mask");
+    test_assert(chEvtGetAndClearFlags(&el1) == (eventflags_t)0, "unexpected flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == (eventflags_t)2, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el3) == (eventflags_t)0x100, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el4) == (eventflags_t)0x102, "wrong flags");
+  }
+  test_end_step(3);
+
+  /* [10.8.4] Broadcasting without flags, all the listeners are expected
+     to be signaled.*/
+  test_set_step(4);
+  {
+    chEvtIndexedBroadcastFlags(&ies1, (eventflags_t)0);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == (EVENT_MASK(0) | EVENT_MASK(1) |
+                      EVENT_MASK(2) | EVENT_MASK(3)),
+                "wrong events mask");
+  }
+  test_end_step(4);
+
+  /* [10.8.5] Unregistering the listeners, a broadcast is not expected
+     to signal any event.*/
+  test_set_step(5);
+  {
+    chEvtIndexedUnregister(&ies1, &el1);
+    chEvtIndexedUnregister(&ies1, &el2);
+    chEvtIndexedUnregister(&ies1, &el3);
+    chEvtIndexedUnregister(&ies1, &el4);
+    test_assert(!chEvtIndexedIsListeningI(&ies1), "stuck listener");
+    chEvtIndexedBroadcastFlags(&ies1, (eventflags_t)-1);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 0, "stuck event");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_010_008 = {
+  "Indexed event sources",
+  rt_test_010_008_setup,
+  NULL,
+  rt_test_010_008_execute
+};
+#endif /* CH_CFG_USE_EVENTS_INDEX == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -590,6 +714,9 @@ const testcase_t * const rt_test_sequence_010_array[] = {
   &rt_test_010_006,
 #endif
   &rt_test_010_007,
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+  &rt_test_010_008,
+#endif
   NULL
 };
 
@@ -38,6 +38,8 @@
  * <h2>Test Cases</h2>
  * - @subpage rt_test_011_001
  * - @subpage rt_test_011_002
+ * - @subpage rt_test_011_003
+ * - @subpage rt_test_011_004
  * .
  */
 
@@ -59,6 +61,54 @@ static THD_FUNCTION(dyn_thread1, p) {
   test_emit_token(*(char *)p);
 }
 
+#if CH_CFG_USE_THREADS_POOLS
+static THD_WORKING_AREA(wa_worker1, WA_SIZE);
+static THD_WORKING_AREA(wa_worker2, WA_SIZE);
+static THREADS_POOL_DECL(pool1, "worker");
+static thread_t *job_thread;
+
+static THD_FUNCTION(pool_job1, p) {
+
+  job_thread = chThdGetSelfX();
+  test_emit_token(*(char *)p);
+}
+
+static THD_FUNCTION(pool_job2, p) {
+
+  job_thread = chThdGetSelfX();
+  chRegSetThreadName("job");
+#if CH_CFG_USE_EVENTS == TRUE
+  chEvtSignal(job_thread, (eventmask_t)1);
+#endif
+  test_emit_token(*(char *)p);
+}
+
+static THD_FUNCTION(pool_job3, p) {
+
+  job_thread = chThdGetSelfX();
+#if CH_CFG_USE_REGISTRY == TRUE
+  if (chRegGetThreadNameX(job_thread) != pool1.name) {
+    test_emit_token('X');
+    return;
+  }
+#endif
+#if CH_CFG_USE_EVENTS == TRUE
+  if (chEvtGetAndClearEvents(ALL_EVENTS) != (eventmask_t)0) {
+    test_emit_token('Y');
+    return;
+  }
+#endif
+  test_emit_token(*(char *)p);
+}
+
+static THD_FUNCTION(pool_exit, p) {
+
+  job_thread = chThdGetSelfX();
+  test_emit_token(*(char *)p);
+  chThdPoolExit(&pool1, (msg_t)*(char *)p);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -276,6 +326,228 @@ static const testcase_t rt_test_011_002 = {
 };
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
 
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_003 [11.3] Threads pool functionality
+ *
+ * <h2>Description</h2>
+ * Two workers are added to a threads pool then functions are started on
+ * the pool at various priority levels. The test expects parked workers
+ * to be reused in LIFO order, start attempts on an empty pool to fail
+ * and threads waiting for a worker to be served as soon as a worker is
+ * parked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_THREADS_POOLS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.3.1] Two workers are added to the pool at a lower priority
+ *   level if not already present, the workers are parked after they run
+ *   for the first time.
+ * - [11.3.2] Two functions are started at an higher priority level, the
+ *   second function is expected to be executed by the same worker of
+ *   the first one.
+ * - [11.3.3] Two functions are started at a lower priority level,
+ *   further start attempts are expected to fail because there are no
+ *   parked workers left.
+ * - [11.3.4] A function is started at an higher priority level, the
+ *   tester thread waits for a worker and it is expected to obtain the
+ *   first worker that gets parked.
+ * - [11.3.5] Letting the remaining function run then checking that both
+ *   workers are parked again.
+ * .
+ */
+
+static void rt_test_011_003_execute(void) {
+  tprio_t prio = chThdGetPriorityX();
+  thread_t *tp;
+  cnt_t n;
+  msg_t msg;
+
+  /* [11.3.1] Two workers are added to the pool at a lower priority
+     level if not already present, the workers are parked after they run
+     for the first time.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    n = chThdPoolGetWorkersI(&pool1);
+    chSysUnlock();
+    if (n == (cnt_t)0) {
+      (void) chThdPoolAddStatic(&pool1, wa_worker1, sizeof wa_worker1, prio - 1);
+      (void) chThdPoolAddStatic(&pool1, wa_worker2, sizeof wa_worker2, prio - 1);
+    }
+    chThdSleepMilliseconds(10);
+    chSysLock();
+    n = chThdPoolGetParkedI(&pool1);
+    chSysUnlock();
+    test_assert(n == (cnt_t)2, "not all workers parked");
+  }
+  test_end_step(1);
+
+  /* [11.3.2] Two functions are started at an higher priority level, the
+     second function is expected to be executed by the same worker of
+     the first one.*/
+  test_set_step(2);
+  {
+    chThdPoolStart(&pool1, prio + 1, pool_job1, "A");
+    tp = job_thread;
+    chThdPoolStart(&pool1, prio + 1, pool_job1, "B");
+    test_assert(job_thread == tp, "worker not reused");
+  }
+  test_end_step(2);
+
+  /* [11.3.3] Two functions are started at a lower priority level,
+     further start attempts are expected to fail because there are no
+     parked workers left.*/
+  test_set_step(3);
+  {
+    test_assert_lock(chThdPoolStartI(&pool1, prio - 1, pool_job1, "C") == MSG_OK,
+                     "start failed");
+    test_assert_lock(chThdPoolStartI(&pool1, prio - 1, pool_job1, "D") == MSG_OK,
+                     "start failed");
+    test_assert_lock(chThdPoolStartI(&pool1, prio - 1, pool_job1, "X") == MSG_TIMEOUT,
+                     "start not failed");
+    msg = chThdPoolStartTimeout(&pool1, prio - 1, pool_job1, "X", TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "start not failed");
+  }
+  test_end_step(3);
+
+  /* [11.3.4] A function is started at an higher priority level, the
+     tester thread waits for a worker and it is expected to obtain the
+     first worker that gets parked.*/
+  test_set_step(4);
+  {
+    chThdPoolStart(&pool1, prio + 1, pool_job1, "E");
+    test_assert_sequence("ABCE", "invalid sequence");
+  }
+  test_end_step(4);
+
+  /* [11.3.5] Letting the remaining function run then checking that both
+     workers are parked again.*/
+  test_set_step(5);
+  {
+    chThdSleepMilliseconds(10);
+    test_assert_sequence("D", "invalid sequence");
+    chSysLock();
+    n = chThdPoolGetParkedI(&pool1);
+    chSysUnlock();
+    test_assert(n == (cnt_t)2, "not all workers parked");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_011_003 = {
+  "Threads pool functionality",
+  NULL,
+  NULL,
+  rt_test_011_003_execute
+};
+#endif /* CH_CFG_USE_THREADS_POOLS == TRUE */
+
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_004 [11.4] Threads pool workers state and exit
+ *
+ * <h2>Description</h2>
+ * A function changing the worker name and leaving events pending is
+ * executed on a worker, the next function executed by the same worker
+ * is expected to find the pool name and no pending events. Then both
+ * workers are terminated using chThdPoolExit(), the pool is expected to
+ * be left without workers.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_THREADS_POOLS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.4.1] Two workers are added to the pool at a lower priority
+ *   level if not already present, the workers are parked after they run
+ *   for the first time.
+ * - [11.4.2] A function renaming the worker and signaling an event to
+ *   it is started, then a second function is started on the same
+ *   worker, the worker name and the pending events are expected to be
+ *   restored.
+ * - [11.4.3] Both workers are terminated, the pool is expected to have
+ *   no workers and the exit codes are expected to be returned.
+ * .
+ */
+
+static void rt_test_011_004_execute(void) {
+  tprio_t prio = chThdGetPriorityX();
+  thread_t *tp1, *tp2;
+  cnt_t n;
+
+  /* [11.4.1] Two workers are added to the pool at a lower priority
+     level if not already present, the workers are parked after they run
+     for the first time.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    n = chThdPoolGetWorkersI(&pool1);
+    chSysUnlock();
+    if (n == (cnt_t)0) {
+      (void) chThdPoolAddStatic(&pool1, wa_worker1, sizeof wa_worker1, prio - 1);
+      (void) chThdPoolAddStatic(&pool1, wa_worker2, sizeof wa_worker2, prio - 1);
+    }
+    chThdSleepMilliseconds(10);
+    chSysLock();
+    n = chThdPoolGetParkedI(&pool1);
+    chSysUnlock();
+    test_assert(n == (cnt_t)2, "not all workers parked");
+  }
+  test_end_step(1);
+
+  /* [11.4.2] A function renaming the worker and signaling an event to
+     it is started, then a second function is started on the same
+     worker, the worker name and the pending events are expected to be
+     restored.*/
+  test_set_step(2);
+  {
+    chThdPoolStart(&pool1, prio + 1, pool_job2, "A");
+    tp1 = job_thread;
+    chThdPoolStart(&pool1, prio + 1, pool_job3, "B");
+    test_assert(job_thread == tp1, "worker not reused");
+    test_assert_sequence("AB", "invalid sequence");
+  }
+  test_end_step(2);
+
+  /* [11.4.3] Both workers are terminated, the pool is expected to have
+     no workers and the exit codes are expected to be returned.*/
+  test_set_step(3);
+  {
+    chThdPoolStart(&pool1, prio + 1, pool_exit, "C");
+    tp1 = job_thread;
+    chThdPoolStart(&pool1, prio + 1, pool_exit, "D");
+    tp2 = job_thread;
+    test_assert(tp1 != tp2, "same worker");
+    chSysLock();
+    n = chThdPoolGetWorkersI(&pool1);
+    chSysUnlock();
+    test_assert(n == (cnt_t)0, "workers still present");
+    chSysLock();
+    n = chThdPoolGetParkedI(&pool1);
+    chSysUnlock();
+    test_assert(n == (cnt_t)0, "workers still parked");
+    test_assert(chThdWait(tp1) == (msg_t)'C', "invalid exit code");
+    test_assert(chThdWait(tp2) == (msg_t)'D', "invalid exit code");
+    test_assert_sequence("CD", "invalid sequence");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_011_004 = {
+  "Threads pool workers state and exit",
+  NULL,
+  NULL,
+  rt_test_011_004_execute
+};
+#endif /* CH_CFG_USE_THREADS_POOLS == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -289,6 +561,12 @@ const testcase_t * const rt_test_sequence_011_array[] = {
 #endif
 #if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
   &rt_test_011_002,
+#endif
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_011_003,
+#endif
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_011_004,
 #endif
   NULL
 };
@@ -46,6 +46,12 @@
  * - @subpage rt_test_012_010
  * - @subpage rt_test_012_011
  * - @subpage rt_test_012_012
+ * - @subpage rt_test_012_013
+ * - @subpage rt_test_012_014
+ * - @subpage rt_test_012_015
+ * - @subpage rt_test_012_016
+ * - @subpage rt_test_012_017
+ * - @subpage rt_test_012_018
  * .
  */
 
@@ -59,6 +65,9 @@ static semaphore_t sem1;
 #if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
 static mutex_t mtx1;
 #endif
+#if CH_CFG_USE_RWLOCKS || defined(__DOXYGEN__)
+static rwlock_t rwl1;
+#endif
 
 static void tmo(virtual_timer_t *vtp, void *param) {
 
@@ -79,6 +88,20 @@ static THD_FUNCTION(bmk_thread1, p) {
   } while (msg);
 }
 
+static THD_FUNCTION(bmk_thread2, p) {
+  thread_t *tp;
+  msg_t msg;
+
+  (void)p;
+  tp = chMsgWait();
+  msg = chMsgGet(tp);
+  while (msg) {
+    tp = chMsgReleaseWait(tp, msg);
+    msg = chMsgGet(tp);
+  }
+  chMsgRelease(tp, msg);
+}
+
 NOINLINE static unsigned int msg_loop_test(thread_t *tp) {
   systime_t start, end;
 
@@ -138,6 +161,83 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+#if CH_CFG_USE_RWLOCKS
+static THD_FUNCTION(bmk_thread9, p) {
+
+  do {
+    chRwlReadLock(&rwl1);
+    chThdYield();
+    chRwlReadUnlock(&rwl1);
+    (*(uint32_t *)p) += 1;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while(!chThdShouldTerminateX());
+}
+#endif
+
+#if CH_CFG_USE_MUTEXES && CH_CFG_USE_SEMAPHORES
+static THD_FUNCTION(bmk_thread10, p) {
+
+  while (true) {
+    chSemWait(&sem1);
+    if (chThdShouldTerminateX()) {
+      break;
+    }
+    chMtxLock((mutex_t *)p);
+    chMtxUnlock((mutex_t *)p);
+  }
+}
+#endif
+
+#if CH_CFG_USE_THREADS_POOLS
+static THD_WORKING_AREA(wa_worker, WA_SIZE);
+static THREADS_POOL_DECL(pool1, "worker");
+
+static THD_FUNCTION(bmk_thread11, p) {
+
+  (void)p;
+}
+#endif
+
+#if CH_CFG_USE_EVENTS && CH_CFG_USE_EVENTS_INDEX
+static event_source_t es1;
+static event_isource_t ies1;
+static event_listener_t el1[48];
+
+NOINLINE static unsigned int evt_loop_test(event_source_t *esp) {
+  systime_t start, end;
+
+  uint32_t n = 0;
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    chEvtBroadcastFlags(esp, (eventflags_t)1);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  return n;
+}
+
+NOINLINE static unsigned int ievt_loop_test(event_isource_t *iesp) {
+  systime_t start, end;
+
+  uint32_t n = 0;
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    chEvtIndexedBroadcastFlags(iesp, (eventflags_t)1);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  return n;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -149,7 +249,8 @@ static THD_FUNCTION(bmk_thread8, p) {
  * <h2>Description</h2>
  * A message server thread is created with a lower priority than the
  * client thread, the messages throughput per second is measured and
- * the result printed on the output log.
+ * the result printed on the output log. The measure is repeated with a
+ * server replying using @p chMsgReleaseWait().
  *
  * <h2>Conditions</h2>
  * This test is only executed if the following preprocessor condition
@@ -162,12 +263,16 @@ static THD_FUNCTION(bmk_thread8, p) {
  *   the current thread.
  * - [12.1.2] The number of messages exchanged is counted in a one
  *   second time window.
- * - [12.1.3] Score is printed.
+ * - [12.1.3] A messenger thread replying using @p chMsgReleaseWait()
+ *   is started at a lower priority than the current thread.
+ * - [12.1.4] The number of messages exchanged is counted in a one
+ *   second time window.
+ * - [12.1.5] Scores are printed.
  * .
  */
 
 static void rt_test_012_001_execute(void) {
-  uint32_t n;
+  uint32_t n1, n2;
 
   /* [12.1.1] The messenger thread is started at a lower priority than
      the current thread.*/
@@ -181,21 +286,43 @@ static void rt_test_012_001_execute(void) {
      second time window.*/
   test_set_step(2);
   {
-    n = msg_loop_test(threads[0]);
+    n1 = msg_loop_test(threads[0]);
     test_wait_threads();
   }
   test_end_step(2);
 
-  /* [12.1.3] Score is printed.*/
+  /* [12.1.3] A messenger thread replying using @p chMsgReleaseWait()
+     is started at a lower priority than the current thread.*/
   test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1, bmk_thread2, NULL);
+  }
+  test_end_step(3);
+
+  /* [12.1.4] The number of messages exchanged is counted in a one
+     second time window.*/
+  test_set_step(4);
+  {
+    n2 = msg_loop_test(threads[0]);
+    test_wait_threads();
+  }
+  test_end_step(4);
+
+  /* [12.1.5] Scores are printed.*/
+  test_set_step(5);
   {
     test_print("--- Score : ");
-    test_printn(n);
+    test_printn(n1);
     test_print(" msgs/S, ");
-    test_printn(n << 1);
+    test_printn(n1 << 1);
     test_println(" ctxswc/S");
+    test_print("--- Score : ");
+    test_printn(n2);
+    test_print(" msgs/S, ");
+    test_printn(n2 << 1);
+    test_println(" ctxswc/S (release and wait)");
   }
-  test_end_step(3);
+  test_end_step(5);
 }
 
 static const testcase_t rt_test_012_001 = {
@@ -213,7 +340,8 @@ static const testcase_t rt_test_012_001 = {
  * <h2>Description</h2>
  * A message server thread is created with an higher priority than the
  * client thread, the messages throughput per second is measured and
- * the result printed on the output log.
+ * the result printed on the output log. The measure is repeated with a
+ * server replying using @p chMsgReleaseWait().
  *
  * <h2>Conditions</h2>
  * This test is only executed if the following preprocessor condition
@@ -226,12 +354,16 @@ static const testcase_t rt_test_012_001 = {
  *   than the current thread.
  * - [12.2.2] The number of messages exchanged is counted in a one
  *   second time window.
- * - [12.2.3] Score is printed.
+ * - [12.2.3] A messenger thread replying using @p chMsgReleaseWait()
+ *   is started at an higher priority than the current thread.
+ * - [12.2.4] The number of messages exchanged is counted in a one
+ *   second time window.
+ * - [12.2.5] Scores are printed.
  * .
  */
 
 static void rt_test_012_002_execute(void) {
-  uint32_t n;
+  uint32_t n1, n2;
 
   /* [12.2.1] The messenger thread is started at an higher priority
      than the current thread.*/
@@ -245,21 +377,43 @@ static void rt_test_012_002_execute(void) {
      second time window.*/
   test_set_step(2);
   {
-    n = msg_loop_test(threads[0]);
+    n1 = msg_loop_test(threads[0]);
     test_wait_threads();
   }
   test_end_step(2);
 
-  /* [12.2.3] Score is printed.*/
+  /* [12.2.3] A messenger thread replying using @p chMsgReleaseWait()
+     is started at an higher priority than the current thread.*/
   test_set_step(3);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread2, NULL);
+  }
+  test_end_step(3);
+
+  /* [12.2.4] The number of messages exchanged is counted in a one
+     second time window.*/
+  test_set_step(4);
+  {
+    n2 = msg_loop_test(threads[0]);
+    test_wait_threads();
+  }
+  test_end_step(4);
+
+  /* [12.2.5] Scores are printed.*/
+  test_set_step(5);
   {
     test_print("--- Score : ");
-    test_printn(n);
+    test_printn(n1);
     test_print(" msgs/S, ");
-    test_printn(n << 1);
+    test_printn(n1 << 1);
     test_println(" ctxswc/S");
+    test_print("--- Score : ");
+    test_printn(n2);
+    test_print(" msgs/S, ");
+    test_printn(n2 << 1);
+    test_println(" ctxswc/S (release and wait)");
   }
-  test_end_step(3);
+  test_end_step(5);
 }
 
 static const testcase_t rt_test_012_002 = {
@@ -278,7 +432,8 @@ static const testcase_t rt_test_012_002 = {
  * A message server thread is created with an higher priority than the
  * client thread, four lower priority threads crowd the ready list, the
  * messages throughput per second is measured while the ready list and
- * the result printed on the output log.
+ * the result printed on the output log. The measure is repeated with a
+ * server replying using @p chMsgReleaseWait().
  *
  * <h2>Conditions</h2>
  * This test is only executed if the following preprocessor condition
@@ -293,12 +448,18 @@ static const testcase_t rt_test_012_002 = {
  *   current thread.
  * - [12.3.3] The number of messages exchanged is counted in a one
  *   second time window.
- * - [12.3.4] Score is printed.
+ * - [12.3.4] A messenger thread replying using @p chMsgReleaseWait()
+ *   is started at an higher priority than the current thread.
+ * - [12.3.5] Four threads are started at a lower priority than the
+ *   current thread.
+ * - [12.3.6] The number of messages exchanged is counted in a one
+ *   second time window.
+ * - [12.3.7] Scores are printed.
  * .
  */
 
 static void rt_test_012_003_execute(void) {
-  uint32_t n;
+  uint32_t n1, n2;
 
   /* [12.3.1] The messenger thread is started at an higher priority
      than the current thread.*/
@@ -323,21 +484,54 @@ static void rt_test_012_003_execute(void) {
      second time window.*/
   test_set_step(3);
   {
-    n = msg_loop_test(threads[0]);
+    n1 = msg_loop_test(threads[0]);
     test_wait_threads();
   }
   test_end_step(3);
 
-  /* [12.3.4] Score is printed.*/
+  /* [12.3.4] A messenger thread replying using @p chMsgReleaseWait()
+     is started at an higher priority than the current thread.*/
   test_set_step(4);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread2, NULL);
+  }
+  test_end_step(4);
+
+  /* [12.3.5] Four threads are started at a lower priority than the
+     current thread.*/
+  test_set_step(5);
+  {
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()-2, bmk_thread3, NULL);
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, chThdGetPriorityX()-3, bmk_thread3, NULL);
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, chThdGetPriorityX()-4, bmk_thread3, NULL);
+    threads[4] = chThdCreateStatic(wa[4], WA_SIZE, chThdGetPriorityX()-5, bmk_thread3, NULL);
+  }
+  test_end_step(5);
+
+  /* [12.3.6] The number of messages exchanged is counted in a one
+     second time window.*/
+  test_set_step(6);
+  {
+    n2 = msg_loop_test(threads[0]);
+    test_wait_threads();
+  }
+  test_end_step(6);
+
+  /* [12.3.7] Scores are printed.*/
+  test_set_step(7);
   {
     test_print("--- Score : ");
-    test_printn(n);
+    test_printn(n1);
     test_print(" msgs/S, ");
-    test_printn(n << 1);
+    test_printn(n1 << 1);
     test_println(" ctxswc/S");
+    test_print("--- Score : ");
+    test_printn(n2);
+    test_print(" msgs/S, ");
+    test_printn(n2 << 1);
+    test_println(" ctxswc/S (release and wait)");
   }
-  test_end_step(4);
+  test_end_step(7);
 }
 
 static const testcase_t rt_test_012_003 = {
@@ -916,28 +1110,585 @@ static const testcase_t rt_test_012_011 = {
 };
 #endif /* CH_CFG_USE_MUTEXES ==TRUE */
 
+#if ((CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
 /**
- * @page rt_test_012_012 [12.12] RAM Footprint
+ * @page rt_test_012_012 [12.12] Mutexes contention performance
  *
  * <h2>Description</h2>
- * The memory size of the various kernel objects is printed.
+ * The tester thread locks a mutex and wakes up a higher priority thread
+ * that tries to lock the same mutex, the priority inheritance protocol
+ * requires four context switches for each cycle.<br> The performance is
+ * calculated by measuring the number of iterations after a second of
+ * continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)
+ * .
  *
  * <h2>Test Steps</h2>
- * - [12.12.1] The size of the system area is printed.
- * - [12.12.2] The size of a thread structure is printed.
- * - [12.12.3] The size of a virtual timer structure is printed.
- * - [12.12.4] The size of a semaphore structure is printed.
- * - [12.12.5] The size of a mutex is printed.
- * - [12.12.6] The size of a condition variable is printed.
- * - [12.12.7] The size of an event source is printed.
- * - [12.12.8] The size of an event listener is printed.
- * - [12.12.9] The size of a mailbox is printed.
+ * - [12.12.1] A thread is created at higher priority, it waits on a
+ *   semaphore then locks and unlocks the mutex. The tester thread locks
+ *   the mutex, signals the semaphore and unlocks the mutex. The
+ *   operation is repeated continuously in a one-second time window.
+ * - [12.12.2] The score is printed.
  * .
  */
 
+static void rt_test_012_012_setup(void) {
+  chSemObjectInit(&sem1, 0);
+  chMtxObjectInit(&mtx1);
+}
+
 static void rt_test_012_012_execute(void) {
+  uint32_t n;
 
-  /* [12.12.1] The size of the system area is printed.*/
+  /* [12.12.1] A thread is created at higher priority, it waits on a
+     semaphore then locks and unlocks the mutex. The tester thread locks
+     the mutex, signals the semaphore and unlocks the mutex. The
+     operation is repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+
+    n = 0;
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread10, (void *)&mtx1);
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chMtxLock(&mtx1);
+      chSemSignal(&sem1);
+      chMtxUnlock(&mtx1);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    test_terminate_threads();
+    chSemSignal(&sem1);
+    test_wait_threads();
+  }
+  test_end_step(1);
+
+  /* [12.12.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" cycles/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_012 = {
+  "Mutexes contention performance",
+  rt_test_012_012_setup,
+  NULL,
+  rt_test_012_012_execute
+};
+#endif /* (CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE) */
+
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_013 [12.13] Ceiling mutexes lock/unlock performance
+ *
+ * <h2>Description</h2>
+ * A ceiling mutex is locked/unlocked into a continuous loop, no Context
+ * Switch happens because there are no other threads asking for the
+ * mutex.<br> The performance is calculated by measuring the number of
+ * iterations after a second of continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES_CEILING == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.13.1] A ceiling mutex is locked and unlocked. The operation is
+ *   repeated continuously in a one-second time window.
+ * - [12.13.2] The score is printed.
+ * .
+ */
+
+static void rt_test_012_013_setup(void) {
+  chMtxObjectInitCeiling(&mtx1, chThdGetPriorityX() + 1);
+}
+
+static void rt_test_012_013_execute(void) {
+  uint32_t n;
+
+  /* [12.13.1] A ceiling mutex is locked and unlocked. The operation is
+     repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chMtxLock(&mtx1);
+      chMtxUnlock(&mtx1);
+      chMtxLock(&mtx1);
+      chMtxUnlock(&mtx1);
+      chMtxLock(&mtx1);
+      chMtxUnlock(&mtx1);
+      chMtxLock(&mtx1);
+      chMtxUnlock(&mtx1);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [12.13.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n * 4);
+    test_println(" lock+unlock/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_013 = {
+  "Ceiling mutexes lock/unlock performance",
+  rt_test_012_013_setup,
+  NULL,
+  rt_test_012_013_execute
+};
+#endif /* CH_CFG_USE_MUTEXES_CEILING == TRUE */
+
+#if ((CH_CFG_USE_MUTEXES_CEILING == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_014 [12.14] Ceiling mutexes contention performance
+ *
+ * <h2>Description</h2>
+ * Same scenario of the mutexes contention benchmark using a ceiling
+ * mutex, the woken thread cannot preempt the mutex owner so only two
+ * context switches are required for each cycle.<br> The performance is
+ * calculated by measuring the number of iterations after a second of
+ * continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_MUTEXES_CEILING == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.14.1] A thread is created at higher priority, it waits on a
+ *   semaphore then locks and unlocks the mutex. The tester thread locks
+ *   the mutex, signals the semaphore and unlocks the mutex. The
+ *   operation is repeated continuously in a one-second time window.
+ * - [12.14.2] The score is printed.
+ * .
+ */
+
+static void rt_test_012_014_setup(void) {
+  chSemObjectInit(&sem1, 0);
+  chMtxObjectInitCeiling(&mtx1, chThdGetPriorityX() + 1);
+}
+
+static void rt_test_012_014_execute(void) {
+  uint32_t n;
+
+  /* [12.14.1] A thread is created at higher priority, it waits on a
+     semaphore then locks and unlocks the mutex. The tester thread locks
+     the mutex, signals the semaphore and unlocks the mutex. The
+     operation is repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+
+    n = 0;
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1, bmk_thread10, (void *)&mtx1);
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chMtxLock(&mtx1);
+      chSemSignal(&sem1);
+      chMtxUnlock(&mtx1);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    test_terminate_threads();
+    chSemSignal(&sem1);
+    test_wait_threads();
+  }
+  test_end_step(1);
+
+  /* [12.14.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" cycles/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_014 = {
+  "Ceiling mutexes contention performance",
+  rt_test_012_014_setup,
+  NULL,
+  rt_test_012_014_execute
+};
+#endif /* (CH_CFG_USE_MUTEXES_CEILING == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE) */
+
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_015 [12.15] Reader-writer locks read scalability
+ *
+ * <h2>Description</h2>
+ * A reader-writer lock is first acquired and released for read access
+ * into a continuous loop with no other threads using the lock. Then
+ * five threads at equal priority acquire the lock for read access and
+ * yield while holding it, readers never block each other so all the
+ * threads keep running.<br> The performance is calculated by measuring
+ * the number of iterations after a second of continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_RWLOCKS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.15.1] The lock is acquired and released for read access. The
+ *   operation is repeated continuously in a one-second time window.
+ * - [12.15.2] The score is printed.
+ * - [12.15.3] The five reader threads are created at lower priority.
+ *   The threads have equal priority and start acquiring the lock for
+ *   read access and yielding continuously.
+ * - [12.15.4] Waiting one second then terminating the 5 threads.
+ * - [12.15.5] The score is printed.
+ * .
+ */
+
+static void rt_test_012_015_setup(void) {
+  chRwlObjectInit(&rwl1);
+}
+
+static void rt_test_012_015_execute(void) {
+  uint32_t n;
+
+  /* [12.15.1] The lock is acquired and released for read access. The
+     operation is repeated continuously in a one-second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chRwlReadLock(&rwl1);
+      chRwlReadUnlock(&rwl1);
+      chRwlReadLock(&rwl1);
+      chRwlReadUnlock(&rwl1);
+      chRwlReadLock(&rwl1);
+      chRwlReadUnlock(&rwl1);
+      chRwlReadLock(&rwl1);
+      chRwlReadUnlock(&rwl1);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [12.15.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n * 4);
+    test_println(" lock+unlock/S");
+  }
+  test_end_step(2);
+
+  /* [12.15.3] The five reader threads are created at lower priority.
+     The threads have equal priority and start acquiring the lock for
+     read access and yielding continuously.*/
+  test_set_step(3);
+  {
+    n = 0;
+    test_wait_tick();
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()-1, bmk_thread9, (void *)&n);
+    threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriorityX()-1, bmk_thread9, (void *)&n);
+    threads[2] = chThdCreateStatic(wa[2], WA_SIZE, chThdGetPriorityX()-1, bmk_thread9, (void *)&n);
+    threads[3] = chThdCreateStatic(wa[3], WA_SIZE, chThdGetPriorityX()-1, bmk_thread9, (void *)&n);
+    threads[4] = chThdCreateStatic(wa[4], WA_SIZE, chThdGetPriorityX()-1, bmk_thread9, (void *)&n);
+  }
+  test_end_step(3);
+
+  /* [12.15.4] Waiting one second then terminating the 5 threads.*/
+  test_set_step(4);
+  {
+    chThdSleepSeconds(1);
+    test_terminate_threads();
+    test_wait_threads();
+  }
+  test_end_step(4);
+
+  /* [12.15.5] The score is printed.*/
+  test_set_step(5);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" reads/S");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t rt_test_012_015 = {
+  "Reader-writer locks read scalability",
+  rt_test_012_015_setup,
+  NULL,
+  rt_test_012_015_execute
+};
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_016 [12.16] Threads performance, recycled workers
+ *
+ * <h2>Description</h2>
+ * Functions are continuously started on a threads pool into a loop, the
+ * pool has a single worker running at an higher priority so the
+ * function is executed immediately and the worker is parked again
+ * before the tester thread resumes.<br> The performance is calculated
+ * by measuring the number of iterations after a second of continuous
+ * operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_THREADS_POOLS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.16.1] A worker is added to the pool at an higher priority level
+ *   if not already present.
+ * - [12.16.2] A function is started on the pool and let return
+ *   immediately. The operation is repeated continuously in a one-second
+ *   time window.
+ * - [12.16.3] Score is printed.
+ * .
+ */
+
+static void rt_test_012_016_execute(void) {
+  uint32_t n;
+  tprio_t prio = chThdGetPriorityX() + 1;
+  systime_t start, end;
+
+  /* [12.16.1] A worker is added to the pool at an higher priority level
+     if not already present.*/
+  test_set_step(1);
+  {
+    cnt_t workers;
+
+    chSysLock();
+    workers = chThdPoolGetWorkersI(&pool1);
+    chSysUnlock();
+    if (workers == (cnt_t)0) {
+      (void) chThdPoolAddStatic(&pool1, wa_worker, sizeof wa_worker, prio);
+    }
+  }
+  test_end_step(1);
+
+  /* [12.16.2] A function is started on the pool and let return
+     immediately. The operation is repeated continuously in a one-second
+     time window.*/
+  test_set_step(2);
+  {
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chThdPoolStart(&pool1, prio, bmk_thread11, NULL);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [12.16.3] Score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" threads/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_012_016 = {
+  "Threads performance, recycled workers",
+  NULL,
+  NULL,
+  rt_test_012_016_execute
+};
+#endif /* CH_CFG_USE_THREADS_POOLS == TRUE */
+
+#if ((CH_CFG_USE_EVENTS == TRUE) && (CH_CFG_USE_EVENTS_INDEX == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_017 [12.17] Event sources broadcast performance
+ *
+ * <h2>Description</h2>
+ * Listeners interested in different flags are registered on a plain
+ * event source and on an indexed event source, a single flag is
+ * broadcasted continuously with an increasing number of listeners.<br>
+ * The performance is calculated by measuring the number of iterations
+ * after a second of continuous operations.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (CH_CFG_USE_EVENTS == TRUE) && (CH_CFG_USE_EVENTS_INDEX == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.17.1] Four listeners are registered on the event source, each
+ *   listener is interested in a different flag. The first flag is
+ *   broadcasted continuously in a one-second time window then the score
+ *   is printed.
+ * - [12.17.2] Other 44 listeners are registered on the event source,
+ *   the measurement is repeated then the listeners are unregistered.
+ * - [12.17.3] Four listeners are registered on the indexed event
+ *   source, each listener is interested in a different flag. The first
+ *   flag is broadcasted continuously in a one-second time window then
+ *   the score is printed.
+ * - [12.17.4] Other 44 listeners are registered on the indexed event
+ *   source, the measurement is repeated then the listeners are
+ *   unregistered.
+ * .
+ */
+
+static void rt_test_012_017_setup(void) {
+  chEvtObjectInit(&es1);
+  chEvtIndexedObjectInit(&ies1);
+}
+
+static void rt_test_012_017_teardown(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static void rt_test_012_017_execute(void) {
+  uint32_t n;
+  unsigned i;
+
+  /* [12.17.1] Four listeners are registered on the event source, each
+     listener is interested in a different flag. The first flag is
+     broadcasted continuously in a one-second time window then the score
+     is printed.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < 4; i++) {
+      chEvtRegisterMaskWithFlags(&es1, &el1[i], EVENT_MASK(0),
+                                 (eventflags_t)1 << (i & 15U));
+    }
+    n = evt_loop_test(&es1);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" broadcasts/S, 4 listeners");
+  }
+  test_end_step(1);
+
+  /* [12.17.2] Other 44 listeners are registered on the event source,
+     the measurement is repeated then the listeners are unregistered.*/
+  test_set_step(2);
+  {
+    for (i = 4; i < 48; i++) {
+      chEvtRegisterMaskWithFlags(&es1, &el1[i], EVENT_MASK(0),
+                                 (eventflags_t)1 << (i & 15U));
+    }
+    n = evt_loop_test(&es1);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" broadcasts/S, 48 listeners");
+    for (i = 48; i > 0; i--) {
+      chEvtUnregister(&es1, &el1[i - 1]);
+    }
+  }
+  test_end_step(2);
+
+  /* [12.17.3] Four listeners are registered on the indexed event
+     source, each listener is interested in a different flag. The first
+     flag is broadcasted continuously in a one-second time window then
+     the score is printed.*/
+  test_set_step(3);
+  {
+    for (i = 0; i < 4; i++) {
+      chEvtIndexedRegisterMaskWithFlags(&ies1, &el1[i], EVENT_MASK(0),
+                                        (eventflags_t)1 << (i & 15U));
+    }
+    n = ievt_loop_test(&ies1);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" broadcasts/S, 4 listeners, indexed");
+  }
+  test_end_step(3);
+
+  /* [12.17.4] Other 44 listeners are registered on the indexed event
+     source, the measurement is repeated then the listeners are
+     unregistered.*/
+  test_set_step(4);
+  {
+    for (i = 4; i < 48; i++) {
+      chEvtIndexedRegisterMaskWithFlags(&ies1, &el1[i], EVENT_MASK(0),
+                                        (eventflags_t)1 << (i & 15U));
+    }
+    n = ievt_loop_test(&ies1);
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" broadcasts/S, 48 listeners, indexed");
+    for (i = 48; i > 0; i--) {
+      chEvtIndexedUnregister(&ies1, &el1[i - 1]);
+    }
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_012_017 = {
+  "Event sources broadcast performance",
+  rt_test_012_017_setup,
+  rt_test_012_017_teardown,
+  rt_test_012_017_execute
+};
+#endif /* (CH_CFG_USE_EVENTS == TRUE) && (CH_CFG_USE_EVENTS_INDEX == TRUE) */
+
+/**
+ * @page rt_test_012_018 [12.18] RAM Footprint
+ *
+ * <h2>Description</h2>
+ * The memory size of the various kernel objects is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.18.1] The size of the system area is printed.
+ * - [12.18.2] The size of a thread structure is printed.
+ * - [12.18.3] The size of a virtual timer structure is printed.
+ * - [12.18.4] The size of a semaphore structure is printed.
+ * - [12.18.5] The size of a mutex is printed.
+ * - [12.18.6] The size of a condition variable is printed.
+ * - [12.18.7] The size of an event source is printed.
+ * - [12.18.8] The size of an event listener is printed.
+ * - [12.18.9] The size of a mailbox is printed.
+ * .
+ */
+
+static void rt_test_012_018_execute(void) {
+
+  /* [12.18.1] The size of the system area is printed.*/
   test_set_step(1);
   {
     test_print("--- OS    : ");
@@ -946,7 +1697,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(1);
 
-  /* [12.12.2] The size of a thread structure is printed.*/
+  /* [12.18.2] The size of a thread structure is printed.*/
   test_set_step(2);
   {
     test_print("--- Thread: ");
@@ -955,7 +1706,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(2);
 
-  /* [12.12.3] The size of a virtual timer structure is printed.*/
+  /* [12.18.3] The size of a virtual timer structure is printed.*/
   test_set_step(3);
   {
     test_print("--- Timer : ");
@@ -964,7 +1715,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(3);
 
-  /* [12.12.4] The size of a semaphore structure is printed.*/
+  /* [12.18.4] The size of a semaphore structure is printed.*/
   test_set_step(4);
   {
 #if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
@@ -975,7 +1726,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(4);
 
-  /* [12.12.5] The size of a mutex is printed.*/
+  /* [12.18.5] The size of a mutex is printed.*/
   test_set_step(5);
   {
 #if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
@@ -986,7 +1737,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(5);
 
-  /* [12.12.6] The size of a condition variable is printed.*/
+  /* [12.18.6] The size of a condition variable is printed.*/
   test_set_step(6);
   {
 #if CH_CFG_USE_CONDVARS || defined(__DOXYGEN__)
@@ -997,7 +1748,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(6);
 
-  /* [12.12.7] The size of an event source is printed.*/
+  /* [12.18.7] The size of an event source is printed.*/
   test_set_step(7);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -1008,7 +1759,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(7);
 
-  /* [12.12.8] The size of an event listener is printed.*/
+  /* [12.18.8] The size of an event listener is printed.*/
   test_set_step(8);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -1019,7 +1770,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(8);
 
-  /* [12.12.9] The size of a mailbox is printed.*/
+  /* [12.18.9] The size of a mailbox is printed.*/
   test_set_step(9);
   {
 #if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
@@ -1031,11 +1782,11 @@ static void rt_test_012_012_execute(void) {
   test_end_step(9);
 }
 
-static const testcase_t rt_test_012_012 = {
+static const testcase_t rt_test_012_018 = {
   "RAM Footprint",
   NULL,
   NULL,
-  rt_test_012_012_execute
+  rt_test_012_018_execute
 };
 
 /****************************************************************************
@@ -1069,7 +1820,25 @@ const testcase_t * const rt_test_sequence_012_array[] = {
 #if (CH_CFG_USE_MUTEXES ==TRUE) || defined(__DOXYGEN__)
   &rt_test_012_011,
 #endif
+#if ((CH_CFG_USE_MUTEXES == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
   &rt_test_012_012,
+#endif
+#if (CH_CFG_USE_MUTEXES_CEILING == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_013,
+#endif
+#if ((CH_CFG_USE_MUTEXES_CEILING == TRUE) && (CH_CFG_USE_SEMAPHORES == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_012_014,
+#endif
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_015,
+#endif
+#if (CH_CFG_USE_THREADS_POOLS == TRUE) || defined(__DOXYGEN__)
+  &rt_test_012_016,
+#endif
+#if ((CH_CFG_USE_EVENTS == TRUE) && (CH_CFG_USE_EVENTS_INDEX == TRUE)) || defined(__DOXYGEN__)
+  &rt_test_012_017,
+#endif
+  &rt_test_012_018,
   NULL
 };
 
@@ -92,7 +92,7 @@ test cfg2 "-DCH_CFG_OPTIMIZE_SPEED=FALSE"
 test cfg3 "-DCH_CFG_TIME_QUANTUM=0"
 test cfg4 "-DCH_CFG_USE_REGISTRY=FALSE -DCH_CFG_USE_DYNAMIC=FALSE"
 test cfg5 "-DCH_CFG_USE_TM=FALSE"
-test cfg6 "-DCH_CFG_USE_SEMAPHORES=FALSE -DCH_CFG_USE_MAILBOXES=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE"
+test cfg6 "-DCH_CFG_USE_SEMAPHORES=FALSE -DCH_CFG_USE_MAILBOXES=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_OBJ_CACHES=FALSE -DCH_CFG_USE_JOBS=FALSE"
 test cfg7 "-DCH_CFG_USE_SEMAPHORES_PRIORITY=TRUE"
 test cfg8 "-DCH_CFG_USE_MUTEXES=FALSE -DCH_CFG_USE_CONDVARS=FALSE"
 test cfg9 "-DCH_CFG_USE_MUTEXES_RECURSIVE=TRUE"
@@ -100,12 +100,12 @@ test cfg10 "-DCH_CFG_USE_CONDVARS=FALSE"
 test cfg11 "-DCH_CFG_USE_CONDVARS_TIMEOUT=FALSE"
 test cfg12 "-DCH_CFG_USE_EVENTS=FALSE"
 test cfg13 "-DCH_CFG_USE_EVENTS_TIMEOUT=FALSE"
-test cfg14 "-DCH_CFG_USE_MESSAGES=FALSE"
+test cfg14 "-DCH_CFG_USE_MESSAGES=FALSE -DCH_CFG_USE_DELEGATES=FALSE"
 test cfg15 "-DCH_CFG_USE_MESSAGES_PRIORITY=TRUE"
-test cfg16 "-DCH_CFG_USE_MAILBOXES=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE"
-test cfg17 "-DCH_CFG_USE_MEMCORE=FALSE -DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE"
-test cfg18 "-DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE"
-test cfg19 "-DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE"
+test cfg16 "-DCH_CFG_USE_MAILBOXES=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_JOBS=FALSE"
+test cfg17 "-DCH_CFG_USE_MEMCORE=FALSE -DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE -DCH_CFG_USE_JOBS=FALSE"
+test cfg18 "-DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE -DCH_CFG_USE_JOBS=FALSE"
+test cfg19 "-DCH_CFG_USE_MEMPOOLS=FALSE -DCH_CFG_USE_OBJ_FIFOS=FALSE -DCH_CFG_USE_FACTORY=FALSE -DCH_CFG_USE_JOBS=FALSE"
 test cfg20 "-DCH_CFG_USE_HEAP=FALSE -DCH_CFG_USE_FACTORY=FALSE"
 test cfg21 "-DCH_CFG_USE_DYNAMIC=FALSE"
 test cfg22 "-DCH_DBG_STATISTICS=TRUE"
@@ -122,6 +122,7 @@ test cfg32 "-DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
 test cfg33 "-DCH_CFG_INTERVALS_SIZE=64"
 test cfg34 "-DCH_CFG_USE_OBJ_FIFOS=FALSE"
 test cfg35 "-DCH_CFG_USE_FACTORY=FALSE"
+test cfg36 "-DPORT_CORES_NUMBER=2 -DCH_CFG_SMP_MODE=TRUE -DCH_CFG_USE_THREADS_MIGRATION=TRUE -DCH_CFG_SMP_BALANCE_INTERVAL=1"
 
 rm *log.txt 2> /dev/null
 echo
@@ -15,6 +15,7 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -27,6 +28,8 @@
 #include "shell.h"
 
 #include "ff.h"
+#include "fatfs_devices.h"
+#include "blkcache.h"
 
 #include "portab.h"
 
@@ -114,6 +117,15 @@ static bool fs_ready = FALSE;
 /* Generic large buffer.*/
 static uint8_t fbuff[1024];
 
+/**
+ * @brief   Write-back cache on top of the SDC driver.
+ */
+static CachedBlockDevice CBD1;
+
+static const CachedBlockConfig cbdcfg = {
+  (BaseBlockDevice *)&PORTAB_SDCD1
+};
+
 static FRESULT scan_files(BaseSequentialStream *chp, char *path) {
   static FILINFO fno;
   FRESULT res;
@@ -213,9 +225,112 @@ static void cmd_create(BaseSequentialStream *chp, int argc, char *argv[]) {
   }
 }
 
+#define BENCH_DATA  "the quick brown fox jumps over the lazy dog"
+
+static bool bench_mount(BaseBlockDevice *bdp) {
+
+  (void) f_mount(NULL, "/", 0);
+  fatfsSetBlockDevice(0, bdp);
+  if (blkConnect(bdp))
+    return false;
+  return f_mount(&SDC_FS, "/", 1) == FR_OK;
+}
+
+static void bench_run(BaseSequentialStream *chp, const char *name,
+                      unsigned n) {
+  FIL f;
+  UINT bw;
+  unsigned i;
+  systime_t start;
+  uint32_t ms;
+  char fname[24];
+
+  (void) f_mkdir("/bench");
+
+  /* Files creation rate, each file is written and closed.*/
+  start = chVTGetSystemTime();
+  for (i = 0; i < n; i++) {
+    chsnprintf(fname, sizeof fname, "/bench/f%u.txt", i);
+    if ((f_open(&f, fname, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) ||
+        (f_write(&f, BENCH_DATA, sizeof BENCH_DATA - 1, &bw) != FR_OK) ||
+        (f_close(&f) != FR_OK)) {
+      chprintf(chp, "%s: create failed\r\n", name);
+      return;
+    }
+  }
+  ms = (uint32_t)TIME_I2MS(chVTTimeElapsedSinceX(start));
+  chprintf(chp, "%s: %u files created in %lu ms (%lu files/S)\r\n",
+           name, n, ms, ms > 0 ? (n * 1000U) / ms : 0U);
+
+  /* Append rate, each append is synchronized.*/
+  if (f_open(&f, "/bench/append.txt", FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+    chprintf(chp, "%s: open failed\r\n", name);
+    return;
+  }
+  start = chVTGetSystemTime();
+  for (i = 0; i < n; i++) {
+    if ((f_write(&f, BENCH_DATA, sizeof BENCH_DATA - 1, &bw) != FR_OK) ||
+        (f_sync(&f) != FR_OK)) {
+      chprintf(chp, "%s: append failed\r\n", name);
+      break;
+    }
+  }
+  ms = (uint32_t)TIME_I2MS(chVTTimeElapsedSinceX(start));
+  (void) f_close(&f);
+  chprintf(chp, "%s: %u appends in %lu ms (%lu appends/S)\r\n",
+           name, n, ms, ms > 0 ? (n * 1000U) / ms : 0U);
+
+  /* Cleanup.*/
+  for (i = 0; i < n; i++) {
+    chsnprintf(fname, sizeof fname, "/bench/f%u.txt", i);
+    (void) f_unlink(fname);
+  }
+  (void) f_unlink("/bench/append.txt");
+  (void) f_unlink("/bench");
+}
+
+static void cmd_bench(BaseSequentialStream *chp, int argc, char *argv[]) {
+  blkcache_stats_t *sp;
+  unsigned n = 100;
+
+  if (argc > 1) {
+    chprintf(chp, "Usage: bench [files]\r\n");
+    return;
+  }
+  if (argc == 1)
+    n = (unsigned)atoi(argv[0]);
+
+  if (!fs_ready) {
+    chprintf(chp, "File System not mounted\r\n");
+    return;
+  }
+
+  /* Without cache, the file system is mounted on the SDC driver.*/
+  bench_run(chp, "uncached", n);
+
+  /* With cache, the file system is mounted again on the cache.*/
+  blkcacheStart(&CBD1, &cbdcfg);
+  if (!bench_mount((BaseBlockDevice *)&CBD1)) {
+    chprintf(chp, "FS: mount on cache failed\r\n");
+  }
+  else {
+    bench_run(chp, "cached", n);
+    sp = blkcacheGetStatsX(&CBD1);
+    chprintf(chp, "cache: %lu hits, %lu misses, %lu writes of %lu blocks\r\n",
+             sp->hits, sp->misses, sp->writes, sp->blocks_written);
+  }
+  (void) f_mount(NULL, "/", 0);
+  (void) blkDisconnect(&CBD1);
+  blkcacheStop(&CBD1);
+
+  /* Back to the SDC driver.*/
+  fs_ready = bench_mount((BaseBlockDevice *)&PORTAB_SDCD1);
+}
+
 static const ShellCommand commands[] = {
   {"tree", cmd_tree},
   {"create", cmd_create},
+  {"bench", cmd_bench},
   {NULL, NULL}
 };
 
@@ -324,6 +439,9 @@ int main(void) {
   /* Activates the  SDC driver using default configuration.*/
   sdcStart(&PORTAB_SDCD1, NULL);
 
+  /* Cache object initialization, it is started by the benchmark.*/
+  blkcacheObjectInit(&CBD1);
+
   /* Activates the card insertion monitor.*/
   tmr_init(&PORTAB_SDCD1);
 